@@ -292,7 +292,8 @@ void OpenMMInterface::calcOpenMMNonbondedAndGBSAForces
 {
     assert(includedAtomStation_G.size() == dumm.getNumIncludedAtoms());
     assert(includedAtomPos_G.size()     == dumm.getNumIncludedAtoms());
-    assert(includedBodyForces_G.size()  == dumm.getNumIncludedBodies());
+    assert(!wantForces 
+           || includedBodyForces_G.size() == dumm.getNumIncludedBodies());
 
     if (!(wantForces || wantEnergy))
         return;
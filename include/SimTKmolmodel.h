@@ -66,6 +66,7 @@ will include this one). **/
 #include "molmodel/internal/VanderWallSphere.h"
 #include "molmodel/internal/RiboseMobilizer.h"
 #include "molmodel/internal/PeriodicVmdReporter.h"
+#include "molmodel/internal/PeriodicTrajectoryWriter.h"
 #include "molmodel/internal/VelocityRescalingThermostat.h"
 #include "molmodel/internal/NoseHooverThermostat.h"
 #include "molmodel/internal/MassCenterMotionRemover.h"
@@ -6,6 +6,7 @@
 #include "VoxelHash.h"
 #include <iterator>
 #include <set>
+#include <iosfwd>
 
 // #include "md_units.hpp"
 
@@ -25,7 +26,9 @@ protected:
     Impl& updRep();
 
 public:
-    enum NeighborAlgorithm {N_SQUARED, VOXEL_HASH, AUTOMATIC};
+    // AUTOTUNE times the other algorithms on the actual system and cutoff,
+    // then sticks with the fastest; see getAutotunedNeighborAlgorithm().
+    enum NeighborAlgorithm {N_SQUARED, VOXEL_HASH, AUTOMATIC, AUTOTUNE};
 
     typedef SimTK::units::md::mass_t mass_t;
     typedef SimTK::units::md::length_t length_t;
@@ -171,6 +174,39 @@ public:
 
     void addBodyExclusion(MobilizedBodyIndex bodyIx1, MobilizedBodyIndex bodyIx2);
 
+    // The voxel hash PairIterator streams pairs from a Verlet neighbor list
+    // kept in the State, containing pairs within cutoff+skin. There is one
+    // list per cutoff, each rebuilt only when some atom has moved more than 
+    // half the skin (default 0.2 nm) since that list was built.
+    AtomSubsystem& setNeighborListSkin(length_t skin);
+    length_t getNeighborListSkin() const;
+    // How many times has the neighbor list been (re)built?
+    long long getNeighborListBuildCount() const;
+    // The neighbor list for this cutoff itself, rebuilt first if needed, for
+    // callers that want to split it up rather than iterate over it. Each pair
+    // has atoms on different, non-excluded bodies, but may be as far apart 
+    // as cutoff+skin; callers must skip the pairs beyond the cutoff. The
+    // cutoff must be positive. Must be realized to position stage.
+    const std::vector< std::pair<AtomIndex, AtomIndex> >& 
+    getNeighborPairs(const State& state, length_t cutoff) const;
+
+    // The atoms of each body, with the bodies each is excluded from 
+    // interacting with, in the order the PairIterator visits them.
+    const AtomicBodies& getAtomicBodies() const;
+
+    // With AUTOTUNE, the first PairIterators for each cutoff take turns
+    // using N_SQUARED and VOXEL_HASH and time complete passes over the
+    // pairs. Only the time spent inside the PairIterator finding the next
+    // pair is counted, not the caller's work on each pair. Neighbor list 
+    // builds are timed separately but charged to the passes that needed
+    // them, so VOXEL_HASH pays for its list averaged over the passes that 
+    // reuse it. After three passes each, the algorithm with the lower mean
+    // time is used for that cutoff until the topology changes. Returns 
+    // AUTOTUNE while still measuring.
+    NeighborAlgorithm getAutotunedNeighborAlgorithm(length_t cutoff) const;
+    // Write the AUTOTUNE timings measured so far, for logging.
+    void dumpNeighborAlgorithmTimings(std::ostream& o) const;
+
     SimbodyMatterSubsystem& updMatterSubsystem();
 };
 
@@ -192,21 +228,24 @@ private:
     AtomicBodies::const_iterator body1;
     AtomicBodies::const_iterator body2;
     AtomIndexList::const_iterator atom1;
-    // atom2 iterator might point to a local container, when voxel hash is used.
-    // which could become invalid when this iterator is copied.
+    // When voxel hash is used, atom2Index is the position in neighborPairs,
+    // the AtomSubsystem's neighbor list in the State cache.
     // So use an index for atom2, instead of an iterator
     // (body1, body2, and atom1 iterators always refer to atomsByBody pointee, and thus remain valid)
     size_t atom2Index;
 
     NeighborAlgorithm algorithm;
     bool bUseVoxelHash;
-    VoxelHash<AtomSubsystem::AtomIndex> voxelHash; // for use in O(n) neighbor list
-    std::set<AtomicBodies::const_iterator> pendingBodies;
-    AtomIndexList currentNeighborAtoms;
+    bool bTimingTrial; // AUTOTUNE is timing this pass
+    double trialTime; // seconds spent finding pairs in this pass so far
+    double trialBuildTime; // seconds spent building the neighbor list for this pass
+    long long trialNumBuilds; // neighbor list builds done for this pass
+    const std::vector<Pair>* neighborPairs; // pairs within cutoff+skin, for O(n) neighbor list
     
+    void incrementPair();
     void trialIncrementAtoms();
     void trialIncrementBodies();
-    void populateVoxelHash(AtomicBodies::const_iterator bodyIter);
+    void finishTimingTrial();
     
 public:
     // 0.0 means no cutoff applied
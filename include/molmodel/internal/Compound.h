@@ -689,6 +689,18 @@ public:
         Compound::AtomIndex atomId   ///< integer index of Atom with respect to this Compound
         ) const;
 
+    /**
+     * \brief Get the indices of all atoms, in the order writePdb() writes them.
+     *
+     * Indices are appended to the end of the atomIndices array. Together with
+     * getAtomMobilizedBodyIndex() and getAtomLocationInMobilizedBodyFrame() this
+     * lets trajectory writers look atoms up once and then gather whole frames
+     * from the body transforms.
+     */
+    void getAtomIndicesInPdbOrder(
+        Array_<Compound::AtomIndex>& atomIndices ///< array to which atom indices are appended
+        ) const;
+
     /**
      * \return default (initial) location and orientation of a subcompound with respect to this Compound
      */
@@ -1186,6 +1198,19 @@ public:
      */
     DuMM::AtomIndex getDuMMAtomIndex(Compound::AtomIndex) const;
 
+    /**
+     * \brief sum a per-atom quantity over the atoms of this Compound
+     *
+     * Requires that this Compound has already been modeled in a CompoundSystem.
+     * For example, use this to total the per-atom energies from
+     * DuMMForceFieldSubsystem::calcGbsaAtomEnergies() for a Compound.
+     *
+     * \return the sum of dummAtomValues[getDuMMAtomIndex(a)] over all atoms a
+     */
+    Real sumDuMMAtomValues(
+        const Vector& dummAtomValues ///< one value per DuMM atom, indexed by DuMM::AtomIndex
+        ) const;
+
     /// @}
     // end simulation methods
 
@@ -2022,6 +2047,19 @@ public:
         BondMobility::Mobility mobility ///< allowed motion of the new bond connecting the new residue to the rest of the chain
         );
 
+    /**
+     * \brief sum a per-atom quantity over the atoms of each residue
+     *
+     * Requires that this Biopolymer has already been modeled in a CompoundSystem.
+     * For example, use this to get per-residue solvation energies from
+     * DuMMForceFieldSubsystem::calcGbsaAtomEnergies().
+     *
+     * \return a Vector of getNumResidues() sums, indexed by ResidueInfo::Index
+     */
+    Vector sumDuMMAtomValuesByResidue(
+        const Vector& dummAtomValues ///< one value per DuMM atom, indexed by DuMM::AtomIndex
+        ) const;
+
     Biopolymer& setResidueBondMobility(ResidueInfo::Index, BondMobility::Mobility);
     MobilizedBodyIndex getResidueAtomMobilizedBodyIndex(ResidueInfo::Index res, ResidueInfo::AtomIndex a) const {
         return getAtomMobilizedBodyIndex(getResidue(res).getAtomIndex(a));
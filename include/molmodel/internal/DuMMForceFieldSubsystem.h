@@ -315,6 +315,11 @@ these are immediately converted to the MD units described above. **/
 class SimTK_MOLMODEL_EXPORT DuMMForceFieldSubsystem : public ForceSubsystem {
 public:
 
+/** Return the potential energy; the State must have been realized through
+Position stage. If forces have already been calculated for this State the
+energy that came with them is returned. Otherwise only the energy is 
+calculated, which is considerably cheaper, and it is cached separately from
+the forces. **/
 Real calcPotentialEnergy(const State& state) const ; 
 
 /** These are the van der Waals mixing rules supported by DuMM. **/
@@ -758,6 +763,143 @@ void setCoulomb15ScaleFactor(Real); ///< default 1
 /**@}**/
 
 
+/** @name                  Nonbonded cutoff
+By default DuMM evaluates van der Waals and Coulomb interactions between
+every pair of nonbond atoms on different bodies, which is O(N^2) in the
+number of atoms. For large systems you can instead enable a cutoff; pairs
+farther apart than the cutoff distance are then simply ignored (there is no
+switching or shifting function). Candidate pairs are kept in a Verlet 
+neighbor list built with a cell grid using radius cutoff+skin. The list is 
+cached in the State and rebuilt only after some atom has moved more than
+half the skin since the last build. The 1-2, 1-3, 1-4, and 1-5 scale 
+factors are applied exactly as they are without a cutoff. The cutoff
+does not affect GBSA implicit solvent (see setUseGbsaCutoff()), and OpenMM acceleration is not used
+while a cutoff is in effect. **/
+/**@{**/
+
+/** Enable or disable the nonbonded cutoff (disabled by default). **/
+void setUseNonbondedCutoff(bool);
+/** Is the nonbonded cutoff enabled? **/
+bool getUseNonbondedCutoff() const;
+
+/** Set the nonbonded cutoff distance in nm (default 1 nm). This has no
+effect unless setUseNonbondedCutoff(true) has been called. **/
+void setNonbondedCutoff(Real cutoffInNm);
+/** Get the nonbonded cutoff distance in nm. **/
+Real getNonbondedCutoff() const;
+
+/** Set the neighbor list skin thickness in nm (default 0.2 nm). A thicker
+skin means fewer list rebuilds but more candidate pairs per evaluation; zero
+forces a rebuild whenever any atom moves. **/
+void setNeighborListSkin(Real skinInNm);
+/** Get the neighbor list skin thickness in nm. **/
+Real getNeighborListSkin() const;
+/**@}**/
+
+
+/** @name              Periodic boundary conditions
+DuMM can treat the system as one cell of an infinite periodic lattice, as is
+needed for explicit solvent simulations. The cell is an orthorhombic box 
+whose edges are aligned with the Ground frame axes. Nonbonded interactions 
+are then evaluated between nearest (minimum) images and a nonbonded cutoff 
+must be in effect, no larger than half the shortest box edge. By default,
+Coulomb interactions are computed with Ewald summation: the real space part
+uses the cutoff and the neighbor list, and the reciprocal space part is 
+computed with the smooth particle mesh Ewald (PME) method. The Ewald 
+splitting parameter and PME grid are chosen automatically from the cutoff 
+and the Ewald error tolerance. Excluded and scaled bonded pairs, and pairs of
+atoms on the same body, are corrected so that the result is the same as
+the direct sum with the usual scale factors. GBSA implicit solvent can't be 
+combined with a periodic box; set its global scale factor to zero. **/
+/**@{**/
+
+/** Make the system periodic, with the given box edge lengths in nm. **/
+void setPeriodicBoxDimensions(const Vec3& boxEdgesInNm);
+/** Go back to a nonperiodic system (this is the default). **/
+void clearPeriodicBox();
+/** Has a periodic box been specified? **/
+bool hasPeriodicBox() const;
+/** Get the periodic box edge lengths in nm; this is Vec3(0) if there is
+no periodic box. **/
+Vec3 getPeriodicBoxDimensions() const;
+
+/** Choose whether Coulomb interactions in a periodic system are computed 
+with Ewald summation (the default) or simply truncated at the cutoff. This
+has no effect on a nonperiodic system. **/
+void setUseEwaldElectrostatics(bool);
+/** Are Ewald electrostatics enabled for periodic systems? **/
+bool getUseEwaldElectrostatics() const;
+
+/** Set the approximate relative error to allow in Ewald forces; smaller 
+values require a finer PME grid (default 5e-4). **/
+void setEwaldErrorTolerance(Real);
+/** Get the Ewald error tolerance. **/
+Real getEwaldErrorTolerance() const;
+/**@}**/
+
+
+/** @name                Multiple time stepping
+In torsion-space dynamics the nonbonded and implicit solvent terms usually
+dominate the cost but vary more slowly than the bonded terms. DuMM's terms 
+are divided into force groups that can be evaluated at different intervals,
+using the impulse form of the r-RESPA multiple time step method (Tuckerman,
+Berne & Martyna, J. Chem. Phys. 97:1990, 1992). You give the integrator's 
+fixed step size h and an interval n for each group. A group with n > 1 is 
+evaluated only at steps k = t/h that are multiples of n, where its forces are
+applied with weight n; at the other steps it contributes no force. Each slow
+group's unweighted forces and energy are cached in the State along with 
+their step number, and are never reused for a different configuration.
+
+Forces may only be calculated at step times, allowing for roundoff in t that
+grows with the number of steps. Realizing Dynamics stage at any other time
+throws an exception rather than quietly leaving out the slow groups. That 
+means a fixed-step integrator whose force evaluations fall on the step 
+times, such as VerletIntegrator with setFixedStepSize(h), and report or 
+event times that are multiples of h, so that the integrator never has to 
+shorten a step. calcPotentialEnergy() always returns the full potential 
+energy of the current configuration, at any time.
+
+The force groups are:
+  - BondedForceGroup: bond stretch, bend, torsion and improper torsion terms
+  - NonbondedNearForceGroup: van der Waals and Coulomb terms, except for
+    the parts in the next group
+  - NonbondedFarForceGroup: the reciprocal space part of Ewald 
+    electrostatics and its bonded pair corrections; this is empty unless 
+    there is a periodic box with Ewald electrostatics
+  - GBSAForceGroup: GBSA implicit solvent
+
+When OpenMM is in use it calculates the nonbonded and GBSA terms together 
+on the NonbondedNearForceGroup schedule. **/
+/**@{**/
+
+/** These are the force groups used for multiple time stepping. **/
+enum ForceGroup {
+    BondedForceGroup        = 0,
+    NonbondedNearForceGroup = 1,
+    NonbondedFarForceGroup  = 2,
+    GBSAForceGroup          = 3,
+    NumForceGroups          = 4
+};
+
+/** Set the fixed integrator step size h in ps used to number the steps for
+multiple time stepping; zero (the default) disables multiple time stepping 
+regardless of the force group intervals. **/
+void setMultipleTimeStepSize(Real stepSizeInPs);
+/** Get the multiple time stepping step size (zero if disabled). **/
+Real getMultipleTimeStepSize() const;
+
+/** Evaluate the given force group only every \a interval steps (default 1,
+meaning every step). **/
+void setForceGroupInterval(ForceGroup group, int interval);
+/** Get the evaluation interval for a force group. **/
+int getForceGroupInterval(ForceGroup group) const;
+
+/** Is multiple time stepping in effect, that is, is the step size nonzero 
+and some force group interval greater than 1? **/
+bool isUsingMultipleTimeStepping() const;
+/**@}**/
+
+
 /** @name   Tinker biotypes and pre-defined force field parameter sets
 DuMM understands Tinker-format parameter files that can be used to load 
 in a whole force field description. This requires assigning Tinker 
@@ -1196,6 +1338,78 @@ Real getSoluteDielectric() const;
 void setGbsaIncludeAceApproximation(bool);
 void setGbsaIncludeAceApproximationOn()  {setGbsaIncludeAceApproximation(true );}
 void setGbsaIncludeAceApproximationOff() {setGbsaIncludeAceApproximation(false);}
+
+/** Enable or disable the GBSA cutoff (disabled by default). Normally the
+Born radii and the generalized Born energy involve every pair of nonbond 
+atoms, costing three O(N^2) sweeps per evaluation. With the cutoff enabled 
+only pairs closer than the cutoff distance contribute, both to the Born 
+radius descreening sums and to the pair energy; the pairs are found with a 
+cell list rebuilt at each evaluation. This is independent of the nonbonded 
+cutoff, and OpenMM acceleration is not used while it is in effect. **/
+void setUseGbsaCutoff(bool);
+/** Is the GBSA cutoff enabled? **/
+bool getUseGbsaCutoff() const;
+
+/** Set the GBSA cutoff distance in nm (default 2 nm). This has no effect
+unless setUseGbsaCutoff(true) has been called. **/
+void setGbsaCutoff(Real cutoffInNm);
+/** Get the GBSA cutoff distance in nm. **/
+Real getGbsaCutoff() const;
+
+/** Enable or disable mixed precision GBSA (disabled by default). When 
+enabled the all-pairs Born radius sums and generalized Born pair terms are 
+evaluated in single precision, using AVX2 instructions if the processor 
+supports them, while per-atom sums and the energy are accumulated in double.
+The relative error in the GBSA energy is typically 1e-5 or better. The 
+GBSA cutoff mode and the ACE term are always computed in full precision, and
+this has no effect when OpenMM acceleration is in use. **/
+void setUseGbsaMixedPrecision(bool);
+/** Is mixed precision GBSA enabled? **/
+bool getUseGbsaMixedPrecision() const;
+
+/** Enable or disable the fused GBSA and nonbonded calculation (disabled by
+default). Normally the all-pairs Coulomb and van der Waals terms and the 
+generalized Born pair energies are computed in separate passes over the atom
+pairs. When enabled, the Born radii are computed first and then one pass 
+computes all three terms for each pair from the same distance, serially or 
+multithreaded. The results are the same up to roundoff. The fused kernel is 
+scalar, so whether it is faster depends on the system and processor. It is 
+only used without nonbonded or GBSA cutoffs, mixed precision GBSA, or OpenMM,
+and when the nonbonded and GBSA force groups are due together. **/
+void setUseFusedGbsaNonbonded(bool);
+/** Is the fused GBSA and nonbonded calculation enabled? **/
+bool getUseFusedGbsaNonbonded() const;
+
+/** Enable or disable reuse of GBSA Born radii between evaluations (disabled
+by default). When enabled, DuMM remembers the atom positions and Born radius 
+sums of the previous GBSA evaluation. Atoms on bodies that haven't moved since
+then keep their sums, corrected only for the atoms that did move, so when a 
+few small bodies move at a time, as in many Monte Carlo and minimization 
+steps, the Born radius cost is proportional to the number of moved atoms 
+rather than to the square of the number of atoms. The results are the same 
+up to roundoff. When a quarter or more of the atoms have moved, or after 100 
+consecutive reuses, the radii are recomputed from scratch. This applies to 
+the all-pairs, full precision GBSA calculation only, and has no effect with 
+the GBSA cutoff, mixed precision GBSA, or OpenMM. **/
+void setUseGbsaBornRadiusCache(bool);
+/** Is reuse of GBSA Born radii between evaluations enabled? **/
+bool getUseGbsaBornRadiusCache() const;
+
+/** Calculate the GBSA energy of this State broken down by atom, in kJ/mol
+and scaled by the GBSA global scale factor. The State must have been realized 
+through Position stage. The polar (generalized Born) energy of an atom is its 
+self energy plus half of each of its pair energies; the nonpolar (ACE) energy
+is the atom's own surface area term, or zero if the ACE approximation is off.
+Together they add up to the GBSA energy that DuMM includes in the potential 
+energy. Both outputs are resized to getNumAtoms() and indexed by 
+DuMM::AtomIndex; atoms that don't take part in GBSA get zero. This costs one 
+GBSA energy evaluation, using the GBSA settings and threads in effect, but no
+force calculation. Per-atom bookkeeping is done only during this call, so 
+ordinary force and energy calculations don't pay for it. Use 
+Compound::sumDuMMAtomValues() and Biopolymer::sumDuMMAtomValuesByResidue() to
+collect the results by compound or residue. **/
+void calcGbsaAtomEnergies(const State& state, Vector& gbEnergies, 
+                          Vector& aceEnergies) const;
 /**@}**/
 
 /** @name                   Global scale factors
@@ -1271,6 +1485,16 @@ zero meaning DuMM chooses the number of threads. This doesn't tell you how many
 threads are actually in use -- see getNumThreadsInUse() for that. **/
 int getNumThreadsRequested() const;
 
+/** Request a number of threads as above, and also set the tile size used to 
+share out the work. When multithreaded, the all-pairs (no cutoff) van der Waals 
+and Coulomb calculation is divided into square tiles of \a nonbondedTileSize 
+atoms on a side, which the threads share out dynamically. The default is 32. 
+Smaller tiles balance the load better; larger ones have less overhead. The
+one-argument form leaves the tile size unchanged. **/
+void setNumThreadsRequested(int numThreads, int nonbondedTileSize);
+/** Return the tile size set with setNumThreadsRequested(). **/
+int getNonbondedTileSize() const;
+
 /** Is DuMM using the multithreaded code? This could return true even
 if there is just one thread, if you forced it with setNumThreadsToUse(). **/
 bool isUsingMultithreadedComputation() const;
@@ -1279,6 +1503,19 @@ bool isUsingMultithreadedComputation() const;
 realizeTopology(). **/
 int getNumThreadsInUse() const;
 
+/** Allow DuMM to use SIMD (AVX2 or AVX-512) kernels for the van der Waals and
+Coulomb terms if the processor supports them (enabled by default). The choice
+is made in realizeTopology(); the vectorized kernels give the same answers as
+the scalar one to within roundoff. Disabling them is useful for checking 
+results or timing. **/
+void setUseVectorizedNonbondedKernels(bool);
+/** Return the current setting of the flag set by 
+setUseVectorizedNonbondedKernels(). **/
+bool getUseVectorizedNonbondedKernels() const;
+/** Return the name of the nonbonded kernel in use: "scalar", "AVX2", or 
+"AVX-512". This will be "scalar" until after realizeTopology(). **/
+std::string getNonbondedKernelInUse() const;
+
 /** This determines whether we use OpenMM GPU acceleration if it is available. 
 By default, this is set false because OpenMM will compute only to single 
 precision. Note that even if you set this flag, we won't use OpenMM unless 
@@ -1309,9 +1546,28 @@ std::string getOpenMMPlatformInUse() const;
 Hopefully you won't need these. **/
 /**@{**/
 
-/** How many times has the forcefield been evaluated? **/
+/** How many times has the forcefield been evaluated? This includes 
+energy-only evaluations. **/
 long long getForceEvaluationCount() const;
 
+/** How many times has the nonbonded neighbor list been (re)built? This is
+always zero unless a nonbonded cutoff is in use. **/
+long long getNeighborListBuildCount() const;
+
+/** How many atoms had their GBSA Born radii recomputed by the most recent 
+all-pairs, full precision GBSA evaluation? This is every atom unless the Born
+radius cache is enabled (see setUseGbsaBornRadiusCache()), in which case it 
+is the number of atoms that had moved, or every atom if the radii were 
+recomputed from scratch. Zero before the first evaluation or if GBSA isn't
+being calculated by DuMM itself. **/
+int getNumGbsaBornRadiiRecomputed() const;
+
+/** Write a short report of how long each step of the last realizeTopology()
+took and roughly how much memory DuMM's main topology data structures use. 
+This is also sent to std::clog at the end of realizeTopology() when tracing is
+enabled. **/
+void dumpTopologyStatistics(std::ostream& o) const;
+
 /** Produce an ugly but comprehensive dump of the contents of DuMM's internal
 data structures, sent to std::cout (stdout). **/
 void dump() const;
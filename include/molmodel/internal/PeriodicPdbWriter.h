@@ -42,6 +42,8 @@ namespace SimTK {
 
 /// Writes atomic coordinates in PDB format to a file stream at
 /// specified intervals during a simulation.
+/// For long runs PeriodicTrajectoryWriter, which writes compact binary
+/// frames, is much cheaper.
 class PeriodicPdbWriter : public PeriodicEventReporter {
 public:
     PeriodicPdbWriter(
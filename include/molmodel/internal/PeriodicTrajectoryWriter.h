@@ -0,0 +1,151 @@
+#ifndef SimTK_MOLMODEL_PERIODICTRAJECTORYWRITER_H_
+#define SimTK_MOLMODEL_PERIODICTRAJECTORYWRITER_H_
+
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKsimbody.h"
+#include "molmodel/internal/common.h"
+#include "molmodel/internal/Compound.h"
+#include <iostream>
+#include <vector>
+
+namespace SimTK {
+
+/**
+ * \brief Writes atomic coordinates as a binary trajectory at specified
+ * intervals during a simulation.
+ *
+ * This is a compact alternative to PeriodicPdbWriter for long runs. The
+ * topology is written only once, as PDB text to an optional separate stream,
+ * and each reporting step then appends one binary frame holding just the
+ * coordinates. Atoms appear in the same order as in the PDB topology
+ * (compound by compound, in the order writePdb() writes them), so the two
+ * files can be loaded together by a molecular viewer.
+ *
+ * The body and station of every atom are looked up once, with the first
+ * frame, so each later frame costs one body transform per mobilized body
+ * and one station transform per atom.
+ *
+ * Two frame formats are supported:
+ *   - DcdFormat: CHARMM/NAMD style DCD with single precision coordinates in
+ *     Angstroms, written in native byte order. The frame count in the header
+ *     is kept up to date if the output stream is seekable.
+ *   - CompressedFormat: a lossy, XTC-like format. Coordinates in nanometers
+ *     are rounded to multiples of 1/precision, and the difference from the
+ *     previous atom is stored as a variable length integer. Each frame is a
+ *     self-describing big-endian record; see readCompressedFrame().
+ *     This is not the GROMACS XTC codec, and its frames start with their own
+ *     magic number so that XTC readers reject them.
+ *
+ * The output streams must be opened in binary mode.
+ */
+class SimTK_MOLMODEL_EXPORT PeriodicTrajectoryWriter : public PeriodicEventReporter {
+public:
+    enum Format {
+        DcdFormat        = 0,
+        CompressedFormat = 1
+    };
+
+    /// Magic number at the start of every CompressedFormat frame; "SMTR"
+    /// in ASCII, deliberately different from the XTC magic number 1995.
+    static const int CompressedFrameMagic = 0x534D5452;
+
+    PeriodicTrajectoryWriter(
+        const CompoundSystem& system,
+        std::ostream& outputStream,
+        Real interval,
+        Format format = DcdFormat)
+        : PeriodicEventReporter(interval),
+          system(system),
+          outputStream(outputStream),
+          topologyStream(NULL),
+          format(format),
+          precision(1000),
+          numAtoms(0),
+          numFramesWritten(0),
+          dcdHeaderPosition(-1)
+    {}
+
+    /// Write the topology, as PDB text with the coordinates of the first
+    /// frame, to this stream when the first frame is written.
+    PeriodicTrajectoryWriter& setTopologyStream(std::ostream& stream) {
+        topologyStream = &stream;
+        return *this;
+    }
+
+    /// Set the CompressedFormat resolution, in units of 1/nanometers; the
+    /// default of 1000 keeps coordinates to the nearest 0.001 nm. Must be
+    /// set before the first frame is written.
+    PeriodicTrajectoryWriter& setPrecision(Real precision);
+    Real getPrecision() const {return precision;}
+
+    Format getFormat() const {return format;}
+    int getNumFramesWritten() const {return numFramesWritten;}
+
+    void handleEvent(const State& state) const;
+
+    /// Read the next CompressedFormat frame from a stream. Returns false
+    /// without changing the outputs if the stream is already at its end.
+    /// Locations are returned in nanometers and step is the frame number.
+    static bool readCompressedFrame(
+        std::istream& inputStream,
+        Array_<Vec3>& locations,
+        int& step,
+        Real& time);
+
+private:
+    void buildGatherTable() const;
+    void gatherLocations(const State& state) const;
+    void writeHeader(const State& state) const;
+    void writeDcdFrame() const;
+    void writeCompressedFrame(const State& state) const;
+
+    const CompoundSystem& system;
+    std::ostream& outputStream;
+    std::ostream* topologyStream;
+    Format format;
+    Real precision;
+
+    mutable int numAtoms;
+    mutable int numFramesWritten;
+    mutable std::streamoff dcdHeaderPosition;       // -1 if not seekable
+    mutable Array_<MobilizedBodyIndex> atomBodies;  // per atom, PDB order
+    mutable Array_<Vec3> atomStations;              // per atom, body frame
+    mutable Array_<MobilizedBodyIndex> bodies;      // distinct atom bodies
+    mutable Array_<Transform> bodyTransforms;       // by MobilizedBodyIndex
+    mutable Array_<Vec3> locations;                 // gathered coordinates
+    mutable std::vector<char> frameBuffer;          // encoded frame
+};
+
+} // namespace SimTK
+
+#endif // SimTK_MOLMODEL_PERIODICTRAJECTORYWRITER_H_
@@ -4,6 +4,8 @@
 #include "SimTKsimbody.h"
 #include <vector>
 #include <iterator>
+#include <memory>
+#include <mutex>
 
 namespace SimTK {
 
@@ -58,9 +60,21 @@ public:
     };
 
     VanDerWaalsForce(const AtomSubsystem& atomSubsystem, length_t cutoff = 0.0 * nanometers) 
-        : atomSubsystem(atomSubsystem), cutoff(cutoff), cutoffSquared(cutoff * cutoff)
+        : atomSubsystem(atomSubsystem), cutoff(cutoff), cutoffSquared(cutoff * cutoff),
+          useMultithreadedComputation(false), numThreadsRequested(0), 
+          executorNumThreads(0)
     {}
 
+    // By default forces and energy are calculated serially. With 
+    // multithreaded computation the atom pairs and the wall sphere terms are
+    // split into blocks that are evaluated by a ParallelExecutor, each thread
+    // accumulating into its own body force buffer; the buffers are summed at
+    // the end. Zero threads requested (the default) means one per processor.
+    void setUseMultithreadedComputation(bool use) {useMultithreadedComputation = use;}
+    bool getUseMultithreadedComputation() const {return useMultithreadedComputation;}
+    void setNumThreadsRequested(int numThreads) {numThreadsRequested = numThreads;}
+    int getNumThreadsRequested() const {return numThreadsRequested;}
+
     bool dependsOnlyOnPositions() const {return true;}
 
     void addAtom(AtomSubsystem::AtomIndex atomIndex, length_t rMin, energy_t wellDepth) 
@@ -128,6 +142,13 @@ public:
     void calcForce(const State& state, Vector_<SpatialVec>& bodyForces,  
             Vector_<Vec3>& particleForces, Vector& mobilityForces) const 
     {
+        if (ParallelExecutor* parallel = updExecutor()) {
+            energy_t unusedEnergy = 0.0 * md::kilojoules_per_mole;
+            ParallelTask task(*this, state, true, bodyForces, unusedEnergy);
+            parallel->execute(task, task.getNumBlocks());
+            return;
+        }
+
         // Forces on pairs of atoms
         for ( AtomSubsystem::PairIterator pair = 
                     atomSubsystem.pairBegin(state, cutoff);
@@ -157,6 +178,13 @@ public:
     Real calcPotentialEnergy(const State& state) const {
         energy_t energy = 0.0 * md::kilojoules_per_mole;
 
+        if (ParallelExecutor* parallel = updExecutor()) {
+            Vector_<SpatialVec> unusedBodyForces;
+            ParallelTask task(*this, state, false, unusedBodyForces, energy);
+            parallel->execute(task, task.getNumBlocks());
+            return energy;
+        }
+
         for (   AtomSubsystem::PairIterator pair = 
                         atomSubsystem.pairBegin(state, cutoff);
                 pair != atomSubsystem.pairEnd();
@@ -186,6 +214,148 @@ public:
 
 protected:
 
+    // The unit of work is a block of atom pairs or, after all those, a 
+    // block of atoms to be tested against every wall sphere. With a cutoff,
+    // the pair blocks are ranges of the AtomSubsystem's neighbor list, which
+    // also holds pairs that are only within its skin; those are skipped. 
+    // Without one, each pair block is one body paired with every later body.
+    // Different blocks can apply forces to the same bodies, so each thread 
+    // accumulates into its own buffer and the buffers are summed as the 
+    // threads finish.
+    class ParallelTask : public ParallelExecutor::Task {
+    public:
+        static const int PairsPerBlock = 256;
+        static const int AtomsPerBlock = 64;
+
+        ParallelTask(const VanDerWaalsForce& vdw, const State& state, bool calcForces,
+                     Vector_<SpatialVec>& bodyForces, energy_t& energy)
+            : vdw(vdw), state(state), calcForces(calcForces), 
+              globalBodyForces(bodyForces), globalEnergy(energy),
+              atomicBodies(vdw.atomSubsystem.getAtomicBodies()),
+              neighborPairs(NULL)
+        {
+            if (vdw.cutoff > 0.0) {
+                neighborPairs = &vdw.atomSubsystem.getNeighborPairs(state, vdw.cutoff);
+                numPairBlocks = (int(neighborPairs->size()) + PairsPerBlock - 1) / PairsPerBlock;
+            }
+            else 
+                numPairBlocks = int(atomicBodies.size());
+            numAtomBlocks = vdw.wallSpheres.empty() ? 0
+                : (int(vdw.vdwAtoms.size()) + AtomsPerBlock - 1) / AtomsPerBlock;
+        }
+
+        int getNumBlocks() const {return numPairBlocks + numAtomBlocks;}
+
+        void initialize() {
+            updLocalEnergy() = 0.0 * md::kilojoules_per_mole;
+            if (calcForces) {
+                updLocalBodyForces().resize(globalBodyForces.size());
+                updLocalBodyForces() = SpatialVec(Vec3(0), Vec3(0));
+            }
+        }
+
+        // Threads finish concurrently so the reduction must be serialized.
+        void finish() {
+            std::lock_guard<std::mutex> lock(reductionMutex);
+            if (calcForces)
+                globalBodyForces += updLocalBodyForces();
+            globalEnergy += updLocalEnergy();
+        }
+
+        void execute(int block) {
+            Vector_<SpatialVec>& bodyForces = updLocalBodyForces();
+            energy_t& energy = updLocalEnergy();
+
+            if (block < numPairBlocks && neighborPairs) {
+                const int end = std::min(int(neighborPairs->size()), (block+1) * PairsPerBlock);
+                for (int p = block * PairsPerBlock; p < end; ++p) {
+                    const AtomIndex atom1 = (*neighborPairs)[p].first;
+                    const AtomIndex atom2 = (*neighborPairs)[p].second;
+                    const Vec3& pos1 = vdw.atomSubsystem.getAtomLocationInGround(state, atom1);
+                    const Vec3& pos2 = vdw.atomSubsystem.getAtomLocationInGround(state, atom2);
+                    if ( (pos1 - pos2).normSqr() >= vdw.cutoffSquared ) continue; // in the skin
+                    calcPair(atom1, atom2, bodyForces, energy);
+                }
+                return;
+            }
+
+            if (block < numPairBlocks) {
+                const AtomSubsystem::AtomsByBody& body1 = atomicBodies[block];
+                for (size_t b2 = block + 1; b2 < atomicBodies.size(); ++b2) {
+                    const AtomSubsystem::AtomsByBody& body2 = atomicBodies[b2];
+                    if (body1.bodyExclusions.find(body2.bodyIx) != body1.bodyExclusions.end())
+                        continue; // These two bodies are excluded from interacting
+                    for (size_t a1 = 0; a1 < body1.atoms.size(); ++a1)
+                        for (size_t a2 = 0; a2 < body2.atoms.size(); ++a2)
+                            calcPair(body1.atoms[a1], body2.atoms[a2], bodyForces, energy);
+                }
+                return;
+            }
+
+            const int atomBlock = block - numPairBlocks;
+            const int end = std::min(int(vdw.vdwAtoms.size()), (atomBlock+1) * AtomsPerBlock);
+            for (int a = atomBlock * AtomsPerBlock; a < end; ++a) {
+                const VdwAtom& vdwAtom = vdw.vdwAtoms[a];
+                if ( ! vdwAtom.atomIndex.isValid() ) continue;
+                for (size_t s(0); s < vdw.wallSpheres.size(); ++s) {
+                    if (calcForces)
+                        vdw.calcForce(vdw.wallSpheres[s], vdwAtom, state, bodyForces);
+                    else
+                        energy += vdw.calcPotentialEnergy(vdw.wallSpheres[s], vdwAtom, state);
+                }
+            }
+        }
+
+    private:
+        void calcPair(AtomIndex atom1, AtomIndex atom2, 
+                      Vector_<SpatialVec>& bodyForces, energy_t& energy) const 
+        {
+            const VdwAtom& vdwAtom1 = vdw.vdwAtoms[atom1];
+            const VdwAtom& vdwAtom2 = vdw.vdwAtoms[atom2];
+            if (!vdwAtom1.atomIndex.isValid()) return;
+            if (!vdwAtom2.atomIndex.isValid()) return;
+
+            if (calcForces)
+                vdw.calcForce(vdwAtom1, vdwAtom2, state, bodyForces);
+            else
+                energy += vdw.calcPotentialEnergy(vdwAtom1, vdwAtom2, state);
+        }
+
+        // Thread local temporaries.
+        static Vector_<SpatialVec>& updLocalBodyForces() 
+        {   thread_local Vector_<SpatialVec> localBodyForces; return localBodyForces; }
+        static energy_t& updLocalEnergy() 
+        {   thread_local energy_t localEnergy; return localEnergy; }
+
+        const VanDerWaalsForce&             vdw;
+        const State&                        state;
+        const bool                          calcForces;
+        Vector_<SpatialVec>&                globalBodyForces;
+        energy_t&                           globalEnergy;
+        std::mutex                          reductionMutex;
+
+        const AtomSubsystem::AtomicBodies&  atomicBodies;
+        const std::vector<AtomSubsystem::PairIterator::Pair>* neighborPairs; // NULL without a cutoff
+        int numPairBlocks;
+        int numAtomBlocks;
+    };
+
+    // Return the executor to use, or NULL if forces should be calculated
+    // serially. The executor is created on first use and replaced if the
+    // number of threads requested changes.
+    ParallelExecutor* updExecutor() const {
+        if (!useMultithreadedComputation) return NULL;
+
+        const int numThreads = numThreadsRequested > 0 
+                                ? numThreadsRequested 
+                                : ParallelExecutor::getNumProcessors();
+        if (!executor || executorNumThreads != numThreads) {
+            executor.reset(new ParallelExecutor(numThreads));
+            executorNumThreads = numThreads;
+        }
+        return executor.get();
+    }
+
     struct ForceAndEnergy {
         force_t force;
         energy_t energy;
@@ -348,6 +518,11 @@ protected:
     length_t cutoff;
     area_t cutoffSquared;
     std::vector<WallSphere> wallSpheres;
+
+    bool useMultithreadedComputation;
+    int numThreadsRequested;
+    mutable std::unique_ptr<ParallelExecutor> executor;
+    mutable int executorNumThreads;
 };
 
 } // namespace SimTK
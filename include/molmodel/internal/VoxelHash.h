@@ -5,10 +5,9 @@
 #include "molmodel/internal/common.h"
 #include <vector>
 #include <map>
+#include <algorithm>
 // #include "md_units.hpp"
 
-#include <unordered_map>
-
 // Subystem for managing atom locations.
 // Depends on matter subsystem
 
@@ -30,113 +29,252 @@ namespace units { namespace md
     static const Real square_nanometers = 1.0;
 }}
 
+// A uniform grid of cubic cells for finding items within a cutoff distance
+// of one another. Items are collected by insert(); the first query after an
+// insertion sorts them by cell (a counting sort over a dense grid that just
+// covers their bounding box) into one contiguous array, so that the items
+// of a cell, and of a whole row of cells, are adjacent in memory and any
+// cell is found by direct indexing.
+//
+// The grid is built lazily inside the const query methods, so a VoxelHash
+// must not be queried from several threads until it has been built once.
 template< class T >
 class SimTK_MOLMODEL_EXPORT VoxelHash 
 {
 public:
     typedef std::pair<SimTK::Vec3, T> VoxelItem;
-    typedef std::vector< VoxelItem > Voxel;
-
-    class VoxelIndex {
-    public:
-        VoxelIndex(int x, int y, int z, size_t numBuckets) 
-            : x(x), y(y), z(z), numBuckets(numBuckets) 
-        {}
-
-        // operator<() needed for map
-        bool operator<(const VoxelIndex& other) const {
-            if      (x < other.x) return true;
-            else if (x > other.x) return false;
-            else if (y < other.y) return true;
-            else if (y > other.y) return false;
-            else if (z < other.z) return true;
-            else return false;
-        }
-        bool operator==(const VoxelIndex& other) const {
-            if      (x != other.x) return false;
-            else if (y != other.y) return false;
-            else if (z != other.z) return false;
-            else return true;
-        }
+    typedef std::pair<T, T> ItemPair;
 
-        // size_t conversion for use by hash_map
-        operator size_t() const {
-            return hash_value();
-        }
-        
-        size_t hash_value() const {
-            // multiply each index by a different large prime number
-            size_t n = (size_t)(x * 0x8da6b343 + y * 0xd8163841 + z * 0xcb1ab31f);
-            n = n % numBuckets;
-            return n;            
-        }
-
-        int x;
-        int y;
-        int z;
-        size_t numBuckets;
-    };
+    // voxelSize is the preferred cell edge length; it is usually the cutoff.
+    // numBuckets is only a hint of how many items will be inserted.
+    VoxelHash(SimTK::units::md::length_t voxelSize, int numBuckets) 
+        : voxelSize(voxelSize), gridIsValid(false), cellSize(0), stencilReach(-1)
+    {
+        if (numBuckets > 0) items.reserve(numBuckets);
+    }
 
-private:
-    VoxelIndex getVoxelIndex(const Vec3& location) const 
+    void clear()
     {
-        SimTK::Real voxSize = voxelSize;
-        int x = int(floor(location[0] / voxSize));
-        int y = int(floor(location[1] / voxSize));
-        int z = int(floor(location[2] / voxSize));
-        return VoxelIndex(x, y, z, numBuckets);
+        items.clear();
+        gridIsValid = false;
     }
 
-    SimTK::units::md::length_t voxelSize;
-
-    // TODO - replace std::map with hash_map or unordered map
-    // std::map<VoxelIndex, Voxel> voxelMap;
-    std::map<VoxelIndex, Voxel> voxelMap;
-    // HASH_MAP_NAMESPACE::hash_map<VoxelIndex, Voxel> voxelMap;
-    size_t numBuckets;
-    
-public:
-    VoxelHash(SimTK::units::md::length_t voxelSize, int numBuckets) 
-        : voxelSize(voxelSize), numBuckets(numBuckets)
-    {}
+    size_t size() const {return items.size();}
 
     void insert(const T& item, const SimTK::Vec3& location)
     {
-        VoxelIndex voxelIndex = getVoxelIndex(location);
-        if ( voxelMap.find(voxelIndex) == voxelMap.end() ) voxelMap[voxelIndex] = Voxel();
-        Voxel& voxel = voxelMap.find(voxelIndex)->second;
-        voxel.push_back( VoxelItem(location, item) );
+        items.push_back( VoxelItem(location, item) );
+        gridIsValid = false;
     }
 
+    // Append to neighbors every item within maxDistance of locationI
+    // (inclusive). locationI need not lie inside the grid, but it must be
+    // finite, as must the locations of all inserted items.
     void findNeighbors(std::vector<T>& neighbors, const SimTK::Vec3& locationI, SimTK::units::md::length_t maxDistance) const
     {
-        SimTK::units::md::area_t maxDistanceSquared(maxDistance * maxDistance);
+        if (items.empty()) return;
+        SimTK_ERRCHK_ALWAYS(locationI.isFinite(), "VoxelHash::findNeighbors()",
+            "The query location is NaN or infinite.");
+        buildGrid();
+
+        const SimTK::units::md::area_t maxDistanceSquared(maxDistance * maxDistance);
+        const int reach = calcReach(maxDistance);
+
+        // The range of cells that could hold a neighbor, clipped to the grid.
+        int lo[3], hi[3];
+        for (int d = 0; d < 3; ++d) {
+            const Real c = floor((locationI[d] - origin[d]) / cellSize);
+            const Real l = std::max(c - reach, Real(0));
+            const Real h = std::min(c + reach, Real(numCells[d] - 1));
+            if (l > h) return; // too far outside the grid
+            lo[d] = int(l); hi[d] = int(h);
+        }
+
+        // Cells (x,y,lo_z..hi_z) are consecutive, so each row of cells is
+        // one contiguous range of sorted items.
+        for (int x = lo[0]; x <= hi[0]; ++x)
+            for (int y = lo[1]; y <= hi[1]; ++y)
+            {
+                const int first = getCellIndex(x, y, lo[2]);
+                const int last  = getCellIndex(x, y, hi[2]);
+                for (int i = cellStart[first]; i < cellStart[last+1]; ++i) {
+                    const SimTK::Vec3 r = locationI - sortedLocations[i];
+                    if (dot(r, r) > maxDistanceSquared) continue; // beyond cutoff
+                    neighbors.push_back(sortedItems[i]); // store neighbor
+                }
+            }
+    }
+
+    // Append to pairs every unordered pair of distinct inserted items that
+    // are within maxDistance of one another (inclusive), each pair once.
+    void findAllPairs(std::vector<ItemPair>& pairs, SimTK::units::md::length_t maxDistance) const
+    {
+        if (items.size() < 2) return;
+        buildGrid();
+        buildStencil(calcReach(maxDistance), maxDistance);
 
-        int dIndex = int(maxDistance / voxelSize) + 1; // How may voxels away do we have to look?
-        VoxelIndex centerVoxelIndex(getVoxelIndex(locationI));
+        const SimTK::units::md::area_t maxDistanceSquared(maxDistance * maxDistance);
 
-        for (int x = centerVoxelIndex.x - dIndex; x <= centerVoxelIndex.x + dIndex; ++x)
-            for (int y = centerVoxelIndex.y - dIndex; y <= centerVoxelIndex.y + dIndex; ++y)
-                for (int z = centerVoxelIndex.z - dIndex; z <= centerVoxelIndex.z + dIndex; ++z)
+        for (int x = 0; x < numCells[0]; ++x)
+            for (int y = 0; y < numCells[1]; ++y)
+                for (int z = 0; z < numCells[2]; ++z)
                 {
-                    const VoxelIndex voxelIndex(x, y, z, numBuckets);
+                    const int cell = getCellIndex(x, y, z);
+                    const int begin = cellStart[cell], end = cellStart[cell+1];
+                    if (begin == end) continue;
+
+                    // Pairs within this cell.
+                    for (int i = begin; i < end; ++i)
+                        for (int j = i+1; j < end; ++j)
+                            if ((sortedLocations[j] - sortedLocations[i]).normSqr() <= maxDistanceSquared)
+                                pairs.push_back( ItemPair(sortedItems[i], sortedItems[j]) );
+
+                    // Pairs with the cells in the forward half of the stencil.
+                    for (size_t s = 0; s < stencil.size(); ++s) {
+                        const Vec<3,int>& off = stencil[s];
+                        const int nx = x + off[0], ny = y + off[1], nz = z + off[2];
+                        if (   nx < 0 || nx >= numCells[0] 
+                            || ny < 0 || ny >= numCells[1] 
+                            || nz < 0 || nz >= numCells[2]) continue;
+                        const int other = cell + stencilOffset[s];
+                        const int otherBegin = cellStart[other], otherEnd = cellStart[other+1];
+                        for (int i = begin; i < end; ++i)
+                            for (int j = otherBegin; j < otherEnd; ++j)
+                                if ((sortedLocations[j] - sortedLocations[i]).normSqr() <= maxDistanceSquared)
+                                    pairs.push_back( ItemPair(sortedItems[i], sortedItems[j]) );
+                    }
+                }
+    }
 
-                    // TODO - store a list of neighbors for each voxel
-                    if ( voxelMap.find(voxelIndex) == voxelMap.end() ) continue; // no such voxel; skip
+private:
+    int getCellIndex(int x, int y, int z) const 
+    {
+        return (x * numCells[1] + y) * numCells[2] + z;
+    }
 
-                    const Voxel& voxel = voxelMap.find(voxelIndex)->second;
-                    typename std::vector<VoxelItem>::const_iterator itemIter;
-                    for (itemIter = voxel.begin(); itemIter != voxel.end(); ++itemIter)
-                    {
-                        const SimTK::Vec3 r = locationI - itemIter->first;
-                        SimTK::units::md::area_t dSquared(dot(r, r) * units::md::square_nanometers);
-                        if (dSquared > maxDistanceSquared) continue; // beyond cutoff
+    // How many cells away do we have to look?
+    int calcReach(SimTK::units::md::length_t maxDistance) const
+    {
+        const Real cells = ceil(maxDistance / cellSize);
+        const int maxCells = std::max(numCells[0], std::max(numCells[1], numCells[2]));
+        return cells < maxCells ? std::max(int(cells), 0) : maxCells;
+    }
 
-                        neighbors.push_back(itemIter->second); // store neighbor
+    // Size the grid from the bounding box of the items and counting-sort
+    // the items into it.
+    void buildGrid() const
+    {
+        if (gridIsValid) return;
+
+        // A NaN or infinite location (say from a simulation that has blown
+        // up) would leave the grid size undefined.
+        SimTK::Vec3 lower(items[0].first), upper(items[0].first);
+        for (size_t i = 0; i < items.size(); ++i) {
+            SimTK_ERRCHK1_ALWAYS(items[i].first.isFinite(), "VoxelHash::buildGrid()",
+                "Item %d has a NaN or infinite location.", (int)i);
+            for (int d = 0; d < 3; ++d) {
+                lower[d] = std::min(lower[d], items[i].first[d]);
+                upper[d] = std::max(upper[d], items[i].first[d]);
+            }
+        }
+        const SimTK::Vec3 extent = upper - lower;
+        SimTK_ERRCHK_ALWAYS(extent.isFinite(), "VoxelHash::buildGrid()",
+            "The items are too far apart to be put on a grid.");
+        origin = lower;
+
+        cellSize = voxelSize;
+        if (!(cellSize > 0)) 
+            cellSize = std::max(std::max(extent[0], extent[1]), std::max(extent[2], Real(1)));
+
+        // Widely scattered items would need a mostly empty grid; keep it
+        // to a few cells per item by coarsening it instead. If that takes
+        // too many doublings, use cells as big as the whole box.
+        const double maxGridCells = std::max(8.0 * items.size(), 64.0);
+        const int maxCoarsenings = 64;
+        for (int pass = 0; ; ++pass) {
+            double totalCells = 1;
+            for (int d = 0; d < 3; ++d)
+                totalCells *= floor(extent[d] / cellSize) + 1;
+            if (totalCells <= maxGridCells) break;
+            if (pass == maxCoarsenings) {
+                cellSize = std::max(std::max(extent[0], extent[1]), extent[2]);
+                break;
+            }
+            cellSize *= 2;
+        }
+        for (int d = 0; d < 3; ++d)
+            numCells[d] = int(floor(extent[d] / cellSize)) + 1;
+
+        const int totalCells = numCells[0] * numCells[1] * numCells[2];
+        cellStart.assign(totalCells + 1, 0);
+        itemCell.resize(items.size());
+        for (size_t i = 0; i < items.size(); ++i) {
+            int c[3];
+            for (int d = 0; d < 3; ++d)
+                c[d] = std::min(int((items[i].first[d] - origin[d]) / cellSize), numCells[d] - 1);
+            itemCell[i] = getCellIndex(c[0], c[1], c[2]);
+            ++cellStart[itemCell[i] + 1];
+        }
+        for (int c = 0; c < totalCells; ++c)
+            cellStart[c+1] += cellStart[c];
+
+        // Scatter, using itemCell[] to hold each item's destination.
+        std::vector<int> next(cellStart.begin(), cellStart.end() - 1);
+        for (size_t i = 0; i < items.size(); ++i)
+            itemCell[i] = next[itemCell[i]]++;
+        sortedLocations.resize(items.size());
+        sortedItems.resize(items.size());
+        for (size_t i = 0; i < items.size(); ++i) {
+            sortedLocations[itemCell[i]] = items[i].first;
+            sortedItems[itemCell[i]]     = items[i].second;
+        }
+
+        gridIsValid = true;
+        stencilReach = -1;
+    }
+
+    // The forward half of the neighbor cell offsets within reach, leaving
+    // out those whose nearest points are beyond maxDistance.
+    void buildStencil(int reach, SimTK::units::md::length_t maxDistance) const
+    {
+        if (reach == stencilReach && maxDistance == stencilDistance) return;
+        stencil.clear();
+        stencilOffset.clear();
+        for (int x = 0; x <= reach; ++x)
+            for (int y = (x == 0 ? 0 : -reach); y <= reach; ++y)
+                for (int z = (x == 0 && y == 0 ? 1 : -reach); z <= reach; ++z)
+                {
+                    Real gapSquared = 0;
+                    const int off[3] = {x, y, z};
+                    for (int d = 0; d < 3; ++d) {
+                        const Real gap = std::max(std::abs(off[d]) - 1, 0) * cellSize;
+                        gapSquared += gap * gap;
                     }
+                    if (gapSquared > maxDistance * maxDistance) continue;
+                    stencil.push_back( Vec<3,int>(x, y, z) );
+                    stencilOffset.push_back( (x * numCells[1] + y) * numCells[2] + z );
                 }
+        stencilReach = reach;
+        stencilDistance = maxDistance;
     }
 
+    SimTK::units::md::length_t voxelSize;
+    std::vector<VoxelItem> items; // in insertion order
+
+    // The grid, valid only when gridIsValid is set.
+    mutable bool gridIsValid;
+    mutable SimTK::Vec3 origin;
+    mutable SimTK::units::md::length_t cellSize;
+    mutable int numCells[3];
+    mutable std::vector<int> cellStart; // items of cell c are [cellStart[c], cellStart[c+1])
+    mutable std::vector<int> itemCell;  // temporary for sorting
+    mutable std::vector<SimTK::Vec3> sortedLocations;
+    mutable std::vector<T> sortedItems;
+
+    mutable int stencilReach;
+    mutable SimTK::units::md::length_t stencilDistance;
+    mutable std::vector< Vec<3,int> > stencil;
+    mutable std::vector<int> stencilOffset; // linear cell index offsets
 };
 
 } // namespace SimTK
@@ -1,10 +1,93 @@
 #include "molmodel/internal/AtomSubsystem.h"
 #include "SimTKcommon/internal/SubsystemGuts.h"
 
+#include <iomanip>
+#include <ostream>
+
 using namespace SimTK::units::md;
 
 namespace SimTK {
 
+// The Verlet neighbor list used by PairIterator's voxel hash method. It holds
+// every pair of atoms on different, non-excluded bodies that were within
+// cutoff+skin of one another when it was built, with the first atom of each
+// pair on the body that comes first in atomsByBody, and the atom positions
+// at that time. It lives in a State cache entry that depends only on Topology
+// stage, so it survives from one evaluation to the next.
+class AtomNeighborList {
+public:
+    AtomNeighborList() : listRadius(0.0 * nanometers) {}
+
+    std::vector<AtomSubsystem::PairIterator::Pair> pairs;
+    std::vector<Vec3> builtPositions; // by AtomIndex
+    length_t listRadius; // cutoff+skin
+};
+
+// Unfortunately required by Value<T>.
+static inline
+std::ostream& operator<<(std::ostream& o, const AtomNeighborList& nl) {
+    o << "AtomNeighborList(" << nl.pairs.size() << " pairs)\n";
+    return o;
+}
+
+// One neighbor list per cutoff, so that forces using different cutoffs don't
+// rebuild each other's list, and a PairIterator's pointer to its list stays
+// valid while iterators for other cutoffs are created. The map never moves
+// its elements.
+class AtomNeighborLists {
+public:
+    std::map<length_t, AtomNeighborList> byCutoff;
+};
+
+static inline
+std::ostream& operator<<(std::ostream& o, const AtomNeighborLists& nls) {
+    o << "AtomNeighborLists(" << nls.byCutoff.size() << " cutoffs)\n";
+    return o;
+}
+
+// The algorithms AUTOTUNE chooses among, in the order they are tried.
+static const AtomSubsystem::NeighborAlgorithm AutotunedAlgorithms[] = 
+    {AtomSubsystem::N_SQUARED, AtomSubsystem::VOXEL_HASH};
+static const int NumAutotunedAlgorithms = 
+    sizeof(AutotunedAlgorithms) / sizeof(AutotunedAlgorithms[0]);
+
+// Timed passes before AUTOTUNE settles on an algorithm.
+static const int NumAutotuneTrials = 3;
+
+static const char* getNeighborAlgorithmName(AtomSubsystem::NeighborAlgorithm algorithm) {
+    switch (algorithm) {
+        case AtomSubsystem::N_SQUARED:  return "N_SQUARED";
+        case AtomSubsystem::VOXEL_HASH: return "VOXEL_HASH";
+        case AtomSubsystem::AUTOMATIC:  return "AUTOMATIC";
+        case AtomSubsystem::AUTOTUNE:   return "AUTOTUNE";
+    }
+    return "unknown";
+}
+
+// AUTOTUNE timings for one cutoff, by position in AutotunedAlgorithms.
+// Neighbor list builds done during an algorithm's passes are charged to it
+// too, so their cost is spread over the passes that reuse the list.
+class NeighborAlgorithmTrials {
+public:
+    NeighborAlgorithmTrials() : winner(AtomSubsystem::AUTOTUNE) {
+        for (int i = 0; i < NumAutotunedAlgorithms; ++i) {
+            numTrials[i] = 0;
+            totalTime[i] = 0;
+            numBuilds[i] = 0;
+            buildTime[i] = 0;
+        }
+    }
+
+    double getMeanTime(int i) const 
+    {   return (totalTime[i] + buildTime[i]) / numTrials[i]; }
+
+    int numTrials[NumAutotunedAlgorithms];
+    double totalTime[NumAutotunedAlgorithms]; // seconds finding pairs
+    long long numBuilds[NumAutotunedAlgorithms];
+    double buildTime[NumAutotunedAlgorithms]; // seconds building lists
+    AtomSubsystem::NeighborAlgorithm winner; // AUTOTUNE until decided
+};
+
 class AtomSubsystem::Impl : public Subsystem::Guts 
 {
 protected:
@@ -22,6 +105,14 @@ protected:
     mutable CacheEntryIndex atomPositionCacheIndex;
     mutable CacheEntryIndex atomBodyStationCacheIndex;
     mutable CacheEntryIndex atomVelocityCacheIndex;
+    mutable CacheEntryIndex neighborListCacheIndex;
+
+    length_t neighborListSkin;
+    mutable long long neighborListBuildCount;
+    mutable double neighborListBuildTime; // seconds, over all builds
+
+    // AUTOTUNE measurements, by cutoff
+    mutable std::map<length_t, NeighborAlgorithmTrials> neighborAlgorithmTrials;
 
 public:
     // need to traverse bodies in the order they were inserted
@@ -35,7 +126,10 @@ public:
     // Keep the data in the Impl, the methods in the non-Impl
     
     Impl(MultibodySystem& system) 
-        : system(system)
+        : system(system), 
+          neighborListSkin(0.2 * nanometers),
+          neighborListBuildCount(0),
+          neighborListBuildTime(0)
     {}
 
     Subsystem::Guts* cloneImpl() const {
@@ -62,6 +156,15 @@ public:
                 new Value< Vector_<Vec3> >()
         );
 
+        neighborListCacheIndex = state.allocateCacheEntry(
+                getMySubsystemIndex(), 
+                Stage::Topology, 
+                new Value< AtomNeighborLists >()
+        );
+
+        // Timings for the old topology don't apply
+        neighborAlgorithmTrials.clear();
+
         return 0;
     }
 
@@ -135,6 +238,131 @@ public:
         return 0;
     }
 
+    // Return the neighbor list pairs for this cutoff, first rebuilding the
+    // list if it was built for a different skin, or if some atom has moved
+    // more than half the skin since it was built. Until then two atoms can 
+    // have closed their separation by at most the skin thickness, so the 
+    // list still contains every pair now within the cutoff. Lists for other
+    // cutoffs are left alone. Must be realized to position stage.
+    const std::vector<AtomSubsystem::PairIterator::Pair>& 
+    getNeighborPairs(const State& state, length_t cutoff) const
+    {
+        AtomNeighborList& list = Value<AtomNeighborLists>::downcast(state.updCacheEntry(
+            getMySubsystemIndex(), 
+            neighborListCacheIndex
+            )).upd().byCutoff[cutoff];
+
+        const Vector_<Vec3>& atomPositionCache = Value< Vector_<Vec3> >::downcast(state.getCacheEntry(
+            getMySubsystemIndex(), 
+            atomPositionCacheIndex
+            )).get();
+
+        bool rebuild = list.builtPositions.size() != atoms.size()
+                    || list.listRadius != cutoff + neighborListSkin;
+
+        const area_t maxMoveSquared = 0.25 * neighborListSkin * neighborListSkin;
+        for (size_t a(0); !rebuild && a < atoms.size(); ++a)
+            if ( (atomPositionCache[a] - list.builtPositions[a]).normSqr() > maxMoveSquared )
+                rebuild = true;
+
+        if (rebuild) 
+            buildNeighborList(atomPositionCache, cutoff, list);
+
+        return list.pairs;
+    }
+
+    // Pick the algorithm for an AUTOTUNE PairIterator: the winner if there
+    // is one, otherwise the candidate with the fewest timed passes, in which
+    // case this pass is a timing trial. Without a cutoff only the n-squared
+    // method works, and with fewer than two bodies there is nothing to time.
+    AtomSubsystem::NeighborAlgorithm 
+    chooseAutotunedAlgorithm(length_t cutoff, bool& isTimingTrial) const
+    {
+        isTimingTrial = false;
+        if (cutoff <= 0.0 || atomsByBody.size() < 2) return AtomSubsystem::N_SQUARED;
+
+        const NeighborAlgorithmTrials& trials = neighborAlgorithmTrials[cutoff];
+        if (trials.winner != AtomSubsystem::AUTOTUNE) return trials.winner;
+
+        int next = 0;
+        for (int i = 1; i < NumAutotunedAlgorithms; ++i)
+            if (trials.numTrials[i] < trials.numTrials[next]) next = i;
+
+        isTimingTrial = true;
+        return AutotunedAlgorithms[next];
+    }
+
+    // Record one complete pass, with any neighbor list builds it needed;
+    // once every candidate has had its passes, the one with the lowest mean
+    // time, builds included, wins.
+    void recordAutotuneTrial(length_t cutoff, AtomSubsystem::NeighborAlgorithm algorithm, 
+                             double seconds, long long numBuilds, double buildSeconds) const
+    {
+        NeighborAlgorithmTrials& trials = neighborAlgorithmTrials[cutoff];
+        if (trials.winner != AtomSubsystem::AUTOTUNE) return;
+
+        for (int i = 0; i < NumAutotunedAlgorithms; ++i)
+            if (AutotunedAlgorithms[i] == algorithm) {
+                ++trials.numTrials[i];
+                trials.totalTime[i] += seconds;
+                trials.numBuilds[i] += numBuilds;
+                trials.buildTime[i] += buildSeconds;
+            }
+
+        int best = 0;
+        for (int i = 0; i < NumAutotunedAlgorithms; ++i) {
+            if (trials.numTrials[i] < NumAutotuneTrials) return; // still measuring
+            if (trials.getMeanTime(i) < trials.getMeanTime(best)) best = i;
+        }
+        trials.winner = AutotunedAlgorithms[best];
+    }
+
+    // Put all the atoms in a voxel hash, find every pair within cutoff+skin 
+    // in one sweep over its grid, and keep those between different bodies 
+    // that are not excluded from one another.
+    void buildNeighborList(const Vector_<Vec3>& atomPositions, length_t cutoff, AtomNeighborList& list) const
+    {
+        const length_t listRadius = cutoff + neighborListSkin;
+        const double startTime = realTime();
+        ++neighborListBuildCount;
+
+        VoxelHash<AtomSubsystem::AtomIndex> voxelHash(listRadius, atoms.size());
+        std::vector<int> atomBody(atoms.size(), -1); // position in atomsByBody
+
+        for (size_t b(0); b < atomsByBody.size(); ++b) {
+            const std::vector<AtomSubsystem::AtomIndex>& bodyAtoms = atomsByBody[b].atoms;
+            for (size_t a(0); a < bodyAtoms.size(); ++a) {
+                atomBody[bodyAtoms[a]] = int(b);
+                voxelHash.insert(bodyAtoms[a], atomPositions[bodyAtoms[a]]);
+            }
+        }
+
+        std::vector<AtomSubsystem::PairIterator::Pair> closePairs;
+        voxelHash.findAllPairs(closePairs, listRadius);
+
+        list.pairs.clear();
+        list.pairs.reserve(closePairs.size());
+        for (size_t p(0); p < closePairs.size(); ++p) {
+            AtomSubsystem::PairIterator::Pair pair = closePairs[p];
+            if (atomBody[pair.first] == atomBody[pair.second]) continue; // same body
+            if (atomBody[pair.first] > atomBody[pair.second]) 
+                std::swap(pair.first, pair.second);
+
+            const AtomSubsystem::AtomsByBody& firstBody = atomsByBody[atomBody[pair.first]];
+            const MobilizedBodyIndex secondBodyIx = atomsByBody[atomBody[pair.second]].bodyIx;
+            if (firstBody.bodyExclusions.find(secondBodyIx) != firstBody.bodyExclusions.end()) 
+                continue; // These two bodies are excluded from interacting
+
+            list.pairs.push_back(pair);
+        }
+
+        list.builtPositions.resize(atoms.size());
+        for (size_t a(0); a < atoms.size(); ++a)
+            list.builtPositions[a] = atomPositions[a];
+        list.listRadius = listRadius;
+        neighborListBuildTime += realTime() - startTime;
+    }
+
 };
 
 // Subystem for managing atom locations.
@@ -233,6 +461,72 @@ AtomSubsystem::updBond(AtomSubsystem::BondIndex ix)
 
 size_t AtomSubsystem::getNumBodies() const {return getRep().atomsByBody.size();}
 
+AtomSubsystem& AtomSubsystem::setNeighborListSkin(length_t skin) {
+    assert( skin >= 0.0 * nanometers );
+    updRep().neighborListSkin = skin;
+    return *this;
+}
+
+AtomSubsystem::length_t AtomSubsystem::getNeighborListSkin() const {
+    return getRep().neighborListSkin;
+}
+
+long long AtomSubsystem::getNeighborListBuildCount() const {
+    return getRep().neighborListBuildCount;
+}
+
+const std::vector<AtomSubsystem::PairIterator::Pair>& 
+AtomSubsystem::getNeighborPairs(const State& state, length_t cutoff) const {
+    assert( cutoff > 0.0 * nanometers );
+    return getRep().getNeighborPairs(state, cutoff);
+}
+
+const AtomSubsystem::AtomicBodies& AtomSubsystem::getAtomicBodies() const {
+    return getRep().atomsByBody;
+}
+
+AtomSubsystem::NeighborAlgorithm 
+AtomSubsystem::getAutotunedNeighborAlgorithm(length_t cutoff) const {
+    if (cutoff <= 0.0) return N_SQUARED;
+    std::map<length_t, NeighborAlgorithmTrials>::const_iterator trials =
+        getRep().neighborAlgorithmTrials.find(cutoff);
+    if (trials == getRep().neighborAlgorithmTrials.end()) return AUTOTUNE;
+    return trials->second.winner;
+}
+
+void AtomSubsystem::dumpNeighborAlgorithmTimings(std::ostream& o) const {
+    const std::map<length_t, NeighborAlgorithmTrials>& allTrials = 
+        getRep().neighborAlgorithmTrials;
+
+    o << "AtomSubsystem neighbor algorithm timings:\n";
+    o << "  neighbor list built " << getRep().neighborListBuildCount << " times";
+    if (getRep().neighborListBuildCount)
+        o << ", mean " << std::fixed << std::setprecision(3) 
+          << 1000 * getRep().neighborListBuildTime / getRep().neighborListBuildCount << " ms"
+          << std::resetiosflags(std::ios::floatfield);
+    o << "\n";
+    if (allTrials.empty())
+        o << "  (no AUTOTUNE pair iterations yet)\n";
+
+    std::map<length_t, NeighborAlgorithmTrials>::const_iterator t;
+    for (t = allTrials.begin(); t != allTrials.end(); ++t) {
+        const NeighborAlgorithmTrials& trials = t->second;
+        o << "  cutoff " << t->first << " nm:";
+        for (int i = 0; i < NumAutotunedAlgorithms; ++i) {
+            o << " " << getNeighborAlgorithmName(AutotunedAlgorithms[i])
+              << " " << trials.numTrials[i] << " passes";
+            if (trials.numTrials[i])
+                o << " mean " << std::fixed << std::setprecision(3) 
+                  << 1000 * trials.getMeanTime(i) << " ms, of which list builds "
+                  << 1000 * trials.buildTime[i] / trials.numTrials[i] << " ms"
+                  << std::resetiosflags(std::ios::floatfield)
+                  << " (" << trials.numBuilds[i] << " builds)";
+            o << ";";
+        }
+        o << " using " << getNeighborAlgorithmName(trials.winner) << "\n";
+    }
+}
+
 const Vec3& AtomSubsystem::getAtomLocationInGround(const SimTK::State& state, AtomSubsystem::AtomIndex atomIx) const 
 {
     // Must be realized to position stage
@@ -332,11 +626,20 @@ AtomSubsystem::PairIterator::PairIterator(
     cutoffSquared(cutoff * cutoff),
     cutoff(cutoff),
     atomsByBody( &(a.getRep().atomsByBody) ), 
-    voxelHash( cutoff, a.getNumAtoms() ),
     algorithm(algorithm)
 {
     // Decide which algorithm to use; populate bUseVoxelHash
-    if (algorithm == N_SQUARED) bUseVoxelHash = false;
+    bTimingTrial = false;
+    trialTime = 0;
+    trialBuildTime = 0;
+    trialNumBuilds = 0;
+    const double startTime = realTime();
+    const double buildTimeBefore = a.getRep().neighborListBuildTime;
+    const long long buildCountBefore = a.getRep().neighborListBuildCount;
+    if (algorithm == AUTOTUNE) 
+        bUseVoxelHash = 
+            a.getRep().chooseAutotunedAlgorithm(cutoff, bTimingTrial) == VOXEL_HASH;
+    else if (algorithm == N_SQUARED) bUseVoxelHash = false;
     else if (algorithm == VOXEL_HASH) bUseVoxelHash = true;
     else if (algorithm == AUTOMATIC) {
         // Automatically choose algorithm based on number of atoms and cutoff
@@ -361,16 +664,22 @@ AtomSubsystem::PairIterator::PairIterator(
     else throw std::string("Error parsing neighbor list algorithm");
 
     if (bUseVoxelHash) { // O(n) method
-        // pairs are disallowed within the first body, so
-        // set state to just before second body, then increment
+        // Stream the pairs of the neighbor list; body1 stays at the 
+        // beginning until they are used up.
         body1 = atomsByBody->begin();
         if (atEnd()) return; // there are no bodies
 
-        pendingBodies.insert(body1);
-        atom1 = body1->atoms.end();
-        currentNeighborAtoms.clear();
+        neighborPairs = &a.getRep().getNeighborPairs(state, cutoff);
         atom2Index = 0;
-        ++(*this);
+        if (neighborPairs->empty())
+            body1 = atomsByBody->end(); // there are no pairs
+        else {
+            currentPair = (*neighborPairs)[atom2Index];
+            const Vec3& pos1 = a.getAtomLocationInGround(state, currentPair.first);
+            const Vec3& pos2 = a.getAtomLocationInGround(state, currentPair.second);
+            if ( area_t((pos1 - pos2).normSqr() * square_nanometers) >= cutoffSquared )
+                incrementPair(); // first pair is in the skin; step to one within cutoff
+        }
     } 
     else { // O(n^2) method
         // Initialize to begin state
@@ -392,11 +701,37 @@ AtomSubsystem::PairIterator::PairIterator(
         atom2Index = 0;
         assert( atom2Index < body2->atoms.size() ); // all bodies must have atoms
         currentPair.second = body2->atoms[atom2Index];
+
+        // The first two bodies might be excluded from interacting, or the
+        // first pair of atoms might be beyond the cutoff. If so, step to the
+        // first pair that qualifies; from the last pair of atoms of these
+        // bodies in the excluded case.
+        if (body1->bodyExclusions.find(body2->bodyIx) != body1->bodyExclusions.end()) {
+            atom1 = body1->atoms.end(); --atom1;
+            atom2Index = body2->atoms.size() - 1;
+            incrementPair();
+        }
+        else if (cutoffSquared > area_t(0.0 * square_nanometers)) {
+            const Vec3& pos1 = a.getAtomLocationInGround(state, currentPair.first);
+            const Vec3& pos2 = a.getAtomLocationInGround(state, currentPair.second);
+            if ( area_t((pos1 - pos2).normSqr() * square_nanometers) >= cutoffSquared )
+                incrementPair();
+        }
+    }
+
+    // Any neighbor list rebuild is kept apart from the time spent finding
+    // pairs, but is charged to this pass. There might be no pairs at all.
+    if (bTimingTrial) {
+        trialBuildTime = a.getRep().neighborListBuildTime - buildTimeBefore;
+        trialNumBuilds = a.getRep().neighborListBuildCount - buildCountBefore;
+        trialTime = realTime() - startTime - trialBuildTime;
+        if (atEnd()) finishTimingTrial();
     }
 }
 
 AtomSubsystem::PairIterator::PairIterator() 
-: atomsByBody(NULL), voxelHash(1.0 * nanometers, 0)
+: atomsByBody(NULL), bUseVoxelHash(false), bTimingTrial(false), trialTime(0), 
+  trialBuildTime(0), trialNumBuilds(0), neighborPairs(NULL)
 {}
 
 bool AtomSubsystem::PairIterator::operator!=(const PairIterator& rhs) const 
@@ -405,6 +740,9 @@ bool AtomSubsystem::PairIterator::operator!=(const PairIterator& rhs) const
     else if (rhs.atEnd()) return true;
     else if (atEnd()) return true;
 
+    else if (bUseVoxelHash != rhs.bUseVoxelHash) return true;
+    else if (bUseVoxelHash) return atom2Index != rhs.atom2Index;
+
     else if (body1 != rhs.body1) return true;
     else if (body2 != rhs.body2) return true;
     else if (atom1 != rhs.atom1) return true;
@@ -433,23 +771,57 @@ AtomSubsystem::PairIterator AtomSubsystem::PairIterator::operator++(int) {
 
 
 // prefix increment
+AtomSubsystem::PairIterator& AtomSubsystem::PairIterator::operator++() 
+{
+    if (!bTimingTrial) {
+        incrementPair();
+        return *this;
+    }
+
+    // Time only the search for the next pair, not what the caller does
+    // with each pair in between.
+    const double startTime = realTime();
+    incrementPair();
+    trialTime += realTime() - startTime;
+    if (atEnd()) finishTimingTrial();
+    return *this;
+}
+
+// Report how long this AUTOTUNE pass spent finding pairs and building the
+// neighbor list, once it reaches the end of the series. Passes abandoned 
+// part way are not counted.
+void AtomSubsystem::PairIterator::finishTimingTrial()
+{
+    bTimingTrial = false;
+    atomSubsystem->getRep().recordAutotuneTrial(
+        cutoff, bUseVoxelHash ? VOXEL_HASH : N_SQUARED, 
+        trialTime, trialNumBuilds, trialBuildTime);
+}
+
 // Step to the next pair of atoms in the series.
 // The meat of the neighbor list algorithm goes in here
-AtomSubsystem::PairIterator& AtomSubsystem::PairIterator::operator++() 
+void AtomSubsystem::PairIterator::incrementPair() 
 {
     area_t zeroArea(0.0 * square_nanometers);
 
-    if ( atEnd() ) return *this; // no more pairs
+    if ( atEnd() ) return; // no more pairs
 
     // O(n) voxel hash method...
     if (bUseVoxelHash) 
     {
+        // The neighbor list also holds pairs that are only within the
+        // skin; skip those.
+        area_t dSquared;
         do {
             trialIncrementAtoms();
 
-            if ( atEnd() ) return *this;
+            if ( atEnd() ) return;
 
-        } while ( !atEnd() && (atom2Index >= currentNeighborAtoms.size()) );
+            const Pair& pair = (*neighborPairs)[atom2Index];
+            const Vec3& pos1 = atomSubsystem->getAtomLocationInGround(*state, pair.first);
+            const Vec3& pos2 = atomSubsystem->getAtomLocationInGround(*state, pair.second);
+            dSquared = area_t( (pos1 - pos2).normSqr() * square_nanometers );
+        } while ( (!atEnd()) && (dSquared >= cutoffSquared) );
     }
     else 
     {
@@ -462,7 +834,7 @@ AtomSubsystem::PairIterator& AtomSubsystem::PairIterator::operator++()
             do {
                 trialIncrementAtoms();
 
-                if ( atEnd() ) return *this;
+                if ( atEnd() ) return;
 
                 const Vec3& pos1 = atomSubsystem->getAtomLocationInGround(*state, *atom1);
                 const Vec3& pos2 = atomSubsystem->getAtomLocationInGround(*state, body2->atoms[atom2Index]);
@@ -474,47 +846,26 @@ AtomSubsystem::PairIterator& AtomSubsystem::PairIterator::operator++()
         }
     }
         
-    if ( atEnd() ) return *this; // no more pairs    
+    if ( atEnd() ) return; // no more pairs    
 
-    currentPair.first = *atom1;
     if (bUseVoxelHash)
-        currentPair.second = currentNeighborAtoms[atom2Index];
-    else
+        currentPair = (*neighborPairs)[atom2Index];
+    else {
+        currentPair.first = *atom1;
         currentPair.second = body2->atoms[atom2Index];
-
-    return *this;
+    }
 }
 
 void AtomSubsystem::PairIterator::trialIncrementAtoms()
 {
     if (bUseVoxelHash) // O(n) algorithm
     {
-        // consult local list of neighbor atoms
-        if ( atom2Index < currentNeighborAtoms.size() ) 
+        // consult the neighbor list
+        if ( atom2Index < neighborPairs->size() ) 
             ++atom2Index;
 
-        if ( atom2Index >= currentNeighborAtoms.size() ) // at end
-        {
-            if ( atom1 != body1->atoms.end() )
-                ++atom1;
-
-            if ( atom1 == body1->atoms.end() ) {
-                trialIncrementBodies();
-
-                if (atEnd()) 
-                    return;
-                else 
-                    atom1 = body1->atoms.begin();
-            }
-
-            currentNeighborAtoms.clear();
-            voxelHash.findNeighbors(
-                currentNeighborAtoms, 
-                atomSubsystem->getAtomLocationInGround(*state, *atom1),
-                cutoff);
-
-            atom2Index = 0;
-        }
+        if ( atom2Index >= neighborPairs->size() ) // end of series of pairs
+            body1 = atomsByBody->end();
     }
     else // O(n^2) algorithm
     {
@@ -554,66 +905,30 @@ void AtomSubsystem::PairIterator::trialIncrementAtoms()
 // whether they are excluded from comparison.
 void AtomSubsystem::PairIterator::trialIncrementBodies()
 {
-    if (bUseVoxelHash) // O(n) method
-    {
-        if (body1 == atomsByBody->end()) return;
-        ++body1;
-        if (body1 == atomsByBody->end()) return;
-
-        // Insert previous bodies into voxel hash, unless they are in exclusion list
-        std::set<AtomicBodies::const_iterator>::const_iterator b2;
-        // Remember which bodies get inserted into voxel hash, 
-        // and remove them from the pending list, 
-        // but only AFTER the pending list iterator has gone through its motions.
-        std::vector<AtomicBodies::const_iterator> unPendingBodies;
-        for (b2 = pendingBodies.begin(); b2 != pendingBodies.end(); ++b2) 
-        {
-            MobilizedBodyIndex body2Ix = (*b2)->bodyIx;
-            // If old body is NOT excluded, put it in the voxelHash
-            if (body1->bodyExclusions.find(body2Ix) == body1->bodyExclusions.end()) {
-                populateVoxelHash(*b2);
-                unPendingBodies.push_back(*b2);
-                // pendingBodies.erase(b2); // oops! I erased from container while using an iterator
-            }
-        }
-        // Now that b2 iterator is done, remove elements from pending
-        std::vector<AtomicBodies::const_iterator>::const_iterator b3;
-        for (b3 = unPendingBodies.begin(); b3 != unPendingBodies.end(); ++b3)
-            pendingBodies.erase(*b3);
+    assert(!bUseVoxelHash); // voxel hash pairs don't step through bodies
 
-        pendingBodies.insert(body1);
-    }
-    else { // O(n^2) method
-        if (body2 != atomsByBody->end())
-            ++body2;
+    if (body2 != atomsByBody->end())
+        ++body2;
 
-        if (body2 == atomsByBody->end())
-        {
-            if ( body1 != atomsByBody->end() )
-                ++body1;
+    if (body2 == atomsByBody->end())
+    {
+        if ( body1 != atomsByBody->end() )
+            ++body1;
 
-            if ( body1 == atomsByBody->end() ) 
-                return; // end of pairs
+        if ( body1 == atomsByBody->end() ) 
+            return; // end of pairs
 
-            body2 = body1;
-            ++body2;
+        body2 = body1;
+        ++body2;
 
-            if (body2 == atomsByBody->end()) {
-                // what if body2 is at end?
-                body1 = atomsByBody->end();
-                return; // end of pairs
-            }
+        if (body2 == atomsByBody->end()) {
+            // what if body2 is at end?
+            body1 = atomsByBody->end();
+            return; // end of pairs
         }
     }
 }
 
-void AtomSubsystem::PairIterator::populateVoxelHash(AtomicBodies::const_iterator bodyIter) {
-    AtomIndexList::const_iterator a;
-    for (a = bodyIter->atoms.begin(); a != bodyIter->atoms.end(); ++a) {
-        voxelHash.insert(*a, atomSubsystem->getAtomLocationInGround(*state, *a) );
-    }
-}
-
 const AtomSubsystem::PairIterator::Pair& AtomSubsystem::PairIterator::operator*() const {
     assert(!atEnd());
     return currentPair;
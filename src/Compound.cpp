@@ -1925,6 +1925,10 @@ Vec3 Compound::calcAtomLocationInGroundFrame(const State& state, Compound::AtomI
     return getImpl().calcAtomLocationInGroundFrame(state, atomId);
 }
 
+void Compound::getAtomIndicesInPdbOrder(Array_<Compound::AtomIndex>& atomIndices) const {
+    getImpl().getAtomIndicesInPdbOrder(atomIndices);
+}
+
 Vec3 Compound::calcAtomVelocityInGroundFrame(const State& state, Compound::AtomIndex atomId) const {
     return getImpl().calcAtomVelocityInGroundFrame(state, atomId);
 }
@@ -2078,6 +2082,13 @@ DuMM::AtomIndex Compound::getDuMMAtomIndex(Compound::AtomIndex aid) const {
     return getImpl().getDuMMAtomIndex(aid);
 }
 
+Real Compound::sumDuMMAtomValues(const Vector& dummAtomValues) const {
+    Real sum = 0;
+    for (Compound::AtomIndex aid(0); aid < getNumAtoms(); ++aid)
+        sum += dummAtomValues[getDuMMAtomIndex(aid)];
+    return sum;
+}
+
 Compound& Compound::setBondMobility(BondMobility::Mobility mobility, const AtomName& atom1, const AtomName& atom2) 
 {
     updImpl().setBondMobility(mobility, atom1, atom2);
@@ -2456,6 +2467,16 @@ ResidueInfo& Biopolymer::updResidue(ResidueInfo::Index residueIndex) {
     return updImpl().updResidue(residueIndex);
 }
 
+Vector Biopolymer::sumDuMMAtomValuesByResidue(const Vector& dummAtomValues) const {
+    Vector sums(getNumResidues(), Real(0));
+    for (ResidueInfo::Index r(0); r < getNumResidues(); ++r) {
+        const ResidueInfo& residue = getResidue(r);
+        for (ResidueInfo::AtomIndex a(0); a < (int)residue.getNumAtoms(); ++a)
+            sums[r] += dummAtomValues[getDuMMAtomIndex(residue.getAtomIndex(a))];
+    }
+    return sums;
+}
+
 const ResidueInfo& Biopolymer::getResidue(Compound::Name residueName) const {
     return getImpl().getResidue(residueName);
 }
@@ -1686,6 +1686,14 @@ public:
         return *this;
     }
 
+    /// Append atom indices in the order populatePdbChain() adds the atoms
+    virtual void getAtomIndicesInPdbOrder(Array_<Compound::AtomIndex>& atomIndices) const
+    {
+        atomIndices.reserve(atomIndices.size() + getNumAtoms());
+        for (Compound::AtomIndex aIx(0); aIx < getNumAtoms(); ++aIx)
+            atomIndices.push_back(aIx);
+    }
+
     /// New way to do PDB writing: create intermediate PdbChain object
     /// Write current default(initial) Compound configuration into a PdbChain object
     virtual const CompoundRep& populatePdbChain(
@@ -2647,6 +2655,17 @@ public:
         return *this;
     }
 
+    /// Biopolymer atoms are written residue by residue
+    virtual void getAtomIndicesInPdbOrder(Array_<Compound::AtomIndex>& atomIndices) const
+    {
+        atomIndices.reserve(atomIndices.size() + getNumAtoms());
+        for (ResidueInfo::Index r(0); r < getNumResidues(); ++r) {
+            const ResidueInfo& residue = getResidue(r);
+            for (ResidueInfo::AtomIndex a(0); a < residue.getNumAtoms(); ++a)
+                atomIndices.push_back(residue.getAtomIndex(a));
+        }
+    }
+
     /// Write current default(initial) Compound configuration into a PdbChain object
     virtual const CompoundRep& populatePdbChain(
         const State& state, 
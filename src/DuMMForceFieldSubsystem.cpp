@@ -927,6 +927,149 @@ void DuMMForceFieldSubsystem::setCoulomb15ScaleFactor(Real fac) {
     mm.coulombScale15=fac;
 }
 
+void DuMMForceFieldSubsystem::setUseNonbondedCutoff(bool use)
+{   invalidateSubsystemTopologyCache();
+    updRep().useNonbondedCutoff = use; }
+
+bool DuMMForceFieldSubsystem::getUseNonbondedCutoff() const
+{   return getRep().useNonbondedCutoff; }
+
+void DuMMForceFieldSubsystem::setNonbondedCutoff(Real cutoff) {
+    static const char* MethodName = "setNonbondedCutoff";
+
+    invalidateSubsystemTopologyCache();
+
+    DuMMForceFieldSubsystemRep& mm = updRep();
+
+    SimTK_APIARGCHECK1_ALWAYS(cutoff > 0, mm.ApiClassName, MethodName,
+        "nonbonded cutoff distance (%g nm) was invalid: must be greater than zero",
+        cutoff);
+
+    mm.nonbondedCutoff = cutoff;
+}
+
+Real DuMMForceFieldSubsystem::getNonbondedCutoff() const
+{   return getRep().nonbondedCutoff; }
+
+void DuMMForceFieldSubsystem::setNeighborListSkin(Real skin) {
+    static const char* MethodName = "setNeighborListSkin";
+
+    invalidateSubsystemTopologyCache();
+
+    DuMMForceFieldSubsystemRep& mm = updRep();
+
+    SimTK_APIARGCHECK1_ALWAYS(skin >= 0, mm.ApiClassName, MethodName,
+        "neighbor list skin thickness (%g nm) was invalid: must be nonnegative",
+        skin);
+
+    mm.neighborListSkin = skin;
+}
+
+Real DuMMForceFieldSubsystem::getNeighborListSkin() const
+{   return getRep().neighborListSkin; }
+
+void DuMMForceFieldSubsystem::setPeriodicBoxDimensions(const Vec3& box) {
+    static const char* MethodName = "setPeriodicBoxDimensions";
+
+    invalidateSubsystemTopologyCache();
+
+    DuMMForceFieldSubsystemRep& mm = updRep();
+
+    SimTK_APIARGCHECK3_ALWAYS(box[0] > 0 && box[1] > 0 && box[2] > 0, 
+        mm.ApiClassName, MethodName,
+        "periodic box dimensions (%g,%g,%g nm) were invalid: all must be greater than zero",
+        box[0], box[1], box[2]);
+
+    mm.usePeriodicBox = true;
+    mm.periodicBox    = box;
+}
+
+void DuMMForceFieldSubsystem::clearPeriodicBox()
+{   invalidateSubsystemTopologyCache();
+    updRep().usePeriodicBox = false; 
+    updRep().periodicBox    = Vec3(0); }
+
+bool DuMMForceFieldSubsystem::hasPeriodicBox() const
+{   return getRep().usePeriodicBox; }
+
+Vec3 DuMMForceFieldSubsystem::getPeriodicBoxDimensions() const
+{   return getRep().periodicBox; }
+
+void DuMMForceFieldSubsystem::setUseEwaldElectrostatics(bool use)
+{   invalidateSubsystemTopologyCache();
+    updRep().useEwaldElectrostatics = use; }
+
+bool DuMMForceFieldSubsystem::getUseEwaldElectrostatics() const
+{   return getRep().useEwaldElectrostatics; }
+
+void DuMMForceFieldSubsystem::setEwaldErrorTolerance(Real tol) {
+    static const char* MethodName = "setEwaldErrorTolerance";
+
+    invalidateSubsystemTopologyCache();
+
+    DuMMForceFieldSubsystemRep& mm = updRep();
+
+    SimTK_APIARGCHECK1_ALWAYS(0 < tol && tol < Real(0.5), 
+        mm.ApiClassName, MethodName,
+        "Ewald error tolerance (%g) was invalid: must be between 0 and 0.5, exclusive",
+        tol);
+
+    mm.ewaldErrorTolerance = tol;
+}
+
+Real DuMMForceFieldSubsystem::getEwaldErrorTolerance() const
+{   return getRep().ewaldErrorTolerance; }
+
+void DuMMForceFieldSubsystem::setMultipleTimeStepSize(Real stepSize) {
+    static const char* MethodName = "setMultipleTimeStepSize";
+
+    invalidateSubsystemTopologyCache();
+
+    DuMMForceFieldSubsystemRep& mm = updRep();
+
+    SimTK_APIARGCHECK1_ALWAYS(stepSize >= 0, mm.ApiClassName, MethodName,
+        "multiple time step size (%g ps) was invalid: must be nonnegative",
+        stepSize);
+
+    mm.multipleTimeStepSize = stepSize;
+}
+
+Real DuMMForceFieldSubsystem::getMultipleTimeStepSize() const {
+    return getRep().multipleTimeStepSize;
+}
+
+void DuMMForceFieldSubsystem::setForceGroupInterval
+   (ForceGroup group, int interval) 
+{
+    static const char* MethodName = "setForceGroupInterval";
+
+    invalidateSubsystemTopologyCache();
+
+    DuMMForceFieldSubsystemRep& mm = updRep();
+
+    SimTK_APIARGCHECK1_ALWAYS(0 <= group && group < NumForceGroups, 
+        mm.ApiClassName, MethodName,
+        "force group %d is not valid", (int)group);
+    SimTK_APIARGCHECK1_ALWAYS(interval >= 1, mm.ApiClassName, MethodName,
+        "force group interval (%d) was invalid: must be at least 1",
+        interval);
+
+    mm.forceGroupInterval[group] = interval;
+}
+
+int DuMMForceFieldSubsystem::getForceGroupInterval(ForceGroup group) const {
+    static const char* MethodName = "getForceGroupInterval";
+    const DuMMForceFieldSubsystemRep& mm = getRep();
+    SimTK_APIARGCHECK1_ALWAYS(0 <= group && group < NumForceGroups, 
+        mm.ApiClassName, MethodName,
+        "force group %d is not valid", (int)group);
+    return mm.forceGroupInterval[group];
+}
+
+bool DuMMForceFieldSubsystem::isUsingMultipleTimeStepping() const {
+    return getRep().isUsingMultipleTimeStepping();
+}
+
 void DuMMForceFieldSubsystem::setVdwGlobalScaleFactor(Real fac) {
     static const char* MethodName = "setVdwScaleFactor";
 
@@ -1080,6 +1223,55 @@ void DuMMForceFieldSubsystem::setGbsaIncludeAceApproximation(bool doInclude)
     mm.gbsaIncludeAceApproximation=doInclude;
 }
 
+void DuMMForceFieldSubsystem::setUseGbsaCutoff(bool use)
+{   invalidateSubsystemTopologyCache();
+    updRep().useGbsaCutoff = use; }
+
+bool DuMMForceFieldSubsystem::getUseGbsaCutoff() const
+{   return getRep().useGbsaCutoff; }
+
+void DuMMForceFieldSubsystem::setGbsaCutoff(Real cutoff) {
+    static const char* MethodName = "setGbsaCutoff";
+
+    invalidateSubsystemTopologyCache();
+
+    DuMMForceFieldSubsystemRep& mm = updRep();
+
+    SimTK_APIARGCHECK1_ALWAYS(cutoff > 0, mm.ApiClassName, MethodName,
+        "GBSA cutoff distance (%g nm) was invalid: must be greater than zero",
+        cutoff);
+
+    mm.gbsaCutoff = cutoff;
+}
+
+Real DuMMForceFieldSubsystem::getGbsaCutoff() const
+{   return getRep().gbsaCutoff; }
+
+void DuMMForceFieldSubsystem::setUseGbsaMixedPrecision(bool use)
+{   invalidateSubsystemTopologyCache();
+    updRep().useGbsaMixedPrecision = use; }
+
+bool DuMMForceFieldSubsystem::getUseGbsaMixedPrecision() const
+{   return getRep().useGbsaMixedPrecision; }
+
+void DuMMForceFieldSubsystem::setUseFusedGbsaNonbonded(bool use)
+{   invalidateSubsystemTopologyCache();
+    updRep().useFusedGbsaNonbonded = use; }
+
+bool DuMMForceFieldSubsystem::getUseFusedGbsaNonbonded() const
+{   return getRep().useFusedGbsaNonbonded; }
+
+void DuMMForceFieldSubsystem::setUseGbsaBornRadiusCache(bool use)
+{   invalidateSubsystemTopologyCache();
+    updRep().useGbsaBornRadiusCache = use; }
+
+bool DuMMForceFieldSubsystem::getUseGbsaBornRadiusCache() const
+{   return getRep().useGbsaBornRadiusCache; }
+
+void DuMMForceFieldSubsystem::calcGbsaAtomEnergies
+   (const State& state, Vector& gbEnergies, Vector& aceEnergies) const
+{   getRep().calcGbsaAtomEnergies(state, gbEnergies, aceEnergies); }
+
 void DuMMForceFieldSubsystem::setGbsaGlobalScaleFactor(Real fac) {
     static const char* MethodName = "setGbsaGlobalScaleFactor";
 
@@ -1292,9 +1484,38 @@ void DuMMForceFieldSubsystem::setNumThreadsRequested(int nThreads)
 {   invalidateSubsystemTopologyCache();
     updRep().numThreadsRequested = nThreads > 0 ? nThreads : 0; }
 
+int DuMMForceFieldSubsystem::getNonbondedTileSize() const
+{   return getRep().nonbondedTileSize; }
+
+void DuMMForceFieldSubsystem::setNumThreadsRequested
+   (int nThreads, int tileSize) {
+    static const char* MethodName = "setNumThreadsRequested";
+
+    invalidateSubsystemTopologyCache();
+
+    DuMMForceFieldSubsystemRep& mm = updRep();
+
+    SimTK_APIARGCHECK1_ALWAYS(tileSize > 0, mm.ApiClassName, MethodName,
+        "nonbonded tile size (%d) was invalid: must be greater than zero",
+        tileSize);
+
+    mm.numThreadsRequested = nThreads > 0 ? nThreads : 0;
+    mm.nonbondedTileSize   = tileSize;
+}
+
 int DuMMForceFieldSubsystem::getNumThreadsInUse() const 
 {   return getRep().numThreadsInUse; }
 
+bool DuMMForceFieldSubsystem::getUseVectorizedNonbondedKernels() const
+{   return getRep().useVectorizedNonbondedKernels; }
+
+void DuMMForceFieldSubsystem::setUseVectorizedNonbondedKernels(bool use)
+{   invalidateSubsystemTopologyCache();
+    updRep().useVectorizedNonbondedKernels = use; }
+
+std::string DuMMForceFieldSubsystem::getNonbondedKernelInUse() const
+{   return DuMMNonbondKernels::getKernelTypeName(getRep().nonbondKernelType); }
+
 
 bool DuMMForceFieldSubsystem::getUseOpenMMAcceleration() const
 {   return getRep().wantOpenMMAcceleration; }
@@ -1774,6 +1995,23 @@ long long DuMMForceFieldSubsystem::getForceEvaluationCount() const
 	return getRep().getForceEvaluationCount();
 }
 
+// How many times has the nonbonded neighbor list been built?
+long long DuMMForceFieldSubsystem::getNeighborListBuildCount() const
+{
+	return getRep().getNeighborListBuildCount();
+}
+
+// How many Born radii did the last GBSA evaluation recompute?
+int DuMMForceFieldSubsystem::getNumGbsaBornRadiiRecomputed() const
+{
+	return getRep().getNumGbsaBornRadiiRecomputed();
+}
+
+void DuMMForceFieldSubsystem::dumpTopologyStatistics(std::ostream& o) const
+{
+    getRep().dumpTopologyStatistics(o);
+}
+
 std::ostream& DuMMForceFieldSubsystemRep::generateBiotypeChargedAtomTypeSelfCode(std::ostream& os) const 
 {
     std::map<BiotypeIndex, DuMM::ChargedAtomTypeIndex>::const_iterator i;
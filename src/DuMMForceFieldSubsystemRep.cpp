@@ -41,6 +41,11 @@
 
 #include "SimbodyVersionCheck.h"
 
+#include <atomic>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+
 using namespace SimTK;
 
 
@@ -48,6 +53,9 @@ using namespace SimTK;
 // e^2/nm to kJ/mol.
 static const Real CoulombFac = (Real)SimTK_COULOMB_CONSTANT_IN_MD;
 
+// Used in Ewald electrostatics.
+static const Real TwoOverSqrtPi = 2/std::sqrt(Pi);
+
     ////////////////////////////////////
     // DUMM FORCE FIELD SUBSYSTEM REP //
     ////////////////////////////////////
@@ -55,9 +63,13 @@ static const Real CoulombFac = (Real)SimTK_COULOMB_CONSTANT_IN_MD;
 /*static*/ const char* DuMMForceFieldSubsystemRep::ApiClassName 
     = "DuMMForceFieldSubsystem";
 
+// These use the hash tables while topology realization is looking up bonded
+// terms, and the maps otherwise; the tables are cleared once those lookups
+// are done so they can't go stale if parameters are defined afterwards.
 const BondStretch* DuMMForceFieldSubsystemRep::getBondStretch
    (DuMM::AtomClassIndex class1, DuMM::AtomClassIndex class2) const 
 {   const AtomClassIndexPair key(class1,class2,true);
+    if (bondStretchTable.isBuilt()) return bondStretchTable.find(key);
     std::map<AtomClassIndexPair,BondStretch>::const_iterator 
         bs = bondStretch.find(key);
     return (bs != bondStretch.end()) ? &bs->second : 0; }
@@ -66,6 +78,7 @@ const BondBend* DuMMForceFieldSubsystemRep::getBondBend
    (DuMM::AtomClassIndex class1, DuMM::AtomClassIndex class2, 
     DuMM::AtomClassIndex class3) const 
 {   const AtomClassIndexTriple key(class1, class2, class3, true);
+    if (bondBendTable.isBuilt()) return bondBendTable.find(key);
     std::map<AtomClassIndexTriple,BondBend>::const_iterator 
         bb = bondBend.find(key);
     return (bb != bondBend.end()) ? &bb->second : 0; }
@@ -74,6 +87,7 @@ const BondTorsion* DuMMForceFieldSubsystemRep::getBondTorsion
    (DuMM::AtomClassIndex class1, DuMM::AtomClassIndex class2, 
     DuMM::AtomClassIndex class3, DuMM::AtomClassIndex class4) const
 {   const AtomClassIndexQuad key(class1, class2, class3, class4, true);
+    if (bondTorsionTable.isBuilt()) return bondTorsionTable.find(key);
     std::map<AtomClassIndexQuad,BondTorsion>::const_iterator 
         bt = bondTorsion.find(key);
     return (bt != bondTorsion.end()) ? &bt->second : 0; }
@@ -101,6 +115,8 @@ DuMMForceFieldSubsystemRep::getAmberImproperTorsion
     }
 
     const AtomClassIndexQuad key(class1, class2, class3, class4, false);
+    if (amberImproperTorsionTable.isBuilt()) 
+        return amberImproperTorsionTable.find(key);
     std::map<AtomClassIndexQuad,BondTorsion>::const_iterator bt = amberImproperTorsion.find(key);
     return (bt != amberImproperTorsion.end()) ? &bt->second : 0;
 }
@@ -112,9 +128,9 @@ DuMMForceFieldSubsystemRep::getAmberImproperTorsion
 //------------------------------------------------------------------------------
 
 // This class is used locally in realizeSubsystemTopologyImpl() below to
-// temporarily accumulate for each atom lists of relevant bonded connections
+// temporarily accumulate for one atom the lists of relevant bonded connections
 // that include atoms from at least two bodies, so that forces applied by
-// bonded force terms can produce motion.
+// bonded force terms can produce motion; see findCrossBodyBonds().
 // Note that all indices here are AtomIndex; we will use these to construct
 // the final lists that will use IncludedAtomIndex and then throw these
 // away.
@@ -135,6 +151,526 @@ struct CrossBodyBondInfo {
     AtomIndexTriple                             xbonds3Atoms;
 };
 
+// This is a group of lists which identify atoms nearby in the molecule's 
+// bond structure, reused from atom to atom by findCrossBodyBonds(). Each 
+// atom's bond12 list already contains the directly bonded (1-2) atoms; the 13
+// list below has the 1-(2)-3 bonded atoms (that is, it includes the path to 
+// the "3" atom), etc. The current Atom is always atom "1" so it isn't stored.
+//
+// Note that the shortPath and xshortPath arrays give the shortest path 
+// between two atoms, while the bond and xbond arrays give *all* 
+// connection paths, with bonds3Atoms giving at most one. Forces must
+// be calculated for all paths between two atoms, but scaling is only
+// done according to the shortest path.
+struct BondPathScratch {
+    Array_<AtomIndexPair,  unsigned short>      bond13;
+    Array_<AtomIndexTriple,unsigned short>      bond14;
+    Array_<AtomIndexQuad,  unsigned short>      bond15;
+    Array_<AtomIndexPair,  unsigned short>      shortPath13;
+    Array_<AtomIndexTriple,unsigned short>      shortPath14;
+    Array_<AtomIndexQuad,  unsigned short>      shortPath15;
+    
+    // This will be invalid unless we find that the current atom is directly
+    // bonded to exactly three other atoms, in which case their atom indices 
+    // will be stored here and isValid() will return true.
+    AtomIndexTriple                             bonds3Atoms;
+        
+    // The atoms reached so far, used to avoid duplicate paths in the 
+    // shortest path calculation. There are rarely more than a few dozen so
+    // a linear search is fine.
+    Array_<DuMM::AtomIndex>                     allBondedSoFar;
+};
+
+// One kind of cross-body connection list for a run of consecutive atoms, 
+// stored in compressed sparse row form: the i'th atom's entries are 
+// entries[start[i]] up to but not including entries[start[i+1]]. This avoids
+// a separate heap allocation for every atom's list.
+template <class T>
+class ConnectionRows {
+public:
+    ConnectionRows() {start.push_back(0);}
+
+    void appendRow(const Array_<T,unsigned short>& row) {
+        for (unsigned short j=0; j < row.size(); ++j)
+            entries.push_back(row[j]);
+        start.push_back(entries.size());
+    }
+
+    void appendRows(const ConnectionRows& rows) {
+        const unsigned offset = entries.size();
+        for (unsigned j=0; j < rows.entries.size(); ++j)
+            entries.push_back(rows.entries[j]);
+        for (unsigned i=1; i < rows.start.size(); ++i)
+            start.push_back(offset + rows.start[i]);
+    }
+
+    ArrayViewConst_<T> getRow(int i) const
+    {   return ArrayViewConst_<T>(entries.cbegin() + start[i],
+                                  entries.cbegin() + start[i+1]); }
+
+    void release() {
+        Array_<T>().swap(entries);
+        Array_<unsigned>().swap(start);
+        start.push_back(0);
+    }
+
+    double getNumBytes() const
+    {   return (double)entries.capacity()*sizeof(T) 
+             + (double)start.capacity()*sizeof(unsigned); }
+
+private:
+    Array_<T>           entries;
+    Array_<unsigned>    start;
+};
+
+// The cross-body connections of a run of consecutive atoms, starting with 
+// atom 0 once the runs found by CrossBodyBondTask have been joined.
+class CrossBodyBondTable {
+public:
+    void appendAtom(const CrossBodyBondInfo& x) {
+        xbond12.appendRow(x.xbond12);           xbond13.appendRow(x.xbond13);
+        xbond14.appendRow(x.xbond14);           xbond15.appendRow(x.xbond15);
+        xshortPath12.appendRow(x.xshortPath12); 
+        xshortPath13.appendRow(x.xshortPath13);
+        xshortPath14.appendRow(x.xshortPath14); 
+        xshortPath15.appendRow(x.xshortPath15);
+        xbonds3Atoms.push_back(x.xbonds3Atoms);
+    }
+
+    void appendAtoms(const CrossBodyBondTable& t) {
+        xbond12.appendRows(t.xbond12);          xbond13.appendRows(t.xbond13);
+        xbond14.appendRows(t.xbond14);          xbond15.appendRows(t.xbond15);
+        xshortPath12.appendRows(t.xshortPath12); 
+        xshortPath13.appendRows(t.xshortPath13);
+        xshortPath14.appendRows(t.xshortPath14); 
+        xshortPath15.appendRows(t.xshortPath15);
+        for (unsigned i=0; i < t.xbonds3Atoms.size(); ++i)
+            xbonds3Atoms.push_back(t.xbonds3Atoms[i]);
+    }
+
+    // Free the heap space.
+    void release() {
+        xbond12.release(); xbond13.release(); 
+        xbond14.release(); xbond15.release();
+        xshortPath12.release(); xshortPath13.release();
+        xshortPath14.release(); xshortPath15.release();
+        Array_<AtomIndexTriple>().swap(xbonds3Atoms);
+    }
+
+    double getNumBytes() const {
+        return xbond12.getNumBytes() + xbond13.getNumBytes() 
+             + xbond14.getNumBytes() + xbond15.getNumBytes()
+             + xshortPath12.getNumBytes() + xshortPath13.getNumBytes()
+             + xshortPath14.getNumBytes() + xshortPath15.getNumBytes()
+             + (double)xbonds3Atoms.capacity()*sizeof(AtomIndexTriple);
+    }
+
+    ConnectionRows<DuMM::AtomIndex>     xbond12;
+    ConnectionRows<AtomIndexPair>       xbond13;
+    ConnectionRows<AtomIndexTriple>     xbond14;
+    ConnectionRows<AtomIndexQuad>       xbond15;
+    ConnectionRows<DuMM::AtomIndex>     xshortPath12;
+    ConnectionRows<AtomIndexPair>       xshortPath13;
+    ConnectionRows<AtomIndexTriple>     xshortPath14;
+    ConnectionRows<AtomIndexQuad>       xshortPath15;
+    Array_<AtomIndexTriple>             xbonds3Atoms;
+};
+
+// A read-only view of one atom's lists in a CrossBodyBondTable, with the 
+// same member names as CrossBodyBondInfo.
+struct CrossBodyBondView {
+    CrossBodyBondView(const CrossBodyBondTable& t, DuMM::AtomIndex ax)
+    :   xbond12(t.xbond12.getRow(ax)), xbond13(t.xbond13.getRow(ax)),
+        xbond14(t.xbond14.getRow(ax)), xbond15(t.xbond15.getRow(ax)),
+        xshortPath12(t.xshortPath12.getRow(ax)), 
+        xshortPath13(t.xshortPath13.getRow(ax)),
+        xshortPath14(t.xshortPath14.getRow(ax)), 
+        xshortPath15(t.xshortPath15.getRow(ax)),
+        xbonds3Atoms(t.xbonds3Atoms[ax]) {}
+
+    const ArrayViewConst_<DuMM::AtomIndex>  xbond12;
+    const ArrayViewConst_<AtomIndexPair>    xbond13;
+    const ArrayViewConst_<AtomIndexTriple>  xbond14;
+    const ArrayViewConst_<AtomIndexQuad>    xbond15;
+    const ArrayViewConst_<DuMM::AtomIndex>  xshortPath12;
+    const ArrayViewConst_<AtomIndexPair>    xshortPath13;
+    const ArrayViewConst_<AtomIndexTriple>  xshortPath14;
+    const ArrayViewConst_<AtomIndexQuad>    xshortPath15;
+    const AtomIndexTriple                   xbonds3Atoms;
+};
+
+// This runs findCrossBodyBonds() for blocks of consecutive atoms, possibly
+// in multiple threads. Each block's results go into its own table so the
+// threads don't share anything writable.
+class CrossBodyBondTask : public SimTK::ParallelExecutor::Task {
+public:
+    static const int AtomsPerBlock = 512;
+
+    CrossBodyBondTask(const DuMMForceFieldSubsystemRep& dumm,
+                      Array_<CrossBodyBondTable>&       blocks)
+    :   dumm(dumm), blocks(blocks) {}
+
+    static int getNumBlocks(int nAtoms)
+    {   return (nAtoms + AtomsPerBlock - 1) / AtomsPerBlock; }
+
+    void execute(int block) {
+        const int begin = block*AtomsPerBlock;
+        const int end   = std::min(dumm.getNumAtoms(), begin+AtomsPerBlock);
+        BondPathScratch   scratch;
+        CrossBodyBondInfo x;
+        for (DuMM::AtomIndex anum(begin); anum < end; ++anum) {
+            dumm.findCrossBodyBonds(anum, scratch, x);
+            blocks[block].appendAtom(x);
+        }
+    }
+
+private:
+    const DuMMForceFieldSubsystemRep&   dumm;
+    Array_<CrossBodyBondTable>&         blocks;
+};
+
+//------------------------------------------------------------------------------
+//                          FIND CROSS BODY BONDS
+//------------------------------------------------------------------------------
+// Helper for realizeSubsystemTopologyImpl(). Find all interesting bonded 
+// connections for which atom anum serves as atom 1, keeping those that cross
+// bodies in x. This only reads DuMM's data, so may be called for different 
+// atoms in parallel with separate scratch and x objects. The atoms' bond12 
+// lists must already be sorted.
+void DuMMForceFieldSubsystemRep::findCrossBodyBonds
+   (DuMM::AtomIndex anum, BondPathScratch& scratch, CrossBodyBondInfo& x) const
+{
+    const DuMMAtom& a = atoms[anum];
+
+    Array_<AtomIndexPair,  unsigned short>& bond13      = scratch.bond13;
+    Array_<AtomIndexTriple,unsigned short>& bond14      = scratch.bond14;
+    Array_<AtomIndexQuad,  unsigned short>& bond15      = scratch.bond15;
+    Array_<AtomIndexPair,  unsigned short>& shortPath13 = scratch.shortPath13;
+    Array_<AtomIndexTriple,unsigned short>& shortPath14 = scratch.shortPath14;
+    Array_<AtomIndexQuad,  unsigned short>& shortPath15 = scratch.shortPath15;
+    AtomIndexTriple&                        bonds3Atoms = scratch.bonds3Atoms;
+    Array_<DuMM::AtomIndex>&             allBondedSoFar = scratch.allBondedSoFar;
+
+    allBondedSoFar.clear();
+    // Add this atom and its direct (1-2) bonds to the list of all bonded
+    // atoms.
+    allBondedSoFar.push_back(anum);
+    for (int j=0; j < (int)a.bond12.size(); ++j)
+        allBondedSoFar.push_back(a.bond12[j]);
+
+    // Find longer bond paths by building each list in turn from
+    // the direct bonds of the atoms in the previous list.
+
+    // build the bond13 and shortPath13 lists
+    // - bond1x list gives *all* paths between bonded atoms where all the
+    // atoms are distinct (i.e., no fair retracing one of the bonds or
+    // running around a short loop to get back to the first atom again).
+    // - shortPath1x list gives *shortest* path between bonded atoms
+    bond13.clear();
+    shortPath13.clear();
+    for (int j=0; j < (int)a.bond12.size(); ++j) {
+        const DuMMAtom&       a12 = atoms[a.bond12[j]];
+        const ShortAtomArray& a12_12 = a12.bond12;
+        for (int k=0; k < (int)a12_12.size(); ++k) {
+            const DuMM::AtomIndex newAtom = a12_12[k];
+            assert(newAtom != a.bond12[j]);
+            if (newAtom == anum)
+                continue; // no loop backs!
+            bond13.emplace_back(a.bond12[j], newAtom);
+
+            // if no shorter path, note this short route
+            if (std::find(allBondedSoFar.begin(), allBondedSoFar.end(), newAtom)
+                == allBondedSoFar.end()) {
+                allBondedSoFar.push_back(newAtom);
+                shortPath13.emplace_back(a.bond12[j], newAtom);
+            }
+        }
+    }
+    std::sort(bond13.begin(), bond13.end());
+    std::sort(shortPath13.begin(), shortPath13.end());
+
+    // Randy was too big of a sissy to combine the bond14 and shortPath14 
+    // computations! Or, discretion is sometimes the better part of valor.
+
+    // build the bond14 list (all non-overlapping, non-looped paths)
+    bond14.clear();
+    for (int j=0; j < (int)bond13.size(); ++j) {
+        const DuMMAtom&       a13 = atoms[bond13[j][1]];
+        const ShortAtomArray& a13_12 = a13.bond12;
+        for (int k=0; k < (int)a13_12.size(); ++k) {
+            const DuMM::AtomIndex newAtom = a13_12[k];
+            assert(newAtom != bond13[j][1]);
+            // avoid repeated atoms (loop back)
+            if (newAtom!=anum && newAtom!=bond13[j][0]) {
+                bond14.emplace_back(bond13[j][0], bond13[j][1], newAtom);
+            }
+        }
+    }
+    std::sort(bond14.begin(), bond14.end());
+
+    // build the shortPath14 list
+    shortPath14.clear();
+    for (int j=0; j < (int)shortPath13.size(); ++j) {
+        const DuMMAtom&       a13 = atoms[shortPath13[j][1]];
+        const ShortAtomArray& a13_12 = a13.bond12;
+        for (int k=0; k < (int)a13_12.size(); ++k) {
+            const DuMM::AtomIndex newAtom = a13_12[k];
+
+             // check if there was already a shorter path
+            if (std::find(allBondedSoFar.begin(), allBondedSoFar.end(), newAtom)
+                == allBondedSoFar.end()) {
+                allBondedSoFar.push_back(newAtom);
+                shortPath14.emplace_back(shortPath13[j][0], shortPath13[j][1], newAtom);
+            }
+        }
+    }
+    std::sort(shortPath14.begin(), shortPath14.end());
+
+
+    // build the bond15 list
+    bond15.clear();
+    for (int j=0; j < (int)bond14.size(); ++j) {
+        const DuMMAtom&       a14    = atoms[bond14[j][2]];
+        const ShortAtomArray& a14_12 = a14.bond12;
+        for (int k=0; k < (int)a14_12.size(); ++k) {
+            const DuMM::AtomIndex newAtom = a14_12[k];
+            assert(newAtom != bond14[j][2]);
+
+            // avoid repeats and loop back
+            if (newAtom!=anum && newAtom!=bond14[j][0] && newAtom!=bond14[j][1]) {
+                bond15.emplace_back(bond14[j][0], bond14[j][1], bond14[j][2], newAtom);
+            }
+        }
+    }
+    std::sort(bond15.begin(), bond15.end());
+
+    // build the shortPath15 list
+    shortPath15.clear();
+    for (int j=0; j < (int)shortPath14.size(); ++j) {
+        const DuMMAtom&       a14    = atoms[shortPath14[j][2]];
+        const ShortAtomArray& a14_12 = a14.bond12;
+        for (int k=0; k < (int)a14_12.size(); ++k) {
+            const DuMM::AtomIndex newAtom = a14_12[k];
+
+            // check if there was already a shorter path
+            if (std::find(allBondedSoFar.begin(), allBondedSoFar.end(), newAtom)
+                == allBondedSoFar.end()) {
+                allBondedSoFar.push_back(newAtom);
+                shortPath15.emplace_back(shortPath14[j][0], shortPath14[j][1], shortPath14[j][2], newAtom);
+            }
+        }
+    }
+    std::sort(shortPath15.begin(), shortPath15.end());
+
+    // Find all atom that are connected to three (and only three) other 
+    // atoms, then add all orderings of this to the improper torsion list.
+    bonds3Atoms.invalidate();
+    if (a.bond12.size() == 3) {
+        bonds3Atoms = AtomIndexTriple(a.bond12[0], a.bond12[1], a.bond12[2]);
+    }
+
+    // Fill in the cross-body bond lists. We only keep bonds that involve
+    // atoms which are not all attached to the same body. Also, we throw
+    // away any bond sequences for which the atom index of atom 1 is
+    // greater than the atom index of the last atom. That prevents 
+    // double counting since the bond sequence will show up in both orders
+    // eventually. (This doesn't apply to improper torsions.)
+    
+    // TODO: need a way to weed out cross-body bonded terms when the
+    // mobilities available prevent any use of that term. For example, if
+    // there is only a torsion dof between two bodies, and it is aligned
+    // with atoms A and B, then a bond stretch term between A and B 
+    // can't do anything and shouldn't be kept on the list below.
+    x.xbond12.clear();
+    for (int j=0; j < (int)a.bond12.size(); ++j) {
+        if (anum > a.bond12[j]) continue;
+        if (atoms[a.bond12[j]].mobodIx != a.mobodIx)
+            x.xbond12.push_back(a.bond12[j]);
+    }
+
+    x.xbond13.clear(); 
+    for (int j=0; j < (int)bond13.size(); ++j) {
+        if (anum > bond13[j][1]) continue;
+        if (   atoms[bond13[j][0]].mobodIx != a.mobodIx
+            || atoms[bond13[j][1]].mobodIx != a.mobodIx)
+            x.xbond13.push_back(bond13[j]);
+    }
+
+    x.xbond14.clear(); 
+    for (int j=0; j < (int)bond14.size(); ++j) {
+        if (anum > bond14[j][2]) continue;
+        if (   atoms[bond14[j][0]].mobodIx != a.mobodIx
+            || atoms[bond14[j][1]].mobodIx != a.mobodIx
+            || atoms[bond14[j][2]].mobodIx != a.mobodIx)
+            x.xbond14.push_back(bond14[j]);
+    }
+
+    x.xbond15.clear(); 
+    for (int j=0; j < (int)bond15.size(); ++j) {
+        if (anum > bond15[j][3]) continue;
+        if (   atoms[bond15[j][0]].mobodIx != a.mobodIx
+            || atoms[bond15[j][1]].mobodIx != a.mobodIx
+            || atoms[bond15[j][2]].mobodIx != a.mobodIx
+            || atoms[bond15[j][3]].mobodIx != a.mobodIx)
+            x.xbond15.push_back(bond15[j]);
+    }
+
+    x.xbonds3Atoms.invalidate();
+    // If there were exactly 3 bonds, and at least one of them is
+    // on a different body, then we win!
+    if (bonds3Atoms.isValid() && 
+        (   atoms[bonds3Atoms[0]].mobodIx != a.mobodIx
+         || atoms[bonds3Atoms[1]].mobodIx != a.mobodIx
+         || atoms[bonds3Atoms[2]].mobodIx != a.mobodIx))
+        x.xbonds3Atoms = bonds3Atoms;
+
+    // By default, or if this atom or its body are on the "must include" 
+    // list then we have to keep all the cross-body bonds we just 
+    // discovered. Otherwise, we only keep the ones for which some other 
+    // atoms or bodies provides the necessity.
+    if (!(   inclList.useDefaultBondList
+          || inclList.isBondAtom(anum)
+          || inclList.isBondBody(a.mobodIx)))
+    {
+        for (int j=0; j < (int)x.xbond12.size();) {
+            bool keep = false;
+            const DuMM::AtomIndex bnum = x.xbond12[j];
+            const MobodIndex      mbx  = atoms[bnum].mobodIx;
+                 if (inclList.isBondAtom(bnum)) keep=true;
+            else if (inclList.isBondBody(mbx))  keep=true;
+            else if (inclList.isBondAtomPair(anum, bnum))    keep=true;
+            else if (inclList.isBondBodyPair(a.mobodIx, mbx)) keep=true;
+            if (keep) ++j;
+            else x.xbond12.erase(&x.xbond12[j]); // don't increment j
+        }
+
+        for (int j=0; j < (int)x.xbond13.size();) {
+            bool keep = false;
+            for (int k=0; k < 2 && !keep; ++k) {
+                const DuMM::AtomIndex bnum = x.xbond13[j][k];
+                const MobodIndex      mbx  = atoms[bnum].mobodIx;
+                     if (inclList.isBondAtom(bnum)) keep=true;
+                else if (inclList.isBondBody(mbx))  keep=true;
+                else if (inclList.isBondAtomPair(anum, bnum))    keep=true;
+                else if (inclList.isBondBodyPair(a.mobodIx, mbx)) keep=true;
+                for (int c=k+1; c < 2 && !keep; ++c) {
+                    const DuMM::AtomIndex cnum = x.xbond13[j][c];
+                    const MobodIndex      mcx  = atoms[cnum].mobodIx;
+                         if (inclList.isBondAtomPair(bnum, cnum)) keep=true;
+                    else if (inclList.isBondBodyPair(mbx, mcx))   keep=true;
+                }
+            }
+            if (keep) ++j;
+            else x.xbond13.erase(&x.xbond13[j]); // don't increment j
+        }
+
+        for (int j=0; j < (int)x.xbond14.size();) {
+            bool keep = false;
+            for (int k=0; k < 3 && !keep; ++k) {
+                const DuMM::AtomIndex bnum = x.xbond14[j][k];
+                const MobodIndex      mbx  = atoms[bnum].mobodIx;
+                     if (inclList.isBondAtom(bnum)) keep=true;
+                else if (inclList.isBondBody(mbx))  keep=true;
+                else if (inclList.isBondAtomPair(anum, bnum))    keep=true;
+                else if (inclList.isBondBodyPair(a.mobodIx, mbx)) keep=true;
+                for (int c=k+1; c < 3 && !keep; ++c) {
+                    const DuMM::AtomIndex cnum = x.xbond14[j][c];
+                    const MobodIndex      mcx  = atoms[cnum].mobodIx;
+                         if (inclList.isBondAtomPair(bnum, cnum)) keep=true;
+                    else if (inclList.isBondBodyPair(mbx, mcx))   keep=true;
+                }
+            }
+            if (keep) ++j;
+            else x.xbond14.erase(&x.xbond14[j]); // don't increment j
+        }
+
+        for (int j=0; j < (int)x.xbond15.size();) {
+            bool keep = false;
+            for (int k=0; k < 4 && !keep; ++k) {
+                const DuMM::AtomIndex bnum = x.xbond15[j][k];
+                const MobodIndex      mbx  = atoms[bnum].mobodIx;
+                     if (inclList.isBondAtom(bnum)) keep=true;
+                else if (inclList.isBondBody(mbx))  keep=true;
+                else if (inclList.isBondAtomPair(anum, bnum))    keep=true;
+                else if (inclList.isBondBodyPair(a.mobodIx, mbx)) keep=true;
+                for (int c=k+1; c < 4 && !keep; ++c) {
+                    const DuMM::AtomIndex cnum = x.xbond15[j][c];
+                    const MobodIndex      mcx  = atoms[cnum].mobodIx;
+                         if (inclList.isBondAtomPair(bnum, cnum)) keep=true;
+                    else if (inclList.isBondBodyPair(mbx, mcx))   keep=true;
+                }
+            }
+            if (keep) ++j;
+            else x.xbond15.erase(&x.xbond15[j]); // don't increment j
+        }
+
+        if (x.xbonds3Atoms.isValid()) { // there is only one of these
+            bool keep = false;
+            for (int k=0; k < 3 && !keep; ++k) {
+                const DuMM::AtomIndex bnum = x.xbonds3Atoms[k];
+                const MobodIndex      mbx  = atoms[bnum].mobodIx;
+                     if (inclList.isBondAtom(bnum)) keep=true;
+                else if (inclList.isBondBody(mbx))  keep=true;
+                else if (inclList.isBondAtomPair(anum, bnum))    keep=true;
+                else if (inclList.isBondBodyPair(a.mobodIx, mbx)) keep=true;
+                for (int c=k+1; c < 3 && !keep; ++c) {
+                    const DuMM::AtomIndex cnum = x.xbonds3Atoms[c];
+                    const MobodIndex      mcx  = atoms[cnum].mobodIx;
+                         if (inclList.isBondAtomPair(bnum, cnum)) keep=true;
+                    else if (inclList.isBondBodyPair(mbx, mcx))   keep=true;
+                }
+            }
+            if (!keep) x.xbonds3Atoms.invalidate();
+        }
+    }
+
+    // Next we're going to work on the shortest-path interconnections
+    // that will be used for nonbond scaling. We'll include 
+    // any shortest path connections that cross a body, provided that
+    // both the first (i.e. current atom "a") and last atom are nonbond 
+    // atoms. Note that we want these bond paths to show up
+    // in both orders so that we can do nonbond scaling from either end.
+
+    x.xshortPath12.clear(); x.xshortPath13.clear();
+    x.xshortPath14.clear(); x.xshortPath15.clear();
+
+    if (a.isNonbondAtom()) {
+        for (int j=0; j < (int)a.bond12.size(); ++j) {
+            if (!atoms[a.bond12[j]].isNonbondAtom()) continue;
+            if (atoms[a.bond12[j]].mobodIx != a.mobodIx)
+                x.xshortPath12.push_back(a.bond12[j]);
+        }
+
+        for (int j=0; j < (int)shortPath13.size(); ++j) {
+            if (!atoms[shortPath13[j][1]].isNonbondAtom()) continue;
+            if (   atoms[shortPath13[j][0]].mobodIx != a.mobodIx
+                || atoms[shortPath13[j][1]].mobodIx != a.mobodIx)
+                x.xshortPath13.push_back(shortPath13[j]);
+        }
+
+
+        for (int j=0; j < (int)shortPath14.size(); ++j) {
+            if (!atoms[shortPath14[j][2]].isNonbondAtom()) continue;
+            if (   atoms[shortPath14[j][0]].mobodIx != a.mobodIx
+                || atoms[shortPath14[j][1]].mobodIx != a.mobodIx
+                || atoms[shortPath14[j][2]].mobodIx != a.mobodIx)
+                x.xshortPath14.push_back(shortPath14[j]);
+        }
+
+        for (int j=0; j < (int)shortPath15.size(); ++j) {
+            if (!atoms[shortPath15[j][3]].isNonbondAtom()) continue;
+            if (   atoms[shortPath15[j][0]].mobodIx != a.mobodIx
+                || atoms[shortPath15[j][1]].mobodIx != a.mobodIx
+                || atoms[shortPath15[j][2]].mobodIx != a.mobodIx
+                || atoms[shortPath15[j][3]].mobodIx != a.mobodIx)
+                x.xshortPath15.push_back(shortPath15[j]);
+        }
+    }
+}
+//............................FIND CROSS BODY BONDS.............................
+
+
+
 // All the force field and molecule parameters have been set, as well as 
 // instructions regarding which atoms should be allowed to participate in force
 // calculations. Here we precalculate everything we can that derives from these
@@ -155,10 +691,26 @@ int DuMMForceFieldSubsystemRep::realizeSubsystemTopologyImpl(State& s) const
     DuMMForceFieldSubsystemRep* mutableThis = 
         const_cast<DuMMForceFieldSubsystemRep*>(this);
 
+    // Note how long each step takes, for dumpTopologyStatistics().
+    double stepStart = realTime();
+    auto endStep = [&](const char* step) {
+        const double now = realTime();
+        mutableThis->topologyStepTimes.push_back
+           (std::make_pair(std::string(step), now - stepStart));
+        stepStart = now;
+    };
+
     mutableThis->invalidateAllTopologicalCacheEntries();
 
         // force field
 
+    // The bonded parameters can't change now, so index them for the many
+    // lookups made below, at least one per cross-body bonded term.
+    mutableThis->bondStretchTable.build(bondStretch);
+    mutableThis->bondBendTable.build(bondBend);
+    mutableThis->bondTorsionTable.build(bondTorsion);
+    mutableThis->amberImproperTorsionTable.build(amberImproperTorsion);
+
     // Calculate effective van der Waals parameters for all pairs of atom 
     // classes. We only fill in the diagonal and upper triangle; that is, each
     // class contains parameters for like classes and all classes whose
@@ -178,6 +730,7 @@ int DuMMForceFieldSubsystemRep::realizeSubsystemTopologyImpl(State& s) const
                                 iclass.vdwDij[j-i],  iclass.vdwEij[j-i]);
         }
     }
+    endStep("force field tables");
 
         // molecule
 
@@ -253,6 +806,8 @@ int DuMMForceFieldSubsystemRep::realizeSubsystemTopologyImpl(State& s) const
     }
 #endif
 
+    endStep("clusters and bodies");
+
     //------- Process bonds -------
     // Now we're going to look at each atom again and find all interesting
     // bonded connections for which an atom serves as atom 1 in a 1-2, 1-2-3,
@@ -306,322 +861,57 @@ int DuMMForceFieldSubsystemRep::realizeSubsystemTopologyImpl(State& s) const
     // need to do bond processing.
 
     
-    // This is a group of lists which identify atoms nearby in the molecule's 
-    // bond structure. Each atom's bond12 list already contains the directly
-    // bonded (1-2) atoms; the 13 list below has the 1-(2)-3 bonded atoms (that
-    // is, it includes the path to the "3" atom), etc. The current Atom is
-    // always atom "1" so it isn't stored.
-    //
-    // Note that the shortPath and xshortPath arrays give the shortest path 
-    // between two atoms, while the bond and xbond arrays give *all* 
-    // connection paths, with bonds3Atoms giving at most one. Forces must
-    // be calculated for all paths between two atoms, but scaling is only
-    // done according to the shortest path.
-
-    Array_<AtomIndexPair,  unsigned short>      bond13;
-    Array_<AtomIndexTriple,unsigned short>      bond14;
-    Array_<AtomIndexQuad,  unsigned short>      bond15;
-    Array_<AtomIndexPair,  unsigned short>      shortPath13;
-    Array_<AtomIndexTriple,unsigned short>      shortPath14;
-    Array_<AtomIndexQuad,  unsigned short>      shortPath15;
-    
-    // This will be invalid unless we find that the current atom is directly
-    // bonded to exactly three other atoms, in which case their atom indices 
-    // will be stored here and isValid() will return true.
-    AtomIndexTriple                             bonds3Atoms;
-        
-    // This set is used to avoid duplicate paths in the shortestPath 
-    // calculation.
-    std::set<DuMM::AtomIndex>                   allBondedSoFar;
-
-    // We have to save these for each atom during a first pass, then
-    // we'll use them to fill in the per-atom bond force and scaling
-    // arrays in a second pass where the included atom indices are known.
-    Array_<CrossBodyBondInfo, DuMM::AtomIndex>  crossBodyBondInfo(atoms.size());
-
-
-    // need to chase bonds to fill in the bonded data
-    // Be sure to distinguish the *shortest* path between two atoms from 
-    // the set of all paths between atoms.
+    // Only the bond12 lists have been filled in so far. We'll sort them now
+    // for good hygiene, before anyone looks at them.
     for (DuMM::AtomIndex anum(0); anum < atoms.size(); ++anum) {
-        DuMMAtom&          a = mutableThis->atoms[anum];
-        CrossBodyBondInfo& x = crossBodyBondInfo[anum];
-
-        // Make sure all the reusable temporary lists defined above are 
-        // cleared before their first use for the current atom a.
-
-        // Only the bond12 list has been filled in so far. We'll sort
-        // all the lists when they're done for good hygiene.
+        DuMMAtom& a = mutableThis->atoms[anum];
         std::sort(a.bond12.begin(), a.bond12.end());
+    }
 
-        allBondedSoFar.clear();
-        // Add this atom and its direct (1-2) bonds to the list of all bonded
-        // atoms.
-        allBondedSoFar.insert(anum);
-        allBondedSoFar.insert(a.bond12.begin(), a.bond12.end());
-
-        // Find longer bond paths by building each list in turn from
-        // the direct bonds of the atoms in the previous list.
-
-        // build the bond13 and shortPath13 lists
-        // - bond1x list gives *all* paths between bonded atoms where all the
-        // atoms are distinct (i.e., no fair retracing one of the bonds or
-        // running around a short loop to get back to the first atom again).
-        // - shortPath1x list gives *shortest* path between bonded atoms
-        bond13.clear();
-        shortPath13.clear();
-        for (int j=0; j < (int)a.bond12.size(); ++j) {
-            const DuMMAtom&       a12 = atoms[a.bond12[j]];
-            const ShortAtomArray& a12_12 = a12.bond12;
-            for (int k=0; k < (int)a12_12.size(); ++k) {
-                const DuMM::AtomIndex newAtom = a12_12[k];
-                assert(newAtom != a.bond12[j]);
-                if (newAtom == anum)
-                    continue; // no loop backs!
-                bond13.emplace_back(a.bond12[j], newAtom);
-
-                // if no shorter path, note this short route
-                if (allBondedSoFar.find(newAtom) == allBondedSoFar.end()) {
-                    allBondedSoFar.insert(newAtom);
-                    shortPath13.emplace_back(a.bond12[j], newAtom);
-                }
-            }
-        }
-        std::sort(bond13.begin(), bond13.end());
-        std::sort(shortPath13.begin(), shortPath13.end());
-
-        // Randy was too big of a sissy to combine the bond14 and shortPath14 
-        // computations! Or, discretion is sometimes the better part of valor.
-
-        // build the bond14 list (all non-overlapping, non-looped paths)
-        bond14.clear();
-        for (int j=0; j < (int)bond13.size(); ++j) {
-            const DuMMAtom&       a13 = atoms[bond13[j][1]];
-            const ShortAtomArray& a13_12 = a13.bond12;
-            for (int k=0; k < (int)a13_12.size(); ++k) {
-                const DuMM::AtomIndex newAtom = a13_12[k];
-                assert(newAtom != bond13[j][1]);
-                // avoid repeated atoms (loop back)
-                if (newAtom!=anum && newAtom!=bond13[j][0]) {
-                    bond14.emplace_back(bond13[j][0], bond13[j][1], newAtom);
-                }
-            }
-        }
-        std::sort(bond14.begin(), bond14.end());
-
-        // build the shortPath14 list
-        shortPath14.clear();
-        for (int j=0; j < (int)shortPath13.size(); ++j) {
-            const DuMMAtom&       a13 = atoms[shortPath13[j][1]];
-            const ShortAtomArray& a13_12 = a13.bond12;
-            for (int k=0; k < (int)a13_12.size(); ++k) {
-                const DuMM::AtomIndex newAtom = a13_12[k];
-
-                 // check if there was already a shorter path
-                if (allBondedSoFar.find(newAtom) == allBondedSoFar.end()) {
-                    allBondedSoFar.insert(newAtom);
-                    shortPath14.emplace_back(shortPath13[j][0], shortPath13[j][1], newAtom);
-                }
-            }
-        }
-        std::sort(shortPath14.begin(), shortPath14.end());
-
-
-        // build the bond15 list
-        bond15.clear();
-        for (int j=0; j < (int)bond14.size(); ++j) {
-            const DuMMAtom&       a14    = atoms[bond14[j][2]];
-            const ShortAtomArray& a14_12 = a14.bond12;
-            for (int k=0; k < (int)a14_12.size(); ++k) {
-                const DuMM::AtomIndex newAtom = a14_12[k];
-                assert(newAtom != bond14[j][2]);
-
-                // avoid repeats and loop back
-                if (newAtom!=anum && newAtom!=bond14[j][0] && newAtom!=bond14[j][1]) {
-                    bond15.emplace_back(bond14[j][0], bond14[j][1], bond14[j][2], newAtom);
-                }
-            }
-        }
-        std::sort(bond15.begin(), bond15.end());
+    // need to chase bonds to fill in the bonded data
+    // Be sure to distinguish the *shortest* path between two atoms from 
+    // the set of all paths between atoms. See findCrossBodyBonds(); the atoms
+    // are independent there so for large systems we do blocks of them in
+    // parallel. Each block's lists are kept in compressed rows and the blocks
+    // are joined in order, so the result doesn't depend on the threads. We 
+    // have to save these for each atom during this first pass, then we'll 
+    // use them to fill in the per-atom bond force and scaling arrays in a 
+    // second pass where the included atom indices are known.
+    CrossBodyBondTable crossBodyBonds;
+    {
+        const int nBlocks = CrossBodyBondTask::getNumBlocks(getNumAtoms());
+        Array_<CrossBodyBondTable> blocks(nBlocks);
+        CrossBodyBondTask task(*this, blocks);
 
-        // build the shortPath15 list
-        shortPath15.clear();
-        for (int j=0; j < (int)shortPath14.size(); ++j) {
-            const DuMMAtom&       a14    = atoms[shortPath14[j][2]];
-            const ShortAtomArray& a14_12 = a14.bond12;
-            for (int k=0; k < (int)a14_12.size(); ++k) {
-                const DuMM::AtomIndex newAtom = a14_12[k];
-
-                // check if there was already a shorter path
-                if (allBondedSoFar.find(newAtom) == allBondedSoFar.end()) {
-                    allBondedSoFar.insert(newAtom);
-                    shortPath15.emplace_back(shortPath14[j][0], shortPath14[j][1], shortPath14[j][2], newAtom);
-                }
-            }
+        int nThreads = 1;
+#if SIMBODY_CURRENT_VERSION >= SIMBODY_VERSION_CHECK(3, 8, 0)
+        if (useMultithreadedComputation && nBlocks > 1 
+            && !ParallelExecutor::isWorkerThread())
+            nThreads = std::min(nBlocks, numThreadsRequested > 0 
+                                         ? numThreadsRequested
+                                         : ParallelExecutor::getNumProcessors());
+#endif // SIMBODY_VERSION_CHECK
+        if (nThreads > 1) {
+            ParallelExecutor walkExecutor(nThreads);
+            walkExecutor.execute(task, nBlocks);
+        } else {
+            for (int b=0; b < nBlocks; ++b)
+                task.execute(b);
         }
-        std::sort(shortPath15.begin(), shortPath15.end());
 
-        // Find all atom that are connected to three (and only three) other 
-        // atoms, then add all orderings of this to the improper torsion list.
-        bonds3Atoms.invalidate();
-        if (a.bond12.size() == 3) {
-            bonds3Atoms = AtomIndexTriple(a.bond12[0], a.bond12[1], a.bond12[2]);
+        for (int b=0; b < nBlocks; ++b) {
+            crossBodyBonds.appendAtoms(blocks[b]);
+            blocks[b].release();
         }
+        mutableThis->topologyWalkThreads    = nThreads;
+        mutableThis->topologyCrossBodyBytes = crossBodyBonds.getNumBytes();
+    }
 
-        // Fill in the cross-body bond lists. We only keep bonds that involve
-        // atoms which are not all attached to the same body. Also, we throw
-        // away any bond sequences for which the atom index of atom 1 is
-        // greater than the atom index of the last atom. That prevents 
-        // double counting since the bond sequence will show up in both orders
-        // eventually. (This doesn't apply to improper torsions.)
-        
-        // TODO: need a way to weed out cross-body bonded terms when the
-        // mobilities available prevent any use of that term. For example, if
-        // there is only a torsion dof between two bodies, and it is aligned
-        // with atoms A and B, then a bond stretch term between A and B 
-        // can't do anything and shouldn't be kept on the list below.
-        x.xbond12.clear();
-        for (int j=0; j < (int)a.bond12.size(); ++j) {
-            if (anum > a.bond12[j]) continue;
-            if (atoms[a.bond12[j]].mobodIx != a.mobodIx)
-                x.xbond12.push_back(a.bond12[j]);
-        }
-
-        x.xbond13.clear(); 
-        for (int j=0; j < (int)bond13.size(); ++j) {
-            if (anum > bond13[j][1]) continue;
-            if (   atoms[bond13[j][0]].mobodIx != a.mobodIx
-                || atoms[bond13[j][1]].mobodIx != a.mobodIx)
-                x.xbond13.push_back(bond13[j]);
-        }
-
-        x.xbond14.clear(); 
-        for (int j=0; j < (int)bond14.size(); ++j) {
-            if (anum > bond14[j][2]) continue;
-            if (   atoms[bond14[j][0]].mobodIx != a.mobodIx
-                || atoms[bond14[j][1]].mobodIx != a.mobodIx
-                || atoms[bond14[j][2]].mobodIx != a.mobodIx)
-                x.xbond14.push_back(bond14[j]);
-        }
-
-        x.xbond15.clear(); 
-        for (int j=0; j < (int)bond15.size(); ++j) {
-            if (anum > bond15[j][3]) continue;
-            if (   atoms[bond15[j][0]].mobodIx != a.mobodIx
-                || atoms[bond15[j][1]].mobodIx != a.mobodIx
-                || atoms[bond15[j][2]].mobodIx != a.mobodIx
-                || atoms[bond15[j][3]].mobodIx != a.mobodIx)
-                x.xbond15.push_back(bond15[j]);
-        }
-
-        x.xbonds3Atoms.invalidate();
-        // If there were exactly 3 bonds, and at least one of them is
-        // on a different body, then we win!
-        if (bonds3Atoms.isValid() && 
-            (   atoms[bonds3Atoms[0]].mobodIx != a.mobodIx
-             || atoms[bonds3Atoms[1]].mobodIx != a.mobodIx
-             || atoms[bonds3Atoms[2]].mobodIx != a.mobodIx))
-            x.xbonds3Atoms = bonds3Atoms;
-
-        // By default, or if this atom or its body are on the "must include" 
-        // list then we have to keep all the cross-body bonds we just 
-        // discovered. Otherwise, we only keep the ones for which some other 
-        // atoms or bodies provides the necessity.
-        if (!(   inclList.useDefaultBondList
-              || inclList.isBondAtom(anum)
-              || inclList.isBondBody(a.mobodIx)))
-        {
-            for (int j=0; j < (int)x.xbond12.size();) {
-                bool keep = false;
-                const DuMM::AtomIndex bnum = x.xbond12[j];
-                const MobodIndex      mbx  = atoms[bnum].mobodIx;
-                     if (inclList.isBondAtom(bnum)) keep=true;
-                else if (inclList.isBondBody(mbx))  keep=true;
-                else if (inclList.isBondAtomPair(anum, bnum))    keep=true;
-                else if (inclList.isBondBodyPair(a.mobodIx, mbx)) keep=true;
-                if (keep) ++j;
-                else x.xbond12.erase(&x.xbond12[j]); // don't increment j
-            }
-
-            for (int j=0; j < (int)x.xbond13.size();) {
-                bool keep = false;
-                for (int k=0; k < 2 && !keep; ++k) {
-                    const DuMM::AtomIndex bnum = x.xbond13[j][k];
-                    const MobodIndex      mbx  = atoms[bnum].mobodIx;
-                         if (inclList.isBondAtom(bnum)) keep=true;
-                    else if (inclList.isBondBody(mbx))  keep=true;
-                    else if (inclList.isBondAtomPair(anum, bnum))    keep=true;
-                    else if (inclList.isBondBodyPair(a.mobodIx, mbx)) keep=true;
-                    for (int c=k+1; c < 2 && !keep; ++c) {
-                        const DuMM::AtomIndex cnum = x.xbond13[j][c];
-                        const MobodIndex      mcx  = atoms[cnum].mobodIx;
-                             if (inclList.isBondAtomPair(bnum, cnum)) keep=true;
-                        else if (inclList.isBondBodyPair(mbx, mcx))   keep=true;
-                    }
-                }
-                if (keep) ++j;
-                else x.xbond13.erase(&x.xbond13[j]); // don't increment j
-            }
-
-            for (int j=0; j < (int)x.xbond14.size();) {
-                bool keep = false;
-                for (int k=0; k < 3 && !keep; ++k) {
-                    const DuMM::AtomIndex bnum = x.xbond14[j][k];
-                    const MobodIndex      mbx  = atoms[bnum].mobodIx;
-                         if (inclList.isBondAtom(bnum)) keep=true;
-                    else if (inclList.isBondBody(mbx))  keep=true;
-                    else if (inclList.isBondAtomPair(anum, bnum))    keep=true;
-                    else if (inclList.isBondBodyPair(a.mobodIx, mbx)) keep=true;
-                    for (int c=k+1; c < 3 && !keep; ++c) {
-                        const DuMM::AtomIndex cnum = x.xbond14[j][c];
-                        const MobodIndex      mcx  = atoms[cnum].mobodIx;
-                             if (inclList.isBondAtomPair(bnum, cnum)) keep=true;
-                        else if (inclList.isBondBodyPair(mbx, mcx))   keep=true;
-                    }
-                }
-                if (keep) ++j;
-                else x.xbond14.erase(&x.xbond14[j]); // don't increment j
-            }
-
-            for (int j=0; j < (int)x.xbond15.size();) {
-                bool keep = false;
-                for (int k=0; k < 4 && !keep; ++k) {
-                    const DuMM::AtomIndex bnum = x.xbond15[j][k];
-                    const MobodIndex      mbx  = atoms[bnum].mobodIx;
-                         if (inclList.isBondAtom(bnum)) keep=true;
-                    else if (inclList.isBondBody(mbx))  keep=true;
-                    else if (inclList.isBondAtomPair(anum, bnum))    keep=true;
-                    else if (inclList.isBondBodyPair(a.mobodIx, mbx)) keep=true;
-                    for (int c=k+1; c < 4 && !keep; ++c) {
-                        const DuMM::AtomIndex cnum = x.xbond15[j][c];
-                        const MobodIndex      mcx  = atoms[cnum].mobodIx;
-                             if (inclList.isBondAtomPair(bnum, cnum)) keep=true;
-                        else if (inclList.isBondBodyPair(mbx, mcx))   keep=true;
-                    }
-                }
-                if (keep) ++j;
-                else x.xbond15.erase(&x.xbond15[j]); // don't increment j
-            }
-
-            if (x.xbonds3Atoms.isValid()) { // there is only one of these
-                bool keep = false;
-                for (int k=0; k < 3 && !keep; ++k) {
-                    const DuMM::AtomIndex bnum = x.xbonds3Atoms[k];
-                    const MobodIndex      mbx  = atoms[bnum].mobodIx;
-                         if (inclList.isBondAtom(bnum)) keep=true;
-                    else if (inclList.isBondBody(mbx))  keep=true;
-                    else if (inclList.isBondAtomPair(anum, bnum))    keep=true;
-                    else if (inclList.isBondBodyPair(a.mobodIx, mbx)) keep=true;
-                    for (int c=k+1; c < 3 && !keep; ++c) {
-                        const DuMM::AtomIndex cnum = x.xbonds3Atoms[c];
-                        const MobodIndex      mcx  = atoms[cnum].mobodIx;
-                             if (inclList.isBondAtomPair(bnum, cnum)) keep=true;
-                        else if (inclList.isBondBodyPair(mbx, mcx))   keep=true;
-                    }
-                }
-                if (!keep) x.xbonds3Atoms.invalidate();
-            }
-        }
+    // Now mark the atoms and bodies of the bonds we kept. This writes to 
+    // other atoms, so is done serially.
+    for (DuMM::AtomIndex anum(0); anum < atoms.size(); ++anum) {
+        DuMMAtom&               a = mutableThis->atoms[anum];
+        const CrossBodyBondView x(crossBodyBonds, anum);
 
         // At this point the cross-body bond arrays contain only bonds that we
         // are keeping. Every atom mentioned in any of the kept bonds should be
@@ -672,51 +962,10 @@ int DuMMForceFieldSubsystemRep::realizeSubsystemTopologyImpl(State& s) const
                     allIncludedMobods.insert(b.mobodIx);
                 }
         }
-
-        // Next we're going to work on the shortest-path interconnections
-        // that will be used for nonbond scaling. We'll include 
-        // any shortest path connections that cross a body, provided that
-        // both the first (i.e. current atom "a") and last atom are nonbond 
-        // atoms. Note that we want these bond paths to show up
-        // in both orders so that we can do nonbond scaling from either end.
-
-        x.xshortPath12.clear(); x.xshortPath13.clear();
-        x.xshortPath14.clear(); x.xshortPath15.clear();
-
-        if (a.isNonbondAtom()) {
-            for (int j=0; j < (int)a.bond12.size(); ++j) {
-                if (!atoms[a.bond12[j]].isNonbondAtom()) continue;
-                if (atoms[a.bond12[j]].mobodIx != a.mobodIx)
-                    x.xshortPath12.push_back(a.bond12[j]);
-            }
-
-            for (int j=0; j < (int)shortPath13.size(); ++j) {
-                if (!atoms[shortPath13[j][1]].isNonbondAtom()) continue;
-                if (   atoms[shortPath13[j][0]].mobodIx != a.mobodIx
-                    || atoms[shortPath13[j][1]].mobodIx != a.mobodIx)
-                    x.xshortPath13.push_back(shortPath13[j]);
-            }
-
-
-            for (int j=0; j < (int)shortPath14.size(); ++j) {
-                if (!atoms[shortPath14[j][2]].isNonbondAtom()) continue;
-                if (   atoms[shortPath14[j][0]].mobodIx != a.mobodIx
-                    || atoms[shortPath14[j][1]].mobodIx != a.mobodIx
-                    || atoms[shortPath14[j][2]].mobodIx != a.mobodIx)
-                    x.xshortPath14.push_back(shortPath14[j]);
-            }
-
-            for (int j=0; j < (int)shortPath15.size(); ++j) {
-                if (!atoms[shortPath15[j][3]].isNonbondAtom()) continue;
-                if (   atoms[shortPath15[j][0]].mobodIx != a.mobodIx
-                    || atoms[shortPath15[j][1]].mobodIx != a.mobodIx
-                    || atoms[shortPath15[j][2]].mobodIx != a.mobodIx
-                    || atoms[shortPath15[j][3]].mobodIx != a.mobodIx)
-                    x.xshortPath15.push_back(shortPath15[j]);
-            }
-        }
     }
 
+    endStep("bond graph walk");
+
     // We have processed all the atoms and marked them included if they 
     // will appear in any nonbonded or bonded force calculation. The
     // nonbond atoms have been separately marked. We have also created a
@@ -797,7 +1046,7 @@ int DuMMForceFieldSubsystemRep::realizeSubsystemTopologyImpl(State& s) const
     // use nonbond atom indices.
     for (DuMM::IncludedAtomIndex iax(0); iax < includedAtoms.size(); ++iax) {
         const DuMM::AtomIndex ax = getAtomIndexOfIncludedAtom(iax);
-        const CrossBodyBondInfo& x = crossBodyBondInfo[ax]; // computed above
+        const CrossBodyBondView x(crossBodyBonds, ax); // computed above
         IncludedAtom& ia = mutableThis->updIncludedAtom(iax);
 
         ia.scale12.clear(); ia.scale13.clear(); 
@@ -920,6 +1169,168 @@ int DuMMForceFieldSubsystemRep::realizeSubsystemTopologyImpl(State& s) const
         }
     }
 
+    // The cross-body lists and bonded parameter tables aren't needed any more.
+    crossBodyBonds.release();
+    mutableThis->bondStretchTable.clear();
+    mutableThis->bondBendTable.clear();
+    mutableThis->bondTorsionTable.clear();
+    mutableThis->amberImproperTorsionTable.clear();
+    endStep("included atoms and bonded lists");
+
+        //////////////////////////////
+        // Flatten the bonded terms //
+        //////////////////////////////
+
+    // Copy each bond starter atom's bonded terms into the per-type arrays
+    // that are used at run time. We go body by body so that the terms are
+    // evaluated in the same order as they were found.
+    mutableThis->flatBondStretches.clear(); 
+    mutableThis->customBondStretches.clear();
+    mutableThis->flatBondBends.clear();     
+    mutableThis->customBondBends.clear();
+    mutableThis->flatBondTorsions.clear();  
+    mutableThis->customBondTorsions.clear();
+    mutableThis->flatImproperTorsions.clear();
+    mutableThis->flatTorsionTerms.clear();
+
+    for (DuMMBondStarterIndex bsx(0); bsx < getNumBondStarterAtoms(); ++bsx) {
+        const DuMM::IncludedAtomIndex a1num = bondStarterAtoms[bsx];
+        const IncludedAtom& a1 = getIncludedAtom(a1num);
+
+        for (int b12=0; b12 < (int)a1.force12.size(); ++b12) {
+            const BondStretch& bs = *a1.stretch[b12];
+            FlatBondStretch t;
+            t.a1 = a1num;           t.a2 = a1.force12[b12];
+            t.b1 = a1.inclBodyIndex;
+            t.b2 = getIncludedAtom(t.a2).inclBodyIndex;
+            t.k  = bs.k;            t.d0 = bs.d0;
+            t.params = &bs;
+            if (bs.hasBuiltinTerm()) mutableThis->flatBondStretches.push_back(t);
+            if (bs.hasCustomTerm())  mutableThis->customBondStretches.push_back(t);
+        }
+
+        for (int b13=0; b13 < (int)a1.force13.size(); ++b13) {
+            const BondBend& bb = *a1.bend[b13];
+            FlatBondBend t; // atom 2 is the central one
+            t.c = a1.force13[b13][0]; t.r = a1num; t.s = a1.force13[b13][1];
+            t.bc = getIncludedAtom(t.c).inclBodyIndex;
+            t.br = a1.inclBodyIndex;
+            t.bs = getIncludedAtom(t.s).inclBodyIndex;
+            t.k  = bb.k;            t.theta0 = bb.theta0;
+            t.params = &bb;
+            if (bb.hasBuiltinTerm()) mutableThis->flatBondBends.push_back(t);
+            if (bb.hasCustomTerm())  mutableThis->customBondBends.push_back(t);
+        }
+
+        for (int b14=0; b14 < (int)a1.force14.size(); ++b14) {
+            const BondTorsion& bt = *a1.torsion[b14];
+            FlatBondTorsion t;
+            t.r = a1num;              t.x = a1.force14[b14][0]; 
+            t.y = a1.force14[b14][1]; t.s = a1.force14[b14][2];
+            t.br = a1.inclBodyIndex;
+            t.bx = getIncludedAtom(t.x).inclBodyIndex;
+            t.by = getIncludedAtom(t.y).inclBodyIndex;
+            t.bs = getIncludedAtom(t.s).inclBodyIndex;
+            t.firstTerm = (unsigned)flatTorsionTerms.size();
+            for (int i=0; i < (int)bt.terms.size(); ++i)
+                mutableThis->flatTorsionTerms.push_back(bt.terms[i]);
+            t.endTerm = (unsigned)flatTorsionTerms.size();
+            t.params = &bt;
+            if (bt.hasBuiltinTerm()) mutableThis->flatBondTorsions.push_back(t);
+            if (bt.hasCustomTerm())  mutableThis->customBondTorsions.push_back(t);
+        }
+
+        // Note that a1 is the *third* atom in an improper torsion.
+        for (int b14=0; b14 < (int)a1.forceImproper14.size(); ++b14) {
+            const BondTorsion& bt = *a1.aImproperTorsion[b14];
+            FlatBondTorsion t;
+            t.r = a1.forceImproper14[b14][0]; t.x = a1.forceImproper14[b14][1];
+            t.y = a1num;                      t.s = a1.forceImproper14[b14][2];
+            t.br = getIncludedAtom(t.r).inclBodyIndex;
+            t.bx = getIncludedAtom(t.x).inclBodyIndex;
+            t.by = a1.inclBodyIndex;
+            t.bs = getIncludedAtom(t.s).inclBodyIndex;
+            t.firstTerm = (unsigned)flatTorsionTerms.size();
+            for (int i=0; i < (int)bt.terms.size(); ++i)
+                mutableThis->flatTorsionTerms.push_back(bt.terms[i]);
+            t.endTerm = (unsigned)flatTorsionTerms.size();
+            t.params = &bt;
+            if (bt.hasBuiltinTerm()) 
+                mutableThis->flatImproperTorsions.push_back(t);
+        }
+    }
+
+    // For parallel evaluation the built-in terms are divided into batches of
+    // a fixed size, so that the work division doesn't depend on the number
+    // of threads. Each term gets a force slot for each of its atoms; then
+    // for each included body we list the slots that belong to it.
+    mutableThis->bondedTermBatches.clear();
+    const int numTerms[BondedTermBatch::NumTermTypes] = 
+    {   (int)flatBondStretches.size(), (int)flatBondBends.size(),
+        (int)flatBondTorsions.size(),  (int)flatImproperTorsions.size() };
+    unsigned numSlots = 0;
+    for (int type=0; type < BondedTermBatch::NumTermTypes; ++type)
+        for (int begin=0; begin < numTerms[type]; 
+             begin += BondedTermBatch::TermsPerBatch)
+        {
+            BondedTermBatch batch;
+            batch.type      = BondedTermBatch::TermType(type);
+            batch.begin     = begin;
+            batch.end       = std::min(numTerms[type], 
+                                       begin + BondedTermBatch::TermsPerBatch);
+            batch.firstSlot = numSlots;
+            numSlots += batch.getNumSlots();
+            mutableThis->bondedTermBatches.push_back(batch);
+        }
+
+    Array_<DuMMIncludedBodyIndex> slotBody;
+    slotBody.reserve(numSlots);
+    for (int i=0; i < (int)flatBondStretches.size(); ++i) {
+        const FlatBondStretch& t = flatBondStretches[i];
+        slotBody.push_back(t.b1); slotBody.push_back(t.b2);
+    }
+    for (int i=0; i < (int)flatBondBends.size(); ++i) {
+        const FlatBondBend& t = flatBondBends[i];
+        slotBody.push_back(t.br); slotBody.push_back(t.bc); 
+        slotBody.push_back(t.bs);
+    }
+    for (int i=0; i < (int)flatBondTorsions.size(); ++i) {
+        const FlatBondTorsion& t = flatBondTorsions[i];
+        slotBody.push_back(t.br); slotBody.push_back(t.bx); 
+        slotBody.push_back(t.by); slotBody.push_back(t.bs);
+    }
+    for (int i=0; i < (int)flatImproperTorsions.size(); ++i) {
+        const FlatBondTorsion& t = flatImproperTorsions[i];
+        slotBody.push_back(t.br); slotBody.push_back(t.bx); 
+        slotBody.push_back(t.by); slotBody.push_back(t.bs);
+    }
+    assert(slotBody.size() == numSlots);
+
+    // Counting sort of the slots by body, keeping them in slot order.
+    mutableThis->firstBondedSlotOfBody.clear();
+    mutableThis->firstBondedSlotOfBody.resize(getNumIncludedBodies()+1, 0);
+    for (unsigned k=0; k < numSlots; ++k)
+        ++mutableThis->firstBondedSlotOfBody[DuMMIncludedBodyIndex(slotBody[k]+1)];
+    for (DuMMIncludedBodyIndex b(0); b < getNumIncludedBodies(); ++b)
+        mutableThis->firstBondedSlotOfBody[DuMMIncludedBodyIndex(b+1)] += 
+            firstBondedSlotOfBody[b];
+    mutableThis->bondedSlotsOfBody.resize(numSlots);
+    {   Array_<unsigned, DuMMIncludedBodyIndex> next(firstBondedSlotOfBody);
+        for (unsigned k=0; k < numSlots; ++k)
+            mutableThis->bondedSlotsOfBody[next[slotBody[k]]++] = k; }
+
+    mutableThis->bondedTermForces.resize(numSlots);
+    mutableThis->bondedBatchEnergy.resize(bondedTermBatches.size());
+
+    if (tracing)
+        std::clog << "NOTE: DuMM: " << flatBondStretches.size() 
+                  << " stretch, " << flatBondBends.size() << " bend, "
+                  << flatBondTorsions.size() << " torsion and "
+                  << flatImproperTorsions.size() 
+                  << " improper torsion terms.\n";
+
+    endStep("flat bonded terms");
+
         /////////////////////////////
         // Fill in GBSA parameters //
         /////////////////////////////
@@ -975,8 +1386,11 @@ int DuMMForceFieldSubsystemRep::realizeSubsystemTopologyImpl(State& s) const
         SimTK_ASSERT_ALWAYS(returnValue == 0, "Couldn't get GBSA input radii.");
 
         // Don't delete this object here.
+        // GBSA works in DuMM's MD units so that it can use the nonbond 
+        // positions directly; the radii are converted from Angstroms.
         ObcParameters* obcParameters = 
             new ObcParameters(getNumNonbondAtoms(), ObcParameters::ObcTypeII);
+        obcParameters->setUnits(SimTKOpenMMCommon::MdUnits);
         obcParameters->setScaledRadiusFactors( &gbsaObcScaleFactors.front() );
         obcParameters->setAtomicRadii(&gbsaRadii.front(), 
                                       SimTKOpenMMCommon::KcalAngUnits);
@@ -984,20 +1398,288 @@ int DuMMForceFieldSubsystemRep::realizeSubsystemTopologyImpl(State& s) const
         obcParameters->setSoluteDielectric(gbsaSoluteDielectric);
         mutableThis->gbsaCpuObc = new CpuObc(obcParameters); // CpuObc takes ownership of the parameters object
         gbsaCpuObc->setIncludeAceApproximation((int)gbsaIncludeAceApproximation);
-
-        // The cpu GBSA requires vectors of pointers to locations and forces.
-        // Allocate those now. Note that forces have to be zeroed each step.
-        gbsaRawCoordinates.resize(3 * getNumNonbondAtoms(), NaN); // [x,y,z,x,y,z,...], Angstrom(!) units
-        gbsaAtomicForces.resize  (3 * getNumNonbondAtoms(), NaN);
-        mutableThis->gbsaCoordinatePointers.resize (getNumNonbondAtoms()); // [&x0,&x1,&x2...]
-        mutableThis->gbsaAtomicForcePointers.resize(getNumNonbondAtoms()); // [&x0,&x1,&x2...]
-        // Load the pointers -- after this they don't change.
-        for (DuMM::NonbondAtomIndex a(0); a < getNumNonbondAtoms(); ++a) {
-            mutableThis->gbsaCoordinatePointers[a]  = &gbsaRawCoordinates[3*a];
-            mutableThis->gbsaAtomicForcePointers[a] = &gbsaAtomicForces[3*a];
+        gbsaCpuObc->setUseCutoff((int)useGbsaCutoff);
+        gbsaCpuObc->setCutoff((RealOpenMM)gbsaCutoff); // nm
+        gbsaCpuObc->setUseMixedPrecision((int)useGbsaMixedPrecision);
+        gbsaCpuObc->setUseBornRadiusCache((int)useGbsaBornRadiusCache);
+
+        // Atoms on the same body never move relative to one another, so 
+        // their contributions to each other's Born radii are computed once
+        // here from the body-frame stations. Nonbond atoms are grouped by 
+        // included body so each body is a contiguous cluster.
+        Array_<int> clusterStart;
+        for (DuMMIncludedBodyIndex inclBodyIx(0); 
+             inclBodyIx < getNumIncludedBodies(); ++inclBodyIx)
+            clusterStart.push_back(includedBodies[inclBodyIx].beginNonbondAtoms);
+        clusterStart.push_back(getNumNonbondAtoms());
+
+        Array_<RealOpenMM> stationX(getNumNonbondAtoms()), 
+                           stationY(getNumNonbondAtoms()), 
+                           stationZ(getNumNonbondAtoms());
+        for (DuMM::NonbondAtomIndex nax(0); nax < getNumNonbondAtoms(); ++nax) {
+            const Vec3& station_B = 
+                includedAtomStations[getIncludedAtomIndexOfNonbondAtom(nax)];
+            stationX[nax] = station_B[0];
+            stationY[nax] = station_B[1];
+            stationZ[nax] = station_B[2];
         }
+        const ImplicitSolventCoordinates stations = 
+           { stationX.cbegin(), stationY.cbegin(), stationZ.cbegin() };
+        returnValue = gbsaCpuObc->setRigidClusters
+           ((int)getNumIncludedBodies(), &clusterStart.front(), stations);
+        SimTK_ASSERT_ALWAYS(returnValue == 0, 
+            "Couldn't set up GBSA rigid body clusters.");
+
+        gbsaForceX.resize(getNumNonbondAtoms());
+        gbsaForceY.resize(getNumNonbondAtoms());
+        gbsaForceZ.resize(getNumNonbondAtoms());
     }
 
+    endStep("GBSA");
+
+        ////////////////////////////////////
+        // Set up nonbonded kernel tables //
+        ////////////////////////////////////
+
+    // Renumber the atom classes that are actually used by nonbond atoms so 
+    // that we can keep square tables of the mixed van der Waals parameters,
+    // indexed by the dense class numbers of both atoms.
+    {
+        std::map<DuMM::AtomClassIndex,int> denseClassIx;
+        Array_<DuMM::AtomClassIndex> usedClasses;
+        mutableThis->nonbondClassIx.resize(getNumNonbondAtoms());
+        mutableThis->nonbondCharge.resize(getNumNonbondAtoms());
+        mutableThis->nonbondEndOfBody.resize(getNumNonbondAtoms());
+        mutableThis->nonbondBodyIx.resize(getNumNonbondAtoms());
+        for (DuMM::NonbondAtomIndex nax(0); nax < getNumNonbondAtoms(); ++nax) {
+            const IncludedAtom& a = getIncludedAtom(
+                                    getIncludedAtomIndexOfNonbondAtom(nax));
+            const ChargedAtomType& atype = 
+                chargedAtomTypes[a.chargedAtomTypeIndex];
+            std::map<DuMM::AtomClassIndex,int>::const_iterator p =
+                denseClassIx.find(atype.atomClassIx);
+            if (p == denseClassIx.end()) {
+                p = denseClassIx.insert(std::make_pair(atype.atomClassIx,
+                                        (int)usedClasses.size())).first;
+                usedClasses.push_back(atype.atomClassIx);
+            }
+            mutableThis->nonbondClassIx[nax] = p->second;
+            mutableThis->nonbondCharge[nax]  = atype.partialCharge;
+        }
+
+        // Note each atom's body and where that body's nonbond atoms end; 
+        // atoms from there on are on later bodies. Also find a bounding 
+        // sphere for each body's nonbond atoms, centered on their bounding
+        // box.
+        for (DuMMIncludedBodyIndex dbx(0); dbx < getNumIncludedBodies(); ++dbx) {
+            IncludedBody& inclBod = mutableThis->includedBodies[dbx];
+            Vec3 lo(Infinity), hi(-Infinity);
+            for (DuMM::NonbondAtomIndex nax = inclBod.beginNonbondAtoms;
+                 nax != inclBod.endNonbondAtoms; ++nax)
+            {
+                mutableThis->nonbondEndOfBody[nax] = inclBod.endNonbondAtoms;
+                mutableThis->nonbondBodyIx[nax]    = dbx;
+                const Vec3& station_B = getIncludedAtomStation(
+                                        getIncludedAtomIndexOfNonbondAtom(nax));
+                for (int k=0; k<3; ++k) {
+                    lo[k] = std::min(lo[k], station_B[k]);
+                    hi[k] = std::max(hi[k], station_B[k]);
+                }
+            }
+            inclBod.nonbondSphereCenter_B = Vec3(0);
+            inclBod.nonbondSphereRadius   = 0;
+            if (inclBod.beginNonbondAtoms == inclBod.endNonbondAtoms)
+                continue;
+            inclBod.nonbondSphereCenter_B = (lo + hi) / 2;
+            for (DuMM::NonbondAtomIndex nax = inclBod.beginNonbondAtoms;
+                 nax != inclBod.endNonbondAtoms; ++nax)
+            {
+                const Vec3& station_B = getIncludedAtomStation(
+                                        getIncludedAtomIndexOfNonbondAtom(nax));
+                inclBod.nonbondSphereRadius = std::max(inclBod.nonbondSphereRadius,
+                    (station_B - inclBod.nonbondSphereCenter_B).norm());
+            }
+        }
+
+        const int nc = (int)usedClasses.size();
+        mutableThis->numNonbondClasses = nc;
+        mutableThis->nonbondVdwDij2.resize(nc*nc);
+        mutableThis->nonbondVdwEij.resize(nc*nc);
+        for (int i=0; i < nc; ++i)
+            for (int j=0; j < nc; ++j) {
+                // Must ask the lower-numbered atom class.
+                const DuMM::AtomClassIndex ci = std::min(usedClasses[i],
+                                                         usedClasses[j]);
+                const DuMM::AtomClassIndex cj = std::max(usedClasses[i],
+                                                         usedClasses[j]);
+                const Real dij = atomClasses[ci].vdwDij[cj-ci];
+                mutableThis->nonbondVdwDij2[i*nc+j] = dij*dij;
+                mutableThis->nonbondVdwEij[i*nc+j]  = atomClasses[ci].vdwEij[cj-ci];
+            }
+
+        mutableThis->nonbondKernelType = 
+            DuMMNonbondKernels::selectKernelType(useVectorizedNonbondedKernels);
+        mutableThis->nonbondRowKernel  = 
+            DuMMNonbondKernels::getRowKernel(nonbondKernelType, true);
+        mutableThis->nonbondEnergyRowKernel = 
+            DuMMNonbondKernels::getRowKernel(nonbondKernelType, false);
+
+        nonbondPosX.resize(getNumNonbondAtoms());
+        nonbondPosY.resize(getNumNonbondAtoms());
+        nonbondPosZ.resize(getNumNonbondAtoms());
+        nonbondForceX.resize(getNumNonbondAtoms());
+        nonbondForceY.resize(getNumNonbondAtoms());
+        nonbondForceZ.resize(getNumNonbondAtoms());
+
+        if (tracing)
+            std::clog << "NOTE: DuMM: using " 
+                      << DuMMNonbondKernels::getKernelTypeName(nonbondKernelType)
+                      << " nonbonded kernel with " << nc 
+                      << " atom classes.\n";
+    }
+
+        ///////////////////////////////////////////////
+        // Collect scaled cross-body nonbond pairs   //
+        ///////////////////////////////////////////////
+
+    // The nonbonded kernels don't scale anything. Instead we make a list of
+    // the cross-body pairs that need scaling, in the row of the lower-numbered
+    // atom; the kernels skip those and they are calculated separately. If an
+    // atom appears on more than one of another atom's scale lists, the later
+    // (1-5 over 1-4, etc.) list wins. Pairs that end up unscaled are dropped.
+    {
+        mutableThis->scaledNonbondPairs.clear();
+        mutableThis->firstScaledNonbondPair.resize(getNumNonbondAtoms()+1);
+        Array_<ScaledNonbondPair> row;
+        for (DuMM::NonbondAtomIndex nax1(0); nax1 < getNumNonbondAtoms(); ++nax1) {
+            mutableThis->firstScaledNonbondPair[nax1] = scaledNonbondPairs.size();
+            const IncludedAtom& a1 = getIncludedAtom(
+                                    getIncludedAtomIndexOfNonbondAtom(nax1));
+
+            const Array_<DuMM::NonbondAtomIndex,unsigned short>* scaleList[4] =
+                {&a1.scale12, &a1.scale13, &a1.scale14, &a1.scale15};
+            const Real vdwScale[4] = 
+                {vdwScale12, vdwScale13, vdwScale14, vdwScale15};
+            const Real coulombScale[4] = 
+                {coulombScale12, coulombScale13, coulombScale14, coulombScale15};
+
+            row.clear();
+            for (int l=0; l < 4; ++l) {
+                const Array_<DuMM::NonbondAtomIndex,unsigned short>& nbrs = 
+                    *scaleList[l];
+                for (unsigned i=0; i < nbrs.size(); ++i) {
+                    const DuMM::NonbondAtomIndex nax2 = nbrs[i];
+                    if (nax2 < nax1) continue; // do each pair only once
+                    unsigned k = 0;
+                    while (k < row.size() && row[k].nax2 != nax2) ++k;
+                    if (k == row.size())
+                        row.push_back(ScaledNonbondPair(nax1, nax2, 1, 1));
+                    row[k].vdwScale     = vdwScale[l];
+                    row[k].coulombScale = coulombScale[l];
+                }
+            }
+
+            std::sort(row.begin(), row.end(), 
+                      [](const ScaledNonbondPair& p1, const ScaledNonbondPair& p2)
+                      {return p1.nax2 < p2.nax2;});
+            for (unsigned k=0; k < row.size(); ++k)
+                if (row[k].vdwScale != 1 || row[k].coulombScale != 1)
+                    mutableThis->scaledNonbondPairs.push_back(row[k]);
+        }
+        mutableThis->firstScaledNonbondPair
+            [DuMM::NonbondAtomIndex(getNumNonbondAtoms())] = 
+                scaledNonbondPairs.size();
+
+        if (tracing)
+            std::clog << "NOTE: DuMM: " << scaledNonbondPairs.size()
+                      << " scaled cross-body nonbond pairs.\n";
+    }
+
+    endStep("nonbonded tables and scaled pairs");
+
+        //////////////////////////////////////////////////
+        // Set up periodic box and Ewald electrostatics //
+        //////////////////////////////////////////////////
+
+    if (usePeriodicBox) {
+        static const char* Where = "DuMMForceFieldSubsystem::realizeTopology()";
+        const Real minEdge = std::min(periodicBox[0], 
+                                      std::min(periodicBox[1], periodicBox[2]));
+        SimTK_ERRCHK_ALWAYS(useNonbondedCutoff, Where,
+            "A periodic box requires a nonbonded cutoff;"
+            " call setUseNonbondedCutoff(true).");
+        SimTK_ERRCHK2_ALWAYS(nonbondedCutoff <= minEdge/2, Where,
+            "The nonbonded cutoff (%g nm) must not be larger than half the"
+            " shortest periodic box edge (%g nm).", nonbondedCutoff, minEdge);
+        SimTK_ERRCHK_ALWAYS(gbsaGlobalScaleFactor == 0 || !getNumNonbondAtoms(),
+            Where, "GBSA implicit solvent can't be used with a periodic box;"
+            " set the GBSA global scale factor to zero.");
+    }
+
+    if (   usePeriodicBox && useEwaldElectrostatics 
+        && coulombGlobalScaleFactor != 0 && getNumNonbondAtoms()) 
+    {
+        mutableThis->usingEwald = true;
+        mutableThis->ewaldAlpha = 
+            DuMMPmeSolver::calcAlpha(nonbondedCutoff, ewaldErrorTolerance);
+        mutableThis->pmeSolver = new DuMMPmeSolver();
+        mutableThis->pmeSolver->initialize(periodicBox, ewaldAlpha,
+            DuMMPmeSolver::calcGridSize(periodicBox, ewaldAlpha, 
+                                        ewaldErrorTolerance));
+
+        mutableThis->ewaldCharges.resize(getNumNonbondAtoms());
+        Real sumQ = 0, sumQ2 = 0;
+        for (DuMM::NonbondAtomIndex nax(0); nax < getNumNonbondAtoms(); ++nax) {
+            const IncludedAtom& a = getIncludedAtom(
+                                    getIncludedAtomIndexOfNonbondAtom(nax));
+            const Real q = chargedAtomTypes[a.chargedAtomTypeIndex].partialCharge;
+            mutableThis->ewaldCharges[nax] = q;
+            sumQ += q; sumQ2 += q*q;
+        }
+
+        // Self energy, and the neutralizing background if there is a net 
+        // charge.
+        const Real volume = periodicBox[0]*periodicBox[1]*periodicBox[2];
+        Real constantEnergy = -ewaldAlpha/std::sqrt(Pi) * sumQ2
+                              - Pi*sumQ*sumQ/(2*volume*ewaldAlpha*ewaldAlpha);
+
+        // The reciprocal space sum includes every pair, but we never compute 
+        // interactions between atoms on the same body. Those pairs don't 
+        // change distance so their reciprocal space contribution is a 
+        // constant that we can remove here; the forces cancel within the body.
+        for (DuMMIncludedBodyIndex dbx(0); dbx < getNumIncludedBodies(); ++dbx) {
+            const IncludedBody& inclBod = includedBodies[dbx];
+            for (DuMM::NonbondAtomIndex nax1 = inclBod.beginNonbondAtoms;
+                 nax1 != inclBod.endNonbondAtoms; ++nax1) 
+            {
+                const Vec3& s1 = includedAtomStations
+                                    [getIncludedAtomIndexOfNonbondAtom(nax1)];
+                for (DuMM::NonbondAtomIndex nax2(nax1+1); 
+                     nax2 != inclBod.endNonbondAtoms; ++nax2) 
+                {
+                    const Vec3& s2 = includedAtomStations
+                                    [getIncludedAtomIndexOfNonbondAtom(nax2)];
+                    const Real d = (s2-s1).norm();
+                    constantEnergy -= ewaldCharges[nax1]*ewaldCharges[nax2]
+                                      * std::erf(ewaldAlpha*d)/d;
+                }
+            }
+        }
+        mutableThis->ewaldConstantEnergy = constantEnergy;
+
+        mutableThis->pmePositions.resize(getNumNonbondAtoms());
+        mutableThis->pmeForces.resize(getNumNonbondAtoms());
+
+        if (tracing) {
+            const Vec<3,int>& grid = pmeSolver->getGridSize();
+            std::clog << "NOTE: DuMM: using PME electrostatics with alpha=" 
+                      << ewaldAlpha << "/nm and a " << grid[0] << "x" 
+                      << grid[1] << "x" << grid[2] << " grid.\n";
+        }
+    }
+
+    endStep("periodic box and Ewald");
+
         ///////////////////////////////////////////
         // Initialize OpenMM if it is being used //
         ///////////////////////////////////////////
@@ -1009,7 +1691,14 @@ int DuMMForceFieldSubsystemRep::realizeSubsystemTopologyImpl(State& s) const
     // Using "while" here just so we can break out; this won't ever loop. If we
     // decide to use OpenMM, the flag usingOpenMM will be set true.
     mutableThis->usingOpenMM = false;
-    while (wantOpenMMAcceleration && getNumNonbondAtoms()) {
+    if (wantOpenMMAcceleration && useNonbondedCutoff && tracing)
+        std::clog << "NOTE: DuMM: not using OpenMM because a nonbonded cutoff"
+                     " was requested.\n";
+    if (wantOpenMMAcceleration && useGbsaCutoff && tracing)
+        std::clog << "NOTE: DuMM: not using OpenMM because a GBSA cutoff"
+                     " was requested.\n";
+    while (wantOpenMMAcceleration && !useNonbondedCutoff && !useGbsaCutoff
+           && getNumNonbondAtoms()) {
         if (!mutableThis->openMMPlugin.load()) {
             if (tracing)
                 std::clog << "WARNING: DuMM: Failed to load OpenMM plugin with message: "
@@ -1085,12 +1774,12 @@ int DuMMForceFieldSubsystemRep::realizeSubsystemTopologyImpl(State& s) const
 
         if (wantParallel) {
             mutableThis->usingMultithreaded = true;
-            if (!anyNonbonded) {
+            if (!anyNonbonded && bondedTermBatches.size() <= 1) {
                 mutableThis->usingMultithreaded = false;
                 if (tracing) 
                     std::clog << "NOTE: DuMM: not using multithreading because"
                                  " there are no nonbonded or implicit solvent"
-                                 " terms to calculate.\n";
+                                 " terms and few bonded terms to calculate.\n";
             }
             // This will probably never happen.
             if (ParallelExecutor::isWorkerThread()) {
@@ -1111,14 +1800,18 @@ int DuMMForceFieldSubsystemRep::realizeSubsystemTopologyImpl(State& s) const
         const int numThreadsWanted = numThreadsRequested > 0 
                             ? numThreadsRequested
                             : ParallelExecutor::getNumProcessors();
+        const int maxUsefulThreads = std::max(getNumNonbondAtoms()/2,
+                                              (int)bondedTermBatches.size());
         mutableThis->numThreadsInUse = std::min(numThreadsWanted,
-                                                std::max(1, getNumNonbondAtoms()/2));
+                                                std::max(1, maxUsefulThreads));
 
         if (tracing && (numThreadsInUse < numThreadsWanted)) 
             std::clog << "NOTE: DuMM: reduced number of threads from "
                       << numThreadsWanted << " to " << numThreadsInUse
                       << " because there were only " << getNumNonbondAtoms() 
-                      << " atoms included in nonbonded force calculations.\n";
+                      << " atoms included in nonbonded force calculations"
+                      << " and " << bondedTermBatches.size() 
+                      << " batches of bonded terms.\n";
 
         mutableThis->executor = new ParallelExecutor(numThreadsInUse);
 
@@ -1126,19 +1819,31 @@ int DuMMForceFieldSubsystemRep::realizeSubsystemTopologyImpl(State& s) const
             std::clog << "NOTE: DuMM: using multithreading code with "
                       << numThreadsInUse << " threads.\n";
 
-        mutableThis->nonbondedExecutor = 
-            new Parallel2DExecutor(includedBodies.size(), *executor);
-        mutableThis->gbsaExecutor = 
-            new Parallel2DExecutor(getNumNonbondAtoms(), *executor);
+        if (getNumNonbondAtoms())
+            mutableThis->gbsaExecutor = 
+                new Parallel2DExecutor(getNumNonbondAtoms(), *executor);
     }
 
-    if (!(usingOpenMM || usingMultithreaded)) {
-        if (tracing)
-            std::clog << "NOTE: DuMM: using single threaded code.\n";
+    if (!(usingOpenMM || usingMultithreaded) && tracing)
+        std::clog << "NOTE: DuMM: using single threaded code.\n";
+
+    // Tiles for the multithreaded all-pairs nonbonded calculation; see 
+    // class NonbondedForceTask.
+    if (usingMultithreaded) {
+        const int nBlocks = (getNumNonbondAtoms() + nonbondedTileSize - 1)
+                            / nonbondedTileSize;
+        mutableThis->nonbondTileRowStart.resize(nBlocks+1);
+        long long nTiles = 0;
+        for (int blockI=0; blockI < nBlocks; ++blockI) {
+            mutableThis->nonbondTileRowStart[blockI] = nTiles;
+            nTiles += nBlocks - blockI;
+        }
+        mutableThis->nonbondTileRowStart[nBlocks] = nTiles;
 
-        // Using single threaded -- allocate global temporaries
-        vdwScaleSingleThread.resize(getNumNonbondAtoms(), Real(1));
-        coulombScaleSingleThread.resize(getNumNonbondAtoms(), Real(1));
+        if (tracing)
+            std::clog << "NOTE: DuMM: all-pairs nonbonded work is " << nTiles
+                      << " tiles of " << nonbondedTileSize << "x" 
+                      << nonbondedTileSize << " atoms.\n";
     }
 
     // Create cache entries for storing position info and forces for included
@@ -1150,6 +1855,8 @@ int DuMMForceFieldSubsystemRep::realizeSubsystemTopologyImpl(State& s) const
        (s, Stage::Position, new Value<Vector_<Vec3> >());
     mutableThis->inclAtomPositionCacheIndex = allocateCacheEntry
        (s, Stage::Position, new Value<Vector_<Vec3> >());
+    mutableThis->inclBodySphereCenterCacheIndex = allocateCacheEntry
+       (s, Stage::Position, new Value<Vector_<Vec3> >());
 
     // Included atom velocity information is "lazy evaluated" because it 
     // usually isn't need for anything. We'll realize it if someone
@@ -1174,6 +1881,52 @@ int DuMMForceFieldSubsystemRep::realizeSubsystemTopologyImpl(State& s) const
     mutableThis->energyCacheIndex = allocateCacheEntry
        (s, Stage::Position, Stage::Dynamics, new Value<Real>());
 
+    // Potential energy calculated without forces, if someone asks for the
+    // energy before forces have been calculated.
+    mutableThis->energyOnlyCacheIndex = allocateCacheEntry
+       (s, Stage::Position, Stage::Dynamics, new Value<Real>());
+
+    // The nonbonded neighbor list depends only on topology; it is rebuilt 
+    // on demand when atoms have moved too far since it was last built.
+    mutableThis->nonbondNeighborListCacheIndex = allocateCacheEntry
+       (s, Stage::Topology, new Value<NonbondNeighborList>());
+
+    // Slow force group results for multiple time stepping are calculated 
+    // along with the forces; see realizeForcesAndEnergy().
+    mutableThis->multipleTimeStepCacheIndex = allocateCacheEntry
+       (s, Stage::Position, Stage::Dynamics, 
+        new Value<MultipleTimeStepCache>());
+
+    if (useNonbondedCutoff && tracing)
+        std::clog << "NOTE: DuMM: using nonbonded cutoff " << nonbondedCutoff
+                  << " nm with neighbor list skin " << neighborListSkin 
+                  << " nm.\n";
+    if (useGbsaCutoff && gbsaCpuObc && tracing)
+        std::clog << "NOTE: DuMM: using GBSA cutoff " << gbsaCutoff << " nm.\n";
+    if (useGbsaMixedPrecision && !useGbsaCutoff && gbsaCpuObc && !usingOpenMM
+        && tracing)
+        std::clog << "NOTE: DuMM: using mixed precision GBSA with "
+                  << gbsaCpuObc->getMixedPrecisionKernelName() << " kernels.\n";
+    if (isFusedGbsaNonbondedPossible() && tracing)
+        std::clog << "NOTE: DuMM: computing GBSA pair terms together with"
+                     " the nonbonded terms.\n";
+    if (useGbsaBornRadiusCache && !useGbsaCutoff && !useGbsaMixedPrecision
+        && gbsaCpuObc && !usingOpenMM && tracing)
+        std::clog << "NOTE: DuMM: reusing GBSA Born radii of atoms that"
+                     " haven't moved.\n";
+
+    if (isUsingMultipleTimeStepping() && tracing) {
+        std::clog << "NOTE: DuMM: multiple time stepping with step " 
+                  << multipleTimeStepSize << " ps; force group intervals";
+        for (int g=0; g < DuMMForceFieldSubsystem::NumForceGroups; ++g)
+            std::clog << " " << forceGroupInterval[g];
+        std::clog << ".\n";
+    }
+
+    endStep("threads, OpenMM and cache entries");
+    if (tracing)
+        dumpTopologyStatistics(std::clog);
+
     return 0;
 }
 //.............................REALIZE TOPOLOGY.................................
@@ -1220,6 +1973,19 @@ realizeSubsystemPositionImpl(const State& s) const {
         }
     }
 
+    // With a cutoff, locate the bodies' nonbond bounding spheres so that we
+    // can skip body pairs that are too far apart to interact.
+    if (useNonbondedCutoff) {
+        Vector_<Vec3>& sphereCenter_G = updIncludedBodySphereCenterCache(s);
+        sphereCenter_G.resize(getNumIncludedBodies());
+        for (DuMMIncludedBodyIndex dbx(0); dbx < includedBodies.size(); ++dbx) {
+            const IncludedBody& inclBod = includedBodies[dbx];
+            const Transform& X_GB = 
+                matter.getMobilizedBody(inclBod.mobodIx).getBodyTransform(s);
+            sphereCenter_G[dbx] = X_GB * inclBod.nonbondSphereCenter_B;
+        }
+    }
+
     return 0;
 }
 //.............................REALIZE POSITION.................................
@@ -1283,261 +2049,581 @@ int DuMMForceFieldSubsystemRep::realizeSubsystemVelocityImpl(const State& state)
 
 
 //------------------------------------------------------------------------------
-//                             CALC BOND STRETCH
+//                           CALC BOND STRETCH RANGE
 //------------------------------------------------------------------------------
-// Helper routine for realizeDynamics. This should be called only once it has 
-// been determined that we need to calculate bond stretch terms. We're given an
-// included atom 1 and we process all the bond stretch terms involving that 
-// atom and one other immediately-adjacent atom. To avoid double-counting the
-// 1-2 bond array force12 for this atom only contain bonds for which this 
-// atom's original atom index was less than the atom index of the other atom. 
-// (The included atom index values that are in force12 won't necessarily be 
-// ordered the same way.)
-void DuMMForceFieldSubsystemRep::calcBondStretch
-   (DuMM::IncludedAtomIndex             a1num, 
+// Helper routine for calcBondedForces(). We evaluate the built-in parts of
+// cross-body bond stretch terms [begin,end) from the flattened array built at
+// topology time; duplicates were already eliminated when the bond starter
+// atoms' force12 lists were built. If termForces is null the spatial forces
+// are added to the included bodies. Otherwise term i *writes* its forces on
+// the bodies of atoms 1 and 2 into termForces[2*(i-begin)] and the next slot
+// for later summation, as is done for parallel evaluation.
+void DuMMForceFieldSubsystemRep::calcBondStretchRange
+   (int                                 begin,
+    int                                 end,
     const Vector_<Vec3>&                inclAtomStation_G,
     const Vector_<Vec3>&                inclAtomPos_G,
-    Real                                bondStretchScaleFactor,
-    Real                                customBondStretchScaleFactor,
+    bool                                calcForces,
+    SpatialVec*                         termForces,
     Vector_<SpatialVec>&                inclBodyForces_G,
     Real&                               energy) const
 {
-    const IncludedAtom&           a1    = getIncludedAtom(a1num);
-    const DuMMIncludedBodyIndex   b1    = a1.inclBodyIndex;
-    const Vec3& a1Station_G = inclAtomStation_G[a1num];
-    const Vec3& a1Pos_G     = inclAtomPos_G[a1num];
-
-    for (DuMM::IncludedAtomIndex b12(0); b12 < a1.force12.size(); ++b12) {
-        const DuMM::IncludedAtomIndex a2num = a1.force12[b12];
-
-        const IncludedAtom&  a2 = getIncludedAtom(a2num);
-        const Vec3& a2Station_G = inclAtomStation_G[a2num];
-        const Vec3& a2Pos_G     = inclAtomPos_G[a2num];
-        const Vec3  r           = a2Pos_G - a1Pos_G;
-        const Real  d           = r.norm();
-
-        const BondStretch& bs = *a1.stretch[b12];
-
-        Real eStretch, fStretch;
-        if (bs.hasBuiltinTerm()) {
-            const Real x = d - bs.d0;
-            const Real kx = bondStretchScaleFactor * bs.k * x;
-            eStretch =  kx*x; // no factor of 1/2!
-            fStretch = -2*kx; // sign is as would be applied to a2
-        } else
-            eStretch = fStretch = 0;
-
-        for (int i=0; i < (int)bs.customTerms.size(); ++i) {
-            const DuMM::CustomBondStretch& term = *bs.customTerms[i];
-            eStretch += customBondStretchScaleFactor * term.calcEnergy(d);
-            // expecting f = -dE/dx but can't check
-            fStretch += customBondStretchScaleFactor * term.calcForce(d); 
-        }
+    const Real scale = bondStretchGlobalScaleFactor;
+
+    for (int i=begin; i < end; ++i) {
+        const FlatBondStretch& bs = flatBondStretches[i];
+        const Vec3 r  = inclAtomPos_G[bs.a2] - inclAtomPos_G[bs.a1];
+        const Real d  = r.norm();
+        const Real x  = d - bs.d0;
+        const Real kx = scale * bs.k * x;
+        energy += kx*x; // no factor of 1/2!
+        if (!calcForces)
+            continue;
 
         // Force is normally directed along the vector from atom 1
         // to atom 2. But if the atoms are exactly on top of one another
         // we're just going to use an arbitrary direction in the hope
         // that this is just some relaxation where the only thing that
         // matters is that the atoms do separate.
+        const Real fStretch = -2*kx; // sign is as would be applied to a2
         const Vec3 f2 = (d==0 ? Vec3(fStretch,0,0) : (fStretch/d)*r);
 
-        const DuMMIncludedBodyIndex b2 = a2.inclBodyIndex;
-        assert(b2 != b1);
-
-        energy += eStretch;
-        inclBodyForces_G[b2] += SpatialVec( a2Station_G % f2, f2); // 15 flops
-        inclBodyForces_G[b1] -= SpatialVec( a1Station_G % f2, f2); // 15 flops
+        assert(bs.b2 != bs.b1);
+        const SpatialVec F1(inclAtomStation_G[bs.a1] % -f2, -f2);
+        const SpatialVec F2(inclAtomStation_G[bs.a2] %  f2,  f2);
+        if (termForces) {
+            SpatialVec* tf = termForces + 2*(i-begin);
+            tf[0] = F1; tf[1] = F2;
+        } else {
+            inclBodyForces_G[bs.b1] += F1;
+            inclBodyForces_G[bs.b2] += F2;
+        }
     }
 }
-//.............................CALC BOND STRETCH................................
+//...........................CALC BOND STRETCH RANGE............................
 
 
 
 //------------------------------------------------------------------------------
-//                              CALC BOND BEND
+//                            CALC BOND BEND RANGE
 //------------------------------------------------------------------------------
-// Helper routine for realizeDynamics. This should be called only
-// once it has been determined that we need to calculate bond bending terms.
-// We're given an atom 1 and we process all the bond bending forces 
-// involving that atom and two others. To avoid double-counting the 1-3 bond 
-// array force13 for this atom only contain bonds for which this atom's original
-// atom index was less than the atom index of the final atom. (The included atom 
-// index values that are in force13 won't necessarily be ordered the same way.)
-void DuMMForceFieldSubsystemRep::calcBondBend
-   (DuMM::IncludedAtomIndex             a1num, 
+// Helper routine for calcBondedForces(), like calcBondStretchRange() but for
+// bond bend terms, with three force slots per term in the order r, c, s. The
+// built-in term is calculated here exactly as in
+// BondBend::calculateAtomForces(), which see for the treatment of the
+// singular cases.
+void DuMMForceFieldSubsystemRep::calcBondBendRange
+   (int                                 begin,
+    int                                 end,
     const Vector_<Vec3>&                inclAtomStation_G,
     const Vector_<Vec3>&                inclAtomPos_G,
-    Real                                bondBendScaleFactor,
-    Real                                customBondBendScaleFactor,
+    bool                                calcForces,
+    SpatialVec*                         termForces,
     Vector_<SpatialVec>&                inclBodyForces_G,
     Real&                               energy) const
 {
-    const IncludedAtom&           a1    = getIncludedAtom(a1num);
-    const DuMMIncludedBodyIndex   b1    = a1.inclBodyIndex;
-    const Vec3& a1Station_G = inclAtomStation_G[a1num];
-    const Vec3& a1Pos_G     = inclAtomPos_G[a1num];
+    const Real scale = bondBendGlobalScaleFactor;
+
+    for (int i=begin; i < end; ++i) {
+        const FlatBondBend& bb = flatBondBends[i];
+        SpatialVec* tf = (calcForces && termForces) ? termForces + 3*(i-begin)
+                                                    : 0;
+        const Vec3& cG = inclAtomPos_G[bb.c];
+        const Vec3 r = inclAtomPos_G[bb.r] - cG;
+        const Vec3 s = inclAtomPos_G[bb.s] - cG;
+        const Real rr = ~r*r, ss = ~s*s;
+        if (rr==0 || ss==0) { // no energy or force
+            if (tf) tf[0] = tf[1] = tf[2] = SpatialVec(Vec3(0), Vec3(0));
+            continue;
+        }
 
-    for (int b13=0; b13 < (int)a1.force13.size(); ++b13) {
-        const DuMM::IncludedAtomIndex a2num = a1.force13[b13][0];
-        const DuMM::IncludedAtomIndex a3num = a1.force13[b13][1];
+        const Vec3 rxs    = r % s;
+        const Real rxslen = rxs.norm();
+        const Real theta  = std::atan2(rxslen, ~r*s);
+        const Real bend   = theta - bb.theta0;
+        const Real skb    = scale*bb.k*bend;
+        energy += skb*bend; // NOTE: no factor of 1/2
+        if (!calcForces)
+            continue;
+
+        const Real torque = -2*skb;
+        const UnitVec3 p = (rxslen != 0 ? UnitVec3(rxs/rxslen,true)
+                                        : UnitVec3(r).perp());
+        const Vec3 rf = (torque/rr)*(r % p);
+        const Vec3 sf = (torque/ss)*(p % s);
+        const Vec3 cf = -(rf+sf);
+
+        // shouldn't be on the list if all on 1 body
+        assert(!(bb.bc==bb.br && bb.bs==bb.br));
+        const SpatialVec Fr(inclAtomStation_G[bb.r] % rf, rf);
+        const SpatialVec Fc(inclAtomStation_G[bb.c] % cf, cf);
+        const SpatialVec Fs(inclAtomStation_G[bb.s] % sf, sf);
+        if (tf) {
+            tf[0] = Fr; tf[1] = Fc; tf[2] = Fs;
+        } else {
+            inclBodyForces_G[bb.br] += Fr;
+            inclBodyForces_G[bb.bc] += Fc;
+            inclBodyForces_G[bb.bs] += Fs;
+        }
+    }
+}
+//............................CALC BOND BEND RANGE..............................
 
-        const IncludedAtom& a2 = getIncludedAtom(a2num);
-        const IncludedAtom& a3 = getIncludedAtom(a3num);
 
-        // TODO: These might be the same body but for now we don't care.
-        const Vec3& a2Station_G = inclAtomStation_G[a2num];
-        const Vec3& a3Station_G = inclAtomStation_G[a3num];
-        const Vec3& a2Pos_G     = inclAtomPos_G[a2num];
-        const Vec3& a3Pos_G     = inclAtomPos_G[a3num];
 
-        Real angle, e;
-        Vec3 f1, f2, f3;
-        const BondBend& bb = *a1.bend[b13];
+//------------------------------------------------------------------------------
+//                          CALC BOND TORSION RANGE
+//------------------------------------------------------------------------------
+// Helper routine for calcBondedForces(), like calcBondStretchRange() but for
+// the proper or Amber improper torsion terms in the given array, with four
+// force slots per term in the order r, x, y, s. The built-in periodic terms
+// are calculated here exactly as in BondTorsion::calculateAtomForces(),
+// which see for the geometry and the treatment of overlapping atoms.
+void DuMMForceFieldSubsystemRep::calcBondTorsionRange
+   (const Array_<FlatBondTorsion>&      terms,
+    Real                                scale,
+    int                                 begin,
+    int                                 end,
+    const Vector_<Vec3>&                inclAtomStation_G,
+    const Vector_<Vec3>&                inclAtomPos_G,
+    bool                                calcForces,
+    SpatialVec*                         termForces,
+    Vector_<SpatialVec>&                inclBodyForces_G,
+    Real&                               energy) const
+{
+    for (int i=begin; i < end; ++i) {
+        const FlatBondTorsion& bt = terms[i];
+        SpatialVec* tf = (calcForces && termForces) ? termForces + 4*(i-begin)
+                                                    : 0;
+        const Vec3& rG = inclAtomPos_G[bt.r];
+        const Vec3& xG = inclAtomPos_G[bt.x];
+        const Vec3& yG = inclAtomPos_G[bt.y];
+        const Vec3& sG = inclAtomPos_G[bt.s];
+
+        // All vectors point along the r->x->y->s direction
+        const Vec3 r  = xG - rG;
+        const Vec3 s  = sG - yG;
+        const Vec3 xy = yG - xG;
+
+        const Real vv = ~xy*xy;
+        const Real oov = (vv==0 ? Real(0) : 1/std::sqrt(vv));
+        const UnitVec3 v =
+            (oov != 0 ? UnitVec3(xy*oov,true)
+                      : ((r%s).norm() != 0 ? UnitVec3(r % s)
+                                           : UnitVec3(r).perp()));
+
+        const Vec3 t = r % v, u = v % s;
+        const Real tt = ~t*t, uu = ~u*u;
+        if (tt == 0 || uu == 0) { // no energy or torque
+            if (tf) tf[0] = tf[1] = tf[2] = tf[3] = SpatialVec(Vec3(0), Vec3(0));
+            continue;
+        }
 
-        // atom 2 is the central one
-        bb.calculateAtomForces(a2Pos_G, a1Pos_G, a3Pos_G, 
-                               bondBendScaleFactor, customBondBendScaleFactor,
-                               angle, e, f2, f1, f3);
+        const Real ootu  = 1/std::sqrt(tt*uu);
+        const Real cth   = (~t*u)*ootu;
+        const Real sth   = (~v*(t % u))*ootu;
+        const Real theta = std::atan2(sth,cth);
 
-        const DuMMIncludedBodyIndex b2 = a2.inclBodyIndex;
-        const DuMMIncludedBodyIndex b3 = a3.inclBodyIndex;
-        assert(!(b2==b1 && b3==b1)); // shouldn't be on the list if all on 1 body
+        Real pe = 0, torque = 0;
+        for (unsigned j=bt.firstTerm; j != bt.endTerm; ++j) {
+            const TorsionTerm& term = flatTorsionTerms[j];
+            pe     += term.energy(theta);
+            torque += term.torque(theta);
+        }
+        energy += scale*pe;
+        if (!calcForces)
+            continue;
+        torque *= scale;
+
+        const Vec3 ry = yG-rG;
+        const Vec3 xs = sG-xG;
+        const Vec3 dedt =  (torque/tt)*(t % v);
+        const Vec3 dedu = -(torque/uu)*(u % v);
+
+        const Vec3 rf = dedt % v;
+        const Vec3 sf = dedu % v;
+        Vec3 xf, yf;
+        if (oov==0) {
+            xf = -rf;   // No axis; this is just desperation.
+            yf = -sf;
+        } else {
+            xf = ((ry % dedt) + (dedu % s))*oov;
+            yf = ((dedt % r) + (xs % dedu))*oov;
+        }
 
-        energy += e;
-        inclBodyForces_G[b1] += SpatialVec( a1Station_G % f1, f1); // 15 flops
-        inclBodyForces_G[b2] += SpatialVec( a2Station_G % f2, f2); // 15 flops
-        inclBodyForces_G[b3] += SpatialVec( a3Station_G % f3, f3); // 15 flops
+        // shouldn't be on the list if all on 1 body
+        assert(!(bt.bx==bt.br && bt.by==bt.br && bt.bs==bt.br));
+        const SpatialVec Fr(inclAtomStation_G[bt.r] % rf, rf);
+        const SpatialVec Fx(inclAtomStation_G[bt.x] % xf, xf);
+        const SpatialVec Fy(inclAtomStation_G[bt.y] % yf, yf);
+        const SpatialVec Fs(inclAtomStation_G[bt.s] % sf, sf);
+        if (tf) {
+            tf[0] = Fr; tf[1] = Fx; tf[2] = Fy; tf[3] = Fs;
+        } else {
+            inclBodyForces_G[bt.br] += Fr;
+            inclBodyForces_G[bt.bx] += Fx;
+            inclBodyForces_G[bt.by] += Fy;
+            inclBodyForces_G[bt.bs] += Fs;
+        }
     }
 }
-//..............................CALC BOND BEND..................................
+//..........................CALC BOND TORSION RANGE.............................
 
 
 
 //------------------------------------------------------------------------------
-//                              CALC BOND TORSION
+//                           CALC CUSTOM BONDED TERMS
 //------------------------------------------------------------------------------
-// Helper routine for realizeDynamics. This should be called only
-// once it has been determined that we need to calculate bond torsion terms.
-// We're given an atom 1 and we process all the bond torsion forces 
-// involving that atom and three others. To avoid double-counting the 1-4 bond 
-// array force14 for this atom only contain bonds for which this atom's original
-// atom index was less than the atom index of the final atom. (The included atom 
-// index values that are in force14 won't necessarily be ordered the same way.)
-void DuMMForceFieldSubsystemRep::calcBondTorsion
-   (DuMM::IncludedAtomIndex             a1num, 
-    const Vector_<Vec3>&                inclAtomStation_G,
+// Helper routine for calcBondedForces(). Here we evaluate the custom parts of
+// the bonded terms that have them, by asking their parameter objects. There
+// are rarely many of these so this is always done serially.
+void DuMMForceFieldSubsystemRep::calcCustomBondedTerms
+   (const Vector_<Vec3>&                inclAtomStation_G,
     const Vector_<Vec3>&                inclAtomPos_G,
-    Real                                bondTorsionScaleFactor,
-    Real                                customBondTorsionScaleFactor,
+    bool                                calcForces,
     Vector_<SpatialVec>&                inclBodyForces_G,
     Real&                               energy) const
 {
-    const IncludedAtom&           a1    = getIncludedAtom(a1num);
-    const DuMMIncludedBodyIndex   b1    = a1.inclBodyIndex;
-    const Vec3& a1Station_G = inclAtomStation_G[a1num];
-    const Vec3& a1Pos_G     = inclAtomPos_G[a1num];
-
-    for (int b14=0; b14 < (int)a1.force14.size(); ++b14) {
-        const DuMM::IncludedAtomIndex a2num = a1.force14[b14][0];
-        const DuMM::IncludedAtomIndex a3num = a1.force14[b14][1];
-        const DuMM::IncludedAtomIndex a4num = a1.force14[b14][2];
-
-        const IncludedAtom& a2 = getIncludedAtom(a2num);
-        const IncludedAtom& a3 = getIncludedAtom(a3num);
-        const IncludedAtom& a4 = getIncludedAtom(a4num);
-
-        const Vec3& a2Station_G = inclAtomStation_G[a2num];
-        const Vec3& a3Station_G = inclAtomStation_G[a3num];
-        const Vec3& a4Station_G = inclAtomStation_G[a4num];
-        const Vec3& a2Pos_G     = inclAtomPos_G[a2num];
-        const Vec3& a3Pos_G     = inclAtomPos_G[a3num];
-        const Vec3& a4Pos_G     = inclAtomPos_G[a4num];
+    const Real stretchScale = customBondStretchGlobalScaleFactor;
+    for (int i=0; stretchScale != 0 && i < (int)customBondStretches.size(); ++i)
+    {
+        const FlatBondStretch& bs = customBondStretches[i];
+        const Vec3 r = inclAtomPos_G[bs.a2] - inclAtomPos_G[bs.a1];
+        const Real d = r.norm();
+
+        const Array_<DuMM::CustomBondStretch*>& terms = bs.params->customTerms;
+        Real fStretch = 0;
+        for (int j=0; j < (int)terms.size(); ++j) {
+            energy += stretchScale * terms[j]->calcEnergy(d);
+            // expecting f = -dE/dx but can't check
+            if (calcForces)
+                fStretch += stretchScale * terms[j]->calcForce(d);
+        }
+        if (!calcForces)
+            continue;
+
+        const Vec3 f2 = (d==0 ? Vec3(fStretch,0,0) : (fStretch/d)*r);
+        inclBodyForces_G[bs.b2] += SpatialVec(inclAtomStation_G[bs.a2] % f2, f2);
+        inclBodyForces_G[bs.b1] -= SpatialVec(inclAtomStation_G[bs.a1] % f2, f2);
+    }
+
+    const Real bendScale = customBondBendGlobalScaleFactor;
+    for (int i=0; bendScale != 0 && i < (int)customBondBends.size(); ++i) {
+        const FlatBondBend& bb = customBondBends[i];
+        const Vec3& cPos_G = inclAtomPos_G[bb.c];
+        const Vec3& rPos_G = inclAtomPos_G[bb.r];
+        const Vec3& sPos_G = inclAtomPos_G[bb.s];
+
+        if (!calcForces) {
+            energy += bb.params->calculateEnergy(cPos_G, rPos_G, sPos_G,
+                                                 0, bendScale);
+            continue;
+        }
 
         Real angle, e;
-        Vec3 f1, f2, f3, f4;
-        const BondTorsion& bt = *a1.torsion[b14];
-        bt.calculateAtomForces
-           (a1Pos_G, a2Pos_G, a3Pos_G, a4Pos_G, 
-            bondTorsionScaleFactor, customBondTorsionScaleFactor,
-            angle, e, f1, f2, f3, f4);
-
-        const DuMMIncludedBodyIndex b2 = a2.inclBodyIndex;
-        const DuMMIncludedBodyIndex b3 = a3.inclBodyIndex;
-        const DuMMIncludedBodyIndex b4 = a4.inclBodyIndex;
-        assert(!(b2==b1 && b3==b1 && b4==b1)); // shouldn't be on the list if all on 1 body
+        Vec3 cf, rf, sf;
+        bb.params->calculateAtomForces(cPos_G, rPos_G, sPos_G, 0, bendScale,
+                                       angle, e, cf, rf, sf);
+        energy += e;
+        inclBodyForces_G[bb.br] += SpatialVec(inclAtomStation_G[bb.r] % rf, rf);
+        inclBodyForces_G[bb.bc] += SpatialVec(inclAtomStation_G[bb.c] % cf, cf);
+        inclBodyForces_G[bb.bs] += SpatialVec(inclAtomStation_G[bb.s] % sf, sf);
+    }
+
+    const Real torsionScale = customBondTorsionGlobalScaleFactor;
+    for (int i=0; torsionScale != 0 && i < (int)customBondTorsions.size(); ++i)
+    {
+        const FlatBondTorsion& bt = customBondTorsions[i];
+        const Vec3& rPos_G = inclAtomPos_G[bt.r];
+        const Vec3& xPos_G = inclAtomPos_G[bt.x];
+        const Vec3& yPos_G = inclAtomPos_G[bt.y];
+        const Vec3& sPos_G = inclAtomPos_G[bt.s];
+
+        if (!calcForces) {
+            energy += bt.params->calculateEnergy(rPos_G, xPos_G, yPos_G, sPos_G,
+                                                 0, torsionScale);
+            continue;
+        }
 
+        Real angle, e;
+        Vec3 rf, xf, yf, sf;
+        bt.params->calculateAtomForces(rPos_G, xPos_G, yPos_G, sPos_G,
+                                       0, torsionScale, angle, e,
+                                       rf, xf, yf, sf);
         energy += e;
-        inclBodyForces_G[b1] += SpatialVec( a1Station_G % f1, f1); // 15 flops
-        inclBodyForces_G[b2] += SpatialVec( a2Station_G % f2, f2); // 15 flops
-        inclBodyForces_G[b3] += SpatialVec( a3Station_G % f3, f3); // 15 flops
-        inclBodyForces_G[b4] += SpatialVec( a4Station_G % f4, f4); // 15 flops
+        inclBodyForces_G[bt.br] += SpatialVec(inclAtomStation_G[bt.r] % rf, rf);
+        inclBodyForces_G[bt.bx] += SpatialVec(inclAtomStation_G[bt.x] % xf, xf);
+        inclBodyForces_G[bt.by] += SpatialVec(inclAtomStation_G[bt.y] % yf, yf);
+        inclBodyForces_G[bt.bs] += SpatialVec(inclAtomStation_G[bt.s] % sf, sf);
     }
 }
-//..............................CALC BOND TORSION...............................
+//..........................CALC CUSTOM BONDED TERMS............................
 
 
 
 //------------------------------------------------------------------------------
-//                         CALC AMBER IMPROPER TORSION
+//                          class BondedForceTask
 //------------------------------------------------------------------------------
-// Helper routine for realizeDynamics. This should be called only once it has 
-// been determined that we need to calculate Amber improper torsion terms.
-// We're given an atom 1 and we process all the improper torsion forces 
-// involving that atom and two others. Unlike the other bonded terms this one 
-// is counted every time it comes up.
-void DuMMForceFieldSubsystemRep::calcAmberImproperTorsion
-   (DuMM::IncludedAtomIndex             a1num, 
-    const Vector_<Vec3>&                inclAtomStation_G,
+// This is used for calculating the built-in bonded terms in multiple threads.
+// Each unit of work is one of the fixed-size batches of terms set up at
+// topology time. Rather than accumulating, each term writes its forces into
+// its own slots in bondedTermForces and each batch its energy into
+// bondedBatchEnergy, so there are no conflicts between threads.
+// BondedForceReductionTask then sums the slots into the bodies, and the
+// caller sums the batch energies, in a fixed order. The result is thus the
+// same no matter how many threads are used or which thread does what.
+class BondedForceTask : public SimTK::ParallelExecutor::Task {
+public:
+    BondedForceTask
+       (const DuMMForceFieldSubsystemRep& dumm,
+        const Vector_<Vec3>& inclAtomStation_G,
+        const Vector_<Vec3>& inclAtomPos_G, bool calcForces,
+        bool doStretch, bool doBend, bool doTorsion, bool doImproper)
+    :   dumm(dumm), inclAtomStation_G(inclAtomStation_G),
+        inclAtomPos_G(inclAtomPos_G), calcForces(calcForces)
+    {
+        doType[BondedTermBatch::Stretch]         = doStretch;
+        doType[BondedTermBatch::Bend]            = doBend;
+        doType[BondedTermBatch::Torsion]         = doTorsion;
+        doType[BondedTermBatch::ImproperTorsion] = doImproper;
+    }
+
+    void execute(int batchNum) {
+        const BondedTermBatch& batch = dumm.bondedTermBatches[batchNum];
+        SpatialVec* termForces =
+            calcForces ? &dumm.bondedTermForces[batch.firstSlot] : 0;
+        Real& energy = dumm.bondedBatchEnergy[batchNum];
+        energy = 0;
+
+        if (!doType[batch.type]) {
+            if (termForces)
+                for (int i=0; i < batch.getNumSlots(); ++i)
+                    termForces[i] = SpatialVec(Vec3(0), Vec3(0));
+            return;
+        }
+
+        Vector_<SpatialVec> noBodyForces; // not touched when using slots
+        switch (batch.type) {
+        case BondedTermBatch::Stretch:
+            dumm.calcBondStretchRange(batch.begin, batch.end,
+                inclAtomStation_G, inclAtomPos_G, calcForces, termForces,
+                noBodyForces, energy);
+            break;
+        case BondedTermBatch::Bend:
+            dumm.calcBondBendRange(batch.begin, batch.end,
+                inclAtomStation_G, inclAtomPos_G, calcForces, termForces,
+                noBodyForces, energy);
+            break;
+        case BondedTermBatch::Torsion:
+            dumm.calcBondTorsionRange(dumm.flatBondTorsions,
+                dumm.bondTorsionGlobalScaleFactor, batch.begin, batch.end,
+                inclAtomStation_G, inclAtomPos_G, calcForces, termForces,
+                noBodyForces, energy);
+            break;
+        case BondedTermBatch::ImproperTorsion:
+            dumm.calcBondTorsionRange(dumm.flatImproperTorsions,
+                dumm.amberImproperTorsionGlobalScaleFactor,
+                batch.begin, batch.end,
+                inclAtomStation_G, inclAtomPos_G, calcForces, termForces,
+                noBodyForces, energy);
+            break;
+        }
+    }
+
+private:
+    const DuMMForceFieldSubsystemRep&   dumm;
+    const Vector_<Vec3>&                inclAtomStation_G;
+    const Vector_<Vec3>&                inclAtomPos_G;
+    const bool                          calcForces;
+    bool                                doType[BondedTermBatch::NumTermTypes];
+};
+
+//...........................class BondedForceTask..............................
+
+
+
+//------------------------------------------------------------------------------
+//                      class BondedForceReductionTask
+//------------------------------------------------------------------------------
+// After a BondedForceTask has run, this adds each included body's term force
+// slots into its spatial force, in parallel over blocks of bodies. Each
+// body's slots are summed in increasing slot order.
+class BondedForceReductionTask : public SimTK::ParallelExecutor::Task {
+public:
+    static const int BodiesPerBlock = 256;
+
+    BondedForceReductionTask
+       (const DuMMForceFieldSubsystemRep& dumm,
+        Vector_<SpatialVec>& inclBodyForces_G)
+    :   dumm(dumm), inclBodyForces_G(inclBodyForces_G) {}
+
+    static int getNumBlocks(int nBodies)
+    {   return (nBodies + BodiesPerBlock - 1) / BodiesPerBlock; }
+
+    void execute(int block) {
+        const int begin = block*BodiesPerBlock;
+        const int end   = std::min(dumm.getNumIncludedBodies(),
+                                   begin+BodiesPerBlock);
+        for (DuMMIncludedBodyIndex b(begin); b < end; ++b) {
+            SpatialVec F(Vec3(0), Vec3(0));
+            for (unsigned k = dumm.firstBondedSlotOfBody[b];
+                 k != dumm.firstBondedSlotOfBody[DuMMIncludedBodyIndex(b+1)];
+                 ++k)
+                F += dumm.bondedTermForces[dumm.bondedSlotsOfBody[k]];
+            inclBodyForces_G[b] += F;
+        }
+    }
+
+private:
+    const DuMMForceFieldSubsystemRep&   dumm;
+    Vector_<SpatialVec>&                inclBodyForces_G;
+};
+
+//.......................class BondedForceReductionTask.........................
+
+
+
+//------------------------------------------------------------------------------
+//                            CALC BONDED FORCES
+//------------------------------------------------------------------------------
+// Helper routine for calcForcesAndEnergy(). Here we calculate all the bonded
+// (stretch, bend, torsion, and Amber improper torsion) terms. When
+// multithreading is in use the built-in terms are done in parallel by
+// BondedForceTask, whose results don't depend on the number of threads;
+// they may differ in the last bits from the serial calculation since the
+// forces are summed in a different order. Custom terms are done afterwards.
+void DuMMForceFieldSubsystemRep::calcBondedForces
+   (const Vector_<Vec3>&                inclAtomStation_G,
     const Vector_<Vec3>&                inclAtomPos_G,
-    Real                                amberImproperTorsionScaleFactor,
+    bool                                calcForces,
     Vector_<SpatialVec>&                inclBodyForces_G,
     Real&                               energy) const
 {
-    const IncludedAtom&           a1    = getIncludedAtom(a1num);
-    const DuMMIncludedBodyIndex   b1    = a1.inclBodyIndex;
-    const Vec3& a1Station_G = inclAtomStation_G[a1num];
-    const Vec3& a1Pos_G     = inclAtomPos_G[a1num];
-
-    // Note that a1 is the *third* atom in the torsion; the other three
-    // are stored for each entry in forceImproper14.
-    for (int b14=0; b14 < (int)a1.forceImproper14.size(); ++b14) {
-        const DuMM::IncludedAtomIndex a2num = a1.forceImproper14[b14][0];
-        const DuMM::IncludedAtomIndex a3num = a1.forceImproper14[b14][1];
-        const DuMM::IncludedAtomIndex a4num = a1.forceImproper14[b14][2];
-
-        const IncludedAtom& a2 = getIncludedAtom(a2num);
-        const IncludedAtom& a3 = getIncludedAtom(a3num);
-        const IncludedAtom& a4 = getIncludedAtom(a4num);
-
-        const Vec3& a2Station_G = inclAtomStation_G[a2num];
-        const Vec3& a3Station_G = inclAtomStation_G[a3num];
-        const Vec3& a4Station_G = inclAtomStation_G[a4num];
-        const Vec3& a2Pos_G     = inclAtomPos_G[a2num];
-        const Vec3& a3Pos_G     = inclAtomPos_G[a3num];
-        const Vec3& a4Pos_G     = inclAtomPos_G[a4num];
+    const bool doStretch  = bondStretchGlobalScaleFactor != 0;
+    const bool doBend     = bondBendGlobalScaleFactor != 0;
+    const bool doTorsion  = bondTorsionGlobalScaleFactor != 0;
+    const bool doImproper = amberImproperTorsionGlobalScaleFactor != 0;
 
-        Real angle, e;
-        Vec3 f1, f2, f3, f4;
-        const BondTorsion& bt = *a1.aImproperTorsion[b14];
+    if (usingMultithreaded && !bondedTermBatches.empty()) {
+        BondedForceTask task(*this, inclAtomStation_G, inclAtomPos_G,
+                             calcForces, doStretch, doBend, doTorsion,
+                             doImproper);
+        executor->execute(task, (int)bondedTermBatches.size());
+        for (int i=0; i < (int)bondedBatchEnergy.size(); ++i)
+            energy += bondedBatchEnergy[i];
+        if (calcForces) {
+            BondedForceReductionTask reduction(*this, inclBodyForces_G);
+            executor->execute(reduction, BondedForceReductionTask
+                                    ::getNumBlocks(getNumIncludedBodies()));
+        }
+    } else {
+        SpatialVec* noTermForces = 0; // accumulate directly into bodies
+        if (doStretch)
+            calcBondStretchRange(0, (int)flatBondStretches.size(),
+                inclAtomStation_G, inclAtomPos_G, calcForces, noTermForces,
+                inclBodyForces_G, energy);
+        if (doBend)
+            calcBondBendRange(0, (int)flatBondBends.size(),
+                inclAtomStation_G, inclAtomPos_G, calcForces, noTermForces,
+                inclBodyForces_G, energy);
+        if (doTorsion)
+            calcBondTorsionRange(flatBondTorsions, bondTorsionGlobalScaleFactor,
+                0, (int)flatBondTorsions.size(),
+                inclAtomStation_G, inclAtomPos_G, calcForces, noTermForces,
+                inclBodyForces_G, energy);
+        if (doImproper)
+            calcBondTorsionRange(flatImproperTorsions,
+                amberImproperTorsionGlobalScaleFactor,
+                0, (int)flatImproperTorsions.size(),
+                inclAtomStation_G, inclAtomPos_G, calcForces, noTermForces,
+                inclBodyForces_G, energy);
+    }
 
-        bt.calculateAtomForces
-           (a2Pos_G, a3Pos_G, a1Pos_G, a4Pos_G,
-            amberImproperTorsionScaleFactor, 0, // no custom improper
-            angle, e, f2, f3, f1, f4);
+    calcCustomBondedTerms(inclAtomStation_G, inclAtomPos_G, calcForces,
+                          inclBodyForces_G, energy);
+}
+//............................CALC BONDED FORCES................................
 
-        const DuMMIncludedBodyIndex b2 = a2.inclBodyIndex;
-        const DuMMIncludedBodyIndex b3 = a3.inclBodyIndex;
-        const DuMMIncludedBodyIndex b4 = a4.inclBodyIndex;
-        assert(!(b2==b1 && b3==b1 && b4==b1)); // shouldn't be on the list if all on 1 body
 
-        energy += e;
-        inclBodyForces_G[b1] += SpatialVec( a1Station_G % f1, f1); // 15 flops
-        inclBodyForces_G[b2] += SpatialVec( a2Station_G % f2, f2); // 15 flops
-        inclBodyForces_G[b3] += SpatialVec( a3Station_G % f3, f3); // 15 flops
-        inclBodyForces_G[b4] += SpatialVec( a4Station_G % f4, f4); // 15 flops
+
+//------------------------------------------------------------------------------
+//                  PACK NONBOND POSITIONS, UNPACK FORCES
+//------------------------------------------------------------------------------
+// The nonbonded kernels want positions and forces in separate x, y, z arrays
+// indexed by nonbond atom so that consecutive atoms can be loaded into SIMD
+// registers together.
+void DuMMForceFieldSubsystemRep::packNonbondPositions
+   (const Vector_<Vec3>& inclAtomPos_G) const
+{
+    for (DuMM::NonbondAtomIndex nax(0); nax < getNumNonbondAtoms(); ++nax) {
+        const Vec3& p = inclAtomPos_G[getIncludedAtomIndexOfNonbondAtom(nax)];
+        nonbondPosX[nax] = p[0]; nonbondPosY[nax] = p[1]; nonbondPosZ[nax] = p[2];
+        nonbondForceX[nax] = nonbondForceY[nax] = nonbondForceZ[nax] = 0;
+    }
+}
+
+void DuMMForceFieldSubsystemRep::unpackNonbondForces
+   (Vector_<Vec3>& inclAtomForce_G) const
+{
+    for (DuMM::NonbondAtomIndex nax(0); nax < getNumNonbondAtoms(); ++nax)
+        inclAtomForce_G[getIncludedAtomIndexOfNonbondAtom(nax)] += 
+            Vec3(nonbondForceX[nax], nonbondForceY[nax], nonbondForceZ[nax]);
+}
+//.................PACK NONBOND POSITIONS, UNPACK FORCES........................
+
+
+
+//------------------------------------------------------------------------------
+//                         INIT NONBOND KERNEL DATA
+//------------------------------------------------------------------------------
+void DuMMForceFieldSubsystemRep::initNonbondKernelData
+   (DuMMNonbondKernelData& data) const
+{
+    data.x = nonbondPosX.cbegin();
+    data.y = nonbondPosY.cbegin();
+    data.z = nonbondPosZ.cbegin();
+    data.charge       = nonbondCharge.cbegin();
+    data.classIx      = nonbondClassIx.cbegin();
+    data.vdwDij2      = nonbondVdwDij2.cbegin();
+    data.vdwEij       = nonbondVdwEij.cbegin();
+    data.numClasses   = numNonbondClasses;
+    data.coulombFac   = coulombGlobalScaleFactor * CoulombFac;
+    data.vdwFac       = vdwGlobalScaleFactor;
+}
+//.........................INIT NONBOND KERNEL DATA.............................
+
+
+
+//------------------------------------------------------------------------------
+//                         CALC NONBOND ROW FORCES
+//------------------------------------------------------------------------------
+// The scaled partners of nax1 are in increasing order; run the kernel on the
+// gaps between the ones that are in [jBegin,jEnd). Those pairs are done by
+// calcScaledPairNonbondedForces().
+void DuMMForceFieldSubsystemRep::calcNonbondRowForces
+   (DuMMNonbondRowKernel                    rowKernel,
+    const DuMMNonbondKernelData&            data,
+    DuMM::NonbondAtomIndex                  nax1,
+    int                                     jBegin,
+    int                                     jEnd,
+    Real* fx, Real* fy, Real* fz,
+    Real&                                   energy) const
+{
+    int j = jBegin;
+    const unsigned endPair = 
+        firstScaledNonbondPair[DuMM::NonbondAtomIndex(nax1+1)];
+    for (unsigned k = firstScaledNonbondPair[nax1]; k != endPair; ++k) {
+        const int nax2 = scaledNonbondPairs[k].nax2;
+        if (nax2 < j) continue;
+        if (nax2 >= jEnd) break;
+        if (nax2 > j)
+            rowKernel(data, nax1, j, nax2, fx, fy, fz, energy);
+        j = nax2 + 1;
     }
+    if (j < jEnd)
+        rowKernel(data, nax1, j, jEnd, fx, fy, fz, energy);
 }
-//.........................CALC AMBER IMPROPER TORSION..........................
+//.........................CALC NONBOND ROW FORCES..............................
 
 
 
@@ -1545,232 +2631,998 @@ void DuMMForceFieldSubsystemRep::calcAmberImproperTorsion
 //                    CALC BODY SUBSET NONBONDED FORCES
 //------------------------------------------------------------------------------
 // Helper routine for realizeDynamics when nonbonded forces are being calculated
-// on the CPU either single-threaded or in parallel. This is just van der Waals 
-// and Coulomb forces, not GBSA. 
-// TODO: there are *no* cutoffs here.
+// single-threaded on the CPU. This is just van der Waals and Coulomb forces, 
+// not GBSA. 
+// There are *no* cutoffs here; if a cutoff has been requested we use 
+// calcNeighborListNonbondedForces() instead.
 // This is *very* expensive -- code carefully!
 //
 // Strategy:
 //   for a single included body b
 //     for each nonbond atom ab on b
-//          set scale factors on atoms bonded to atom ab
-//          for each body c in range [first,last]
-//            for each nonbond atom ac on c
-//                 compute vector r=ac-ab and distance d=|r|
-//                 compute vdw forces
-//                 compute Coulomb forces
-//                 add force contribution to atoms
-//          reset scale factors on atoms bonded to atom ab
+//          run the row kernel over all nonbond atoms on bodies [first,last],
+//            which are consecutively numbered, in pieces that leave out 
+//            the atoms whose interactions with ab are scaled
 //
+// The scaled pairs are done afterwards by calcScaledPairNonbondedForces().
+// The row kernel (scalar, AVX2, or AVX-512) was chosen at topology time; see
+// DuMMNonbondKernels.cpp for the actual force calculation. If calcForces is
+// false we use the energy-only version of the kernel.
 void DuMMForceFieldSubsystemRep::calcBodySubsetNonbondedForces
    (DuMMIncludedBodyIndex                   dummBodIx,
     DuMMIncludedBodyIndex                   firstIx,
     DuMMIncludedBodyIndex                   lastIx,
-    const Vector_<Vec3>&                    inclAtomPos_G,
-    Array_<Real,DuMM::NonbondAtomIndex>&    vdwScale,    // temps: all 1s
-    Array_<Real,DuMM::NonbondAtomIndex>&    coulombScale,
-    Vector_<Vec3>&                          inclAtomForce_G,
+    bool                                    calcForces,
     Real&                                   energy) const
 {   
+    assert(firstIx > dummBodIx || lastIx < dummBodIx);
     const IncludedBody& inclBod1 = includedBodies[dummBodIx];
 
+    // Nonbond atoms are numbered in included body order so the atoms on 
+    // bodies first through last are a contiguous range.
+    const int jBegin = includedBodies[firstIx].beginNonbondAtoms;
+    const int jEnd   = includedBodies[lastIx].endNonbondAtoms;
+    if (jBegin == jEnd)
+        return;
+
+    DuMMNonbondKernelData data;
+    initNonbondKernelData(data);
+
+    const DuMMNonbondRowKernel rowKernel = 
+        calcForces ? nonbondRowKernel : nonbondEnergyRowKernel;
+
+    Real* fx = nonbondForceX.begin();
+    Real* fy = nonbondForceY.begin();
+    Real* fz = nonbondForceZ.begin();
+
     // Run through every nonbond atom that is attached to this included body.
     for (DuMM::NonbondAtomIndex nax1 = inclBod1.beginNonbondAtoms;
          nax1 != inclBod1.endNonbondAtoms; ++nax1)
+        calcNonbondRowForces(rowKernel, data, nax1, jBegin, jEnd, 
+                             fx, fy, fz, energy);
+}
+//....................CALC BODY SUBSET NONBONDED FORCES.........................
+
+
+
+//------------------------------------------------------------------------------
+//                         CALC NONBOND TILE FORCES
+//------------------------------------------------------------------------------
+// This is the unit of work for the multithreaded all-pairs calculation: the
+// interactions between nonbond atoms in tile block I and those in block J, 
+// I <= J. Atom j interacts with atom i only if it is on a later body than i,
+// which is the case exactly when j is at or past the end of i's body's atoms.
+// That takes care of the diagonal tiles, and of tiles that are entirely 
+// within one body, without any special cases. Positions come from the 
+// structure-of-arrays buffers; forces go into the given buffers.
+void DuMMForceFieldSubsystemRep::calcNonbondTileForces
+   (int                                     blockI,
+    int                                     blockJ,
+    bool                                    calcForces,
+    Real* fx, Real* fy, Real* fz,
+    Real&                                   energy) const
+{
+    assert(blockI <= blockJ);
+    const int nAtoms = getNumNonbondAtoms();
+    const int iBegin = blockI*nonbondedTileSize;
+    const int iEnd   = std::min(nAtoms, iBegin + nonbondedTileSize);
+    const int jBlockBegin = blockJ*nonbondedTileSize;
+    const int jEnd        = std::min(nAtoms, jBlockBegin + nonbondedTileSize);
+
+    DuMMNonbondKernelData data;
+    initNonbondKernelData(data);
+
+    const DuMMNonbondRowKernel rowKernel = 
+        calcForces ? nonbondRowKernel : nonbondEnergyRowKernel;
+
+    for (DuMM::NonbondAtomIndex nax1(iBegin); nax1 < iEnd; ++nax1) {
+        const int jBegin = std::max(jBlockBegin, (int)nonbondEndOfBody[nax1]);
+        if (jBegin < jEnd)
+            calcNonbondRowForces(rowKernel, data, nax1, jBegin, jEnd, 
+                                 fx, fy, fz, energy);
+    }
+}
+//.........................CALC NONBOND TILE FORCES.............................
+
+
+
+//------------------------------------------------------------------------------
+//                       CALC GBSA NONBOND ROW FORCES
+//------------------------------------------------------------------------------
+// The fused counterpart of calcNonbondRowForces(). Atoms of nax1's own body
+// come first (nonbond atoms are grouped by body) and get only the GB term;
+// after that the scaled partners get only the GB term and the gaps between
+// them get everything.
+void DuMMForceFieldSubsystemRep::calcGbsaNonbondRowForces
+   (const DuMMNonbondKernelData&            data,
+    const DuMMGbsaKernelData&               gbsa,
+    bool                                    calcForces,
+    DuMM::NonbondAtomIndex                  nax1,
+    int                                     jBegin,
+    int                                     jEnd,
+    Real* fx, Real* fy, Real* fz,
+    Real*                                   bornForce,
+    Real&                                   energy,
+    Real&                                   gbEnergy) const
+{
+    assert(jBegin > nax1);
+    const DuMMGbsaNonbondRowKernel fusedKernel = 
+        DuMMNonbondKernels::getGbsaRowKernel(true, calcForces);
+    const DuMMGbsaNonbondRowKernel gbsaKernel = 
+        DuMMNonbondKernels::getGbsaRowKernel(false, calcForces);
+
+    int j = jBegin;
+    const int endOfBody = std::min(jEnd, (int)nonbondEndOfBody[nax1]);
+    if (j < endOfBody) {
+        gbsaKernel(data, gbsa, nax1, j, endOfBody, fx, fy, fz, 
+                   bornForce, energy, gbEnergy);
+        j = endOfBody;
+    }
+
+    const unsigned endPair = 
+        firstScaledNonbondPair[DuMM::NonbondAtomIndex(nax1+1)];
+    for (unsigned k = firstScaledNonbondPair[nax1]; k != endPair; ++k) {
+        const int nax2 = scaledNonbondPairs[k].nax2;
+        if (nax2 < j) continue;
+        if (nax2 >= jEnd) break;
+        if (nax2 > j)
+            fusedKernel(data, gbsa, nax1, j, nax2, fx, fy, fz, 
+                        bornForce, energy, gbEnergy);
+        gbsaKernel(data, gbsa, nax1, nax2, nax2+1, fx, fy, fz, 
+                   bornForce, energy, gbEnergy);
+        j = nax2 + 1;
+    }
+    if (j < jEnd)
+        fusedKernel(data, gbsa, nax1, j, jEnd, fx, fy, fz, 
+                    bornForce, energy, gbEnergy);
+}
+//.......................CALC GBSA NONBOND ROW FORCES...........................
+
+
+
+//------------------------------------------------------------------------------
+//                       CALC GBSA NONBOND TILE FORCES
+//------------------------------------------------------------------------------
+// The fused counterpart of calcNonbondTileForces(): all pairs i < j between
+// tile blocks I and J, since GB needs the same-body pairs as well.
+void DuMMForceFieldSubsystemRep::calcGbsaNonbondTileForces
+   (int                                     blockI,
+    int                                     blockJ,
+    bool                                    calcForces,
+    const DuMMGbsaKernelData&               gbsa,
+    Real* fx, Real* fy, Real* fz,
+    Real*                                   bornForce,
+    Real&                                   energy,
+    Real&                                   gbEnergy) const
+{
+    assert(blockI <= blockJ);
+    const int nAtoms = getNumNonbondAtoms();
+    const int iBegin = blockI*nonbondedTileSize;
+    const int iEnd   = std::min(nAtoms, iBegin + nonbondedTileSize);
+    const int jBlockBegin = blockJ*nonbondedTileSize;
+    const int jEnd        = std::min(nAtoms, jBlockBegin + nonbondedTileSize);
+
+    DuMMNonbondKernelData data;
+    initNonbondKernelData(data);
+
+    for (DuMM::NonbondAtomIndex nax1(iBegin); nax1 < iEnd; ++nax1) {
+        const int jBegin = std::max(jBlockBegin, nax1+1);
+        if (jBegin < jEnd)
+            calcGbsaNonbondRowForces(data, gbsa, calcForces, nax1, jBegin, 
+                                     jEnd, fx, fy, fz, bornForce, 
+                                     energy, gbEnergy);
+    }
+}
+//.......................CALC GBSA NONBOND TILE FORCES..........................
+
+
+
+//------------------------------------------------------------------------------
+//                          CALC NONBONDED FORCES
+//------------------------------------------------------------------------------
+// This is the single-threaded nonbonded force calculation (not including GBSA). 
+// For each included body, we calculate its interactions with all 
+// higher-numbered included bodies.
+void DuMMForceFieldSubsystemRep::calcNonbondedForces
+   (const Vector_<Vec3>&                inclAtomPos_G,
+    bool                                calcForces,
+    Vector_<Vec3>&                      inclAtomForce_G,
+    Real&                               energy) const
+{             
+    packNonbondPositions(inclAtomPos_G);
+    for (DuMMIncludedBodyIndex inclBodyIx(0); 
+         inclBodyIx < getNumIncludedBodies()-1; ++inclBodyIx) 
     {
-        DuMM::IncludedAtomIndex iax1 = getIncludedAtomIndexOfNonbondAtom(nax1);
-        const IncludedAtom& a1 = getIncludedAtom(iax1);
-        const ChargedAtomType& a1type = chargedAtomTypes[a1.chargedAtomTypeIndex];
-        const DuMM::AtomClassIndex a1cnum = a1type.atomClassIx;
-        const AtomClass&           a1class = atomClasses[a1cnum];
-        const Vec3&                a1Pos_G = inclAtomPos_G[iax1];
-
-        const Real q1Fac = coulombGlobalScaleFactor
-                                * CoulombFac * a1type.partialCharge;
-
-        // Set scale factors for all closely-bonded atoms to a1 that are
-        // involved in nonbond calculations.
-        scaleBondedAtoms(a1,vdwScale,coulombScale);
-
-        // We'll update this element repeatedly below so get a reference
-        // to it once outside the loop.
-        Vec3& afrc1_G = inclAtomForce_G[iax1];
-
-        for (DuMMIncludedBodyIndex dbx2 = firstIx; dbx2 <= lastIx; ++dbx2) {
-            assert(dbx2 != dummBodIx);
-            const IncludedBody& inclBod2 = includedBodies[dbx2];
-
-            // Run through all the nonbond atoms that are attached to this body.
-            for (DuMM::NonbondAtomIndex nax2 = inclBod2.beginNonbondAtoms;
-                 nax2 != inclBod2.endNonbondAtoms; ++nax2)
-            {
-                DuMM::IncludedAtomIndex iax2 = 
-                    getIncludedAtomIndexOfNonbondAtom(nax2);
-                assert(iax2 != iax1);
-                const IncludedAtom& a2 = getIncludedAtom(iax2);
-                const ChargedAtomType& a2type  = chargedAtomTypes[a2.chargedAtomTypeIndex];
-                const DuMM::AtomClassIndex a2cnum  = a2type.atomClassIx;
-                const AtomClass& a2class = atomClasses[a2cnum];
-                const Vec3&      a2Pos_G = inclAtomPos_G[iax2];
-
-                const Vec3  r  = a2Pos_G - a1Pos_G; // from a1 to a2 (3 flops)
-                const Real  d2 = r.normSqr() ;     // 5 flops
+        calcBodySubsetNonbondedForces(
+            inclBodyIx, 
+            DuMMIncludedBodyIndex(inclBodyIx + 1),
+            DuMMIncludedBodyIndex(getNumIncludedBodies()-1),
+            calcForces, energy);
+    }
+    if (calcForces)
+        unpackNonbondForces(inclAtomForce_G);
+}
+//............................CALC NONBONDED FORCES.............................
 
-                // Check for cutoffs on d2?
 
-                const Real  ood = 1/std::sqrt(d2); // approx 40 flops
-                const Real  ood2 = ood*ood;        // 1 flop
 
-                // Coulombic electrostatic force
-                const Real qq = coulombScale[nax2] // 2 flops
-                                    * q1Fac * a2type.partialCharge; 
-                // e = scale*(1/(4*pi*e0)) *  q1*q2/d 
-                const Real eCoulomb = qq * ood;     // 1 flop 
-                // f = -[scale*(1/(4*pi*e0)) * -q1*q2/d^2] * r 
-                // Note: we're missing a factor of 1/d^2 here; see below.
-                const Real fCoulomb = eCoulomb; 
+//------------------------------------------------------------------------------
+//                        class NonbondedForceTask
+//------------------------------------------------------------------------------
+// This class is used by realizeDynamics for calculating all-pairs nonbonded 
+// interactions in multiple threads. The units of work are fixed-size tiles of
+// the atom-atom interaction matrix (see calcNonbondTileForces()), so the load
+// balances well whether there are thousands of tiny bodies or a few huge ones.
+//
+// The tiles are dealt out in contiguous ranges, one per worker, which keeps
+// each thread working on neighboring tiles that share atoms. A worker that has
+// finished its own range steals tiles from the other workers' ranges. Each
+// range is just an atomic counter so owner and thieves can't get the same 
+// tile. Since simultaneously executing tiles can share atoms, each thread 
+// accumulates forces into its own buffers; the buffers are registered here 
+// and summed afterwards by NonbondedForceReductionTask.
+//
+// If GBSA kernel data is supplied the tiles are done with the fused GBSA
+// kernels (see calcFusedGbsaNonbondedForces()); then each thread also has
+// its own Born force buffer, and the unscaled GB energy goes to gbEnergy.
+class NonbondedForceTask : public SimTK::ParallelExecutor::Task {
+public:
+    NonbondedForceTask
+       (const DuMMForceFieldSubsystemRep& dumm, int numWorkers,
+        bool calcForces, Real& energy,
+        const DuMMGbsaKernelData* gbsa=0, Real* gbEnergy=0) 
+    :   dumm(dumm), numWorkers(numWorkers), calcForces(calcForces), 
+        globalEnergy(energy), gbsa(gbsa), globalGbEnergy(gbEnergy),
+        ranges(new WorkRange[numWorkers])
+    {
+        const long long numTiles = dumm.nonbondTileRowStart.back();
+        for (int w=0; w < numWorkers; ++w) {
+            ranges[w].next = (numTiles*w)/numWorkers;
+            ranges[w].end  = (numTiles*(w+1))/numWorkers;
+        }
+    }
 
-                // van der Waals forces
+    // Each thread zeroes its own energy accumulator and force buffers and 
+    // registers the buffers for the reduction.
+    void initialize() {
+        localEnergy = localGbEnergy = 0;
+        if (!calcForces)
+            return;
+        const int nAtoms = dumm.getNumNonbondAtoms();
+        localForceX.resize(nAtoms); localForceX.fill(0);
+        localForceY.resize(nAtoms); localForceY.fill(0);
+        localForceZ.resize(nAtoms); localForceZ.fill(0);
+        if (gbsa) {
+            localBornForce.resize(nAtoms); localBornForce.fill(0);
+        }
+        std::lock_guard<std::mutex> lock(finishMutex);
+        threadForceX.push_back(localForceX.begin());
+        threadForceY.push_back(localForceY.begin());
+        threadForceZ.push_back(localForceZ.begin());
+        if (gbsa)
+            threadBornForce.push_back(localBornForce.begin());
+    }
+
+    // At the end of execution, each thread adds its local energy contribution
+    // to the global total. Threads finish concurrently.
+    void finish() {
+        std::lock_guard<std::mutex> lock(finishMutex);
+        globalEnergy += localEnergy;
+        if (gbsa)
+            *globalGbEnergy += localGbEnergy;
+    }
 
-                // Get precomputed mixed dmin and emin. Must ask the lower-numbered atom class.
-                Real dij, eij;
-                if (a1cnum <= a2cnum) {
-                    dij = a1class.vdwDij[a2cnum-a1cnum];
-                    eij = a1class.vdwEij[a2cnum-a1cnum];
+    // Work on our own range of tiles, then help out with the others.
+    void execute(int worker) {
+        for (int v=0; v < numWorkers; ++v) {
+            WorkRange& range = ranges[(worker+v) % numWorkers];
+            for (;;) {
+                const long long tile = range.next++;
+                if (tile >= range.end)
+                    break;
+                executeTile(tile);
+            }
+        }
+    }
+
+    int getNumThreadBuffers() const {return (int)threadForceX.size();}
+    const Real* getThreadForceX(int t) const {return threadForceX[t];}
+    const Real* getThreadForceY(int t) const {return threadForceY[t];}
+    const Real* getThreadForceZ(int t) const {return threadForceZ[t];}
+    // Null unless the GBSA kernels are in use.
+    const Real* getThreadBornForce(int t) const 
+    {   return gbsa ? threadBornForce[t] : 0; }
+
+private:
+    struct WorkRange {
+        std::atomic<long long>  next;
+        long long               end;
+    };
+
+    void executeTile(long long tile) {
+        const Array_<long long>& rowStart = dumm.nonbondTileRowStart;
+        const int blockI = int(std::upper_bound(rowStart.begin(), 
+                                                rowStart.end(), tile)
+                               - rowStart.begin()) - 1;
+        const int blockJ = blockI + int(tile - rowStart[blockI]);
+        if (gbsa)
+            dumm.calcGbsaNonbondTileForces(blockI, blockJ, calcForces, *gbsa,
+                                   localForceX.begin(), localForceY.begin(),
+                                   localForceZ.begin(), localBornForce.begin(),
+                                   localEnergy, localGbEnergy);
+        else
+            dumm.calcNonbondTileForces(blockI, blockJ, calcForces,
+                                   localForceX.begin(), localForceY.begin(),
+                                   localForceZ.begin(), localEnergy);
+    }
+
+    const DuMMForceFieldSubsystemRep&   dumm;
+    const int                           numWorkers;
+    const bool                          calcForces;
+    Real&                               globalEnergy;
+    const DuMMGbsaKernelData*           gbsa;
+    Real*                               globalGbEnergy;
+    std::unique_ptr<WorkRange[]>        ranges;
+    std::mutex                          finishMutex;
+    std::vector<Real*>                  threadForceX, threadForceY, 
+                                        threadForceZ, threadBornForce;
+
+    // Thread local temporaries.
+    // SCF had trouble with these, converted to regular variables (non-thread-local) 
+    //ThreadLocal< Real >                                 localEnergy;
+    static thread_local Real                                 localEnergy;
+    static thread_local Real                                 localGbEnergy;
+    static thread_local Array_<Real, DuMM::NonbondAtomIndex> localForceX;
+    static thread_local Array_<Real, DuMM::NonbondAtomIndex> localForceY;
+    static thread_local Array_<Real, DuMM::NonbondAtomIndex> localForceZ;
+    static thread_local Array_<Real, DuMM::NonbondAtomIndex> localBornForce;
+};
+
+thread_local Real                                 NonbondedForceTask::localEnergy;
+thread_local Real                                 NonbondedForceTask::localGbEnergy;
+thread_local Array_<Real, DuMM::NonbondAtomIndex> NonbondedForceTask::localForceX;
+thread_local Array_<Real, DuMM::NonbondAtomIndex> NonbondedForceTask::localForceY;
+thread_local Array_<Real, DuMM::NonbondAtomIndex> NonbondedForceTask::localForceZ;
+thread_local Array_<Real, DuMM::NonbondAtomIndex> NonbondedForceTask::localBornForce;
+
+//..........................class NonbondedForceTask............................
+
+
+
+//------------------------------------------------------------------------------
+//                    class NonbondedForceReductionTask
+//------------------------------------------------------------------------------
+// After a NonbondedForceTask has run, this sums the per-thread force buffers
+// into the nonbond force buffers, in parallel over contiguous blocks of atoms.
+// Each atom's forces are summed in thread buffer order. The per-thread Born
+// forces of the fused GBSA calculation are added to bornForce in the same way.
+class NonbondedForceReductionTask : public SimTK::ParallelExecutor::Task {
+public:
+    static const int AtomsPerBlock = 1024;
+
+    NonbondedForceReductionTask
+       (const DuMMForceFieldSubsystemRep& dumm, const NonbondedForceTask& task,
+        Real* bornForce=0)
+    :   dumm(dumm), task(task), bornForce(bornForce) {}
+
+    static int getNumBlocks(int nAtoms) 
+    {   return (nAtoms + AtomsPerBlock - 1) / AtomsPerBlock; }
+
+    void execute(int block) {
+        const int begin = block*AtomsPerBlock;
+        const int end   = std::min(dumm.getNumNonbondAtoms(), 
+                                   begin+AtomsPerBlock);
+        Real* fx = dumm.nonbondForceX.begin();
+        Real* fy = dumm.nonbondForceY.begin();
+        Real* fz = dumm.nonbondForceZ.begin();
+        for (int t=0; t < task.getNumThreadBuffers(); ++t) {
+            const Real* tfx = task.getThreadForceX(t);
+            const Real* tfy = task.getThreadForceY(t);
+            const Real* tfz = task.getThreadForceZ(t);
+            for (int i=begin; i < end; ++i) {
+                fx[i] += tfx[i]; fy[i] += tfy[i]; fz[i] += tfz[i];
+            }
+            if (bornForce) {
+                const Real* tbf = task.getThreadBornForce(t);
+                for (int i=begin; i < end; ++i)
+                    bornForce[i] += tbf[i];
+            }
+        }
+    }
+
+private:
+    const DuMMForceFieldSubsystemRep&   dumm;
+    const NonbondedForceTask&           task;
+    Real*                               bornForce;
+};
+
+//...................class NonbondedForceReductionTask.........................
+
+
+
+
+//------------------------------------------------------------------------------
+//                      IS NEIGHBOR LIST REBUILD NEEDED
+//------------------------------------------------------------------------------
+// The neighbor list contains every cross-body pair that was within 
+// cutoff+skin when it was built. It remains valid (i.e., contains every pair
+// now within the cutoff) as long as no atom has moved more than half the skin
+// since then, because two atoms can then have closed their separation by at
+// most the skin thickness.
+bool DuMMForceFieldSubsystemRep::isNeighborListRebuildNeeded
+   (const Vector_<Vec3>&        inclAtomPos_G,
+    const NonbondNeighborList&  list) const
+{
+    if (list.isEmpty() 
+        || list.builtPos_G.size() != nonbondAtoms.size()
+        || list.listRadius != nonbondedCutoff + neighborListSkin)
+        return true;
+
+    const Real halfSkin = neighborListSkin / 2;
+    const Real maxMove2 = halfSkin*halfSkin;
+    for (DuMM::NonbondAtomIndex nax(0); nax < getNumNonbondAtoms(); ++nax) {
+        const Vec3& aPos_G = 
+            inclAtomPos_G[getIncludedAtomIndexOfNonbondAtom(nax)];
+        if ((aPos_G - list.builtPos_G[nax]).normSqr() > maxMove2)
+            return true;
+    }
+    return false;
+}
+//.......................IS NEIGHBOR LIST REBUILD NEEDED........................
+
+
+
+//------------------------------------------------------------------------------
+//                        BUILD NONBOND NEIGHBOR LIST
+//------------------------------------------------------------------------------
+// Build the Verlet list of cross-body nonbond atom pairs that are within 
+// cutoff+skin of one another. We bin the atoms into a grid of cells whose 
+// edges are at least cutoff+skin long, so that all candidates for an atom are
+// in its own cell or one of the 26 cells that surround it. Binning is done
+// with a counting sort so the cell contents are contiguous. The cost is 
+// linear in the number of atoms for systems of roughly uniform density.
+//
+// Each atom's partners are only higher-numbered atoms on other bodies. 
+// Nonbond atoms are grouped by body, so that is every atom at or past the end
+// of the current atom's body. Partners are sorted so the result doesn't 
+// depend on the order in which cells are visited. We work through the bodies
+// in order, collecting the partners of all of one body's atoms and then 
+// regrouping them by partner body to form that body's body pairs.
+void DuMMForceFieldSubsystemRep::buildNonbondNeighborList
+   (const Vector_<Vec3>&        inclAtomPos_G,
+    NonbondNeighborList&        list) const
+{
+    const int  nAtoms   = getNumNonbondAtoms();
+    const Real rList    = nonbondedCutoff + neighborListSkin;
+    const Real rList2   = rList*rList;
+
+    list.clear();
+    list.listRadius = rList;
+    list.builtPos_G.resize(nAtoms);
+    ++neighborListBuildCount;
+
+    // Collect positions and the bounding box. In a periodic box the grid 
+    // covers the box itself and we bin the atoms' primary images.
+    Array_<Vec3, DuMM::NonbondAtomIndex> binPos(nAtoms);
+    Vec3 lo(Infinity), hi(-Infinity);
+    for (DuMM::NonbondAtomIndex nax(0); nax < nAtoms; ++nax) {
+        const Vec3& p = inclAtomPos_G[getIncludedAtomIndexOfNonbondAtom(nax)];
+        list.builtPos_G[nax] = binPos[nax] = p;
+        for (int k=0; k<3; ++k) {
+            if (usePeriodicBox)
+                binPos[nax][k] -= periodicBox[k]
+                                  * std::floor(p[k]/periodicBox[k]);
+            lo[k] = std::min(lo[k], binPos[nax][k]);
+            hi[k] = std::max(hi[k], binPos[nax][k]);
+        }
+    }
+    if (usePeriodicBox) {
+        lo = Vec3(0);
+        hi = periodicBox;
+    }
+
+    // Choose the grid. Cells must be at least rList on a side. For very 
+    // sparse systems we make the cells bigger to limit the number of (mostly
+    // empty) cells. With periodic wrapping we need at least three cells
+    // along an axis for the 27-cell neighborhood to be distinct; otherwise
+    // we use just one cell along that axis.
+    int nCell[3];
+    for (int k=0; k<3; ++k)
+        nCell[k] = nAtoms ? std::max(1, (int)std::floor((hi[k]-lo[k])/rList))
+                          : 1;
+    const long long maxCells = 4*(long long)nAtoms + 64;
+    while ((long long)nCell[0]*nCell[1]*nCell[2] > maxCells) {
+        const int k = nCell[0] >= nCell[1] 
+                        ? (nCell[0] >= nCell[2] ? 0 : 2)
+                        : (nCell[1] >= nCell[2] ? 1 : 2);
+        nCell[k] = std::max(1, nCell[k]/2);
+    }
+    if (usePeriodicBox)
+        for (int k=0; k<3; ++k)
+            if (nCell[k] < 3) nCell[k] = 1;
+    Vec3 cellsPerNm;
+    for (int k=0; k<3; ++k) {
+        const Real extent = hi[k]-lo[k];
+        cellsPerNm[k] = extent > 0 ? nCell[k]/extent : Real(0);
+    }
+    const int nCells = nCell[0]*nCell[1]*nCell[2];
+
+    // Counting sort of atoms into cells.
+    Array_<int> atomCell(nAtoms), cellStart(nCells+1, 0), cellAtoms(nAtoms);
+    for (DuMM::NonbondAtomIndex nax(0); nax < nAtoms; ++nax) {
+        int c[3];
+        for (int k=0; k<3; ++k)
+            c[k] = std::max(0, std::min(nCell[k]-1, 
+                       (int)((binPos[nax][k]-lo[k])*cellsPerNm[k])));
+        atomCell[nax] = (c[2]*nCell[1] + c[1])*nCell[0] + c[0];
+        ++cellStart[atomCell[nax]+1];
+    }
+    for (int c=0; c < nCells; ++c)
+        cellStart[c+1] += cellStart[c];
+    {   Array_<int> fill(cellStart.begin(), cellStart.end()-1);
+        for (int i=0; i < nAtoms; ++i)
+            cellAtoms[fill[atomCell[i]]++] = i; }
+
+    // Search the 27-cell neighborhood of each atom. The partners of one 
+    // body's atoms go in bodyNbrs, one segment per atom and partner body.
+    Array_<DuMM::NonbondAtomIndex> row, bodyNbrs;
+    Array_<NonbondNeighborList::Segment> bodySegs;
+    Array_<std::pair<DuMMIncludedBodyIndex,int> > segOrder; // body2, segment
+    for (DuMMIncludedBodyIndex dbx(0); dbx < getNumIncludedBodies(); ++dbx) {
+        const IncludedBody& inclBod = includedBodies[dbx];
+        bodyNbrs.clear(); bodySegs.clear(); segOrder.clear();
+        for (DuMM::NonbondAtomIndex nax1 = inclBod.beginNonbondAtoms;
+             nax1 != inclBod.endNonbondAtoms; ++nax1) {
+            const DuMM::NonbondAtomIndex firstCandidate = 
+                nonbondEndOfBody[nax1];
+            if (firstCandidate == nAtoms)
+                continue; // no atoms on later bodies
+
+            const Vec3& p1 = list.builtPos_G[nax1];
+            const int c = atomCell[nax1];
+            const int cell[3] = {c % nCell[0], (c / nCell[0]) % nCell[1],
+                                 c / (nCell[0]*nCell[1])};
+
+            // Neighboring cell coordinates along each axis.
+            int nbrCell[3][3], nNbrCells[3];
+            for (int k=0; k<3; ++k) {
+                nNbrCells[k] = 0;
+                for (int off=-1; off <= 1; ++off) {
+                    int ck = cell[k] + off;
+                    if (usePeriodicBox) {
+                        if (nCell[k] == 1 && off != 0) continue;
+                        ck = (ck + nCell[k]) % nCell[k];
+                    } else if (ck < 0 || ck >= nCell[k]) continue;
+                    nbrCell[k][nNbrCells[k]++] = ck;
+                }
+            }
+
+            row.clear();
+            for (int iz=0; iz < nNbrCells[2]; ++iz)
+            for (int iy=0; iy < nNbrCells[1]; ++iy)
+            for (int ix=0; ix < nNbrCells[0]; ++ix) {
+                const int c2 = 
+                    (nbrCell[2][iz]*nCell[1] + nbrCell[1][iy])*nCell[0] 
+                    + nbrCell[0][ix];
+                for (int k = cellStart[c2]; k < cellStart[c2+1]; ++k) {
+                    const DuMM::NonbondAtomIndex nax2(cellAtoms[k]);
+                    if (nax2 < firstCandidate) continue;
+                    const Vec3 r = 
+                        applyMinimumImage(list.builtPos_G[nax2] - p1);
+                    if (r.normSqr() <= rList2)
+                        row.push_back(nax2);
+                }
+            }
+            std::sort(row.begin(), row.end());
+
+            // Leave out the scaled pairs; both lists are in increasing order.
+            // Start a new segment whenever the partner body changes.
+            unsigned k = firstScaledNonbondPair[nax1];
+            const unsigned endPair = 
+                firstScaledNonbondPair[DuMM::NonbondAtomIndex(nax1+1)];
+            DuMM::NonbondAtomIndex endOfBody2(0);
+            for (unsigned n=0; n < row.size(); ++n) {
+                while (k != endPair && scaledNonbondPairs[k].nax2 < row[n]) ++k;
+                if (k != endPair && scaledNonbondPairs[k].nax2 == row[n])
+                    continue;
+                if (row[n] >= endOfBody2) {
+                    endOfBody2 = nonbondEndOfBody[row[n]];
+                    segOrder.push_back(std::make_pair(nonbondBodyIx[row[n]], 
+                                                      (int)bodySegs.size()));
+                    NonbondNeighborList::Segment seg;
+                    seg.nax1     = nax1;
+                    seg.firstNbr = bodyNbrs.size();
+                    bodySegs.push_back(seg);
+                }
+                bodyNbrs.push_back(row[n]);
+                bodySegs.back().endNbr = bodyNbrs.size();
+            }
+        }
+
+        // Regroup this body's segments by partner body; within a body pair 
+        // they stay in atom order.
+        std::sort(segOrder.begin(), segOrder.end());
+        for (unsigned i=0; i < segOrder.size(); ++i) {
+            const DuMMIncludedBodyIndex body2 = segOrder[i].first;
+            if (i == 0 || body2 != segOrder[i-1].first) {
+                NonbondNeighborList::BodyPair bodyPair;
+                bodyPair.body1        = dbx;
+                bodyPair.body2        = body2;
+                bodyPair.firstSegment = list.segments.size();
+                list.bodyPairs.push_back(bodyPair);
+            }
+            const NonbondNeighborList::Segment& from = 
+                bodySegs[segOrder[i].second];
+            NonbondNeighborList::Segment seg;
+            seg.nax1     = from.nax1;
+            seg.firstNbr = list.neighbors.size();
+            for (unsigned n = from.firstNbr; n != from.endNbr; ++n)
+                list.neighbors.push_back(bodyNbrs[n]);
+            seg.endNbr   = list.neighbors.size();
+            list.segments.push_back(seg);
+            list.bodyPairs.back().endSegment = list.segments.size();
+        }
+    }
+}
+//........................BUILD NONBOND NEIGHBOR LIST...........................
+
+
+
+//------------------------------------------------------------------------------
+//                   CALC NEIGHBOR LIST NONBONDED FORCES
+//------------------------------------------------------------------------------
+// This is the cutoff version of calcBodySubsetNonbondedForces(). For each
+// body pair in [beginBodyPair,endBodyPair) of the neighbor list we first check
+// whether the two bodies' bounding spheres are now out of range of one 
+// another, and if so skip all of that body pair's atom pairs. Otherwise we 
+// visit the candidate pairs, skipping those that are currently beyond the 
+// cutoff. Scaled pairs of closely-bonded atoms were left out of the neighbor
+// list. In a periodic box we use the nearest image of each partner atom, and
+// if Ewald electrostatics are in use this calculates the real space part.
+// Forces are skipped if calcForces is false.
+void DuMMForceFieldSubsystemRep::calcNeighborListNonbondedForces
+   (int                                     beginBodyPair,
+    int                                     endBodyPair,
+    const NonbondNeighborList&              list,
+    const Vector_<Vec3>&                    inclAtomPos_G,
+    const Vector_<Vec3>&                    inclBodySphereCenter_G,
+    bool                                    calcForces,
+    Vector_<Vec3>&                          inclAtomForce_G,
+    Real&                                   energy) const
+{
+    const Real cutoff2 = nonbondedCutoff*nonbondedCutoff;
+
+    for (int bp = beginBodyPair; bp != endBodyPair; ++bp) {
+        const NonbondNeighborList::BodyPair& bodyPair = list.bodyPairs[bp];
+        if (areBodiesBeyondCutoff(bodyPair.body1, bodyPair.body2, 
+                                  inclBodySphereCenter_G))
+            continue;
+
+        for (unsigned sg = bodyPair.firstSegment; 
+             sg != bodyPair.endSegment; ++sg) 
+        {
+            const NonbondNeighborList::Segment& seg = list.segments[sg];
+            const DuMM::NonbondAtomIndex nax1 = seg.nax1;
+
+            DuMM::IncludedAtomIndex iax1 = 
+                getIncludedAtomIndexOfNonbondAtom(nax1);
+            const Vec3&         a1Pos_G = inclAtomPos_G[iax1];
+
+            const Real q1Fac = coulombGlobalScaleFactor
+                                    * CoulombFac * nonbondCharge[nax1];
+
+            // Row of the van der Waals tables for a1's atom class.
+            const int   a1Row     = nonbondClassIx[nax1]*numNonbondClasses;
+            const Real* vdwDij2_1 = &nonbondVdwDij2[a1Row];
+            const Real* vdwEij_1  = &nonbondVdwEij[a1Row];
+
+            Vec3& afrc1_G = inclAtomForce_G[iax1];
+
+            for (unsigned k = seg.firstNbr; k != seg.endNbr; ++k) {
+                const DuMM::NonbondAtomIndex nax2 = list.neighbors[k];
+                DuMM::IncludedAtomIndex iax2 = 
+                    getIncludedAtomIndexOfNonbondAtom(nax2);
+                const Vec3& a2Pos_G = inclAtomPos_G[iax2];
+
+                // From a1 to a2, or to the nearest image of a2 if periodic.
+                const Vec3  r  = applyMinimumImage(a2Pos_G - a1Pos_G);
+                const Real  d2 = r.normSqr() ;     // 5 flops
+                if (d2 > cutoff2)
+                    continue;
+
+                const Real  ood = 1/std::sqrt(d2);
+                const Real  ood2 = ood*ood;
+
+                // Coulombic electrostatic force 
+                // (see calcBodySubsetNonbondedForces)
+                const Real qq = q1Fac * nonbondCharge[nax2]; 
+                Real eCoulomb, fCoulomb; // fCoulomb is missing 1/d^2
+                if (usingEwald) {
+                    // Real space part of the Ewald sum: 
+                    // e = qq*erfc(alpha*d)/d.
+                    const Real alphaD = ewaldAlpha*d2*ood;
+                    const Real erfcAlphaD = std::erfc(alphaD);
+                    eCoulomb = qq * erfcAlphaD * ood;
+                    fCoulomb = calcForces 
+                        ? eCoulomb + qq * TwoOverSqrtPi * ewaldAlpha 
+                                        * std::exp(-alphaD*alphaD)
+                        : 0;
                 } else {
-                    dij = a2class.vdwDij[a1cnum-a2cnum];
-                    eij = a2class.vdwEij[a1cnum-a2cnum];
+                    eCoulomb = qq * ood;
+                    fCoulomb = eCoulomb;
                 }
 
-                // 5 flops
-                const Real ddij2  = dij*dij*ood2;   // (dmin_ij/d)^2
+                // van der Waals forces
+                const int  a2cnum = nonbondClassIx[nax2];
+                const Real eij    = vdwEij_1[a2cnum];
+
+                const Real ddij2  = vdwDij2_1[a2cnum]*ood2;   // (dmin_ij/d)^2
                 const Real ddij6  = ddij2*ddij2*ddij2;
                 const Real ddij12 = ddij6*ddij6;
 
-                // 8 flops
-                const Real eijScale = vdwGlobalScaleFactor*vdwScale[nax2]*eij;
+                const Real eijScale = vdwGlobalScaleFactor*eij;
                 const Real eVdw     =      eijScale * (ddij12 - 2*ddij6);
-                // Note: factor of 1/d^2 missing here; see below.
-                const Real fVdw     = 12 * eijScale * (ddij12 -   ddij6); 
-
-                // Here's where we restore the missing 1/d^2. This
-                // is the force to apply to atom 2; apply equal and
-                // opposite to atom 1.
-                const Vec3 fj = ((fCoulomb+fVdw)*ood2) * r; // 5 flops
-
-                // kJ (Da-nm^2/ps^2)        // 2 flops 
-                energy                += (eCoulomb + eVdw); 
-                inclAtomForce_G[iax2] += fj;   // 3 flops
-                afrc1_G               -= fj;   // 3 flops
-            }
-        }
-            
-        // This is the end of the outer atom loop. We're done with atom a1.
-        unscaleBondedAtoms(a1,vdwScale,coulombScale);
-    }
-}
-//....................CALC BODY SUBSET NONBONDED FORCES.........................
 
+                energy += (eCoulomb + eVdw); 
+                if (!calcForces)
+                    continue;
 
+                const Real fVdw = 12 * eijScale * (ddij12 - ddij6); 
 
-//------------------------------------------------------------------------------
-//                          CALC NONBONDED FORCES
-//------------------------------------------------------------------------------
-// This is the single-threaded nonbonded force calculation (not including GBSA). 
-// For each included body, we calculate its interactions with all 
-// higher-numbered included bodies.
-void DuMMForceFieldSubsystemRep::calcNonbondedForces
-   (const Vector_<Vec3>&                inclAtomPos_G,
-    Vector_<Vec3>&                      inclAtomForce_G,
-    Real&                               energy) const
-{             
-    for (DuMMIncludedBodyIndex inclBodyIx(0); 
-         inclBodyIx < getNumIncludedBodies(); ++inclBodyIx) 
-    {
-        calcBodySubsetNonbondedForces(
-            inclBodyIx, 
-            DuMMIncludedBodyIndex(inclBodyIx + 1),
-            DuMMIncludedBodyIndex(getNumIncludedBodies()-1),
-            inclAtomPos_G,
-            vdwScaleSingleThread,     // these 2 temps are indexed by nonbond
-            coulombScaleSingleThread, //   atom index, *not* included atom index
-            inclAtomForce_G, energy);
+                // Force on atom 2; apply equal and opposite to atom 1.
+                const Vec3 fj = ((fCoulomb+fVdw)*ood2) * r;
+
+                inclAtomForce_G[iax2] += fj;
+                afrc1_G               -= fj;
+            }
+        }
     }
 }
-//............................CALC NONBONDED FORCES.............................
+//....................CALC NEIGHBOR LIST NONBONDED FORCES.......................
 
 
 
 //------------------------------------------------------------------------------
-//                        class NonbondedForceTask
+//                  class NeighborListNonbondedForceTask
 //------------------------------------------------------------------------------
-// This class is used by realizeDynamics for calculating nonbonded interactions 
-// in multiple threads. The strategy here is to let the Parallel2DExecutor
-// utility execute disjoint pairs of included bodies in parallel.
-class NonbondedForceTask : public SimTK::Parallel2DExecutor::Task {
+// This is used by realizeDynamics for calculating cutoff nonbonded 
+// interactions in multiple threads. Each unit of work is a contiguous block 
+// of neighbor list body pairs. Unlike the all-pairs case, the atoms in 
+// simultaneously executing blocks aren't disjoint, so each thread accumulates
+// forces into its own buffer and the buffers are summed at the end.
+class NeighborListNonbondedForceTask : public SimTK::ParallelExecutor::Task {
 public:
-    NonbondedForceTask
+    static const int BodyPairsPerBlock = 16;
+
+    NeighborListNonbondedForceTask
        (const DuMMForceFieldSubsystemRep& dumm,
+        const NonbondNeighborList& list,
         const Vector_<Vec3>& inclAtomPos_G, 
+        const Vector_<Vec3>& inclBodySphereCenter_G, bool calcForces,
         Vector_<Vec3>& inclAtomForces_G, Real& energy) 
-    :   dumm(dumm), inclAtomPos_G(inclAtomPos_G), 
-        globalAtomForces_G(inclAtomForces_G), globalEnergy(energy)
+    :   dumm(dumm), list(list), inclAtomPos_G(inclAtomPos_G), 
+        inclBodySphereCenter_G(inclBodySphereCenter_G),
+        calcForces(calcForces), globalAtomForces_G(inclAtomForces_G), 
+        globalEnergy(energy)
     {
     }
 
-    // Each thread initializes its own local energy accumulator to 0. Forces
-    // don't need to be accumulated locally because Parallel2DExecutor 
-    // guarantees that simultaneous tasks use disjoint body indices.
+    static int getNumBlocks(int nBodyPairs) 
+    {   return (nBodyPairs + BodyPairsPerBlock - 1) / BodyPairsPerBlock; }
+
     void initialize() {
         localEnergy = 0;
-
-        // Temps for nonbonded scale factors; initialize to 1
-        localVdwScale.resize(getNumNonbondAtoms(), Real(1));
-        localCoulombScale.resize(getNumNonbondAtoms(), Real(1));
+        if (calcForces) {
+            localAtomForces_G.resize(dumm.getNumIncludedAtoms());
+            localAtomForces_G = Vec3(0);
+        }
     }
 
-    // At the end of execution, each thread adds its local energy contribution
-    // to the global total. See comment above regarding forces.
+    // Threads finish concurrently so the reduction must be serialized.
     void finish() {
+        std::lock_guard<std::mutex> lock(reductionMutex);
+        if (calcForces)
+            globalAtomForces_G += localAtomForces_G;
         globalEnergy += localEnergy;
     }
 
-    // This is the standard unit of work for a pair of body indices. No
-    // simultaneous task will be using either of these two indices, so we
-    // can access global data that is indexed by them without synchronization.
-    void execute(int body1, int body2) {
-        dumm.calcBodySubsetNonbondedForces(
-            DuMMIncludedBodyIndex(body1), 
-            DuMMIncludedBodyIndex(body2),   // i.e, just one body
-            DuMMIncludedBodyIndex(body2),
-            inclAtomPos_G,
-            localVdwScale, localCoulombScale,
-            globalAtomForces_G, localEnergy);
+    void execute(int block) {
+        const int nBodyPairs = list.getNumBodyPairs();
+        const int begin      = block*BodyPairsPerBlock;
+        const int end        = std::min(nBodyPairs, begin+BodyPairsPerBlock);
+        dumm.calcNeighborListNonbondedForces(begin, end,
+            list, inclAtomPos_G, inclBodySphereCenter_G,
+            calcForces, localAtomForces_G, localEnergy);
     }
 
 private:
-    int getNumNonbondAtoms() const {return dumm.getNumNonbondAtoms();}
-
     const DuMMForceFieldSubsystemRep&   dumm;
+    const NonbondNeighborList&          list;
     const Vector_<Vec3>&                inclAtomPos_G;
+    const Vector_<Vec3>&                inclBodySphereCenter_G;
+    const bool                          calcForces;
     Vector_<Vec3>&                      globalAtomForces_G;
     Real&                               globalEnergy;
+    std::mutex                          reductionMutex;
 
     // Thread local temporaries.
-    // SCF had trouble with these, converted to regular variables (non-thread-local) 
-    //ThreadLocal< Real >                                 localEnergy;
-    //ThreadLocal< Array_<Real, DuMM::NonbondAtomIndex> > localVdwScale;
-    //ThreadLocal< Array_<Real, DuMM::NonbondAtomIndex> > localCoulombScale;
     static thread_local Real                                 localEnergy;
-    static thread_local Array_<Real, DuMM::NonbondAtomIndex> localVdwScale;
-    static thread_local Array_<Real, DuMM::NonbondAtomIndex> localCoulombScale;
+    static thread_local Vector_<Vec3>                        localAtomForces_G;
 };
 
-thread_local Real                                 NonbondedForceTask::localEnergy;
-thread_local Array_<Real, DuMM::NonbondAtomIndex> NonbondedForceTask::localVdwScale;
-thread_local Array_<Real, DuMM::NonbondAtomIndex> NonbondedForceTask::localCoulombScale;
+thread_local Real                                 NeighborListNonbondedForceTask::localEnergy;
+thread_local Vector_<Vec3>                        NeighborListNonbondedForceTask::localAtomForces_G;
 
-//..........................class NonbondedForceTask............................
+//..................class NeighborListNonbondedForceTask........................
+
+
+
+//------------------------------------------------------------------------------
+//                    CALC SCALED PAIR NONBONDED FORCES
+//------------------------------------------------------------------------------
+// The all-pairs kernels and the neighbor list leave out cross-body pairs of 
+// closely-bonded atoms whose interactions are scaled; here we calculate just
+// those, with their scale factors applied. There are only a few of these 
+// (a handful per cross-body bond) so this is done serially. Pairs that are
+// scaled to zero (normally 1-2 and 1-3) cost nothing. With a cutoff we 
+// treat these pairs exactly as calcNeighborListNonbondedForces() would.
+void DuMMForceFieldSubsystemRep::calcScaledPairNonbondedForces
+   (const Vector_<Vec3>&                    inclAtomPos_G,
+    bool                                    calcForces,
+    Vector_<Vec3>&                          inclAtomForce_G,
+    Real&                                   energy) const
+{
+    const Real cutoff2 = nonbondedCutoff*nonbondedCutoff;
+
+    for (unsigned k=0; k < scaledNonbondPairs.size(); ++k) {
+        const ScaledNonbondPair& pair = scaledNonbondPairs[k];
+        if (pair.vdwScale == 0 && pair.coulombScale == 0)
+            continue;
+
+        const DuMM::IncludedAtomIndex iax1 = 
+            getIncludedAtomIndexOfNonbondAtom(pair.nax1);
+        const DuMM::IncludedAtomIndex iax2 = 
+            getIncludedAtomIndexOfNonbondAtom(pair.nax2);
+
+        const Vec3  r  = applyMinimumImage(inclAtomPos_G[iax2] 
+                                           - inclAtomPos_G[iax1]);
+        const Real  d2 = r.normSqr();
+        if (useNonbondedCutoff && d2 > cutoff2)
+            continue;
+
+        const Real  ood = 1/std::sqrt(d2);
+        const Real  ood2 = ood*ood;
+
+        // Coulombic electrostatic force (see calcNeighborListNonbondedForces)
+        const Real qq = pair.coulombScale * coulombGlobalScaleFactor 
+                        * CoulombFac * nonbondCharge[pair.nax1]
+                        * nonbondCharge[pair.nax2];
+        Real eCoulomb, fCoulomb; // fCoulomb is missing 1/d^2
+        if (usingEwald) {
+            const Real alphaD = ewaldAlpha*d2*ood;
+            eCoulomb = qq * std::erfc(alphaD) * ood;
+            fCoulomb = calcForces 
+                ? eCoulomb + qq * TwoOverSqrtPi * ewaldAlpha 
+                                * std::exp(-alphaD*alphaD)
+                : 0;
+        } else {
+            eCoulomb = qq * ood;
+            fCoulomb = eCoulomb;
+        }
+
+        // van der Waals forces
+        const int  vdwIx  = nonbondClassIx[pair.nax1]*numNonbondClasses 
+                            + nonbondClassIx[pair.nax2];
+        const Real ddij2  = nonbondVdwDij2[vdwIx]*ood2;   // (dmin_ij/d)^2
+        const Real ddij6  = ddij2*ddij2*ddij2;
+        const Real ddij12 = ddij6*ddij6;
+
+        const Real eijScale = 
+            vdwGlobalScaleFactor*pair.vdwScale*nonbondVdwEij[vdwIx];
+        const Real eVdw     =      eijScale * (ddij12 - 2*ddij6);
+
+        energy += (eCoulomb + eVdw); 
+        if (!calcForces)
+            continue;
+
+        const Real fVdw = 12 * eijScale * (ddij12 - ddij6); 
+
+        // Force on atom 2; apply equal and opposite to atom 1.
+        const Vec3 fj = ((fCoulomb+fVdw)*ood2) * r;
+
+        inclAtomForce_G[iax2] += fj;
+        inclAtomForce_G[iax1] -= fj;
+    }
+}
+//....................CALC SCALED PAIR NONBONDED FORCES.........................
+
+
+
+//------------------------------------------------------------------------------
+//                     CALC EWALD EXCLUSION CORRECTIONS
+//------------------------------------------------------------------------------
+// The reciprocal space part of the Ewald sum includes the full interaction
+// qi*qj*erf(alpha*d)/d of every pair of atoms. For cross-body pairs that are 
+// scaled by coulombScale < 1, we have to remove (1-scale) of that. Pairs 
+// that have only their van der Waals interaction scaled are skipped. 
+// (Same-body pairs are dealt with at topology time.)
+void DuMMForceFieldSubsystemRep::calcEwaldExclusionCorrections
+   (const Vector_<Vec3>&        inclAtomPos_G,
+    bool                        calcForces,
+    Vector_<Vec3>&              inclAtomForce_G,
+    Real&                       energy) const
+{
+    const Real globalFac = coulombGlobalScaleFactor * CoulombFac;
+
+    for (unsigned k=0; k < scaledNonbondPairs.size(); ++k) {
+        const ScaledNonbondPair& pair = scaledNonbondPairs[k];
+        if (pair.coulombScale == 1) continue;
+        const Real q1 = ewaldCharges[pair.nax1];
+        const Real q2 = ewaldCharges[pair.nax2];
+        if (q1 == 0 || q2 == 0) continue;
+
+        const DuMM::IncludedAtomIndex iax1 = 
+            getIncludedAtomIndexOfNonbondAtom(pair.nax1);
+        const DuMM::IncludedAtomIndex iax2 = 
+            getIncludedAtomIndexOfNonbondAtom(pair.nax2);
+        const Vec3 r = applyMinimumImage(inclAtomPos_G[iax2] 
+                                         - inclAtomPos_G[iax1]);
+        const Real d2  = r.normSqr();
+        const Real ood = 1/std::sqrt(d2);
+        const Real alphaD = ewaldAlpha*d2*ood;
+        const Real erfAlphaD = std::erf(alphaD);
+
+        // e = -c*erf(alpha*d)/d
+        const Real c = (1-pair.coulombScale) * globalFac * q1 * q2;
+        const Real eCorr = -c * erfAlphaD * ood;
+        energy += eCorr;
+        if (!calcForces)
+            continue;
+
+        const Real fCorr = eCorr 
+            + c * TwoOverSqrtPi * ewaldAlpha * std::exp(-alphaD*alphaD);
+        const Vec3 fj = (fCorr*ood*ood) * r;
+
+        inclAtomForce_G[iax2] += fj;
+        inclAtomForce_G[iax1] -= fj;
+    }
+}
+//.....................CALC EWALD EXCLUSION CORRECTIONS.........................
+
+
+
+//------------------------------------------------------------------------------
+//                       CALC EWALD RECIPROCAL FORCES
+//------------------------------------------------------------------------------
+// Calculate the reciprocal space part of the Ewald sum with PME, and add in
+// the constant energy terms computed at topology time.
+void DuMMForceFieldSubsystemRep::calcEwaldReciprocalForces
+   (const Vector_<Vec3>&        inclAtomPos_G,
+    bool                        calcForces,
+    Vector_<Vec3>&              inclAtomForce_G,
+    Real&                       energy) const
+{
+    const Real globalFac = coulombGlobalScaleFactor * CoulombFac;
+
+    for (DuMM::NonbondAtomIndex nax(0); nax < getNumNonbondAtoms(); ++nax) {
+        pmePositions[nax] = 
+            inclAtomPos_G[getIncludedAtomIndexOfNonbondAtom(nax)];
+        pmeForces[nax] = Vec3(0);
+    }
+
+    const Real eRecip = pmeSolver->calcEnergyAndForces
+       (getNumNonbondAtoms(), &pmePositions[DuMM::NonbondAtomIndex(0)],
+        &ewaldCharges[DuMM::NonbondAtomIndex(0)], 
+        calcForces ? &pmeForces[DuMM::NonbondAtomIndex(0)] : 0);
+
+    if (calcForces)
+        for (DuMM::NonbondAtomIndex nax(0); nax < getNumNonbondAtoms(); ++nax)
+            inclAtomForce_G[getIncludedAtomIndexOfNonbondAtom(nax)] += 
+                globalFac * pmeForces[nax];
+
+    energy += globalFac * (eRecip + ewaldConstantEnergy);
+}
+//.......................CALC EWALD RECIPROCAL FORCES...........................
 
 
 
@@ -1780,46 +3632,52 @@ thread_local Array_<Real, DuMM::NonbondAtomIndex> NonbondedForceTask::localCoulo
 //------------------------------------------------------------------------------
 // Helper function used by realizeSubsystemDynamicsImpl().
 // This calculates GBSA implicit solvent forces. This is the most expensive
-// calculation -- probably 3X the other nonbonded terms.
+// calculation -- probably 3X the other nonbonded terms. GBSA works in our
+// MD units on the structure-of-arrays nonbond positions; if the nonbonded
+// calculation hasn't already packed them for this evaluation
+// (positionsArePacked false) we do it here.
 void DuMMForceFieldSubsystemRep::calcGBSAForces
    (const Vector_<Vec3>&                inclAtomStation_G,
     const Vector_<Vec3>&                inclAtomPos_G,
+    bool                                positionsArePacked,
     bool                                useParallel,
     Real                                gbsaGlobalScaleFac,
+    bool                                calcForces,
     Vector_<SpatialVec>&                inclBodyForces_G,
     Real&                               energy) const
 {  
-    // 1) Populate array of atom positions for gbsa IN ANGSTROMS
-    // Put atomic coordinates relative to ground in gbsaRawCoordinates.
-    // Note that we pass a pre-calculated array of pointers to GBSA; it
-    // was set in realizeTopology() to point into gbsaRawCoordinates.
-
-    for (DuMM::NonbondAtomIndex nax(0); nax < getNumNonbondAtoms(); ++nax) {
-        const DuMM::IncludedAtomIndex iax =
-            getIncludedAtomIndexOfNonbondAtom(nax);
-        // atomic coordinates with respect to Ground frame
-        const Vec3 aPos_G  = inclAtomPos_G[iax]*DuMM::Nm2Ang; // Angstroms
-
-        gbsaRawCoordinates[3 * nax + 0] = aPos_G[0];
-        gbsaRawCoordinates[3 * nax + 1] = aPos_G[1];
-        gbsaRawCoordinates[3 * nax + 2] = aPos_G[2];
+    if (!positionsArePacked) {
+        for (DuMM::NonbondAtomIndex nax(0); nax < getNumNonbondAtoms(); ++nax) {
+            const Vec3& p = inclAtomPos_G[getIncludedAtomIndexOfNonbondAtom(nax)];
+            nonbondPosX[nax] = p[0]; nonbondPosY[nax] = p[1]; nonbondPosZ[nax] = p[2];
+        }
     }
 
+    const ImplicitSolventCoordinates coords = 
+       { nonbondPosX.cbegin(), nonbondPosY.cbegin(), nonbondPosZ.cbegin() };
+    const ImplicitSolventForces forces = 
+       { gbsaForceX.begin(), gbsaForceY.begin(), gbsaForceZ.begin() };
 
-    // compute GBSA forces and energy
+    // compute GBSA forces and energy; passing null forces gets just energy
     const int returnValue = gbsaCpuObc->computeImplicitSolventForces
-       (&gbsaCoordinatePointers.front(), &gbsaAtomicPartialCharges.front(),
-        &gbsaAtomicForcePointers.front(), useParallel ? gbsaExecutor : NULL );
+       (coords, &gbsaAtomicPartialCharges.front(),
+        calcForces ? &forces : NULL, 
+        useParallel ? gbsaExecutor : NULL );
     SimTK_ASSERT_ALWAYS(returnValue == 0, 
         "GBSA CpuObc::computeImplicitSolventForces() failed.");
 
-    RealOpenMM gbsaEnergy = gbsaCpuObc->getEnergy(); 
-
-    // 4)  apply GBSA forces to bodies
+    energy += gbsaGlobalScaleFac * gbsaCpuObc->getEnergy(); // kJ/mol
 
-    // convert force units from kcal/mol-A to to kJ/mol-nm
-    const Real KcalA2KJnm = DuMM::Kcal2KJ/DuMM::Ang2Nm;
+    if (calcForces)
+        applyGBSAForcesToBodies(inclAtomStation_G, gbsaGlobalScaleFac, 
+                                inclBodyForces_G);
+}
 
+void DuMMForceFieldSubsystemRep::applyGBSAForcesToBodies
+   (const Vector_<Vec3>&                inclAtomStation_G,
+    Real                                gbsaGlobalScaleFac,
+    Vector_<SpatialVec>&                inclBodyForces_G) const
+{
     for (DuMMIncludedBodyIndex inclBodyIx(0); 
          inclBodyIx < getNumIncludedBodies(); ++inclBodyIx) 
     {
@@ -1834,114 +3692,191 @@ void DuMMForceFieldSubsystemRep::calcGBSAForces
                 getIncludedAtomIndexOfNonbondAtom(nax);
             const Vec3& aStation_G = inclAtomStation_G[iax];  // nm
 
-            Vec3 fGbsa(gbsaAtomicForces[3 * nax + 0],      // kcal/mol-A
-                       gbsaAtomicForces[3 * nax + 1],
-                       gbsaAtomicForces[3 * nax + 2]);
-
-            // convert force units from kcal/mol-A to to kJ/mol-nm
-            fGbsa *= KcalA2KJnm;
-            fGbsa *= gbsaGlobalScaleFac;
+            const Vec3 fGbsa = gbsaGlobalScaleFac            // kJ/mol-nm
+                * Vec3(gbsaForceX[nax], gbsaForceY[nax], gbsaForceZ[nax]);
 
             inclBodyForces_G[inclBodyIx] += 
                 SpatialVec( aStation_G % fGbsa, fGbsa );
         }
     }
-
-    // update potential energy from gbsa
-    // convert kcal/mol to kJ/mol
-    gbsaEnergy *= DuMM::Kcal2KJ;
-    gbsaEnergy *= gbsaGlobalScaleFac;
-    energy += gbsaEnergy;
 }
 //..............................CALC GBSA FORCES................................
 
 
 
 //------------------------------------------------------------------------------
-//                          REALIZE FORCES AND ENERGY
+//                           CALC GBSA ATOM ENERGIES
 //------------------------------------------------------------------------------
-// Here's where we calculate all the forces if they haven't already been done.
-// Potential energy is calculated at the same time since that comes for free.
-void DuMMForceFieldSubsystemRep::realizeForcesAndEnergy(const State& s) const 
+// Evaluate the GBSA energy of the given State (no forces) with CpuObc's 
+// per-atom energies turned on just for this call, and map them from nonbond
+// atoms to DuMM atoms. We always use our own GBSA implementation here, even
+// if OpenMM is doing the force calculations.
+
+// CpuObc is shared with the force calculations, which fail while it is in 
+// per-atom mode, so the mode is turned off again however we leave.
+class GbsaAtomEnergiesMode {
+public:
+    explicit GbsaAtomEnergiesMode(CpuObc& obc) : obc(obc) 
+    {   obc.setComputeAtomEnergies(1); }
+    ~GbsaAtomEnergiesMode() 
+    {   obc.setComputeAtomEnergies(0); }
+private:
+    CpuObc& obc;
+};
+
+void DuMMForceFieldSubsystemRep::calcGbsaAtomEnergies
+   (const State&            s,
+    Vector&                 gbEnergies,
+    Vector&                 aceEnergies) const
 {
-    if (   isIncludedAtomForceCacheRealized(s) 
-        && isIncludedBodyForceCacheRealized(s) 
-        && isEnergyCacheRealized(s))
-        return; // nothing to do
+    gbEnergies.resize(getNumAtoms());  gbEnergies  = 0;
+    aceEnergies.resize(getNumAtoms()); aceEnergies = 0;
+    if (!gbsaCpuObc || gbsaGlobalScaleFactor == 0)
+        return;
 
-    // Get access to the matter subsystem so we can access the bodies.
-    const MultibodySystem&        mbs    = getMultibodySystem();
-    const SimbodyMatterSubsystem& matter = mbs.getMatterSubsystem();
+    const Vector_<Vec3>& inclAtomPos_G = getIncludedAtomPositionsInG(s);
+    for (DuMM::NonbondAtomIndex nax(0); nax < getNumNonbondAtoms(); ++nax) {
+        const Vec3& p = inclAtomPos_G[getIncludedAtomIndexOfNonbondAtom(nax)];
+        nonbondPosX[nax] = p[0]; nonbondPosY[nax] = p[1]; nonbondPosZ[nax] = p[2];
+    }
+    const ImplicitSolventCoordinates coords = 
+       { nonbondPosX.cbegin(), nonbondPosY.cbegin(), nonbondPosZ.cbegin() };
 
-    // These are the DuMM-local cache entries that we're going to fill in here.
-    Vector_<Vec3>&          inclAtomForce_G  = updIncludedAtomForceCache(s);
-    Vector_<SpatialVec>&    inclBodyForces_G = updIncludedBodyForceCache(s);
-    Real&                   energy           = updEnergyCache(s);
+    const GbsaAtomEnergiesMode atomEnergiesMode(*gbsaCpuObc);
+    const int returnValue = gbsaCpuObc->computeImplicitSolventForces
+       (coords, &gbsaAtomicPartialCharges.front(), NULL,
+        usingMultithreaded ? gbsaExecutor : NULL);
+    SimTK_ASSERT_ALWAYS(returnValue == 0, 
+        "GBSA CpuObc::computeImplicitSolventForces() failed.");
 
-    inclAtomForce_G.resize(getNumIncludedAtoms());
-    inclAtomForce_G = Vec3(0);
+    const RealOpenMM* gb  = gbsaCpuObc->getAtomGbEnergies();
+    const RealOpenMM* ace = gbsaCpuObc->getAceAtomEnergies(); // may be null
+    for (DuMM::NonbondAtomIndex nax(0); nax < getNumNonbondAtoms(); ++nax) {
+        const DuMM::AtomIndex ax = getAtomIndexOfNonbondAtom(nax);
+        gbEnergies[ax] = gbsaGlobalScaleFactor * gb[nax];  // kJ/mol
+        if (ace)
+            aceEnergies[ax] = gbsaGlobalScaleFactor * ace[nax];
+    }
+}
+//...........................CALC GBSA ATOM ENERGIES............................
 
-    inclBodyForces_G.resize(getNumIncludedBodies());
-    inclBodyForces_G = SpatialVec(Vec3(0), Vec3(0));
 
-    energy = 0;
-	++forceEvaluationCount;
 
-    // Get access to already-calculated position dependent quantities.
-    const Vector_<Vec3>& inclAtomStation_G = getIncludedAtomStationsInG(s);
-    const Vector_<Vec3>& inclAtomPos_G     = getIncludedAtomPositionsInG(s);
+//------------------------------------------------------------------------------
+//                     CALC FUSED GBSA NONBONDED FORCES
+//------------------------------------------------------------------------------
+// The all-pairs calculation of calcNonbondedForces() (or NonbondedForceTask)
+// and of calcGBSAForces() in one pass. CpuObc computes the Born radii and 
+// ACE first; then each pair's distance is used for Coulomb, van der Waals 
+// and the GB pair term together, with the GB pair forces going straight into
+// the nonbond force buffers; finally CpuObc applies the Born radius chain 
+// rule, leaving those forces in the GBSA force buffers as usual. 
+void DuMMForceFieldSubsystemRep::calcFusedGbsaNonbondedForces
+   (const Vector_<Vec3>&                inclAtomStation_G,
+    const Vector_<Vec3>&                inclAtomPos_G,
+    bool                                calcForces,
+    Vector_<Vec3>&                      inclAtomForce_G,
+    Vector_<SpatialVec>&                inclBodyForces_G,
+    Real&                               energy) const
+{
+    const int nAtoms = getNumNonbondAtoms();
+    packNonbondPositions(inclAtomPos_G);
+
+    const ImplicitSolventCoordinates coords = 
+       { nonbondPosX.cbegin(), nonbondPosY.cbegin(), nonbondPosZ.cbegin() };
+    const ImplicitSolventForces forces = 
+       { gbsaForceX.begin(), gbsaForceY.begin(), gbsaForceZ.begin() };
+    Parallel2DExecutor* gbsaExec = usingMultithreaded ? gbsaExecutor : NULL;
+
+    RealOpenMM* bornForce = 0;
+    int returnValue = gbsaCpuObc->beginBornEnergyForces
+       (coords, calcForces ? &forces : NULL, gbsaExec, &bornForce);
+    SimTK_ASSERT_ALWAYS(returnValue == 0, 
+        "GBSA CpuObc::beginBornEnergyForces() failed.");
 
+    DuMMGbsaKernelData gbsa;
+    gbsa.charge     = &gbsaAtomicPartialCharges.front();
+    gbsa.bornRadius = gbsaCpuObc->getBornRadii();
+    gbsa.preFactor  = gbsaCpuObc->getObcParameters()->getPreFactor();
+    gbsa.gbsaFac    = gbsaGlobalScaleFactor;
 
-        // BONDED FORCES //
+    Real gbEnergy = 0;
+    if (usingMultithreaded) {
+        NonbondedForceTask task(*this, numThreadsInUse, calcForces, energy,
+                                &gbsa, &gbEnergy);
+        executor->execute(task, numThreadsInUse);
+        if (calcForces) {
+            NonbondedForceReductionTask reduction(*this, task, bornForce);
+            executor->execute(reduction, NonbondedForceReductionTask
+                                    ::getNumBlocks(nAtoms));
+        }
+    } else {
+        DuMMNonbondKernelData data;
+        initNonbondKernelData(data);
+        for (DuMM::NonbondAtomIndex nax1(0); nax1 < nAtoms-1; ++nax1)
+            calcGbsaNonbondRowForces(data, gbsa, calcForces, nax1, nax1+1, 
+                                     nAtoms, nonbondForceX.begin(), 
+                                     nonbondForceY.begin(), 
+                                     nonbondForceZ.begin(), bornForce, 
+                                     energy, gbEnergy);
+    }
+    DuMMNonbondKernels::calcGbsaSelfTerms(gbsa, 0, nAtoms, calcForces, 
+                                          bornForce, gbEnergy);
 
-    const bool doStretch =    bondStretchGlobalScaleFactor != 0 
-                           || customBondStretchGlobalScaleFactor != 0;
-    const bool doBend    =    bondBendGlobalScaleFactor != 0 
-                           || customBondBendGlobalScaleFactor != 0;
-    const bool doTorsion =    bondTorsionGlobalScaleFactor != 0 
-                           || customBondTorsionGlobalScaleFactor != 0;
-    const bool doImproper = amberImproperTorsionGlobalScaleFactor != 0;
+    if (calcForces)
+        unpackNonbondForces(inclAtomForce_G);
 
-    for (DuMMIncludedBodyIndex incBodyIx(0); 
-         incBodyIx < getNumIncludedBodies(); ++incBodyIx) 
-    {
-        const IncludedBody& inclBody = includedBodies[incBodyIx];
-        assert(inclBody.isValid());
-
-        // For each atom on this body, deal with all the bonded forces for which
-        // it is atom 1 of a bond. See discussion elsewhere for how we avoid 
-        // double counting.
-        for (DuMMBondStarterIndex bsx = inclBody.beginBondStarterAtoms;
-             bsx != inclBody.endBondStarterAtoms; ++bsx)
-        {
-            const DuMM::IncludedAtomIndex atom = bondStarterAtoms[bsx];
+    returnValue = gbsaCpuObc->finishBornEnergyForces
+       (coords, calcForces ? &forces : NULL, gbEnergy, gbsaExec);
+    SimTK_ASSERT_ALWAYS(returnValue == 0, 
+        "GBSA CpuObc::finishBornEnergyForces() failed.");
 
-            // Bond stretch (1-2)
-	        if (doStretch)
-                calcBondStretch(atom, inclAtomStation_G, inclAtomPos_G, 
-                                bondStretchGlobalScaleFactor, customBondStretchGlobalScaleFactor,
-                                inclBodyForces_G, energy);
+    energy += gbsaGlobalScaleFactor * gbsaCpuObc->getEnergy(); // kJ/mol
+    if (calcForces)
+        applyGBSAForcesToBodies(inclAtomStation_G, gbsaGlobalScaleFactor, 
+                                inclBodyForces_G);
+}
+//.....................CALC FUSED GBSA NONBONDED FORCES.........................
 
-            // Bond bend (1-2-3)
-            if (doBend)
-                calcBondBend(atom, inclAtomStation_G, inclAtomPos_G, 
-                             bondBendGlobalScaleFactor, customBondBendGlobalScaleFactor,
-                             inclBodyForces_G, energy);
 
-             // Bond torsion (1-2-3-4)
-	        if (doTorsion)
-                calcBondTorsion(atom, inclAtomStation_G, inclAtomPos_G, 
-                                bondTorsionGlobalScaleFactor, customBondTorsionGlobalScaleFactor,
-                                inclBodyForces_G, energy);
 
-            // Amber improper torsion   2-1-3
-            //                             \4
-            if (doImproper)
-                calcAmberImproperTorsion(atom, inclAtomStation_G, 
-                    inclAtomPos_G, amberImproperTorsionGlobalScaleFactor,
-                    inclBodyForces_G, energy);
-        }
-    }
+//------------------------------------------------------------------------------
+//                          CALC FORCES AND ENERGY
+//------------------------------------------------------------------------------
+// Here's where we calculate all the forces and potential energy. If 
+// calcForces is false we calculate only the energy; then the force arrays 
+// are neither resized nor touched and can be empty. Otherwise they must
+// already be sized and zeroed; forces and energy are *added* in. Only terms
+// in the force groups selected by the forceGroups bit mask are included.
+void DuMMForceFieldSubsystemRep::calcForcesAndEnergy
+   (const State&            s,
+    bool                    calcForces,
+    unsigned                forceGroups,
+    Vector_<Vec3>&          inclAtomForce_G,
+    Vector_<SpatialVec>&    inclBodyForces_G,
+    Real&                   energy) const 
+{
+	++forceEvaluationCount;
+
+    // Get access to already-calculated position dependent quantities.
+    const Vector_<Vec3>& inclAtomStation_G = getIncludedAtomStationsInG(s);
+    const Vector_<Vec3>& inclAtomPos_G     = getIncludedAtomPositionsInG(s);
+
+
+    const bool doBonded = (forceGroups & forceGroupBit
+                           (DuMMForceFieldSubsystem::BondedForceGroup)) != 0;
+    const bool doNear   = (forceGroups & forceGroupBit
+                           (DuMMForceFieldSubsystem::NonbondedNearForceGroup)) != 0;
+    const bool doFar    = (forceGroups & forceGroupBit
+                           (DuMMForceFieldSubsystem::NonbondedFarForceGroup)) != 0;
+    const bool doGBSA   = (forceGroups & forceGroupBit
+                           (DuMMForceFieldSubsystem::GBSAForceGroup)) != 0;
+
+        // BONDED FORCES //
+
+    if (doBonded)
+        calcBondedForces(inclAtomStation_G, inclAtomPos_G, 
+                         calcForces, inclBodyForces_G, energy);
 
                 // NONBONDED FORCES //
 
@@ -1952,39 +3887,116 @@ void DuMMForceFieldSubsystemRep::realizeForcesAndEnergy(const State& s) const
         if (usingOpenMM) {
             assert(openMMPluginIfc);
 
-            // Calculate forces and energy.
-            // TODO: should calculate energy only when it is asked for.
-            openMMPluginIfc->calcOpenMMNonbondedAndGBSAForces(
-                inclAtomStation_G, inclAtomPos_G, true /*forces*/, true /*energy*/,
-                inclBodyForces_G, energy);
+            // Calculate forces (if requested) and energy. OpenMM does
+            // nonbonded and GBSA together, on the near group's schedule.
+            if (doNear)
+                openMMPluginIfc->calcOpenMMNonbondedAndGBSAForces(
+                    inclAtomStation_G, inclAtomPos_G, calcForces, 
+                    true /*energy*/, inclBodyForces_G, energy);
 
             // All done!
-            markIncludedAtomForceCacheRealized(s);
-            markIncludedBodyForceCacheRealized(s);
-            markEnergyCacheRealized(s);
             return;
         }
 
         // We're not using OpenMM; calculate these terms here as best we can.
-        if (usingMultithreaded) {
+        const bool doCoulombOrVdw = 
+            !(coulombGlobalScaleFactor==0 && vdwGlobalScaleFactor==0);
+        // Set when the all-pairs calculation below has filled in the 
+        // structure-of-arrays nonbond positions, so GBSA can reuse them.
+        bool nonbondPositionsPacked = false;
+        // Set when GBSA was done together with the nonbonded terms.
+        bool gbsaDone = false;
+        if (!doNear) {
+            // Only the Ewald reciprocal space part can be wanted here.
+            if (useNonbondedCutoff && usingEwald && doFar) {
+                calcEwaldExclusionCorrections(inclAtomPos_G, calcForces,
+                                              inclAtomForce_G, energy);
+                calcEwaldReciprocalForces(inclAtomPos_G, calcForces,
+                                          inclAtomForce_G, energy);
+            }
+        } else if (useNonbondedCutoff) {
+            // Bring the neighbor list up to date if atoms have moved too far.
+            NonbondNeighborList& list = updNonbondNeighborListCache(s);
+            if (doCoulombOrVdw 
+                && isNeighborListRebuildNeeded(inclAtomPos_G, list))
+                buildNonbondNeighborList(inclAtomPos_G, list);
+
+            const Vector_<Vec3>& inclBodySphereCenter_G = 
+                getIncludedBodySphereCenterCache(s);
+
+            if (!doCoulombOrVdw) {
+                // nothing to do
+            } else if (usingMultithreaded) {
+                NeighborListNonbondedForceTask task
+                   (*this, list, inclAtomPos_G, inclBodySphereCenter_G, 
+                    calcForces, inclAtomForce_G, energy);
+                executor->execute(task, NeighborListNonbondedForceTask
+                                        ::getNumBlocks(list.getNumBodyPairs()));
+            } else {
+                calcNeighborListNonbondedForces(0, list.getNumBodyPairs(),
+                    list, inclAtomPos_G, inclBodySphereCenter_G,
+                    calcForces, inclAtomForce_G, energy);
+            }
+
+            if (doCoulombOrVdw)
+                calcScaledPairNonbondedForces(inclAtomPos_G, calcForces,
+                                              inclAtomForce_G, energy);
+
+            // In a periodic box, Ewald electrostatics need the reciprocal 
+            // space part and corrections for scaled pairs.
+            if (usingEwald && doFar) {
+                calcEwaldExclusionCorrections(inclAtomPos_G, calcForces,
+                                              inclAtomForce_G, energy);
+                calcEwaldReciprocalForces(inclAtomPos_G, calcForces,
+                                          inclAtomForce_G, energy);
+            }
+        } else if (doCoulombOrVdw && doGBSA && gbsaGlobalScaleFactor != 0
+                   && isFusedGbsaNonbondedPossible()) {
+            // One pass over the pairs for nonbonded and GBSA, serial or 
+            // parallel.
+            calcFusedGbsaNonbondedForces(inclAtomStation_G, inclAtomPos_G,
+                                         calcForces, inclAtomForce_G, 
+                                         inclBodyForces_G, energy);
+            gbsaDone = true;
+            calcScaledPairNonbondedForces(inclAtomPos_G, calcForces,
+                                          inclAtomForce_G, energy);
+        } else if (usingMultithreaded) {
             // Parallel calculation.
-            NonbondedForceTask task
-               (*this, inclAtomPos_G, inclAtomForce_G, energy);
-            nonbondedExecutor->execute(task, Parallel2DExecutor::HalfMatrix);
+            packNonbondPositions(inclAtomPos_G);
+            nonbondPositionsPacked = true;
+            NonbondedForceTask task(*this, numThreadsInUse, calcForces, energy);
+            executor->execute(task, numThreadsInUse);
+            if (calcForces) {
+                NonbondedForceReductionTask reduction(*this, task);
+                executor->execute(reduction, NonbondedForceReductionTask
+                                        ::getNumBlocks(getNumNonbondAtoms()));
+                unpackNonbondForces(inclAtomForce_G);
+            }
+            calcScaledPairNonbondedForces(inclAtomPos_G, calcForces,
+                                          inclAtomForce_G, energy);
         } else {
             // Serial calculation in this thread.
-            if (!(coulombGlobalScaleFactor==0 && vdwGlobalScaleFactor==0)) {
-                calcNonbondedForces(inclAtomPos_G, inclAtomForce_G, energy);
+            if (doCoulombOrVdw) {
+                calcNonbondedForces(inclAtomPos_G, calcForces, 
+                                    inclAtomForce_G, energy);
+                nonbondPositionsPacked = true;
+                calcScaledPairNonbondedForces(inclAtomPos_G, calcForces,
+                                              inclAtomForce_G, energy);
             }
         }
 
         // GBSA - (Generalized Born/solvent accessibility implicit) solvent model
-        if (gbsaGlobalScaleFactor != 0) {
-            calcGBSAForces(inclAtomStation_G, inclAtomPos_G, usingMultithreaded,
-                           gbsaGlobalScaleFactor, inclBodyForces_G, energy);
+        if (gbsaGlobalScaleFactor != 0 && doGBSA && !gbsaDone) {
+            calcGBSAForces(inclAtomStation_G, inclAtomPos_G, 
+                           nonbondPositionsPacked, usingMultithreaded,
+                           gbsaGlobalScaleFactor, calcForces, 
+                           inclBodyForces_G, energy);
         }
     }
 
+    if (!calcForces)
+        return;
+
     // Compute included body spatial forces from generated atom forces.
     for (DuMMIncludedBodyIndex dbx(0); dbx < getNumIncludedBodies(); ++dbx) {
         const IncludedBody& inclBod = includedBodies[dbx];
@@ -1996,6 +4008,101 @@ void DuMMForceFieldSubsystemRep::realizeForcesAndEnergy(const State& s) const
             inclBodyForces_G[dbx] += SpatialVec(aStation_G % aFrc_G, aFrc_G);
         }
     }
+}
+//............................CALC FORCES AND ENERGY............................
+
+
+
+//------------------------------------------------------------------------------
+//                          REALIZE FORCES AND ENERGY
+//------------------------------------------------------------------------------
+// Here's where we calculate all the forces if they haven't already been done.
+// Potential energy is calculated at the same time since that comes for free.
+//
+// With multiple time stepping we number the steps k = t/h. The fast force
+// groups (interval 1) are calculated every time. A slow group with interval
+// n is calculated only when k is a multiple of n; its body forces are then 
+// applied with weight n (the impulse form of r-RESPA), and at other steps 
+// not at all. Forces must only be wanted at step times: a time that isn't
+// one is an error, since silently leaving out the slow groups would give 
+// wrong dynamics. Roundoff in t grows with the number of steps taken, so the
+// tolerance for being on a step grows with k. The slow groups' unweighted 
+// forces and energies are kept in the MultipleTimeStepCache, labeled with
+// their step; like the rest of the force cache it depends on Position stage.
+// The energy reported here includes only the groups calculated at this 
+// step; calcPotentialEnergy() doesn't use it in that case. The atom force 
+// cache holds only fast group forces.
+void DuMMForceFieldSubsystemRep::realizeForcesAndEnergy(const State& s) const 
+{
+    if (   isIncludedAtomForceCacheRealized(s) 
+        && isIncludedBodyForceCacheRealized(s) 
+        && isEnergyCacheRealized(s))
+        return; // nothing to do
+
+    // These are the DuMM-local cache entries that we're going to fill in here.
+    Vector_<Vec3>&          inclAtomForce_G  = updIncludedAtomForceCache(s);
+    Vector_<SpatialVec>&    inclBodyForces_G = updIncludedBodyForceCache(s);
+    Real&                   energy           = updEnergyCache(s);
+
+    inclAtomForce_G.resize(getNumIncludedAtoms());
+    inclAtomForce_G = Vec3(0);
+
+    inclBodyForces_G.resize(getNumIncludedBodies());
+    inclBodyForces_G = SpatialVec(Vec3(0), Vec3(0));
+
+    energy = 0;
+
+    if (!isUsingMultipleTimeStepping()) {
+        calcForcesAndEnergy(s, true, allForceGroups(), 
+                            inclAtomForce_G, inclBodyForces_G, energy);
+    } else {
+        const Real      k    = s.getTime()/multipleTimeStepSize;
+        const long long step = (long long)std::floor(k + 0.5);
+        const Real      tol  = std::max(Real(1e-6), Real(1e-8)*std::abs(k));
+        SimTK_ERRCHK3_ALWAYS(std::abs(k - Real(step)) <= tol,
+            "DuMMForceFieldSubsystem::realizeForcesAndEnergy()",
+            "With multiple time stepping, forces can only be calculated at"
+            " multiples of the step size %g ps, but the time is %.17g ps"
+            " (step %.17g). Use a fixed step integrator with that step size,"
+            " and report times that are multiples of it.",
+            multipleTimeStepSize, s.getTime(), k);
+
+        MultipleTimeStepCache& mts = updMultipleTimeStepCache(s);
+        if (!isMultipleTimeStepCacheRealized(s))
+            mts.clear(); // positions or time have changed
+
+        unsigned fastGroups = 0;
+        for (int g=0; g < DuMMForceFieldSubsystem::NumForceGroups; ++g)
+            if (forceGroupInterval[g] <= 1)
+                fastGroups |= forceGroupBit(g);
+        calcForcesAndEnergy(s, true, fastGroups, 
+                            inclAtomForce_G, inclBodyForces_G, energy);
+
+        Vector_<Vec3> slowAtomForce_G; // temporary
+        for (int g=0; g < DuMMForceFieldSubsystem::NumForceGroups; ++g) {
+            const int interval = forceGroupInterval[g];
+            if (interval <= 1 || (step % interval) != 0)
+                continue; // fast, or not due
+
+            Vector_<SpatialVec>& slowBodyForces_G = mts.bodyForces_G[g];
+            if (mts.step[g] != step) {
+                slowBodyForces_G.resize(getNumIncludedBodies());
+                slowBodyForces_G = SpatialVec(Vec3(0), Vec3(0));
+                slowAtomForce_G.resize(getNumIncludedAtoms());
+                slowAtomForce_G = Vec3(0);
+                mts.energy[g] = 0;
+                calcForcesAndEnergy(s, true, forceGroupBit(g), 
+                    slowAtomForce_G, slowBodyForces_G, mts.energy[g]);
+                mts.step[g] = step;
+            }
+
+            for (DuMMIncludedBodyIndex dbx(0); 
+                 dbx < getNumIncludedBodies(); ++dbx)
+                inclBodyForces_G[dbx] += Real(interval) * slowBodyForces_G[dbx];
+            energy += mts.energy[g];
+        }
+        markMultipleTimeStepCacheRealized(s);
+    }
 
     // Done.
     markIncludedAtomForceCacheRealized(s);
@@ -2006,6 +4113,32 @@ void DuMMForceFieldSubsystemRep::realizeForcesAndEnergy(const State& s) const
 
 
 
+//------------------------------------------------------------------------------
+//                            REALIZE ENERGY ONLY
+//------------------------------------------------------------------------------
+// This is for callers that want only the potential energy, such as Monte 
+// Carlo and scoring loops. No atom or body forces are accumulated. The result
+// goes in its own cache entry so that it can't be mistaken for the energy
+// that accompanies a force calculation.
+void DuMMForceFieldSubsystemRep::realizeEnergyOnly(const State& s) const 
+{
+    if (isEnergyOnlyCacheRealized(s))
+        return; // nothing to do
+
+    Real& energy = updEnergyOnlyCache(s);
+    energy = 0;
+
+    Vector_<Vec3>       noAtomForces;  // these won't be touched
+    Vector_<SpatialVec> noBodyForces;
+    calcForcesAndEnergy(s, false, allForceGroups(), 
+                        noAtomForces, noBodyForces, energy);
+
+    markEnergyOnlyCacheRealized(s);
+}
+//............................REALIZE ENERGY ONLY...............................
+
+
+
 //------------------------------------------------------------------------------
 //                              REALIZE DYNAMICS
 //------------------------------------------------------------------------------
@@ -2043,76 +4176,19 @@ int DuMMForceFieldSubsystemRep::realizeSubsystemDynamicsImpl(const State& s) con
 // Return the potential energy. This can be done any time after stage Position,
 // however we have to make sure it has been realized first.
 Real DuMMForceFieldSubsystemRep::calcPotentialEnergy(const State& state) const {
-    // Currently there is no way to compute only the energy, although it
-    // would be somewhat cheaper if forces aren't needed.
-    realizeForcesAndEnergy(state);
-    return getEnergyCache(state);
+    // If forces have already been calculated the energy came with them,
+    // unless some of it is from slow force groups evaluated at earlier steps.
+    if (isEnergyCacheRealized(state) && !isUsingMultipleTimeStepping())
+        return getEnergyCache(state);
+
+    // Otherwise calculate only the energy, which is considerably cheaper.
+    realizeEnergyOnly(state);
+    return getEnergyOnlyCache(state);
 }
 //............................CALC POTENTIAL ENERGY.............................
 
 
 
-//------------------------------------------------------------------------------
-//                             SCALE BONDED ATOMS
-//------------------------------------------------------------------------------
-// Prior to performing nonbonded calculations involving a particular nonbond
-// atom, we set scale factors on certain closely-bonded atoms that have been
-// precalculated as needing to be scaled.
-void DuMMForceFieldSubsystemRep::scaleBondedAtoms
-   (const IncludedAtom& a,  // this is a nonbond atom 
-    Array_<Real,DuMM::NonbondAtomIndex>& vdwScale, 
-    Array_<Real,DuMM::NonbondAtomIndex>& coulombScale) const 
-{
-    for (int i=0; i < (int)a.scale12.size(); ++i) {
-        const DuMM::NonbondAtomIndex ix = a.scale12[i]; 
-        vdwScale[ix]=vdwScale12; coulombScale[ix]=coulombScale12;
-    }
-    for (int i=0; i < (int)a.scale13.size(); ++i) {
-        const DuMM::NonbondAtomIndex ix = a.scale13[i]; 
-        vdwScale[ix]=vdwScale13; coulombScale[ix]=coulombScale13;
-    }
-    for (int i=0; i < (int)a.scale14.size(); ++i) {
-        const DuMM::NonbondAtomIndex ix = a.scale14[i]; 
-        vdwScale[ix]=vdwScale14; coulombScale[ix]=coulombScale14;
-    }
-    for (int i=0; i < (int)a.scale15.size(); ++i) {
-        const DuMM::NonbondAtomIndex ix = a.scale15[i]; 
-        vdwScale[ix]=vdwScale15; coulombScale[ix]=coulombScale15;
-    }
-}
-//.............................SCALE BONDED ATOMS...............................
-
-
-
-//------------------------------------------------------------------------------
-//                            UNSCALE BONDED ATOMS
-//------------------------------------------------------------------------------
-void DuMMForceFieldSubsystemRep::unscaleBondedAtoms
-   (const IncludedAtom& a, 
-    Array_<Real,DuMM::NonbondAtomIndex>& vdwScale, 
-    Array_<Real,DuMM::NonbondAtomIndex>& coulombScale) const 
-{
-    for (int i=0; i < (int)a.scale12.size(); ++i) {
-        const DuMM::NonbondAtomIndex ix = a.scale12[i]; 
-        vdwScale[ix]=coulombScale[ix]=1;
-    }
-    for (int i=0; i < (int)a.scale13.size(); ++i) {
-        const DuMM::NonbondAtomIndex ix = a.scale13[i]; 
-        vdwScale[ix]=coulombScale[ix]=1;
-    }
-    for (int i=0; i < (int)a.scale14.size(); ++i) {
-        const DuMM::NonbondAtomIndex ix = a.scale14[i]; 
-        vdwScale[ix]=coulombScale[ix]=1;
-    }
-    for (int i=0; i < (int)a.scale15.size(); ++i) {
-        const DuMM::NonbondAtomIndex ix = a.scale15[i]; 
-        vdwScale[ix]=coulombScale[ix]=1;
-    }
-}
-//............................UNSCALE BONDED ATOMS..............................
-
-
-
 // Vdw combining functions
 // -----------------------
 // There are several in common use. The most common
@@ -2273,6 +4349,67 @@ void DuMMForceFieldSubsystemRep::applyMixingRule(Real ri, Real rj, Real ei, Real
 }
 
 
+// Heap space used by an array, in bytes.
+template <class T, class X> static double 
+numBytes(const Array_<T,X>& a) {return (double)a.capacity()*sizeof(T);}
+
+void DuMMForceFieldSubsystemRep::dumpTopologyStatistics(std::ostream& o) const
+{
+    const std::ios::fmtflags flags = o.flags();
+    const std::streamsize    prec  = o.precision();
+    o << std::fixed << std::setprecision(2);
+
+    o << "DuMM topology: " << getNumAtoms() << " atoms, " 
+      << getNumIncludedAtoms() << " included atoms on " 
+      << getNumIncludedBodies() << " bodies, " << getNumNonbondAtoms() 
+      << " nonbond atoms; bond graph walked with " << topologyWalkThreads 
+      << (topologyWalkThreads == 1 ? " thread.\n" : " threads.\n");
+
+    double total = 0;
+    for (unsigned i=0; i < topologyStepTimes.size(); ++i) {
+        o << "  " << std::setw(36) << std::left << topologyStepTimes[i].first 
+          << std::right << std::setw(10) << 1000*topologyStepTimes[i].second 
+          << " ms\n";
+        total += topologyStepTimes[i].second;
+    }
+    o << "  " << std::setw(36) << std::left << "total" 
+      << std::right << std::setw(10) << 1000*total << " ms\n";
+
+    double atomBytes = numBytes(atoms);
+    for (DuMM::AtomIndex ax(0); ax < atoms.size(); ++ax)
+        atomBytes += numBytes(atoms[ax].bond12);
+
+    double inclAtomBytes = numBytes(includedAtoms) 
+                         + numBytes(includedAtomStations)
+                         + numBytes(nonbondAtoms) + numBytes(bondStarterAtoms);
+    for (DuMM::IncludedAtomIndex iax(0); iax < includedAtoms.size(); ++iax)
+        inclAtomBytes += includedAtoms[iax].getNumBytes();
+
+    const double bondedBytes = 
+          numBytes(flatBondStretches) + numBytes(customBondStretches)
+        + numBytes(flatBondBends)     + numBytes(customBondBends)
+        + numBytes(flatBondTorsions)  + numBytes(customBondTorsions)
+        + numBytes(flatImproperTorsions) + numBytes(flatTorsionTerms)
+        + numBytes(bondedTermBatches) + numBytes(firstBondedSlotOfBody)
+        + numBytes(bondedSlotsOfBody) + numBytes(bondedTermForces);
+
+    const double nonbondBytes = 
+          numBytes(nonbondClassIx) + numBytes(nonbondEndOfBody)
+        + numBytes(nonbondBodyIx)  + numBytes(nonbondCharge)
+        + numBytes(nonbondVdwDij2) + numBytes(nonbondVdwEij)
+        + numBytes(scaledNonbondPairs) + numBytes(firstScaledNonbondPair);
+
+    const double MB = 1024*1024;
+    o << "  memory (MB): atoms and bonds " << atomBytes/MB
+      << ", cross-body connections (temporary) " << topologyCrossBodyBytes/MB
+      << ", included atom lists " << inclAtomBytes/MB
+      << ", bonded terms " << bondedBytes/MB
+      << ", nonbond tables " << nonbondBytes/MB << "\n";
+
+    o.flags(flags);
+    o.precision(prec);
+}
+
 void DuMMForceFieldSubsystemRep::dump() const 
 {
     printf("===============================================================\n");
@@ -2470,6 +4607,28 @@ void BondBend::calculateAtomForces
     cf = -(rf+sf); // makes the net force zero (6 flops)
 }
 
+// This is the energy-only version of calculateAtomForces() above.
+Real BondBend::calculateEnergy
+   (const Vec3& cG, const Vec3& rG, const Vec3& sG, 
+    const Real& builtinScale, const Real& customScale) const
+{
+    const Vec3 r = rG - cG;
+    const Vec3 s = sG - cG;
+    if (r.normSqr()==0 || s.normSqr()==0)
+        return 0;
+
+    const Real theta = std::atan2((r % s).norm(), ~r * s);
+
+    Real pe = 0;
+    if (hasBuiltinTerm()) {
+        const Real bend = theta - theta0;
+        pe = builtinScale*k*bend*bend; // NOTE: no factor of 1/2
+    }
+    for (int i=0; i < (int)customTerms.size(); ++i)
+        pe += customScale*customTerms[i]->calcEnergy(theta);
+    return pe;
+}
+
     //////////////////
     // BOND TORSION //
     //////////////////
@@ -2558,6 +4717,42 @@ void BondTorsion::calculateAtomForces
     }
 }
 
+// This is the energy-only version of calculateAtomForces() above; the 
+// torsion angle is found in exactly the same way.
+Real BondTorsion::calculateEnergy
+   (const Vec3& rG, const Vec3& xG, const Vec3& yG, const Vec3& sG,
+    const Real& builtinScale, const Real& customScale) const
+{
+    const Vec3 r  = xG - rG;
+    const Vec3 s  = sG - yG;
+    const Vec3 xy = yG - xG;
+
+    const Real vv = ~xy*xy;
+    const Real oov = (vv==0 ? Real(0) : 1/std::sqrt(vv));
+    const UnitVec3 v = 
+        (oov != 0 ? UnitVec3(xy*oov,true)
+                  : ((r%s).norm() != 0 ? UnitVec3(r % s)
+                                       : UnitVec3(r).perp()));
+
+    const Vec3 t = r % v, u = v % s;
+    const Real tt = ~t*t, uu = ~u*u;
+    if (tt == 0 || uu == 0)
+        return 0;
+
+    const Real ootu = 1/std::sqrt(tt*uu);
+    const Real cth = (~t*u)*ootu;
+    const Real sth = (~v*(t % u))*ootu;
+    const Real theta = std::atan2(sth,cth);
+
+    Real pe = 0; 
+    for (int i=0; i < (int)terms.size(); ++i)
+        pe += terms[i].energy(theta);
+    pe *= builtinScale;
+    for (int i=0; i < (int)customTerms.size(); ++i)
+        pe += customScale*customTerms[i]->calcEnergy(theta);
+    return pe;
+}
+
 
     //////////
     // ATOM //
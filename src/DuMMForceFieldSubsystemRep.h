@@ -51,6 +51,8 @@
 #include "gbsa/CpuObc.h"
 
 #include "OpenMMPlugin.h"
+#include "DuMMPmeSolver.h"
+#include "DuMMNonbondKernels.h"
 
 #include "SimbodyVersionCheck.h"
 
@@ -85,6 +87,11 @@ SimTK_DEFINE_UNIQUE_INDEX_TYPE(DuMMIncludedBodyIndex);
 // bond for which we are going to compute a bond force at run time.
 SimTK_DEFINE_UNIQUE_INDEX_TYPE(DuMMBondStarterIndex);
 
+// These are used only while realizing topology; see 
+// DuMMForceFieldSubsystemRep::findCrossBodyBonds().
+struct CrossBodyBondInfo;
+struct BondPathScratch;
+
 
 
 //-----------------------------------------------------------------------------
@@ -235,6 +242,74 @@ typedef IndexQuad<DuMM::AtomClassIndex>     AtomClassIndexQuad;
 
 
 
+//-----------------------------------------------------------------------------
+//                          ATOM CLASS TUPLE TABLE
+//-----------------------------------------------------------------------------
+// A read-only open addressing hash table that indexes one of the bonded 
+// parameter maps (keyed by an IndexPair, IndexTriple or IndexQuad of atom 
+// class indices with N entries) for fast lookup. The table points into the 
+// map, so it must be rebuilt whenever the map changes; we do that at the start
+// of each topology realization. Keys are looked up exactly as given, so the 
+// caller canonicalizes them just as for the map.
+template <class Key, int N, class T>
+class AtomClassTupleTable {
+public:
+    AtomClassTupleTable() : mask(0) {}
+
+    void build(const std::map<Key,T>& params) {
+        // Keep the load factor at 1/2 or less so probe sequences stay short.
+        unsigned size = 2;
+        while (size < 2*params.size()) size *= 2;
+        slots.clear(); slots.resize(size);
+        mask = size-1;
+        typename std::map<Key,T>::const_iterator p;
+        for (p = params.begin(); p != params.end(); ++p) {
+            unsigned h = hash(p->first) & mask;
+            while (slots[h].value) h = (h+1) & mask;
+            slots[h].key   = p->first;
+            slots[h].value = &p->second;
+        }
+    }
+
+    void clear() {slots.clear(); mask=0;}
+    bool isBuilt() const {return !slots.empty();}
+
+    // Return the parameters for this key, or 0 if there aren't any.
+    const T* find(const Key& key) const {
+        assert(isBuilt());
+        for (unsigned h = hash(key) & mask; slots[h].value; h = (h+1) & mask)
+            if (isSameKey(slots[h].key, key)) return slots[h].value;
+        return 0;
+    }
+
+private:
+    struct Slot {
+        Slot() : value(0) {}
+        Key      key;
+        const T* value; // 0 means the slot is empty
+    };
+
+    // Combine the class indices and then mix all the bits down into the
+    // low ones, which are the only ones the mask keeps.
+    static unsigned hash(const Key& key) {
+        unsigned h = 0;
+        for (int i=0; i < N; ++i) h = 31*h + (unsigned)(int)key[i];
+        h ^= h >> 16; h *= 0x85ebca6bU;
+        h ^= h >> 13; h *= 0xc2b2ae35U;
+        h ^= h >> 16;
+        return h;
+    }
+    static bool isSameKey(const Key& k1, const Key& k2) {
+        for (int i=0; i < N; ++i) if (k1[i] != k2[i]) return false;
+        return true;
+    }
+
+    Array_<Slot> slots;
+    unsigned     mask;
+};
+
+
+
 //-----------------------------------------------------------------------------
 //                               ATOM CLASS
 //-----------------------------------------------------------------------------
@@ -480,6 +555,11 @@ public:
         const Real& scale, const Real& customScale,
         Real& theta, Real& pe, Vec3& cf, Vec3& rf, Vec3& sf) const;
 
+    // Same, but return only the potential energy.
+    Real calculateEnergy
+       (const Vec3& cG, const Vec3& rG, const Vec3& sG, 
+        const Real& scale, const Real& customScale) const;
+
     std::ostream& generateSelfCode(std::ostream& os) const 
     {
         if (hasBuiltinTerm()) {
@@ -657,6 +737,11 @@ public:
         Real& theta, Real& pe, 
         Vec3& rf, Vec3& xf, Vec3& yf, Vec3& sf) const;
 
+    // Same, but return only the potential energy.
+    Real calculateEnergy
+       (const Vec3& rG, const Vec3& xG, const Vec3& yG, const Vec3& sG,
+        const Real& builtinScale, const Real& customScale) const;
+
     // Type 1 => normal torsion parameters
     // Type 2 => amber improper torsion parameters
     std::ostream& generateSelfCode(std::ostream& os, int torsionType = 1) const 
@@ -896,6 +981,21 @@ public:
         aImproperTorsion.clear(); 
     }
 
+    // Heap space used by the lists below, in bytes.
+    double getNumBytes() const {
+        return (double)sizeof(DuMM::NonbondAtomIndex)
+                   * (  scale12.capacity() + scale13.capacity() 
+                      + scale14.capacity() + scale15.capacity())
+             + (double)sizeof(DuMM::IncludedAtomIndex)*force12.capacity()
+             + (double)sizeof(IncludedAtomIndexPair)*force13.capacity()
+             + (double)sizeof(IncludedAtomIndexTriple)
+                   * (force14.capacity() + forceImproper14.capacity())
+             + (double)sizeof(IncludedAtomIndexQuad)*force15.capacity()
+             + (double)sizeof(void*)
+                   * (  stretch.capacity() + bend.capacity() 
+                      + torsion.capacity() + aImproperTorsion.capacity());
+    }
+
     void dump() const;
 
     // This is the included atom index of this atom -- redundant information
@@ -953,6 +1053,68 @@ public:
 
 
 
+//-----------------------------------------------------------------------------
+//                           FLAT BONDED TERMS
+//-----------------------------------------------------------------------------
+// At topology time every bonded force term in the IncludedAtom lists above
+// is also copied into a contiguous array for its term type, along with its 
+// atoms' included atom and included body indices and its built-in 
+// parameters, so that each term type can be evaluated by a single tight loop
+// without chasing pointers through IncludedAtom and the parameter maps. A 
+// term whose parameters have no built-in part is left out of those arrays.
+// Terms with custom parts are listed again in separate arrays; only those 
+// need to look at their parameter objects, through the params pointer.
+class FlatBondStretch {
+public:
+    DuMM::IncludedAtomIndex a1, a2;
+    DuMMIncludedBodyIndex   b1, b2;
+    Real                    k, d0;
+    const BondStretch*      params;
+};
+
+// Atoms are stored in the order BondBend expects: c is the central atom
+// bonded to r and s.
+class FlatBondBend {
+public:
+    DuMM::IncludedAtomIndex c, r, s;
+    DuMMIncludedBodyIndex   bc, br, bs;
+    Real                    k, theta0;
+    const BondBend*         params;
+};
+
+// Atoms are stored in the order BondTorsion expects, r-x-y-s with rotation
+// about x-y; for an Amber improper torsion the central atom is y. The 
+// periodic terms are flatTorsionTerms[firstTerm] up to (but not including)
+// flatTorsionTerms[endTerm].
+class FlatBondTorsion {
+public:
+    DuMM::IncludedAtomIndex r, x, y, s;
+    DuMMIncludedBodyIndex   br, bx, by, bs;
+    unsigned                firstTerm, endTerm;
+    const BondTorsion*      params;
+};
+
+// For parallel evaluation the built-in terms in the flat arrays are divided
+// into batches of at most TermsPerBatch consecutive terms of one type. Each
+// term of a batch has a force slot for each of its atoms (2, 3, or 4, in the
+// order given by the term type's evaluation routine); the batch's slots are
+// numbered consecutively from firstSlot.
+class BondedTermBatch {
+public:
+    enum TermType {Stretch=0, Bend, Torsion, ImproperTorsion, NumTermTypes};
+    static const int TermsPerBatch = 128;
+
+    static int getNumAtoms(TermType t) 
+    {   return t==Stretch ? 2 : (t==Bend ? 3 : 4); }
+    int getNumSlots() const {return getNumAtoms(type)*(end-begin);}
+
+    TermType    type;
+    int         begin, end;  // in the flat array for this type
+    unsigned    firstSlot;
+};
+
+
+
 //-----------------------------------------------------------------------------
 //                                  BOND
 //-----------------------------------------------------------------------------
@@ -1282,7 +1444,7 @@ public:
 // derived during realizeTopology() from user-provided data stored elsewhere.
 class IncludedBody {
 public:
-    IncludedBody() {}
+    IncludedBody() : nonbondSphereRadius(0) {}
     bool isValid() const {return mobodIx.isValid();}
     MobilizedBodyIndex      mobodIx;
     // Defined as in std:: classes; end is one past the last atom.
@@ -1290,6 +1452,11 @@ public:
     DuMM::NonbondAtomIndex  beginNonbondAtoms,     endNonbondAtoms;
     DuMMBondStarterIndex    beginBondStarterAtoms, endBondStarterAtoms;
 
+    // A sphere in the body frame that contains all the nonbond atoms on this
+    // body; used to skip distant body pairs when there is a cutoff.
+    Vec3                    nonbondSphereCenter_B; // nm
+    Real                    nonbondSphereRadius;   // nm
+
     void dump() const {
         printf("    mobodIndex=%d\n", (int)mobodIx);
         printf("    includedAtoms=[%d,%d)\n", 
@@ -1387,6 +1554,113 @@ std::ostream& operator<<(std::ostream& o, const InclusionListSpec& ils) {
 
 
 
+//-----------------------------------------------------------------------------
+//                          SCALED NONBOND PAIR
+//-----------------------------------------------------------------------------
+// A cross-body pair of closely-bonded (1-2 through 1-5) nonbond atoms whose 
+// van der Waals and/or Coulomb interaction the force field wants scaled. 
+// These are collected at topology time with nax1 < nax2. The nonbonded 
+// kernels skip these pairs entirely and they are calculated separately, so
+// that the kernels need no scale factors.
+class ScaledNonbondPair {
+public:
+    ScaledNonbondPair() : vdwScale(1), coulombScale(1) {}
+    ScaledNonbondPair(DuMM::NonbondAtomIndex nax1, DuMM::NonbondAtomIndex nax2,
+                      Real vdwScale, Real coulombScale)
+    :   nax1(nax1), nax2(nax2), vdwScale(vdwScale), coulombScale(coulombScale)
+    {}
+
+    DuMM::NonbondAtomIndex  nax1, nax2;
+    Real                    vdwScale, coulombScale;
+};
+
+
+
+//-----------------------------------------------------------------------------
+//                         NONBOND NEIGHBOR LIST
+//-----------------------------------------------------------------------------
+// When a nonbonded cutoff is in use we keep a Verlet list of candidate pairs
+// of nonbond atoms that were within cutoff+skin of one another when the list
+// was last built. Only cross-body pairs are kept, except for scaled pairs 
+// which are calculated separately, and each pair appears once, with its 
+// lower-numbered atom first. The pairs are grouped by the pair of bodies they
+// join, so that a body pair whose atoms are all out of range can be skipped
+// as a whole. Within a body pair, each segment holds the partners of one 
+// atom on the first body: neighbors[firstNbr] up to (but not including)
+// neighbors[endNbr], in increasing order. We also save the atom positions
+// used for the build so that we can tell when the list has to be rebuilt. 
+// This object lives in a State cache entry that depends only on Topology 
+// stage so it survives from one force evaluation to the next.
+class NonbondNeighborList {
+public:
+    struct Segment {
+        DuMM::NonbondAtomIndex  nax1;
+        unsigned                firstNbr, endNbr;
+    };
+    struct BodyPair {
+        DuMMIncludedBodyIndex   body1, body2;   // body1 < body2
+        unsigned                firstSegment, endSegment;
+    };
+
+    NonbondNeighborList() : listRadius(0) {}
+
+    bool isEmpty() const {return listRadius == 0;}
+    void clear() {
+        bodyPairs.clear(); segments.clear(); neighbors.clear(); 
+        builtPos_G.clear();
+        listRadius = 0;
+    }
+
+    int getNumPairs() const {return (int)neighbors.size();}
+    int getNumBodyPairs() const {return (int)bodyPairs.size();}
+
+    Array_<BodyPair>                            bodyPairs;
+    Array_<Segment>                             segments;
+    Array_<DuMM::NonbondAtomIndex>              neighbors;
+    Array_<Vec3, DuMM::NonbondAtomIndex>        builtPos_G;
+    Real                                        listRadius;    // cutoff+skin
+};
+
+// Unfortunately required by Value<T>.
+static inline
+std::ostream& operator<<(std::ostream& o, const NonbondNeighborList& nl) {
+    o << "NonbondNeighborList(" << nl.getNumPairs() << " pairs)\n";
+    return o;
+}
+
+
+
+//-----------------------------------------------------------------------------
+//                        MULTIPLE TIME STEP CACHE
+//-----------------------------------------------------------------------------
+// For multiple time stepping we save the unweighted body forces and the 
+// energy of each slow force group, along with the step number at which they
+// were calculated (-1 if they haven't been). This lives in a State cache 
+// entry that depends on Position stage, so it never outlives the 
+// configuration and time it was calculated for.
+class MultipleTimeStepCache {
+public:
+    MultipleTimeStepCache() {clear();}
+
+    void clear() {
+        for (int g=0; g < DuMMForceFieldSubsystem::NumForceGroups; ++g)
+        {   energy[g] = 0; step[g] = -1; }
+    }
+
+    Vector_<SpatialVec> bodyForces_G[DuMMForceFieldSubsystem::NumForceGroups];
+    Real                energy[DuMMForceFieldSubsystem::NumForceGroups];
+    long long           step[DuMMForceFieldSubsystem::NumForceGroups];
+};
+
+// Unfortunately required by Value<T>.
+static inline
+std::ostream& operator<<(std::ostream& o, const MultipleTimeStepCache&) {
+    o << "MultipleTimeStepCache\n";
+    return o;
+}
+
+
+
 //-----------------------------------------------------------------------------
 //                       DuMM FORCE FIELD SUBSYSTEM REP
 //-----------------------------------------------------------------------------
@@ -1414,22 +1688,55 @@ public:
         tracing                     = false;
         useMultithreadedComputation = true;
         numThreadsRequested         = 0; // let DuMM pick
+        nonbondedTileSize           = 32;
+
+        useNonbondedCutoff          = false;
+        nonbondedCutoff             = 1;   // nm
+        neighborListSkin            = Real(0.2); // nm
+        neighborListBuildCount      = 0;
+        topologyWalkThreads         = 0;
+        topologyCrossBodyBytes      = 0;
+
+        usePeriodicBox              = false;
+        periodicBox                 = Vec3(0);
+        useEwaldElectrostatics      = true;
+        ewaldErrorTolerance         = Real(5e-4);
+
+        multipleTimeStepSize        = 0; // off
+        for (int g=0; g < DuMMForceFieldSubsystem::NumForceGroups; ++g)
+            forceGroupInterval[g]   = 1;
+
+        useVectorizedNonbondedKernels = true;
 
         wantOpenMMAcceleration      = false;
         allowOpenMMReference        = false;
 
         gbsaIncludeAceApproximation = true;
+        useGbsaCutoff               = false;
+        gbsaCutoff                  = 2;   // nm
+        useGbsaMixedPrecision       = false;
+        useFusedGbsaNonbonded       = false;
+        useGbsaBornRadiusCache      = false;
         gbsaSolventDielectric = 80; // default for water
         gbsaSoluteDielectric  = 1;  // default for protein
 
         gbsaCpuObc = 0;
 
+        usingEwald          = false;
+        ewaldAlpha          = 0;
+        ewaldConstantEnergy = 0;
+        pmeSolver           = 0;
+
+        numNonbondClasses   = 0;
+        nonbondKernelType   = DuMMNonbondKernels::Scalar;
+        nonbondRowKernel    = 0;
+        nonbondEnergyRowKernel = 0;
+
         usingOpenMM     = false;
         openMMPluginIfc = 0;
 
         numThreadsInUse   = 0;
-        nonbondedExecutor = 0;  // these are allocated if we end up multithreaded
-        gbsaExecutor      = 0;
+        gbsaExecutor      = 0;  // these are allocated if we end up multithreaded
         executor          = 0;
 
         const DuMM::ClusterIndex gid = 
@@ -1439,10 +1746,10 @@ public:
     }
 
     ~DuMMForceFieldSubsystemRep() {
-        delete nonbondedExecutor;
         delete gbsaExecutor;
         delete executor;
         delete gbsaCpuObc;
+        delete pmeSolver;
         delete openMMPluginIfc;
     }
 
@@ -1698,6 +2005,11 @@ public:
     // someone asks for them earlier (they only depend on Positions).
     void realizeForcesAndEnergy(const State&) const;
 
+    // If someone asks only for the potential energy before forces have been
+    // calculated, we can calculate just that. It goes in a separate cache
+    // entry from the energy that is calculated along with forces.
+    void realizeEnergyOnly(const State&) const;
+
     // Override virtual methods from Subsystem::Guts class.
 
     DuMMForceFieldSubsystemRep* cloneImpl() const {
@@ -1708,6 +2020,10 @@ public:
     // onto bodies.
     int realizeSubsystemTopologyImpl(State& s) const;
 
+    // Helper for realizeSubsystemTopologyImpl(); see the definition.
+    void findCrossBodyBonds(DuMM::AtomIndex anum, BondPathScratch& scratch,
+                            CrossBodyBondInfo& x) const;
+
     int realizeSubsystemModelImpl(State& s) const {
         // Nothing to compute here.
         return 0;
@@ -1747,36 +2063,165 @@ public:
     // last change to Position-stage state variables.
     Real calcPotentialEnergy(const State& state) const;
 
-    // We scale short range interactions but only for bonds which cross bodies.
-    void scaleBondedAtoms(const IncludedAtom&   atom,  
-                          Array_<Real,DuMM::NonbondAtomIndex>&     vdwScale,  
-                          Array_<Real,DuMM::NonbondAtomIndex>&     coulombScale) const;
-    void unscaleBondedAtoms(const IncludedAtom& atom,  
-                            Array_<Real,DuMM::NonbondAtomIndex>&   vdwScale,  
-                            Array_<Real,DuMM::NonbondAtomIndex>&   coulombScale) const;
+    // Copy nonbond atom positions into the structure-of-arrays buffers used
+    // by the nonbonded kernels and zero the matching force buffers; then 
+    // after the kernels have run, add the forces back in to the included atom
+    // force array.
+    void packNonbondPositions(const Vector_<Vec3>& inclAtomPos_G) const;
+    void unpackNonbondForces(Vector_<Vec3>& inclAtomForce_G) const;
+
+    // Fill in the nonbond kernel's view of the structure-of-arrays buffers.
+    void initNonbondKernelData(DuMMNonbondKernelData& data) const;
+
+    // Run a row kernel for nonbond atom i against atoms [jBegin,jEnd), in 
+    // pieces that leave out i's scaled partners.
+    void calcNonbondRowForces
+       (DuMMNonbondRowKernel                    rowKernel,
+        const DuMMNonbondKernelData&            data,
+        DuMM::NonbondAtomIndex                  nax1,
+        int                                     jBegin,
+        int                                     jEnd,
+        Real* fx, Real* fy, Real* fz,
+        Real&                                   energy) const;
+
+    // Calculate the cross-body, unscaled interactions between the nonbond 
+    // atoms of tile blocks I and J (I <= J). Forces are *added* to the given
+    // force buffers (unless calcForces is false) and energy to energy.
+    void calcNonbondTileForces
+       (int                                     blockI,
+        int                                     blockJ,
+        bool                                    calcForces,
+        Real* fx, Real* fy, Real* fz,
+        Real&                                   energy) const;
+
+    // The same two for the fused GBSA and nonbonded calculation: every pair 
+    // gets the generalized Born pair term, and cross-body pairs that aren't 
+    // scaled get Coulomb and van der Waals in the same pass. jBegin must be
+    // greater than nax1, so each pair is done once.
+    void calcGbsaNonbondRowForces
+       (const DuMMNonbondKernelData&            data,
+        const DuMMGbsaKernelData&               gbsa,
+        bool                                    calcForces,
+        DuMM::NonbondAtomIndex                  nax1,
+        int                                     jBegin,
+        int                                     jEnd,
+        Real* fx, Real* fy, Real* fz,
+        Real*                                   bornForce,
+        Real&                                   energy,
+        Real&                                   gbEnergy) const;
+    void calcGbsaNonbondTileForces
+       (int                                     blockI,
+        int                                     blockJ,
+        bool                                    calcForces,
+        const DuMMGbsaKernelData&               gbsa,
+        Real* fx, Real* fy, Real* fz,
+        Real*                                   bornForce,
+        Real&                                   energy,
+        Real&                                   gbEnergy) const;
 
     // This runs through all the nonbond atoms on the given included body, 
     // calculating nonbonded forces between those atoms and all the 
     // nonbond atoms on consecutively-numbered bodies in the range [first,last].
-    // Atom forces are *added* in to inclAtomForce_G and potential energy is 
-    // *added* to energy. Note that position and force arrays are indexed by
-    // included atom number, even though we are only interested here in nonbond
-    // atoms. That's because those arrays are used for bonded force calculations
-    // as well.
+    // Scaled pairs are skipped; see calcScaledPairNonbondedForces().
+    // Positions come from the nonbond structure-of-arrays buffers, which must
+    // have been filled in by packNonbondPositions(). Atom forces are *added* 
+    // in to the nonbond force buffers (unless calcForces is false) and 
+    // potential energy is *added* to energy.
     void calcBodySubsetNonbondedForces
        (DuMMIncludedBodyIndex                   inclBodIx,
         DuMMIncludedBodyIndex                   firstIx,
         DuMMIncludedBodyIndex                   lastIx,
+        bool                                    calcForces,
+        Real&                                   energy) const;
+
+    // This is the cutoff counterpart of calcBodySubsetNonbondedForces(). It 
+    // calculates nonbonded forces between the atom pairs of neighbor list 
+    // body pairs [begin,end) that are within the cutoff. Forces and energy 
+    // are *added* in as above.
+    void calcNeighborListNonbondedForces
+       (int                                     beginBodyPair,
+        int                                     endBodyPair,
+        const NonbondNeighborList&              list,
         const Vector_<Vec3>&                    inclAtomPos_G,
-        Array_<Real,DuMM::NonbondAtomIndex>&    vdwScale,       // temps
-        Array_<Real,DuMM::NonbondAtomIndex>&    coulombScale,
+        const Vector_<Vec3>&                    inclBodySphereCenter_G,
+        bool                                    calcForces,
+        Vector_<Vec3>&                          inclAtomForce_G,
+        Real&                                   energy) const;
+
+    // This does the scaled cross-body pairs that the two methods above skip,
+    // honoring the cutoff, periodic box, and Ewald settings. Forces and 
+    // energy are *added* in as above.
+    void calcScaledPairNonbondedForces
+       (const Vector_<Vec3>&                    inclAtomPos_G,
+        bool                                    calcForces,
         Vector_<Vec3>&                          inclAtomForce_G,
         Real&                                   energy) const;
+
+    // These evaluate the built-in parts of a range of flattened bonded 
+    // terms for calcBondedForces(), either adding forces to the included 
+    // bodies or, if termForces is not null, writing them to term force slots.
+    // They are also used by BondedForceTask.
+    void calcBondStretchRange   // 1-2
+       (int begin, int end,
+        const Vector_<Vec3>&    inclAtomStation_G,
+        const Vector_<Vec3>&    inclAtomPos_G,
+        bool                    calcForces,
+        SpatialVec*             termForces,
+        Vector_<SpatialVec>&    inclBodyForces_G,
+        Real&                   energy) const;
+    void calcBondBendRange      // 1-2-3
+       (int begin, int end,
+        const Vector_<Vec3>&    inclAtomStation_G,
+        const Vector_<Vec3>&    inclAtomPos_G,
+        bool                    calcForces,
+        SpatialVec*             termForces,
+        Vector_<SpatialVec>&    inclBodyForces_G,
+        Real&                   energy) const;
+    // This is used for both proper and Amber improper torsions.
+    void calcBondTorsionRange   // 1-2-3-4
+       (const Array_<FlatBondTorsion>&  terms,
+        Real                    scaleFactor,
+        int begin, int end,
+        const Vector_<Vec3>&    inclAtomStation_G,
+        const Vector_<Vec3>&    inclAtomPos_G,
+        bool                    calcForces,
+        SpatialVec*             termForces,
+        Vector_<SpatialVec>&    inclBodyForces_G,
+        Real&                   energy) const;
+    
+    // Return true if the nonbond bounding spheres of two included bodies are
+    // farther apart than the cutoff, in which case no atom pair between them
+    // can interact. The minimum image of the center separation is a lower 
+    // bound on the separation of any images of the spheres.
+    bool areBodiesBeyondCutoff(DuMMIncludedBodyIndex        b1,
+                               DuMMIncludedBodyIndex        b2,
+                               const Vector_<Vec3>&         sphereCenter_G) const
+    {   const Real r = nonbondedCutoff + includedBodies[b1].nonbondSphereRadius
+                                       + includedBodies[b2].nonbondSphereRadius;
+        return applyMinimumImage(sphereCenter_G[b2] 
+                                 - sphereCenter_G[b1]).normSqr() > r*r; }
+
+    // Return the nearest periodic image of a separation vector; this does
+    // nothing if there is no periodic box.
+    Vec3 applyMinimumImage(const Vec3& r) const {
+        if (!usePeriodicBox) return r;
+        Vec3 rmin;
+        for (int k=0; k<3; ++k)
+            rmin[k] = r[k] - periodicBox[k]*std::floor(r[k]/periodicBox[k] + 0.5);
+        return rmin;
+    }
     
     void dump() const;
 
 	// How many times has the forcefield been evaluated?
 	long long getForceEvaluationCount() const {return forceEvaluationCount;}
+	long long getNeighborListBuildCount() const {return neighborListBuildCount;}
+    int getNumGbsaBornRadiiRecomputed() const
+    {   return gbsaCpuObc ? gbsaCpuObc->getNumberOfRecomputedBornRadii() : 0; }
+
+    // Report the time taken by each step of the last topology realization
+    // and the memory used by the main data structures it built.
+    void dumpTopologyStatistics(std::ostream& o) const;
 
     std::ostream& generateBiotypeChargedAtomTypeSelfCode(std::ostream& os) const;
     DuMM::ChargedAtomTypeIndex getBiotypeChargedAtomType(BiotypeIndex biotypeIx) const;
@@ -1839,13 +2284,39 @@ private:
         gbsaNumberOfCovalentBondPartners.clear();
         gbsaRadii.clear();
         gbsaObcScaleFactors.clear();
-        gbsaCoordinatePointers.clear();
-        gbsaAtomicForcePointers.clear();
-        gbsaRawCoordinates.clear();
-        gbsaAtomicForces.clear();
+        gbsaForceX.clear(); gbsaForceY.clear(); gbsaForceZ.clear();
 
         delete gbsaCpuObc;          gbsaCpuObc = 0;
 
+        bondStretchTable.clear();
+        bondBendTable.clear();
+        bondTorsionTable.clear();
+        amberImproperTorsionTable.clear();
+
+        topologyStepTimes.clear();
+        topologyWalkThreads    = 0;
+        topologyCrossBodyBytes = 0;
+
+        usingEwald = false;
+        ewaldAlpha = ewaldConstantEnergy = 0;
+        ewaldCharges.clear();
+        pmePositions.clear();
+        pmeForces.clear();
+        delete pmeSolver;           pmeSolver = 0;
+
+        numNonbondClasses = 0;
+        nonbondClassIx.clear();
+        nonbondEndOfBody.clear();
+        nonbondBodyIx.clear();
+        nonbondCharge.clear();
+        nonbondVdwDij2.clear();
+        nonbondVdwEij.clear();
+        nonbondKernelType = DuMMNonbondKernels::Scalar;
+        nonbondRowKernel  = 0;
+        nonbondEnergyRowKernel = 0;
+        nonbondPosX.clear(); nonbondPosY.clear(); nonbondPosZ.clear();
+        nonbondForceX.clear(); nonbondForceY.clear(); nonbondForceZ.clear();
+
         usingOpenMM = false;
         openMMPlatformInUse.clear();
         delete openMMPluginIfc;     openMMPluginIfc = 0;
@@ -1854,66 +2325,140 @@ private:
 #if SIMBODY_CURRENT_VERSION >= SIMBODY_VERSION_CHECK(3, 8, 0)
         usingMultithreaded = false;
         numThreadsInUse    = 0;
-        delete nonbondedExecutor;   nonbondedExecutor = 0;
+        nonbondTileRowStart.clear();
         delete gbsaExecutor;        gbsaExecutor = 0;
         delete executor;            executor = 0;
 #endif // SIMBODY_VERSION_CHECK
 
-        vdwScaleSingleThread.clear();
-        coulombScaleSingleThread.clear();
+        scaledNonbondPairs.clear();
+        firstScaledNonbondPair.clear();
+
+        flatBondStretches.clear();   customBondStretches.clear();
+        flatBondBends.clear();       customBondBends.clear();
+        flatBondTorsions.clear();    customBondTorsions.clear();
+        flatImproperTorsions.clear();
+        flatTorsionTerms.clear();
+        bondedTermBatches.clear();
+        firstBondedSlotOfBody.clear();
+        bondedSlotsOfBody.clear();
 
         inclAtomStationCacheIndex.invalidate(); 
         inclAtomPositionCacheIndex.invalidate();
+        inclBodySphereCenterCacheIndex.invalidate();
         inclAtomVelocityCacheIndex.invalidate();
         inclAtomForceCacheIndex.invalidate();
         inclBodyForceCacheIndex.invalidate();
         energyCacheIndex.invalidate();
+        energyOnlyCacheIndex.invalidate();
+        nonbondNeighborListCacheIndex.invalidate();
+        multipleTimeStepCacheIndex.invalidate();
     }
 
-    // These are used by realizeSubsystemDynamicsImpl().
-    void calcBondStretch    // 1-2
-       (DuMM::IncludedAtomIndex a1,
-        const Vector_<Vec3>&    inclAtomStation_G,
-        const Vector_<Vec3>&    inclAtomPos_G,
-        Real                    scaleFactor,
-        Real                    customScaleFactor,
-        Vector_<SpatialVec>&    inclBodyForces_G,
-        Real&                   energy) const;
-    void calcBondBend       // 1-2-3
-       (DuMM::IncludedAtomIndex a1,
-        const Vector_<Vec3>&    inclAtomStation_G,
-        const Vector_<Vec3>&    inclAtomPos_G,
-        Real                    scaleFactor,
-        Real                    customScaleFactor,
+    // Force groups are selected by a bit mask with bit (1 << g) set for
+    // each DuMMForceFieldSubsystem::ForceGroup g that is wanted.
+    static unsigned forceGroupBit(int g) {return 1u << g;}
+    static unsigned allForceGroups() 
+    {   return (1u << DuMMForceFieldSubsystem::NumForceGroups) - 1; }
+
+    bool isUsingMultipleTimeStepping() const {
+        if (multipleTimeStepSize <= 0) return false;
+        for (int g=0; g < DuMMForceFieldSubsystem::NumForceGroups; ++g)
+            if (forceGroupInterval[g] > 1) return true;
+        return false;
+    }
+
+    // This does the work for realizeForcesAndEnergy() and realizeEnergyOnly().
+    // Only the terms belonging to the selected force groups are included.
+    void calcForcesAndEnergy
+       (const State&            s,
+        bool                    calcForces,
+        unsigned                forceGroups,
+        Vector_<Vec3>&          inclAtomForce_G,
         Vector_<SpatialVec>&    inclBodyForces_G,
         Real&                   energy) const;
-    void calcBondTorsion    // 1-2-3-4 (not incl. improper)
-       (DuMM::IncludedAtomIndex a1,
-        const Vector_<Vec3>&    inclAtomStation_G,
+
+    // These are used by calcForcesAndEnergy(). If calcForces is false they
+    // calculate only energy and don't touch the force arrays.
+    void calcBondedForces
+       (const Vector_<Vec3>&    inclAtomStation_G,
         const Vector_<Vec3>&    inclAtomPos_G,
-        Real                    scaleFactor,
-        Real                    customScaleFactor,
+        bool                    calcForces,
         Vector_<SpatialVec>&    inclBodyForces_G,
         Real&                   energy) const;
-    void calcAmberImproperTorsion
-       (DuMM::IncludedAtomIndex a1,
-        const Vector_<Vec3>&    inclAtomStation_G,
+
+    void calcCustomBondedTerms
+       (const Vector_<Vec3>&    inclAtomStation_G,
         const Vector_<Vec3>&    inclAtomPos_G,
-        Real                    scaleFactor,
+        bool                    calcForces,
         Vector_<SpatialVec>&    inclBodyForces_G,
         Real&                   energy) const;
 
   
     void calcNonbondedForces
        (const Vector_<Vec3>&    inclAtomPos_G,
+        bool                    calcForces,
         Vector_<Vec3>&          inclAtomForces_G,
         Real&                   energy) const; 
 
+    // These are used only when a nonbonded cutoff is in effect.
+    bool isNeighborListRebuildNeeded
+       (const Vector_<Vec3>&        inclAtomPos_G,
+        const NonbondNeighborList&  list) const;
+    void buildNonbondNeighborList
+       (const Vector_<Vec3>&        inclAtomPos_G,
+        NonbondNeighborList&        list) const;
+
+    // These are used only for Ewald electrostatics in a periodic box.
+    void calcEwaldExclusionCorrections
+       (const Vector_<Vec3>&        inclAtomPos_G,
+        bool                        calcForces,
+        Vector_<Vec3>&              inclAtomForces_G,
+        Real&                       energy) const;
+    void calcEwaldReciprocalForces
+       (const Vector_<Vec3>&        inclAtomPos_G,
+        bool                        calcForces,
+        Vector_<Vec3>&              inclAtomForces_G,
+        Real&                       energy) const;
+
     void calcGBSAForces
        (const Vector_<Vec3>&    inclAtomStation_G,
         const Vector_<Vec3>&    inclAtomPos_G,
+        bool                    positionsArePacked,
         bool                    useParallel,
         Real                    gbsaGlobalScaleFac,
+        bool                    calcForces,
+        Vector_<SpatialVec>&    inclBodyForces_G,
+        Real&                   energy) const; 
+
+    // Per-atom GBSA energies of a State; see 
+    // DuMMForceFieldSubsystem::calcGbsaAtomEnergies().
+    void calcGbsaAtomEnergies
+       (const State&            s,
+        Vector&                 gbEnergies,
+        Vector&                 aceEnergies) const;
+
+    // Add the forces left in the GBSA force buffers to the bodies.
+    void applyGBSAForcesToBodies
+       (const Vector_<Vec3>&    inclAtomStation_G,
+        Real                    gbsaGlobalScaleFac,
+        Vector_<SpatialVec>&    inclBodyForces_G) const;
+
+    // Can the all-pairs nonbonded and GBSA calculations be done in one pass
+    // with calcFusedGbsaNonbondedForces()? 
+    bool isFusedGbsaNonbondedPossible() const {
+        return useFusedGbsaNonbonded && gbsaCpuObc && !usingOpenMM
+            && !useNonbondedCutoff && !useGbsaCutoff && !useGbsaMixedPrecision;
+    }
+
+    // All-pairs Coulomb, van der Waals and GBSA in a single pass over the 
+    // atom pairs once the Born radii are known, serial or multithreaded. 
+    // Scaled pairs' nonbonded terms are left for 
+    // calcScaledPairNonbondedForces().
+    void calcFusedGbsaNonbondedForces
+       (const Vector_<Vec3>&    inclAtomStation_G,
+        const Vector_<Vec3>&    inclAtomPos_G,
+        bool                    calcForces,
+        Vector_<Vec3>&          inclAtomForces_G,
         Vector_<SpatialVec>&    inclBodyForces_G,
         Real&                   energy) const; 
 
@@ -1959,6 +2504,15 @@ private:
     {   return Value<Vector_<Vec3> >::downcast
             (getCacheEntry(s, inclAtomPositionCacheIndex)); }
 
+    // Ground frame centers of the included bodies' nonbond bounding spheres;
+    // these are calculated only when there is a nonbonded cutoff.
+    Vector_<Vec3>& updIncludedBodySphereCenterCache(const State& s) const
+    {   return Value<Vector_<Vec3> >::downcast
+            (updCacheEntry(s, inclBodySphereCenterCacheIndex)); }
+    const Vector_<Vec3>& getIncludedBodySphereCenterCache(const State& s) const
+    {   return Value<Vector_<Vec3> >::downcast
+            (getCacheEntry(s, inclBodySphereCenterCacheIndex)); }
+
     // Atom velocities are lazy evaluated.
     Vector_<Vec3>& updIncludedAtomVelocityCache(const State& s) const
     {   return Value<Vector_<Vec3> >::downcast
@@ -1983,6 +2537,32 @@ private:
     void markEnergyCacheRealized(const State& s) const
     {   markCacheValueRealized(s, energyCacheIndex); }
 
+    // This is the potential energy calculated without forces.
+    Real& updEnergyOnlyCache(const State& s) const
+    {   return Value<Real>::downcast(updCacheEntry(s, energyOnlyCacheIndex)); }
+    Real  getEnergyOnlyCache(const State& s) const
+    {   return Value<Real>::downcast(getCacheEntry(s, energyOnlyCacheIndex)); }
+    bool isEnergyOnlyCacheRealized(const State& s) const
+    {   return isCacheValueRealized(s, energyOnlyCacheIndex); }
+    void markEnergyOnlyCacheRealized(const State& s) const
+    {   markCacheValueRealized(s, energyOnlyCacheIndex); }
+
+    // The neighbor list is allocated at Topology stage and is never 
+    // invalidated by later changes; we decide ourselves when to rebuild it.
+    NonbondNeighborList& updNonbondNeighborListCache(const State& s) const
+    {   return Value<NonbondNeighborList>::downcast
+            (updCacheEntry(s, nonbondNeighborListCacheIndex)); }
+
+    // The slow force group results for multiple time stepping can be 
+    // realized any time after Position stage, along with the forces.
+    MultipleTimeStepCache& updMultipleTimeStepCache(const State& s) const
+    {   return Value<MultipleTimeStepCache>::downcast
+            (updCacheEntry(s, multipleTimeStepCacheIndex)); }
+    bool isMultipleTimeStepCacheRealized(const State& s) const
+    {   return isCacheValueRealized(s, multipleTimeStepCacheIndex); }
+    void markMultipleTimeStepCacheRealized(const State& s) const
+    {   markCacheValueRealized(s, multipleTimeStepCacheIndex); }
+
     // Forces can be realized any time after Position stage but won't be until
     // someone asks for them.
 
@@ -2018,6 +2598,8 @@ public:
 
 	// keep track of how many forceEvaluations have been computed
 	mutable long long forceEvaluationCount;
+	// and how many times the nonbonded neighbor list has been built
+	mutable long long neighborListBuildCount;
 
         // TOPOLOGICAL STATE VARIABLES
         //   Filled in during construction.
@@ -2064,6 +2646,22 @@ public:
     std::map<AtomClassIndexQuad,   BondTorsion> bondTorsion;
     std::map<AtomClassIndexQuad,   BondTorsion> amberImproperTorsion;
 
+    // Hash table indices of the four maps above, built from them at the start
+    // of topology realization for the lookups made there. TOPOLOGY STAGE
+    AtomClassTupleTable<AtomClassIndexPair,  2,BondStretch> bondStretchTable;
+    AtomClassTupleTable<AtomClassIndexTriple,3,BondBend>    bondBendTable;
+    AtomClassTupleTable<AtomClassIndexQuad,  4,BondTorsion> bondTorsionTable;
+    AtomClassTupleTable<AtomClassIndexQuad,  4,BondTorsion> 
+                                                    amberImproperTorsionTable;
+
+    // Wall clock seconds taken by each step of the last topology 
+    // realization, the number of threads used to walk the bond graph, and 
+    // the size of the temporary cross-body connection lists (freed before 
+    // realization finishes), for dumpTopologyStatistics(). TOPOLOGY STAGE
+    Array_<std::pair<std::string,double> >  topologyStepTimes;
+    int                                     topologyWalkThreads;
+    double                                  topologyCrossBodyBytes;
+
     // Which rule to use for combining van der Waals radii and energy well
     // depth for dissimilar atom classes.
     DuMMForceFieldSubsystem::VdwMixingRule  vdwMixingRule;
@@ -2087,12 +2685,36 @@ public:
     bool gbsaIncludeAceApproximation;
     Real gbsaSolventDielectric; // typically 80 for water
     Real gbsaSoluteDielectric;  // typically 1 or 2 for protein
+    bool useGbsaCutoff;         // GB pairs only within gbsaCutoff
+    Real gbsaCutoff;            // nm
+    bool useGbsaMixedPrecision; // all-pairs GB terms in single precision
+    bool useFusedGbsaNonbonded; // GB pair terms in the nonbonded pass
+    bool useGbsaBornRadiusCache; // reuse Born radius sums of unmoved atoms
 
     bool tracing; // for debugging
 
     // Control use of multithreading.
     bool useMultithreadedComputation;
     int  numThreadsRequested;   // 0 means let DuMM choose
+    int  nonbondedTileSize;     // atoms per side of a parallel nonbonded tile
+
+    // Control nonbonded cutoff and its neighbor list.
+    bool useNonbondedCutoff;
+    Real nonbondedCutoff;       // nm
+    Real neighborListSkin;      // nm
+
+    // Control periodic boundary conditions and Ewald electrostatics.
+    bool usePeriodicBox;
+    Vec3 periodicBox;           // nm; box edge lengths
+    bool useEwaldElectrostatics;
+    Real ewaldErrorTolerance;
+
+    // Control multiple time stepping; see realizeForcesAndEnergy().
+    Real multipleTimeStepSize;  // ps; 0 means off
+    int  forceGroupInterval[DuMMForceFieldSubsystem::NumForceGroups];
+
+    // Allow use of SIMD nonbonded kernels if the processor supports them.
+    bool useVectorizedNonbondedKernels;
 
     // Control use of OpenMM.
     bool wantOpenMMAcceleration;
@@ -2122,6 +2744,25 @@ public:
     Array_<DuMM::IncludedAtomIndex, DuMM::NonbondAtomIndex> nonbondAtoms;
     Array_<DuMM::IncludedAtomIndex, DuMMBondStarterIndex>   bondStarterAtoms;
 
+    // Bonded terms flattened by type; see FlatBondStretch. The custom arrays
+    // list only the terms that have custom parts. Amber improper torsions 
+    // have no custom terms.
+    Array_<FlatBondStretch>     flatBondStretches,    customBondStretches;
+    Array_<FlatBondBend>        flatBondBends,        customBondBends;
+    Array_<FlatBondTorsion>     flatBondTorsions,     customBondTorsions;
+    Array_<FlatBondTorsion>     flatImproperTorsions;
+    Array_<TorsionTerm>         flatTorsionTerms;
+
+    // For parallel bonded evaluation; see BondedTermBatch. For each included
+    // body we list the term force slots to be summed into its spatial force,
+    // in increasing order (compressed sparse row format). The per-evaluation
+    // slot forces and batch energies are kept here too.
+    Array_<BondedTermBatch>                     bondedTermBatches;
+    Array_<unsigned, DuMMIncludedBodyIndex>     firstBondedSlotOfBody; // nBod+1
+    Array_<unsigned>                            bondedSlotsOfBody;
+    mutable Array_<SpatialVec>                  bondedTermForces;
+    mutable Array_<Real>                        bondedBatchEnergy;
+
     // Used for GBSA, which works only with nonbond atoms.
     Array_<RealOpenMM, DuMM::NonbondAtomIndex> gbsaAtomicPartialCharges;
     Array_<int,        DuMM::NonbondAtomIndex> gbsaAtomicNumbers;
@@ -2130,22 +2771,62 @@ public:
     Array_<RealOpenMM, DuMM::NonbondAtomIndex> gbsaRadii;
     Array_<RealOpenMM, DuMM::NonbondAtomIndex> gbsaObcScaleFactors;
 
-    Array_<RealOpenMM*, DuMM::NonbondAtomIndex> gbsaCoordinatePointers;
-    Array_<RealOpenMM*, DuMM::NonbondAtomIndex> gbsaAtomicForcePointers;
     CpuObc*  gbsaCpuObc;
 
-    // GBSA runtime temps.
-
-    // Angstrom
-    mutable Array_<RealOpenMM>  gbsaRawCoordinates;
-    mutable Array_<RealOpenMM>  gbsaAtomicForces;
-
-    // These arrays are used for vdw and coulomb scaling for neighbor
-    // atoms, when we're in single-threaded mode. When running multithreaded
-    // each thread has a local one of these. These arrays have one entry
-    // per included nonbond atom and must be initialized to all-1.
-    mutable Array_<Real, DuMM::NonbondAtomIndex> vdwScaleSingleThread;
-    mutable Array_<Real, DuMM::NonbondAtomIndex> coulombScaleSingleThread;
+    // Used for Ewald electrostatics. The constant energy includes the self
+    // energy, the neutralizing background for a net charge, and the 
+    // exclusion of same-body pairs from the reciprocal space sum; none of
+    // these produce forces. Charges are indexed by nonbond atom.
+    bool                                        usingEwald;
+    Real                                        ewaldAlpha;          // 1/nm
+    Real                                        ewaldConstantEnergy; // e^2/nm
+    Array_<Real, DuMM::NonbondAtomIndex>        ewaldCharges;        // e
+    DuMMPmeSolver*                              pmeSolver;
+    mutable Array_<Vec3, DuMM::NonbondAtomIndex> pmePositions;       // nm
+    mutable Array_<Vec3, DuMM::NonbondAtomIndex> pmeForces;
+
+    // Used by the nonbonded kernels. Atom classes used by nonbond atoms are
+    // renumbered densely and the mixed van der Waals parameters for every 
+    // pair of those classes are stored in square numNonbondClasses^2 tables
+    // so that no branch is needed to find the lower-numbered class. The
+    // dmin values are stored squared since that's how they are used.
+    int                                         numNonbondClasses;
+    Array_<int,  DuMM::NonbondAtomIndex>        nonbondClassIx;
+    Array_<DuMM::NonbondAtomIndex,
+           DuMM::NonbondAtomIndex>              nonbondEndOfBody; // of the atom's body
+    Array_<DuMMIncludedBodyIndex,
+           DuMM::NonbondAtomIndex>              nonbondBodyIx;
+    Array_<Real, DuMM::NonbondAtomIndex>        nonbondCharge;  // e
+    Array_<Real>                                nonbondVdwDij2; // nm^2
+    Array_<Real>                                nonbondVdwEij;  // kJ/mol
+    DuMMNonbondKernels::KernelType              nonbondKernelType;
+    DuMMNonbondRowKernel                        nonbondRowKernel;
+    DuMMNonbondRowKernel                        nonbondEnergyRowKernel;
+
+    // Nonbond kernel runtime temps, in structure-of-arrays layout.
+    mutable Array_<Real, DuMM::NonbondAtomIndex> nonbondPosX, nonbondPosY, 
+                                                 nonbondPosZ;   // nm
+    mutable Array_<Real, DuMM::NonbondAtomIndex> nonbondForceX, nonbondForceY,
+                                                 nonbondForceZ;
+
+    // GBSA runtime temps. GBSA reads the nonbond positions above and 
+    // writes its own forces, in kJ/mol-nm, also indexed by nonbond atom.
+    mutable Array_<RealOpenMM, DuMM::NonbondAtomIndex> gbsaForceX, gbsaForceY,
+                                                       gbsaForceZ;
+
+    // The multithreaded all-pairs nonbonded calculation divides the nonbond
+    // atoms into blocks of nonbondedTileSize consecutive atoms. The units of
+    // work are the tiles (I,J) with I <= J, numbered row by row; the tiles of
+    // row I start at nonbondTileRowStart[I] and the last entry is the total.
+    Array_<long long>                           nonbondTileRowStart; // nBlocks+1
+
+    // Cross-body nonbond atom pairs whose interactions are scaled, sorted by
+    // nax1 and then nax2. The pairs for nonbond atom i are 
+    // scaledNonbondPairs[firstScaledNonbondPair[i]] up to (but not including)
+    // scaledNonbondPairs[firstScaledNonbondPair[i+1]]. Pairs whose scale 
+    // factors are both 1 aren't included.
+    Array_<ScaledNonbondPair>                   scaledNonbondPairs;
+    Array_<unsigned, DuMM::NonbondAtomIndex>    firstScaledNonbondPair; // nNonbond+1
     
     // Used for multithreaded computation.
 #if SIMBODY_CURRENT_VERSION >= SIMBODY_VERSION_CHECK(3, 8, 0)
@@ -2155,7 +2836,6 @@ public:
     const bool usingMultithreaded;
 #endif // SIMBODY_VERSION_CHECK
     int                     numThreadsInUse;
-    Parallel2DExecutor*     nonbondedExecutor;
     Parallel2DExecutor*     gbsaExecutor;
     ParallelExecutor*       executor;
 
@@ -2167,10 +2847,14 @@ public:
 
     CacheEntryIndex         inclAtomStationCacheIndex;
     CacheEntryIndex         inclAtomPositionCacheIndex;
+    CacheEntryIndex         inclBodySphereCenterCacheIndex;
     CacheEntryIndex         inclAtomVelocityCacheIndex;
     CacheEntryIndex         inclAtomForceCacheIndex;
     CacheEntryIndex         inclBodyForceCacheIndex;
     CacheEntryIndex         energyCacheIndex;
+    CacheEntryIndex         energyOnlyCacheIndex;
+    CacheEntryIndex         nonbondNeighborListCacheIndex;
+    CacheEntryIndex         multipleTimeStepCacheIndex;
 };
 
 
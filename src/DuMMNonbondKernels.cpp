@@ -0,0 +1,422 @@
+/* -------------------------------------------------------------------------- *
+ *                             SimTK Molmodel(tm)                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+
+/**@file
+ *
+ * Implementation of the scalar and vectorized nonbonded kernels used by
+ * DuMMForceFieldSubsystem.
+ */
+
+#include "DuMMNonbondKernels.h"
+
+#include <cmath>
+
+// The vectorized kernels are compiled for specific instruction sets using 
+// function attributes so that the rest of the library doesn't require them;
+// we check for processor support before calling them.
+// These kernels assume that Real is double.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) \
+    && SimTK_DEFAULT_PRECISION == 2
+    #define DUMM_X86_KERNELS
+    #include <immintrin.h>
+#endif
+
+using namespace SimTK;
+
+
+//------------------------------------------------------------------------------
+//                            SCALAR ROW KERNEL
+//------------------------------------------------------------------------------
+// This is the reference implementation; the arithmetic is done in the same
+// order as in the original DuMM nonbonded loop. If CalcForces is false only
+// the energy is accumulated and the force arrays are not touched.
+template <bool CalcForces>
+static void scalarRowKernel
+   (const DuMMNonbondKernelData& d, int i, int jBegin, int jEnd,
+    Real* fx, Real* fy, Real* fz, Real& energy)
+{
+    const Real xi = d.x[i], yi = d.y[i], zi = d.z[i];
+    const Real qiFac = d.coulombFac * d.charge[i];
+    const Real* dij2Row = d.vdwDij2 + d.classIx[i]*d.numClasses;
+    const Real* eijRow  = d.vdwEij  + d.classIx[i]*d.numClasses;
+
+    Real fxi = 0, fyi = 0, fzi = 0, e = 0;
+    for (int j = jBegin; j < jEnd; ++j) {
+        const Real rx = d.x[j]-xi, ry = d.y[j]-yi, rz = d.z[j]-zi;
+        const Real d2   = rx*rx + ry*ry + rz*rz;
+        const Real ood  = 1/std::sqrt(d2);
+        const Real ood2 = ood*ood;
+
+        // Coulomb; note that fCoulomb is missing a factor of 1/d^2.
+        const Real qq       = qiFac * d.charge[j];
+        const Real eCoulomb = qq * ood;
+        const Real fCoulomb = eCoulomb;
+
+        // van der Waals; fVdw is also missing 1/d^2.
+        const int  cj     = d.classIx[j];
+        const Real ddij2  = dij2Row[cj]*ood2;
+        const Real ddij6  = ddij2*ddij2*ddij2;
+        const Real ddij12 = ddij6*ddij6;
+        const Real eijScale = d.vdwFac*eijRow[cj];
+        const Real eVdw     =      eijScale * (ddij12 - 2*ddij6);
+        e += eCoulomb + eVdw;
+        if (!CalcForces)
+            continue;
+
+        const Real fVdw = 12 * eijScale * (ddij12 - ddij6);
+
+        // Force on atom j; apply equal and opposite to atom i.
+        const Real f = (fCoulomb+fVdw)*ood2;
+        fx[j] += f*rx; fy[j] += f*ry; fz[j] += f*rz;
+        fxi   += f*rx; fyi   += f*ry; fzi   += f*rz;
+    }
+    if (CalcForces) {
+        fx[i] -= fxi; fy[i] -= fyi; fz[i] -= fzi;
+    }
+    energy += e;
+}
+//............................SCALAR ROW KERNEL.................................
+
+
+
+#ifdef DUMM_X86_KERNELS
+
+//------------------------------------------------------------------------------
+//                             AVX2 ROW KERNEL
+//------------------------------------------------------------------------------
+// Four j atoms at a time. The mixed van der Waals parameters are gathered 
+// from the row of the square tables that belongs to atom i's class. Any 
+// leftover atoms are done with the scalar kernel.
+__attribute__((target("avx2,fma")))
+static inline Real sum4(__m256d v) {
+    const __m128d lo = _mm_add_pd(_mm256_castpd256_pd128(v), 
+                                  _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+template <bool CalcForces>
+__attribute__((target("avx2,fma")))
+static void avx2RowKernel
+   (const DuMMNonbondKernelData& d, int i, int jBegin, int jEnd,
+    Real* fx, Real* fy, Real* fz, Real& energy)
+{
+    const __m256d xi = _mm256_set1_pd(d.x[i]);
+    const __m256d yi = _mm256_set1_pd(d.y[i]);
+    const __m256d zi = _mm256_set1_pd(d.z[i]);
+    const __m256d qiFac  = _mm256_set1_pd(d.coulombFac * d.charge[i]);
+    const __m256d vdwFac = _mm256_set1_pd(d.vdwFac);
+    const __m256d one    = _mm256_set1_pd(1);
+    const __m256d two    = _mm256_set1_pd(2);
+    const __m256d twelve = _mm256_set1_pd(12);
+    const Real* dij2Row = d.vdwDij2 + d.classIx[i]*d.numClasses;
+    const Real* eijRow  = d.vdwEij  + d.classIx[i]*d.numClasses;
+
+    __m256d fxi = _mm256_setzero_pd(), fyi = _mm256_setzero_pd(),
+            fzi = _mm256_setzero_pd(), e   = _mm256_setzero_pd();
+
+    int j = jBegin;
+    for (; j+4 <= jEnd; j += 4) {
+        const __m256d rx = _mm256_sub_pd(_mm256_loadu_pd(d.x+j), xi);
+        const __m256d ry = _mm256_sub_pd(_mm256_loadu_pd(d.y+j), yi);
+        const __m256d rz = _mm256_sub_pd(_mm256_loadu_pd(d.z+j), zi);
+        const __m256d d2 = _mm256_fmadd_pd(rx, rx, 
+                           _mm256_fmadd_pd(ry, ry, _mm256_mul_pd(rz, rz)));
+        const __m256d ood  = _mm256_div_pd(one, _mm256_sqrt_pd(d2));
+        const __m256d ood2 = _mm256_mul_pd(ood, ood);
+
+        const __m256d qq = _mm256_mul_pd(qiFac, _mm256_loadu_pd(d.charge+j));
+        const __m256d eCoulomb = _mm256_mul_pd(qq, ood);
+
+        const __m128i cj = _mm_loadu_si128((const __m128i*)(d.classIx+j));
+        const __m256d dij2 = _mm256_i32gather_pd(dij2Row, cj, 8);
+        const __m256d eij  = _mm256_i32gather_pd(eijRow,  cj, 8);
+        const __m256d ddij2  = _mm256_mul_pd(dij2, ood2);
+        const __m256d ddij6  = _mm256_mul_pd(_mm256_mul_pd(ddij2, ddij2), ddij2);
+        const __m256d ddij12 = _mm256_mul_pd(ddij6, ddij6);
+        const __m256d eijScale = _mm256_mul_pd(vdwFac, eij);
+        const __m256d eVdw = _mm256_mul_pd(eijScale,
+                                _mm256_fnmadd_pd(two, ddij6, ddij12));
+        e = _mm256_add_pd(e, _mm256_add_pd(eCoulomb, eVdw));
+        if (!CalcForces)
+            continue;
+
+        const __m256d fVdw = _mm256_mul_pd(_mm256_mul_pd(twelve, eijScale),
+                                _mm256_sub_pd(ddij12, ddij6));
+
+        const __m256d f   = _mm256_mul_pd(_mm256_add_pd(eCoulomb, fVdw), ood2);
+        const __m256d fjx = _mm256_mul_pd(f, rx);
+        const __m256d fjy = _mm256_mul_pd(f, ry);
+        const __m256d fjz = _mm256_mul_pd(f, rz);
+        _mm256_storeu_pd(fx+j, _mm256_add_pd(_mm256_loadu_pd(fx+j), fjx));
+        _mm256_storeu_pd(fy+j, _mm256_add_pd(_mm256_loadu_pd(fy+j), fjy));
+        _mm256_storeu_pd(fz+j, _mm256_add_pd(_mm256_loadu_pd(fz+j), fjz));
+        fxi = _mm256_add_pd(fxi, fjx);
+        fyi = _mm256_add_pd(fyi, fjy);
+        fzi = _mm256_add_pd(fzi, fjz);
+    }
+
+    if (CalcForces) {
+        fx[i] -= sum4(fxi); fy[i] -= sum4(fyi); fz[i] -= sum4(fzi);
+    }
+    energy += sum4(e);
+
+    if (j < jEnd)
+        scalarRowKernel<CalcForces>(d, i, j, jEnd, fx, fy, fz, energy);
+}
+//.............................AVX2 ROW KERNEL..................................
+
+
+
+//------------------------------------------------------------------------------
+//                            AVX-512 ROW KERNEL
+//------------------------------------------------------------------------------
+// Same as the AVX2 kernel but eight j atoms at a time.
+template <bool CalcForces>
+__attribute__((target("avx512f")))
+static void avx512RowKernel
+   (const DuMMNonbondKernelData& d, int i, int jBegin, int jEnd,
+    Real* fx, Real* fy, Real* fz, Real& energy)
+{
+    const __m512d xi = _mm512_set1_pd(d.x[i]);
+    const __m512d yi = _mm512_set1_pd(d.y[i]);
+    const __m512d zi = _mm512_set1_pd(d.z[i]);
+    const __m512d qiFac  = _mm512_set1_pd(d.coulombFac * d.charge[i]);
+    const __m512d vdwFac = _mm512_set1_pd(d.vdwFac);
+    const __m512d one    = _mm512_set1_pd(1);
+    const __m512d two    = _mm512_set1_pd(2);
+    const __m512d twelve = _mm512_set1_pd(12);
+    const Real* dij2Row = d.vdwDij2 + d.classIx[i]*d.numClasses;
+    const Real* eijRow  = d.vdwEij  + d.classIx[i]*d.numClasses;
+
+    __m512d fxi = _mm512_setzero_pd(), fyi = _mm512_setzero_pd(),
+            fzi = _mm512_setzero_pd(), e   = _mm512_setzero_pd();
+
+    int j = jBegin;
+    for (; j+8 <= jEnd; j += 8) {
+        const __m512d rx = _mm512_sub_pd(_mm512_loadu_pd(d.x+j), xi);
+        const __m512d ry = _mm512_sub_pd(_mm512_loadu_pd(d.y+j), yi);
+        const __m512d rz = _mm512_sub_pd(_mm512_loadu_pd(d.z+j), zi);
+        const __m512d d2 = _mm512_fmadd_pd(rx, rx, 
+                           _mm512_fmadd_pd(ry, ry, _mm512_mul_pd(rz, rz)));
+        const __m512d ood  = _mm512_div_pd(one, _mm512_sqrt_pd(d2));
+        const __m512d ood2 = _mm512_mul_pd(ood, ood);
+
+        const __m512d qq = _mm512_mul_pd(qiFac, _mm512_loadu_pd(d.charge+j));
+        const __m512d eCoulomb = _mm512_mul_pd(qq, ood);
+
+        const __m256i cj = _mm256_loadu_si256((const __m256i*)(d.classIx+j));
+        const __m512d dij2 = _mm512_i32gather_pd(cj, dij2Row, 8);
+        const __m512d eij  = _mm512_i32gather_pd(cj, eijRow,  8);
+        const __m512d ddij2  = _mm512_mul_pd(dij2, ood2);
+        const __m512d ddij6  = _mm512_mul_pd(_mm512_mul_pd(ddij2, ddij2), ddij2);
+        const __m512d ddij12 = _mm512_mul_pd(ddij6, ddij6);
+        const __m512d eijScale = _mm512_mul_pd(vdwFac, eij);
+        const __m512d eVdw = _mm512_mul_pd(eijScale,
+                                _mm512_fnmadd_pd(two, ddij6, ddij12));
+        e = _mm512_add_pd(e, _mm512_add_pd(eCoulomb, eVdw));
+        if (!CalcForces)
+            continue;
+
+        const __m512d fVdw = _mm512_mul_pd(_mm512_mul_pd(twelve, eijScale),
+                                _mm512_sub_pd(ddij12, ddij6));
+
+        const __m512d f   = _mm512_mul_pd(_mm512_add_pd(eCoulomb, fVdw), ood2);
+        const __m512d fjx = _mm512_mul_pd(f, rx);
+        const __m512d fjy = _mm512_mul_pd(f, ry);
+        const __m512d fjz = _mm512_mul_pd(f, rz);
+        _mm512_storeu_pd(fx+j, _mm512_add_pd(_mm512_loadu_pd(fx+j), fjx));
+        _mm512_storeu_pd(fy+j, _mm512_add_pd(_mm512_loadu_pd(fy+j), fjy));
+        _mm512_storeu_pd(fz+j, _mm512_add_pd(_mm512_loadu_pd(fz+j), fjz));
+        fxi = _mm512_add_pd(fxi, fjx);
+        fyi = _mm512_add_pd(fyi, fjy);
+        fzi = _mm512_add_pd(fzi, fjz);
+    }
+
+    if (CalcForces) {
+        fx[i] -= _mm512_reduce_add_pd(fxi); 
+        fy[i] -= _mm512_reduce_add_pd(fyi); 
+        fz[i] -= _mm512_reduce_add_pd(fzi);
+    }
+    energy += _mm512_reduce_add_pd(e);
+
+    if (j < jEnd)
+        scalarRowKernel<CalcForces>(d, i, j, jEnd, fx, fy, fz, energy);
+}
+//............................AVX-512 ROW KERNEL................................
+
+#endif // DUMM_X86_KERNELS
+
+
+
+//------------------------------------------------------------------------------
+//                          SCALAR GBSA ROW KERNEL
+//------------------------------------------------------------------------------
+// Coulomb and van der Waals exactly as in scalarRowKernel() (if 
+// IncludeNonbonded), plus the generalized Born pair term of CpuObc's first
+// force loop. The GB force along the pair is folded into the same scalar
+// as the other terms so each j atom's force is only updated once.
+template <bool CalcForces, bool IncludeNonbonded>
+static void scalarGbsaRowKernel
+   (const DuMMNonbondKernelData& d, const DuMMGbsaKernelData& gb,
+    int i, int jBegin, int jEnd, Real* fx, Real* fy, Real* fz, 
+    Real* bornForce, Real& energy, Real& gbEnergy)
+{
+    const Real xi = d.x[i], yi = d.y[i], zi = d.z[i];
+    const Real qiFac = d.coulombFac * d.charge[i];
+    const Real* dij2Row = d.vdwDij2 + d.classIx[i]*d.numClasses;
+    const Real* eijRow  = d.vdwEij  + d.classIx[i]*d.numClasses;
+    const Real bRi    = gb.bornRadius[i];
+    const Real qiGb   = gb.preFactor * gb.charge[i];
+
+    Real fxi = 0, fyi = 0, fzi = 0, e = 0, eGb = 0, bFi = 0;
+    for (int j = jBegin; j < jEnd; ++j) {
+        const Real rx = d.x[j]-xi, ry = d.y[j]-yi, rz = d.z[j]-zi;
+        const Real d2   = rx*rx + ry*ry + rz*rz;
+
+        // Generalized Born.
+        const Real alpha2 = bRi*gb.bornRadius[j];
+        const Real D      = d2/(4*alpha2);
+        const Real expTerm = std::exp(-D);
+        const Real denom2 = d2 + alpha2*expTerm;
+        const Real Gpol   = qiGb*gb.charge[j]/std::sqrt(denom2);
+        eGb += Gpol;
+
+        Real f = 0; // missing 1/d^2 for the nonbonded part, as above
+        Real ood2 = 0;
+        if (IncludeNonbonded) {
+            const Real ood  = 1/std::sqrt(d2);
+            ood2 = ood*ood;
+
+            const Real qq       = qiFac * d.charge[j];
+            const Real eCoulomb = qq * ood;
+
+            const int  cj     = d.classIx[j];
+            const Real ddij2  = dij2Row[cj]*ood2;
+            const Real ddij6  = ddij2*ddij2*ddij2;
+            const Real ddij12 = ddij6*ddij6;
+            const Real eijScale = d.vdwFac*eijRow[cj];
+            e += eCoulomb + eijScale * (ddij12 - 2*ddij6);
+            if (CalcForces)
+                f = eCoulomb + 12 * eijScale * (ddij12 - ddij6);
+        }
+        if (!CalcForces)
+            continue;
+
+        const Real dGpol_dr      = -Gpol*(1 - Real(0.25)*expTerm)/denom2;
+        const Real dGpol_dalpha2 = -Real(0.5)*Gpol*expTerm*(1 + D)/denom2;
+        bornForce[j] += dGpol_dalpha2*bRi;
+        bFi          += dGpol_dalpha2*gb.bornRadius[j];
+
+        // Force on atom j; apply equal and opposite to atom i.
+        const Real fj = f*ood2 - gb.gbsaFac*dGpol_dr;
+        fx[j] += fj*rx; fy[j] += fj*ry; fz[j] += fj*rz;
+        fxi   += fj*rx; fyi   += fj*ry; fzi   += fj*rz;
+    }
+    if (CalcForces) {
+        fx[i] -= fxi; fy[i] -= fyi; fz[i] -= fzi;
+        bornForce[i] += bFi;
+    }
+    energy   += e;
+    gbEnergy += eGb;
+}
+//..........................SCALAR GBSA ROW KERNEL..............................
+
+
+
+    //////////////////////////
+    // DUMM NONBOND KERNELS //
+    //////////////////////////
+
+/*static*/ DuMMNonbondKernels::KernelType 
+DuMMNonbondKernels::selectKernelType(bool allowVectorized) {
+    if (!allowVectorized)
+        return Scalar;
+#ifdef DUMM_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return AVX2;
+#endif
+    return Scalar;
+}
+
+/*static*/ DuMMNonbondRowKernel 
+DuMMNonbondKernels::getRowKernel(KernelType type, bool calcForces) {
+    switch (type) {
+#ifdef DUMM_X86_KERNELS
+    case AVX512: return calcForces ? avx512RowKernel<true> 
+                                   : avx512RowKernel<false>;
+    case AVX2:   return calcForces ? avx2RowKernel<true> 
+                                   : avx2RowKernel<false>;
+#endif
+    default:     return calcForces ? scalarRowKernel<true> 
+                                   : scalarRowKernel<false>;
+    }
+}
+
+/*static*/ DuMMGbsaNonbondRowKernel 
+DuMMNonbondKernels::getGbsaRowKernel(bool includeNonbonded, bool calcForces) {
+    if (includeNonbonded)
+        return calcForces ? scalarGbsaRowKernel<true,true> 
+                          : scalarGbsaRowKernel<false,true>;
+    return calcForces ? scalarGbsaRowKernel<true,false> 
+                      : scalarGbsaRowKernel<false,false>;
+}
+
+// With r=0 the pair term reduces to preFactor*q^2/bornRadius, counted once
+// rather than twice; its dE/d(bornRadius) gets the full, unhalved term as in
+// CpuObc.
+/*static*/ void 
+DuMMNonbondKernels::calcGbsaSelfTerms
+   (const DuMMGbsaKernelData& gb, int begin, int end, bool calcForces,
+    Real* bornForce, Real& gbEnergy)
+{
+    Real eGb = 0;
+    for (int i = begin; i < end; ++i) {
+        const Real Gpol = gb.preFactor*gb.charge[i]*gb.charge[i]
+                          / gb.bornRadius[i];
+        eGb += Gpol/2;
+        if (calcForces)
+            bornForce[i] -= Gpol/(2*gb.bornRadius[i]);
+    }
+    gbEnergy += eGb;
+}
+
+/*static*/ const char* 
+DuMMNonbondKernels::getKernelTypeName(KernelType type) {
+    switch (type) {
+    case AVX512: return "AVX-512";
+    case AVX2:   return "AVX2";
+    default:     return "scalar";
+    }
+}
@@ -0,0 +1,129 @@
+#ifndef SimTK_MOLMODEL_DUMM_NONBOND_KERNELS_H_
+#define SimTK_MOLMODEL_DUMM_NONBOND_KERNELS_H_
+
+/* -------------------------------------------------------------------------- *
+ *                             SimTK Molmodel(tm)                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+
+/**@file
+ * This header declares the low-level van der Waals and Coulomb kernels used
+ * by DuMMForceFieldSubsystem for its all-pairs nonbonded calculation. There
+ * is a portable scalar kernel and, on x86 processors, AVX2 and AVX-512
+ * kernels; the best one the processor supports is chosen at run time.
+ */
+
+#include "SimTKcommon.h"
+
+namespace SimTK {
+
+//-----------------------------------------------------------------------------
+//                          DuMM NONBOND KERNEL DATA
+//-----------------------------------------------------------------------------
+// Packed structure-of-arrays view of the nonbond atoms, indexed by nonbond 
+// atom number. Atom classes are renumbered densely from 0 so that the mixed
+// van der Waals parameters for a pair of atoms are found at 
+// [class1*numClasses + class2] in the square tables, regardless of order.
+// Positions and forces are in nm and kJ/nm.
+struct DuMMNonbondKernelData {
+    const Real* x;
+    const Real* y;
+    const Real* z;
+    const Real* charge;         // e
+    const int*  classIx;        // dense atom class index
+    const Real* vdwDij2;        // (dmin_ij)^2, nm^2
+    const Real* vdwEij;         // well depth, kJ
+    int         numClasses;
+    Real        coulombFac;     // global scale factor * Coulomb's constant
+    Real        vdwFac;         // global scale factor
+};
+
+// Calculate the interactions of nonbond atom i with atoms j in [jBegin,jEnd),
+// which must not include i. Forces are *added* to the force arrays (for 
+// atom i as well as the j's) and potential energy is *added* to energy. 
+// Energy-only kernels ignore the force arrays. No bonded-pair scaling is 
+// done here; the caller must leave scaled pairs out of the j range.
+typedef void (*DuMMNonbondRowKernel)
+   (const DuMMNonbondKernelData& data, int i, int jBegin, int jEnd,
+    Real* fx, Real* fy, Real* fz, Real& energy);
+
+//-----------------------------------------------------------------------------
+//                          DuMM GBSA KERNEL DATA
+//-----------------------------------------------------------------------------
+// What the fused kernels below need, beyond DuMMNonbondKernelData, for the
+// generalized Born pair terms once the Born radii are known. These are the
+// first force loop of CpuObc::computeBornEnergyForces(), which see.
+struct DuMMGbsaKernelData {
+    const Real* charge;         // GBSA partial charges, e
+    const Real* bornRadius;     // nm
+    Real        preFactor;      // GB prefactor, kJ nm/(mol e^2)
+    Real        gbsaFac;        // global scale factor for the GB forces
+};
+
+// Like DuMMNonbondRowKernel, but also adds the generalized Born pair terms 
+// for i and each j, sharing the distance calculation. GB pair forces are
+// scaled by gbsaFac and added to the force arrays with the others; 
+// dE/d(bornRadius) is *added* to bornForce for i and the j's, unscaled; the
+// unscaled GB energy is *added* to gbEnergy. The "GB only" kernels leave out
+// Coulomb and van der Waals, for pairs whose nonbonded terms are skipped or
+// scaled. Energy-only kernels ignore the force and Born force arrays.
+typedef void (*DuMMGbsaNonbondRowKernel)
+   (const DuMMNonbondKernelData& data, const DuMMGbsaKernelData& gbsa,
+    int i, int jBegin, int jEnd, Real* fx, Real* fy, Real* fz, 
+    Real* bornForce, Real& energy, Real& gbEnergy);
+
+class DuMMNonbondKernels {
+public:
+    enum KernelType {
+        Scalar = 0,
+        AVX2   = 1,
+        AVX512 = 2
+    };
+
+    // Return the fastest kernel type supported by this processor, or Scalar
+    // if vectorization is not allowed.
+    static KernelType selectKernelType(bool allowVectorized);
+    static DuMMNonbondRowKernel getRowKernel(KernelType, bool calcForces);
+    static const char* getKernelTypeName(KernelType);
+
+    // The fused GBSA kernels are scalar; the exponential in the GB pair term
+    // dominates their cost.
+    static DuMMGbsaNonbondRowKernel getGbsaRowKernel(bool includeNonbonded,
+                                                     bool calcForces);
+
+    // Add the GB self terms (the i==j "pairs") of atoms [begin,end).
+    static void calcGbsaSelfTerms(const DuMMGbsaKernelData& gbsa, 
+                                  int begin, int end, bool calcForces,
+                                  Real* bornForce, Real& gbEnergy);
+};
+
+} // namespace SimTK
+
+#endif // SimTK_MOLMODEL_DUMM_NONBOND_KERNELS_H_
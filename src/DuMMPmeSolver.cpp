@@ -0,0 +1,347 @@
+/* -------------------------------------------------------------------------- *
+ *                             SimTK Molmodel(tm)                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+
+/**@file
+ *
+ * Implementation of the in-tree FFT and smooth PME solver used by
+ * DuMMForceFieldSubsystem for periodic electrostatics.
+ */
+
+#include "DuMMPmeSolver.h"
+
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+using namespace SimTK;
+
+
+    ////////////////
+    // DUMM FFT1D //
+    ////////////////
+
+void DuMMFFT1D::setLength(int len) {
+    assert(len > 0);
+    n = len;
+
+    // Factor n into primes.
+    factors.clear();
+    int remaining = n;
+    for (int f = 2; f*f <= remaining; ++f)
+        while (remaining % f == 0) {
+            factors.push_back(f);
+            remaining /= f;
+        }
+    if (remaining > 1)
+        factors.push_back(remaining);
+
+    roots.resize(n);
+    for (int j=0; j < n; ++j) {
+        const Real angle = -2*Pi*j/n;
+        roots[j] = Complex(std::cos(angle), std::sin(angle));
+    }
+
+    work.resize(n); result.resize(n);
+    butterfly.resize(factors.empty() ? 1 : factors.back());
+}
+
+// Decimation in time. The len inputs are in[0], in[inStride], ... and the
+// len outputs go to out[0..len-1]. Each of the p interleaved subsequences is
+// transformed recursively into consecutive blocks of out, then the blocks
+// are combined with p-point butterflies. Twiddle factors for length len are
+// every twiddleStep'th entry in the length n roots table.
+void DuMMFFT1D::recurse(const Complex* in, int inStride, Complex* out,
+                        int len, int factorIx, int twiddleStep,
+                        bool forward) const
+{
+    const int p = factors[factorIx];
+    const int m = len / p;
+
+    if (m > 1)
+        for (int q=0; q < p; ++q)
+            recurse(in + q*inStride, inStride*p, out + q*m, m, factorIx+1,
+                    twiddleStep*p, forward);
+    else
+        for (int q=0; q < p; ++q)
+            out[q] = in[q*inStride];
+
+    const int pStep = n / p; // W_p = roots[pStep]
+    for (int k=0; k < m; ++k) {
+        for (int q=0; q < p; ++q) {
+            const Complex& w = roots[(q*k*twiddleStep) % n];
+            butterfly[q] = out[q*m + k] * (forward ? w : std::conj(w));
+        }
+        for (int r=0; r < p; ++r) {
+            Complex sum = butterfly[0];
+            for (int q=1; q < p; ++q) {
+                const Complex& w = roots[((q*r) % p) * pStep];
+                sum += butterfly[q] * (forward ? w : std::conj(w));
+            }
+            out[k + r*m] = sum;
+        }
+    }
+}
+
+void DuMMFFT1D::transform(Complex* data, int stride, bool forward) const {
+    if (n == 1) return;
+    for (int j=0; j < n; ++j)
+        work[j] = data[j*stride];
+    recurse(&work[0], 1, &result[0], n, 0, 1, forward);
+    for (int j=0; j < n; ++j)
+        data[j*stride] = result[j];
+}
+
+/*static*/ int DuMMFFT1D::findGoodLength(int n) {
+    for (int m = std::max(n,1); ; ++m) {
+        int r = m;
+        while (r % 2 == 0) r /= 2;
+        while (r % 3 == 0) r /= 3;
+        while (r % 5 == 0) r /= 5;
+        if (r == 1) return m;
+    }
+}
+
+
+
+    /////////////////////
+    // DUMM PME SOLVER //
+    /////////////////////
+
+/*static*/ Real DuMMPmeSolver::calcAlpha(Real cutoff, Real errorTolerance) {
+    return std::sqrt(-std::log(2*errorTolerance)) / cutoff;
+}
+
+/*static*/ Vec<3,int> DuMMPmeSolver::calcGridSize
+   (const Vec3& boxSize, Real alpha, Real errorTolerance)
+{
+    Vec<3,int> n;
+    for (int d=0; d < 3; ++d) {
+        const int nd = (int)std::ceil(2*alpha*boxSize[d]
+                                      / (3*std::pow(errorTolerance, 0.2)));
+        n[d] = DuMMFFT1D::findGoodLength(std::max(nd, 2*SplineOrder));
+    }
+    return n;
+}
+
+void DuMMPmeSolver::initialize
+   (const Vec3& boxSize, Real ewaldAlpha, const Vec<3,int>& size)
+{
+    box      = boxSize;
+    alpha    = ewaldAlpha;
+    gridSize = size;
+    for (int d=0; d < 3; ++d) {
+        fft[d].setLength(gridSize[d]);
+        calcSplineModuli(d);
+    }
+    grid.resize(gridSize[0]*gridSize[1]*gridSize[2]);
+    line.resize(std::max(gridSize[0], std::max(gridSize[1], gridSize[2])));
+}
+
+// Calculate the squared magnitude of the discrete Fourier transform of the
+// B-spline values at the integer points, which we divide out of the
+// structure factor. Near-zero values (which can occur only for odd spline
+// orders at the Nyquist frequency) are replaced by the average of their
+// neighbors.
+void DuMMPmeSolver::calcSplineModuli(int dim) {
+    const int nd = gridSize[dim];
+
+    // B-spline values at integer points 1..SplineOrder-1.
+    Real data[SplineOrder];
+    data[0] = 1;
+    for (int i=1; i < SplineOrder; ++i) data[i] = 0;
+    for (int i=3; i <= SplineOrder; ++i) {
+        const Real div = Real(1)/(i-1);
+        data[i-1] = 0;
+        for (int j=1; j < i-1; ++j)
+            data[i-j-1] = div*(j*data[i-j-2] + (i-j)*data[i-j-1]);
+        data[0] = div*data[0];
+    }
+    Array_<Real> bspline(nd, Real(0));
+    for (int i=0; i < SplineOrder && i+1 < nd; ++i)
+        bspline[i+1] = data[i];
+
+    Array_<Real>& moduli = splineModuli[dim];
+    moduli.resize(nd);
+    for (int k=0; k < nd; ++k) {
+        Real sc = 0, ss = 0;
+        for (int j=0; j < nd; ++j) {
+            const Real arg = 2*Pi*k*j/nd;
+            sc += bspline[j]*std::cos(arg);
+            ss += bspline[j]*std::sin(arg);
+        }
+        moduli[k] = sc*sc + ss*ss;
+    }
+    for (int k=0; k < nd; ++k)
+        if (moduli[k] < Real(1e-7))
+            moduli[k] = (moduli[(k-1+nd)%nd] + moduli[(k+1)%nd]) / 2;
+}
+
+// Calculate the SplineOrder B-spline weights and their derivatives for a
+// point whose fractional offset from its grid cell is w.
+void DuMMPmeSolver::calcSplines(Real w, Real* data, Real* ddata) const {
+    const int p = SplineOrder;
+    data[p-1] = 0;
+    data[1]   = w;
+    data[0]   = 1-w;
+    for (int j=3; j < p; ++j) {
+        const Real div = Real(1)/(j-1);
+        data[j-1] = div*w*data[j-2];
+        for (int k=1; k < j-1; ++k)
+            data[j-k-1] = div*((w+k)*data[j-k-2] + (j-k-w)*data[j-k-1]);
+        data[0] = div*(1-w)*data[0];
+    }
+
+    // Differentiate, then finish the last recursion step.
+    ddata[0] = -data[0];
+    for (int j=1; j < p; ++j)
+        ddata[j] = data[j-1] - data[j];
+
+    const Real div = Real(1)/(p-1);
+    data[p-1] = div*w*data[p-2];
+    for (int k=1; k < p-1; ++k)
+        data[p-k-1] = div*((w+k)*data[p-k-2] + (p-k-w)*data[p-k-1]);
+    data[0] = div*(1-w)*data[0];
+}
+
+// Transform the whole grid, one line at a time along each axis.
+void DuMMPmeSolver::transform3D(bool forward) const {
+    const int nx = gridSize[0], ny = gridSize[1], nz = gridSize[2];
+
+    // z lines are contiguous.
+    for (int x=0; x < nx; ++x)
+        for (int y=0; y < ny; ++y)
+            fft[2].transform(&grid[gridIndex(x,y,0)], 1, forward);
+
+    for (int x=0; x < nx; ++x)
+        for (int z=0; z < nz; ++z)
+            fft[1].transform(&grid[gridIndex(x,0,z)], nz, forward);
+
+    for (int y=0; y < ny; ++y)
+        for (int z=0; z < nz; ++z)
+            fft[0].transform(&grid[gridIndex(0,y,z)], ny*nz, forward);
+}
+
+Real DuMMPmeSolver::calcEnergyAndForces
+   (int nAtoms, const Vec3* pos, const Real* q, Vec3* forces) const
+{
+    const int p  = SplineOrder;
+    const int nx = gridSize[0], ny = gridSize[1], nz = gridSize[2];
+
+    atomGridIndex.resize(nAtoms);
+    for (int d=0; d < 3; ++d) {
+        theta[d].resize(nAtoms*p);
+        dtheta[d].resize(nAtoms*p);
+    }
+
+    // Spread the charges onto the grid.
+    std::fill(grid.begin(), grid.end(), std::complex<Real>(0));
+    for (int i=0; i < nAtoms; ++i) {
+        for (int d=0; d < 3; ++d) {
+            Real u = pos[i][d]/box[d];
+            u = (u - std::floor(u)) * gridSize[d];
+            int iu = (int)u;
+            if (iu >= gridSize[d]) iu = gridSize[d]-1; // roundoff
+            atomGridIndex[i][d] = iu;
+            calcSplines(u-iu, &theta[d][i*p], &dtheta[d][i*p]);
+        }
+        const Real* tx = &theta[0][i*p];
+        const Real* ty = &theta[1][i*p];
+        const Real* tz = &theta[2][i*p];
+        for (int ix=0; ix < p; ++ix) {
+            const int gx = (atomGridIndex[i][0] + ix) % nx;
+            for (int iy=0; iy < p; ++iy) {
+                const int gy = (atomGridIndex[i][1] + iy) % ny;
+                const Real qxy = q[i]*tx[ix]*ty[iy];
+                for (int iz=0; iz < p; ++iz) {
+                    const int gz = (atomGridIndex[i][2] + iz) % nz;
+                    grid[gridIndex(gx,gy,gz)] += qxy*tz[iz];
+                }
+            }
+        }
+    }
+
+    transform3D(true);
+
+    // Multiply by the influence function, accumulating the energy.
+    const Real volume = box[0]*box[1]*box[2];
+    const Real expFac = Pi*Pi/(alpha*alpha);
+    Real energy = 0;
+    for (int kx=0; kx < nx; ++kx) {
+        const Real mx = (kx <= nx/2 ? kx : kx-nx) / box[0];
+        for (int ky=0; ky < ny; ++ky) {
+            const Real my = (ky <= ny/2 ? ky : ky-ny) / box[1];
+            for (int kz=0; kz < nz; ++kz) {
+                std::complex<Real>& s = grid[gridIndex(kx,ky,kz)];
+                if (kx==0 && ky==0 && kz==0) {s = 0; continue;}
+                const Real mz = (kz <= nz/2 ? kz : kz-nz) / box[2];
+                const Real m2 = mx*mx + my*my + mz*mz;
+                const Real denom = Pi*volume*m2*splineModuli[0][kx]
+                                   *splineModuli[1][ky]*splineModuli[2][kz];
+                const Real eterm = std::exp(-expFac*m2)/denom;
+                energy += eterm*std::norm(s);
+                s *= eterm;
+            }
+        }
+    }
+    energy /= 2;
+
+    if (!forces)
+        return energy; // energy only
+
+    // Back transform gives the potential on the grid; interpolate its
+    // gradient at each atom.
+    transform3D(false);
+
+    for (int i=0; i < nAtoms; ++i) {
+        const Real* tx = &theta[0][i*p], *dtx = &dtheta[0][i*p];
+        const Real* ty = &theta[1][i*p], *dty = &dtheta[1][i*p];
+        const Real* tz = &theta[2][i*p], *dtz = &dtheta[2][i*p];
+        Vec3 grad(0);
+        for (int ix=0; ix < p; ++ix) {
+            const int gx = (atomGridIndex[i][0] + ix) % nx;
+            for (int iy=0; iy < p; ++iy) {
+                const int gy = (atomGridIndex[i][1] + iy) % ny;
+                for (int iz=0; iz < p; ++iz) {
+                    const int gz = (atomGridIndex[i][2] + iz) % nz;
+                    const Real phi = grid[gridIndex(gx,gy,gz)].real();
+                    grad[0] += dtx[ix]* ty[iy]* tz[iz]*phi;
+                    grad[1] +=  tx[ix]*dty[iy]* tz[iz]*phi;
+                    grad[2] +=  tx[ix]* ty[iy]*dtz[iz]*phi;
+                }
+            }
+        }
+        for (int d=0; d < 3; ++d)
+            forces[i][d] -= q[i]*grad[d]*gridSize[d]/box[d];
+    }
+
+    return energy;
+}
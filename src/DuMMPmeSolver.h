@@ -0,0 +1,150 @@
+#ifndef SimTK_MOLMODEL_DUMM_PME_SOLVER_H_
+#define SimTK_MOLMODEL_DUMM_PME_SOLVER_H_
+
+/* -------------------------------------------------------------------------- *
+ *                             SimTK Molmodel(tm)                             *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK biosimulation toolkit originating from           *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+
+/**@file
+ * This header declares the smooth particle mesh Ewald (PME) reciprocal space
+ * solver used internally by DuMMForceFieldSubsystem for periodic
+ * electrostatics, and the small complex FFT it is built on. Neither depends
+ * on any external FFT library.
+ */
+
+#include "SimTKcommon.h"
+
+#include <complex>
+
+namespace SimTK {
+
+//-----------------------------------------------------------------------------
+//                               DuMM FFT 1D
+//-----------------------------------------------------------------------------
+// An unnormalized complex-to-complex discrete Fourier transform of a fixed
+// length n, computed with a recursive mixed-radix Cooley-Tukey algorithm.
+// Any n works, but the cost is proportional to n times the sum of its prime
+// factors so the PME solver chooses lengths that factor into 2s, 3s and 5s.
+class DuMMFFT1D {
+public:
+    typedef std::complex<Real> Complex;
+
+    DuMMFFT1D() : n(0) {}
+    explicit DuMMFFT1D(int n) {setLength(n);}
+
+    void setLength(int n);
+    int  getLength() const {return n;}
+
+    // Transform the n values in data[0], data[stride], ... in place. Forward
+    // uses exp(-2 pi i jk/n), backward exp(+2 pi i jk/n); neither scales.
+    void transform(Complex* data, int stride, bool forward) const;
+
+    // Return the smallest m >= n with no prime factors other than 2, 3, 5.
+    static int findGoodLength(int n);
+
+private:
+    void recurse(const Complex* in, int inStride, Complex* out,
+                 int len, int factorIx, int twiddleStep, bool forward) const;
+
+    int                 n;
+    Array_<int>         factors;    // prime factors of n
+    Array_<Complex>     roots;      // exp(-2 pi i j/n), j=0..n-1
+    mutable Array_<Complex> work, result, butterfly; // temporaries
+};
+
+
+
+//-----------------------------------------------------------------------------
+//                             DuMM PME SOLVER
+//-----------------------------------------------------------------------------
+// This computes the reciprocal space part of the Ewald sum for point charges
+// in an orthorhombic periodic box using the smooth particle mesh Ewald method
+// of Essmann et al. (J. Chem. Phys. 103:8577, 1995). Charges are spread on a
+// regular grid with cardinal B-splines of order 5, the grid is Fourier
+// transformed, multiplied by the Ewald influence function, transformed back,
+// and the resulting potential is interpolated to give forces.
+//
+// The returned energy and forces are in units of charge^2/length; the caller
+// multiplies by Coulomb's constant. The self energy and any excluded-pair
+// corrections are the caller's responsibility.
+class DuMMPmeSolver {
+public:
+    static const int SplineOrder = 5;
+
+    DuMMPmeSolver() : alpha(0) {}
+
+    // Set up for a given box (edge lengths), Ewald splitting parameter
+    // alpha (1/length), and grid dimensions.
+    void initialize(const Vec3& boxSize, Real alpha, 
+                    const Vec<3,int>& gridSize);
+
+    // Choose alpha and grid dimensions that will give approximately the
+    // requested relative force error with the given real space cutoff.
+    // These are the same heuristics used by OpenMM.
+    static Real calcAlpha(Real cutoff, Real errorTolerance);
+    static Vec<3,int> calcGridSize(const Vec3& boxSize, Real alpha,
+                                   Real errorTolerance);
+
+    const Vec3&       getBoxSize()  const {return box;}
+    Real              getAlpha()    const {return alpha;}
+    const Vec<3,int>& getGridSize() const {return gridSize;}
+
+    // Calculate reciprocal space energy; forces are *added* to the force
+    // array unless it is null, in which case only the energy is calculated.
+    // Positions need not be in the primary box.
+    Real calcEnergyAndForces(int                    nAtoms,
+                             const Vec3*            positions,
+                             const Real*            charges,
+                             Vec3*                  forces) const;
+
+private:
+    void calcSplineModuli(int dim);
+    void calcSplines(Real w, Real* theta, Real* dtheta) const;
+    void transform3D(bool forward) const;
+    int  gridIndex(int x, int y, int z) const
+    {   return (x*gridSize[1] + y)*gridSize[2] + z; }
+
+    Vec3                box;
+    Real                alpha;
+    Vec<3,int>          gridSize;
+    DuMMFFT1D           fft[3];
+    Array_<Real>        splineModuli[3];
+
+    // Per-evaluation temporaries.
+    mutable Array_<std::complex<Real> > grid;
+    mutable Array_<std::complex<Real> > line;
+    mutable Array_<Vec<3,int> >         atomGridIndex;
+    mutable Array_<Real>                theta[3], dtheta[3];
+};
+
+} // namespace SimTK
+
+#endif // SimTK_MOLMODEL_DUMM_PME_SOLVER_H_
@@ -0,0 +1,351 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+#include "molmodel/internal/PeriodicTrajectoryWriter.h"
+
+#include "molmodel/internal/Compound.h"
+#include "molmodel/internal/CompoundSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace SimTK {
+
+namespace {
+
+const Real AngstromsPerNanometer = 10;
+const Real PicosecondsPerAkmaTime = 0.04888821; // CHARMM time unit
+
+const int DcdTitleLength  = 80;
+const int DcdCharmmVersion = 24;
+
+// DCD files are written in native byte order, as CHARMM and NAMD do;
+// readers detect the byte order from the first record marker.
+template <class T>
+void appendNative(std::vector<char>& buffer, const T& value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+// CompressedFormat frames are written in XDR (big-endian) byte order.
+void appendXdrInt(std::vector<char>& buffer, int value) {
+    const unsigned u = (unsigned)value;
+    for (int shift = 24; shift >= 0; shift -= 8)
+        buffer.push_back((char)((u >> shift) & 0xff));
+}
+
+void appendXdrFloat(std::vector<char>& buffer, float value) {
+    int bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    appendXdrInt(buffer, bits);
+}
+
+int readXdrInt(const unsigned char* bytes) {
+    const unsigned u = ((unsigned)bytes[0] << 24) | ((unsigned)bytes[1] << 16)
+                     | ((unsigned)bytes[2] <<  8) |  (unsigned)bytes[3];
+    return (int)u;
+}
+
+float readXdrFloat(const unsigned char* bytes) {
+    const int bits = readXdrInt(bytes);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Signed differences are zigzag mapped (0,-1,1,-2,... -> 0,1,2,3,...) so
+// that small values of either sign encode in few bytes, then written seven
+// bits at a time, low bits first, with the high bit marking continuation.
+void appendVarint(std::vector<char>& buffer, long long value) {
+    unsigned long long u = ((unsigned long long)value << 1)
+                         ^ (unsigned long long)(value >> 63);
+    while (u >= 0x80) {
+        buffer.push_back((char)((u & 0x7f) | 0x80));
+        u >>= 7;
+    }
+    buffer.push_back((char)u);
+}
+
+bool readVarint(const std::vector<char>& buffer, size_t& pos, long long& value) {
+    unsigned long long u = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= buffer.size())
+            return false;
+        const unsigned char byte = (unsigned char)buffer[pos++];
+        u |= (unsigned long long)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            value = (long long)(u >> 1) ^ -(long long)(u & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+const int CompressedHeaderSize = 24; // six 4-byte words
+
+} // anonymous namespace
+
+PeriodicTrajectoryWriter& PeriodicTrajectoryWriter::setPrecision(Real p) {
+    SimTK_ERRCHK1_ALWAYS(p > 0, "PeriodicTrajectoryWriter::setPrecision()",
+        "Precision must be positive but was %g.", (double)p);
+    SimTK_ERRCHK_ALWAYS(numFramesWritten == 0, "PeriodicTrajectoryWriter::setPrecision()",
+        "Precision can't be changed after frames have been written.");
+    precision = p;
+    return *this;
+}
+
+// Record the mobilized body and body frame station of every atom, compound
+// by compound in PDB order. This is the only per-atom lookup in the
+// Compounds; later frames just transform the stations.
+void PeriodicTrajectoryWriter::buildGatherTable() const
+{
+    atomBodies.clear();
+    atomStations.clear();
+    bodies.clear();
+
+    Array_<Compound::AtomIndex> atomIndices;
+    for (CompoundSystem::CompoundIndex c(0); c < system.getNumCompounds(); ++c) {
+        const Compound& compound = system.getCompound(c);
+        atomIndices.clear();
+        compound.getAtomIndicesInPdbOrder(atomIndices);
+        for (unsigned i = 0; i < atomIndices.size(); ++i) {
+            atomBodies.push_back(compound.getAtomMobilizedBodyIndex(atomIndices[i]));
+            atomStations.push_back(compound.getAtomLocationInMobilizedBodyFrame(atomIndices[i]));
+        }
+    }
+    numAtoms = (int)atomBodies.size();
+
+    Array_<bool> isAtomBody(system.getMatterSubsystem().getNumBodies(), false);
+    for (int a = 0; a < numAtoms; ++a)
+        if (!isAtomBody[atomBodies[a]]) {
+            isAtomBody[atomBodies[a]] = true;
+            bodies.push_back(atomBodies[a]);
+        }
+    bodyTransforms.resize(isAtomBody.size());
+}
+
+void PeriodicTrajectoryWriter::gatherLocations(const State& state) const
+{
+    const SimbodyMatterSubsystem& matter = system.getMatterSubsystem();
+    for (unsigned b = 0; b < bodies.size(); ++b)
+        bodyTransforms[bodies[b]] = matter.getMobilizedBody(bodies[b]).getBodyTransform(state);
+
+    locations.resize(numAtoms);
+    for (int a = 0; a < numAtoms; ++a)
+        locations[a] = bodyTransforms[atomBodies[a]]*atomStations[a];
+}
+
+void PeriodicTrajectoryWriter::handleEvent(const State& state) const
+{
+    system.realize(state, Stage::Position);
+
+    if (numFramesWritten == 0)
+        buildGatherTable();
+    gatherLocations(state);
+
+    if (numFramesWritten == 0)
+        writeHeader(state);
+
+    if (format == DcdFormat)
+        writeDcdFrame();
+    else
+        writeCompressedFrame(state);
+
+    ++numFramesWritten;
+
+    // Keep the DCD frame count (NSET, the first control word) current so
+    // the file is valid even if the run is interrupted.
+    if (format == DcdFormat && dcdHeaderPosition >= 0) {
+        const std::streampos endOfFrames = outputStream.tellp();
+        const int nset = numFramesWritten;
+        outputStream.seekp(dcdHeaderPosition + 8);
+        outputStream.write(reinterpret_cast<const char*>(&nset), sizeof(nset));
+        outputStream.seekp(endOfFrames);
+    }
+    outputStream.flush();
+}
+
+void PeriodicTrajectoryWriter::writeHeader(const State& state) const
+{
+    if (topologyStream) {
+        int nextAtomSerialNumber = 1; // atom serial number for each compound picks up where previous compound left off
+        for (CompoundSystem::CompoundIndex c(0); c < system.getNumCompounds(); ++c)
+            system.getCompound(c).writePdb(state, *topologyStream, nextAtomSerialNumber);
+        *topologyStream << "END" << std::endl;
+    }
+
+    if (format != DcdFormat)
+        return; // CompressedFormat frames are self-describing
+
+    const Real interval = getEventInterval();
+    const int istart = (int)std::floor(state.getTime()/interval + 0.5);
+    const float delta = (float)(interval/PicosecondsPerAkmaTime);
+
+    frameBuffer.clear();
+
+    // Control record: "CORD" and 20 control words.
+    int icntrl[20] = {0};
+    icntrl[1] = istart;         // first frame number
+    icntrl[2] = 1;              // frames between saves
+    std::memcpy(&icntrl[9], &delta, sizeof(delta)); // time between frames
+    icntrl[19] = DcdCharmmVersion;
+    appendNative(frameBuffer, (int)(4 + sizeof(icntrl)));
+    frameBuffer.insert(frameBuffer.end(), {'C', 'O', 'R', 'D'});
+    for (int i = 0; i < 20; ++i)
+        appendNative(frameBuffer, icntrl[i]);
+    appendNative(frameBuffer, (int)(4 + sizeof(icntrl)));
+
+    // Title record.
+    String titles[2];
+    titles[0] = "REMARKS Created by SimTK Molmodel PeriodicTrajectoryWriter";
+    titles[1] = "REMARKS " + String(numAtoms) + " atoms, "
+              + String(interval) + " ps between frames";
+    appendNative(frameBuffer, 4 + 2*DcdTitleLength);
+    appendNative(frameBuffer, 2);
+    for (int t = 0; t < 2; ++t) {
+        titles[t].resize(DcdTitleLength, ' ');
+        frameBuffer.insert(frameBuffer.end(), titles[t].begin(), titles[t].end());
+    }
+    appendNative(frameBuffer, 4 + 2*DcdTitleLength);
+
+    // Atom count record.
+    appendNative(frameBuffer, 4);
+    appendNative(frameBuffer, numAtoms);
+    appendNative(frameBuffer, 4);
+
+    const std::streampos headerPosition = outputStream.tellp();
+    dcdHeaderPosition = (headerPosition == std::streampos(-1))
+                        ? -1 : (std::streamoff)headerPosition;
+    outputStream.write(&frameBuffer[0], frameBuffer.size());
+}
+
+void PeriodicTrajectoryWriter::writeDcdFrame() const
+{
+    const int blockSize = 4*numAtoms;
+
+    frameBuffer.clear();
+    frameBuffer.reserve(3*(blockSize + 8));
+    for (int k = 0; k < 3; ++k) {
+        appendNative(frameBuffer, blockSize);
+        for (int a = 0; a < numAtoms; ++a)
+            appendNative(frameBuffer, (float)(locations[a][k]*AngstromsPerNanometer));
+        appendNative(frameBuffer, blockSize);
+    }
+    outputStream.write(&frameBuffer[0], frameBuffer.size());
+}
+
+void PeriodicTrajectoryWriter::writeCompressedFrame(const State& state) const
+{
+    // Quantize with the precision exactly as stored, so a reader dividing
+    // by the stored value recovers the rounded coordinates.
+    const float storedPrecision = (float)precision;
+
+    frameBuffer.assign(CompressedHeaderSize, 0);
+    long long previous[3] = {0, 0, 0};
+    for (int a = 0; a < numAtoms; ++a)
+        for (int k = 0; k < 3; ++k) {
+            const long long q = (long long)std::floor(locations[a][k]*storedPrecision + 0.5);
+            appendVarint(frameBuffer, q - previous[k]);
+            previous[k] = q;
+        }
+    const int numBytes = (int)frameBuffer.size() - CompressedHeaderSize;
+    while (frameBuffer.size() % 4)
+        frameBuffer.push_back(0); // XDR pads to whole words
+
+    std::vector<char> header;
+    appendXdrInt(header, CompressedFrameMagic);
+    appendXdrInt(header, numAtoms);
+    appendXdrInt(header, numFramesWritten);
+    appendXdrFloat(header, (float)state.getTime());
+    appendXdrFloat(header, storedPrecision);
+    appendXdrInt(header, numBytes);
+    std::copy(header.begin(), header.end(), frameBuffer.begin());
+
+    outputStream.write(&frameBuffer[0], frameBuffer.size());
+}
+
+bool PeriodicTrajectoryWriter::readCompressedFrame(
+    std::istream& inputStream,
+    Array_<Vec3>& locations,
+    int& step,
+    Real& time)
+{
+    static const char* where = "PeriodicTrajectoryWriter::readCompressedFrame()";
+
+    unsigned char header[CompressedHeaderSize];
+    inputStream.read(reinterpret_cast<char*>(header), CompressedHeaderSize);
+    if (inputStream.gcount() == 0 && inputStream.eof())
+        return false;
+    SimTK_ERRCHK_ALWAYS(inputStream.gcount() == CompressedHeaderSize, where,
+        "Truncated frame header.");
+
+    const int magic = readXdrInt(header);
+    SimTK_ERRCHK1_ALWAYS(magic == CompressedFrameMagic, where,
+        "Bad magic number %d at start of frame.", magic);
+    const int   numAtoms       = readXdrInt(header + 4);
+    const int   frameStep      = readXdrInt(header + 8);
+    const float frameTime      = readXdrFloat(header + 12);
+    const float framePrecision = readXdrFloat(header + 16);
+    const int   numBytes       = readXdrInt(header + 20);
+    SimTK_ERRCHK_ALWAYS(numAtoms >= 0 && numBytes >= 0 && framePrecision > 0,
+        where, "Corrupt frame header.");
+
+    std::vector<char> payload((numBytes + 3) & ~3);
+    if (!payload.empty()) {
+        inputStream.read(&payload[0], payload.size());
+        SimTK_ERRCHK_ALWAYS(inputStream.gcount() == (std::streamsize)payload.size(),
+            where, "Truncated frame.");
+    }
+    payload.resize(numBytes);
+
+    locations.resize(numAtoms);
+    long long current[3] = {0, 0, 0};
+    size_t pos = 0;
+    for (int a = 0; a < numAtoms; ++a)
+        for (int k = 0; k < 3; ++k) {
+            long long delta;
+            SimTK_ERRCHK_ALWAYS(readVarint(payload, pos, delta), where,
+                "Corrupt coordinate data.");
+            current[k] += delta;
+            locations[a][k] = (Real)current[k]/framePrecision;
+        }
+    SimTK_ERRCHK_ALWAYS(pos == payload.size(), where,
+        "Frame has more coordinate data than atoms.");
+
+    step = frameStep;
+    time = frameTime;
+    return true;
+}
+
+} // namespace SimTK
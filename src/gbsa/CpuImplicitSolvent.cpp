@@ -581,10 +581,10 @@ RealOpenMM* CpuImplicitSolvent::getBornRadiiTemp( void ){
 
    --------------------------------------------------------------------------------------- */
 
-int CpuImplicitSolvent::computeBornRadii( const RealOpenMM* const*  atomCoordinates, 
-                                          RealOpenMM*               bornRadii, 
-                                          SimTK::ParallelExecutor*  executor,
-                                          RealOpenMM*               obcChain ){
+int CpuImplicitSolvent::computeBornRadii( const ImplicitSolventCoordinates&   atomCoordinates, 
+                                          RealOpenMM*                         bornRadii,
+                                          SimTK::ParallelExecutor*            executor,
+                                          RealOpenMM*                         obcChain ){
 
    // ---------------------------------------------------------------------------------------
 
@@ -606,17 +606,17 @@ int CpuImplicitSolvent::computeBornRadii( const RealOpenMM* const*  atomCoordina
 
    @param atomCoordinates     atomic coordinates
    @param partialCharges      partial charges
-   @param forces              forces (output)
+   @param forces              forces (output); if NULL only the energy is computed
 
 
    @return SimTKOpenMMCommon::DefaultReturn; abort if cpuImplicitSolvent is not set
 
    --------------------------------------------------------------------------------------- */
 
-int CpuImplicitSolvent::computeImplicitSolventForces( const RealOpenMM* const*   atomCoordinates,
-                                                      const RealOpenMM*          partialCharges,
-                                                      RealOpenMM* const*         forces, 
-                                                      SimTK::Parallel2DExecutor* executor ){
+int CpuImplicitSolvent::computeImplicitSolventForces( const ImplicitSolventCoordinates&   atomCoordinates,
+                                                      const RealOpenMM*                   partialCharges,
+                                                      const ImplicitSolventForces*        forces,
+                                                      SimTK::Parallel2DExecutor*          executor ){
 
    // ---------------------------------------------------------------------------------------
 
@@ -661,7 +661,10 @@ int CpuImplicitSolvent::computeImplicitSolventForces( const RealOpenMM* const*
    // and then once computed, always greater than zero.
 
    RealOpenMM* bornRadii = getBornRadii();
-   computeBornRadii( atomCoordinates, bornRadii, executor == NULL ? NULL : &executor->getExecutor() );
+   if( computeBornRadii( atomCoordinates, bornRadii, executor == NULL ? NULL : &executor->getExecutor() )
+       != SimTKOpenMMCommon::DefaultReturn ){
+      return SimTKOpenMMCommon::ErrorReturn;
+   }
 
    // diagnostics
 
@@ -676,7 +679,7 @@ int CpuImplicitSolvent::computeImplicitSolventForces( const RealOpenMM* const*
 
       for( int ii = 0; ii < printSampleOutput && ii < numberOfAtoms; ii++ ){
                   message << "\n   " << ii << " rad=" << atomicRadii[ii] << " q=" << partialCharges[ii] << " bR=" << bornRadii[ii] << " X[";
-         SimTKOpenMMUtilities::formatRealStringStream( message, atomCoordinates[ii] );
+         message << atomCoordinates.x[ii] << " " << atomCoordinates.y[ii] << " " << atomCoordinates.z[ii];
                   message << "]";
       }
       message << "\n";
@@ -685,7 +688,7 @@ int CpuImplicitSolvent::computeImplicitSolventForces( const RealOpenMM* const*
                        implicitSolventParameters->getNumberOfAtoms() - printSampleOutput : numberOfAtoms;
       for( int ii = startIndex; ii < numberOfAtoms; ii++ ){
                    message << "\n   " << ii << " " << atomicRadii[ii] << " " << bornRadii[ii] << " X[";
-         SimTKOpenMMUtilities::formatRealStringStream( message, atomCoordinates[ii] );
+         message << atomCoordinates.x[ii] << " " << atomCoordinates.y[ii] << " " << atomCoordinates.z[ii];
                    message << "]";
       }
       SimTKOpenMMLog::printMessage( message );
@@ -693,8 +696,10 @@ int CpuImplicitSolvent::computeImplicitSolventForces( const RealOpenMM* const*
 
    // compute forces
 
-   computeBornEnergyForces( getBornRadii(), atomCoordinates,
-                            partialCharges, forces, executor );
+   if( computeBornEnergyForces( getBornRadii(), atomCoordinates,
+                                partialCharges, forces, executor ) != SimTKOpenMMCommon::DefaultReturn ){
+      return SimTKOpenMMCommon::ErrorReturn;
+   }
 
    // diagnostics
 
@@ -713,7 +718,7 @@ int CpuImplicitSolvent::computeImplicitSolventForces( const RealOpenMM* const*
 
       for( int ii = 0; ii < printSampleOutput && ii < numberOfAtoms; ii++ ){
          message << "\n   " << ii << " [ ";
-         SimTKOpenMMUtilities::formatRealStringStream( message, forces[ii] );
+         message << forces->x[ii] << " " << forces->y[ii] << " " << forces->z[ii];
          message << "] bRad=" << bornRadii[ii]; 
       }
 		message << "\n";
@@ -721,7 +726,7 @@ int CpuImplicitSolvent::computeImplicitSolventForces( const RealOpenMM* const*
                        implicitSolventParameters->getNumberOfAtoms() - printSampleOutput : numberOfAtoms;
       for( int ii = startIndex; ii < numberOfAtoms; ii++ ){
          message << "\n   " << ii << " [ ";
-         SimTKOpenMMUtilities::formatRealStringStream( message, forces[ii] );
+         message << forces->x[ii] << " " << forces->y[ii] << " " << forces->z[ii];
          message << "] bRad=" << bornRadii[ii]; 
       }
       SimTKOpenMMLog::printMessage( message );
@@ -752,11 +757,11 @@ int CpuImplicitSolvent::computeImplicitSolventForces( const RealOpenMM* const*
 
    --------------------------------------------------------------------------------------- */
 
-int CpuImplicitSolvent::computeBornEnergyForces( const RealOpenMM*          bornRadii,
-                                                 const RealOpenMM* const*   atomCoordinates,
-                                                 const RealOpenMM*          partialCharges,
-                                                 RealOpenMM* const*         forces, 
-                                                 SimTK::Parallel2DExecutor* executor ){
+int CpuImplicitSolvent::computeBornEnergyForces( const RealOpenMM*                   bornRadii,
+                                                 const ImplicitSolventCoordinates&   atomCoordinates,
+                                                 const RealOpenMM*                   partialCharges,
+                                                 const ImplicitSolventForces*        forces,
+                                                 SimTK::Parallel2DExecutor*          executor ){
 
    // ---------------------------------------------------------------------------------------
 
@@ -772,15 +777,77 @@ int CpuImplicitSolvent::computeBornEnergyForces( const RealOpenMM*          born
 
 }
 
+/**---------------------------------------------------------------------------------------
+
+   Run a per-atom task for atoms 0..numberOfAtoms-1, in parallel if an
+   executor is supplied and serially otherwise
+
+   @param task              task
+   @param numberOfAtoms     number of atoms
+   @param executor          executor; may be NULL
+
+   --------------------------------------------------------------------------------------- */
+
+void CpuImplicitSolvent::executeAtomTask( ParallelExecutor::Task& task, int numberOfAtoms,
+                                          ParallelExecutor* executor ){
+   if( executor != NULL ){
+      executor->execute( task, numberOfAtoms );
+   } else {
+      task.initialize();
+      for( int atomI = 0; atomI < numberOfAtoms; atomI++ ){
+         task.execute( atomI );
+      }
+      task.finish();
+   }
+}
+
+/**
+ * This calculates the ACE nonpolar term in parallel. Each work item owns
+ * atom I; it stores I's energy and increments I's Born force.
+ */
+
+class AceNonPolarTask : public ParallelExecutor::Task {
+public:
+    AceNonPolarTask(const RealOpenMM*   atomicRadii,
+                    const RealOpenMM*   bornRadii,
+                    RealOpenMM          probeRadius,
+                    RealOpenMM          surfaceAreaFactor,
+                    RealOpenMM*         atomEnergy,
+                    RealOpenMM*         forces)
+    :   atomicRadii(atomicRadii), bornRadii(bornRadii), probeRadius(probeRadius),
+        surfaceAreaFactor(surfaceAreaFactor), atomEnergy(atomEnergy), forces(forces) {
+    }
+    void execute(int atomI) {
+
+      // 1 + 1 + pow + 3 + 1 + 2 FLOP
+
+      atomEnergy[atomI]          = (RealOpenMM) 0.0;
+      if( bornRadii[atomI] > 0.0 ){
+         RealOpenMM r            = atomicRadii[atomI] + probeRadius;
+         RealOpenMM ratio6       = POW( atomicRadii[atomI]/bornRadii[atomI], (RealOpenMM) 6.0 );
+         RealOpenMM saTerm       = surfaceAreaFactor*r*r*ratio6;
+         atomEnergy[atomI]       = saTerm;
+         forces[atomI]          += ((RealOpenMM) -6.0)*saTerm/bornRadii[atomI]; 
+      }
+    }
+private:
+    const RealOpenMM*   atomicRadii;
+    const RealOpenMM*   bornRadii;
+    const RealOpenMM    probeRadius;
+    const RealOpenMM    surfaceAreaFactor;
+    RealOpenMM*         atomEnergy;
+    RealOpenMM*         forces;
+};
+
 /**---------------------------------------------------------------------------------------
 
    Get nonpolar solvation force constribution via ACE approximation
 
    @param implicitSolventParameters parameters
-   @param vdwRadii                  Vdw radii
    @param bornRadii                 Born radii
    @param energy                    energy (output): value is incremented from input value 
    @param forces                    forces: values are incremented from input values
+   @param executor                  used for parallelizing the loop; may be NULL
 
    @return SimTKOpenMMCommon::DefaultReturn
 
@@ -788,39 +855,54 @@ int CpuImplicitSolvent::computeBornEnergyForces( const RealOpenMM*          born
 
 int CpuImplicitSolvent::computeAceNonPolarForce( const ImplicitSolventParameters* implicitSolventParameters,
                                                  const RealOpenMM* bornRadii, RealOpenMM* energy,
-                                                 RealOpenMM* forces ) const {
+                                                 RealOpenMM* forces, ParallelExecutor* executor ) const {
 
    // ---------------------------------------------------------------------------------------
 
    // static const char* methodName = "\nCpuImplicitSolvent::computeAceNonPolarForce";
 
-   static const RealOpenMM minusSix = -6.0;
-
    // ---------------------------------------------------------------------------------------
 
-   // compute the nonpolar solvation via ACE approximation
+   // compute the nonpolar solvation via ACE approximation; per-atom energies
+   // are summed in atom order so the result doesn't depend on the thread count
 
-   const RealOpenMM probeRadius          = implicitSolventParameters->getProbeRadius();
-   const RealOpenMM surfaceAreaFactor    = implicitSolventParameters->getPi4Asolv();
-   const RealOpenMM* atomicRadii         = implicitSolventParameters->getAtomicRadii();
    int numberOfAtoms                     = implicitSolventParameters->getNumberOfAtoms();
+   if( numberOfAtoms <= 0 ){
+      return SimTKOpenMMCommon::DefaultReturn; 
+   }
 
-   // 1 + 1 + pow + 3 + 1 + 2 FLOP
+   _aceEnergy.resize( numberOfAtoms );
+   AceNonPolarTask task( implicitSolventParameters->getAtomicRadii(), bornRadii,
+                         implicitSolventParameters->getProbeRadius(),
+                         implicitSolventParameters->getPi4Asolv(),
+                         &_aceEnergy[0], forces );
+   executeAtomTask( task, numberOfAtoms, executor );
 
    for( int atomI = 0; atomI < numberOfAtoms; atomI++ ){
-      if( bornRadii[atomI] > 0.0 ){
-         RealOpenMM r            = atomicRadii[atomI] + probeRadius;
-         RealOpenMM ratio6       = POW( atomicRadii[atomI]/bornRadii[atomI], (RealOpenMM) 6.0 );
-         RealOpenMM saTerm       = surfaceAreaFactor*r*r*ratio6;
-         *energy                += saTerm;
-         forces[atomI]          += minusSix*saTerm/bornRadii[atomI]; 
-      }
+      *energy += _aceEnergy[atomI];
    }
 
    return SimTKOpenMMCommon::DefaultReturn; 
 
 }
 
+/**---------------------------------------------------------------------------------------
+
+   Get the per-atom terms of the last ACE nonpolar energy calculation
+
+   @return array of size getNumberOfAtoms(), or NULL if the ACE term isn't
+           included or hasn't been computed
+
+   --------------------------------------------------------------------------------------- */
+
+const RealOpenMM* CpuImplicitSolvent::getAceAtomEnergies( void ) const {
+   if( !includeAceApproximation() ||
+       (int) _aceEnergy.size() != _implicitSolventParameters->getNumberOfAtoms() ){
+      return NULL;
+   }
+   return &_aceEnergy[0];
+}
+
 /**---------------------------------------------------------------------------------------
 
    Write Born energy and forces (Simbios)
@@ -835,10 +917,10 @@ int CpuImplicitSolvent::computeAceNonPolarForce( const ImplicitSolventParameters
 
    --------------------------------------------------------------------------------------- */
 
-int CpuImplicitSolvent::writeBornEnergyForces( const RealOpenMM* const* atomCoordinates,
-                                               const RealOpenMM*        partialCharges,
-                                               const RealOpenMM* const* forces,
-                                               const std::string&       resultsFileName ) const {
+int CpuImplicitSolvent::writeBornEnergyForces( const ImplicitSolventCoordinates&   atomCoordinates,
+                                               const RealOpenMM*                   partialCharges,
+                                               const ImplicitSolventForces*        forces,
+                                               const std::string&                  resultsFileName ) const {
 
    // ---------------------------------------------------------------------------------------
 
@@ -889,17 +971,17 @@ int CpuImplicitSolvent::writeBornEnergyForces( const RealOpenMM* const* atomCoor
 
    // output
 
-   if( forces != NULL && atomCoordinates != NULL && partialCharges != NULL && atomicRadii != NULL ){
+   if( forces != NULL && partialCharges != NULL && atomicRadii != NULL ){
       for( int ii = 0; ii < numberOfAtoms; ii++ ){
             (void) fprintf( implicitSolventResultsFile, "%.7e %.7e %.7e %.7e %.5f %.5f %.7e %.7e %.7e\n",
-                            lengthConversion*atomCoordinates[ii][0],
-                            lengthConversion*atomCoordinates[ii][1], 
-                            lengthConversion*atomCoordinates[ii][2],
+                            lengthConversion*atomCoordinates.x[ii],
+                            lengthConversion*atomCoordinates.y[ii], 
+                            lengthConversion*atomCoordinates.z[ii],
                            (bornRadii != NULL ? lengthConversion*bornRadii[ii] : 0.0),
                             partialCharges[ii], lengthConversion*atomicRadii[ii],
-                            forceConversion*forces[ii][0],
-                            forceConversion*forces[ii][1],
-                            forceConversion*forces[ii][2]
+                            forceConversion*forces->x[ii],
+                            forceConversion*forces->y[ii],
+                            forceConversion*forces->z[ii]
                           );
       }
    }
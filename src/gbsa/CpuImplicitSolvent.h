@@ -32,6 +32,25 @@ namespace SimTK {
 
 // ---------------------------------------------------------------------------------------
 
+// Atom coordinates and forces are passed in structure-of-arrays layout: the x, y
+// and z components for atom i are x[i], y[i] and z[i]. They are in the length
+// and energy units of the ImplicitSolventParameters, so with MdUnits the caller's
+// nm positions can be used directly and forces come back in kJ/mol/nm.
+
+struct ImplicitSolventCoordinates {
+   const RealOpenMM* x;
+   const RealOpenMM* y;
+   const RealOpenMM* z;
+};
+
+struct ImplicitSolventForces {
+   RealOpenMM* x;
+   RealOpenMM* y;
+   RealOpenMM* z;
+};
+
+// ---------------------------------------------------------------------------------------
+
 class CpuImplicitSolvent {
 
    public:
@@ -90,6 +109,11 @@ class CpuImplicitSolvent {
 
       RealOpenMM _implicitSolventEnergy; 
 
+      // per-atom ACE terms, summed in atom order so the energy
+      // doesn't depend on the thread count
+
+      mutable RealOpenMMVector _aceEnergy;
+
       /**---------------------------------------------------------------------------------------
       
          Initialize data members -- potentially more than
@@ -101,6 +125,20 @@ class CpuImplicitSolvent {
 
    protected:
 
+      /**---------------------------------------------------------------------------------------
+      
+         Run a per-atom task for atoms 0..numberOfAtoms-1, in parallel if an
+         executor is supplied and serially otherwise
+      
+         @param task              task
+         @param numberOfAtoms     number of atoms
+         @param executor          executor; may be NULL
+      
+         --------------------------------------------------------------------------------------- */
+      
+      static void executeAtomTask( SimTK::ParallelExecutor::Task& task, int numberOfAtoms,
+                                   SimTK::ParallelExecutor* executor );
+
       /**---------------------------------------------------------------------------------------
       
          Return implicitSolventBornForce, a work array of size _implicitSolventParameters->getNumberOfAtoms()*sizeof( RealOpenMM )
@@ -351,22 +389,22 @@ class CpuImplicitSolvent {
       
          @param atomCoordinates   atomic coordinates
          @param partialCharges    partial charges
-         @param forces            forces (output); if not set on input, then memory is allocated
+         @param forces            forces (output); if NULL only the energy is computed
       
          @return SimTKOpenMMCommon::DefaultReturn 
       
          --------------------------------------------------------------------------------------- */
       
-      int computeImplicitSolventForces( const RealOpenMM* const*    atomCoordinates,
-                                        const RealOpenMM*           partialCharges,
-                                        RealOpenMM* const*          forces, 
-                                        SimTK::Parallel2DExecutor*  executor );
+      int computeImplicitSolventForces( const ImplicitSolventCoordinates&   atomCoordinates,
+                                        const RealOpenMM*                   partialCharges,
+                                        const ImplicitSolventForces*        forces,
+                                        SimTK::Parallel2DExecutor*          executor );
       
       /**---------------------------------------------------------------------------------------
       
          Get Born radii based on J. Phys. Chem. A V101 No 16, p. 3005 (Simbios)
       
-         @param atomCoordinates   atomic coordinates dimension: [0-numberAtoms-1][0-2]
+         @param atomCoordinates   atomic coordinates
          @param bornRadii         output array of Born radii
          @param obcChain          output array of OBC chain derivative
       
@@ -374,10 +412,10 @@ class CpuImplicitSolvent {
       
          --------------------------------------------------------------------------------------- */
       
-      virtual int computeBornRadii( const RealOpenMM* const* atomCoordinates, 
-                                    RealOpenMM*              bornRadii, 
-                                    SimTK::ParallelExecutor* executor,
-                                    RealOpenMM*              obcChain = NULL );
+      virtual int computeBornRadii( const ImplicitSolventCoordinates&   atomCoordinates, 
+                                    RealOpenMM*                         bornRadii,
+                                    SimTK::ParallelExecutor*            executor,
+                                    RealOpenMM*                         obcChain = NULL );
       
       /**---------------------------------------------------------------------------------------
       
@@ -392,11 +430,11 @@ class CpuImplicitSolvent {
       
          --------------------------------------------------------------------------------------- */
       
-      virtual int computeBornEnergyForces( const RealOpenMM*            bornRadii, 
-                                           const RealOpenMM* const*     atomCoordinates,
-                                           const RealOpenMM*            partialCharges, 
-                                           RealOpenMM* const*           forces, 
-                                           SimTK::Parallel2DExecutor*   executor );
+      virtual int computeBornEnergyForces( const RealOpenMM*                   bornRadii, 
+                                           const ImplicitSolventCoordinates&   atomCoordinates,
+                                           const RealOpenMM*                   partialCharges,
+                                           const ImplicitSolventForces*        forces,
+                                           SimTK::Parallel2DExecutor*          executor );
       
       /**---------------------------------------------------------------------------------------
       
@@ -406,6 +444,7 @@ class CpuImplicitSolvent {
          @param bornRadii                 Born radii
          @param energy                    energy (output): value is incremented from input value 
          @param forces                    forces: values are incremented from input values
+         @param executor                  used for parallelizing the loop; may be NULL
       
          @return SimTKOpenMMCommon::DefaultReturn
       
@@ -413,7 +452,18 @@ class CpuImplicitSolvent {
       
       int computeAceNonPolarForce( const ImplicitSolventParameters* implicitSolventParameters,
                                    const RealOpenMM* bornRadii, RealOpenMM* energy, 
-                                   RealOpenMM* forces ) const;
+                                   RealOpenMM* forces, SimTK::ParallelExecutor* executor = NULL ) const;
+
+      /**---------------------------------------------------------------------------------------
+      
+         Get the per-atom terms of the last ACE nonpolar energy calculation
+      
+         @return array of size getNumberOfAtoms(), or NULL if the ACE term isn't
+                 included or hasn't been computed
+      
+         --------------------------------------------------------------------------------------- */
+      
+      const RealOpenMM* getAceAtomEnergies( void ) const;
       
       /**---------------------------------------------------------------------------------------
       
@@ -428,10 +478,10 @@ class CpuImplicitSolvent {
       
          --------------------------------------------------------------------------------------- */
       
-      virtual int writeBornEnergyForces( const RealOpenMM* const*   atomCoordinates,
-                                         const RealOpenMM*          partialCharges, 
-                                         const RealOpenMM* const*   forces,
-                                         const std::string&         resultsFileName ) const;
+      virtual int writeBornEnergyForces( const ImplicitSolventCoordinates&   atomCoordinates,
+                                         const RealOpenMM*                   partialCharges,
+                                         const ImplicitSolventForces*        forces,
+                                         const std::string&                  resultsFileName ) const;
 
       /**---------------------------------------------------------------------------------------
             
@@ -33,6 +33,7 @@
 #include <iostream>
 #include <iomanip>
 #include <cmath>
+#include <algorithm>
 
 using namespace SimTK;
 
@@ -97,6 +98,21 @@ void CpuObc::_initializeObcDataMembers( void ){
    _obcParameters = NULL;
    _obcChain      = NULL;
    _obcChainTemp  = NULL;
+   _useCutoff     = 0;
+   _cutoff        = (RealOpenMM) 20.0;
+
+   _numberOfClusters         = 0;
+
+   _useMixedPrecision        = 0;
+   _mixedPrecisionKernelType = CpuObcMixedPrecisionKernels::Scalar;
+   memset( &_floatAtoms, 0, sizeof( _floatAtoms ) );
+
+   _computeAtomEnergies      = 0;
+
+   _useBornRadiusCache          = 0;
+   _bornRadiusCacheValid        = 0;
+   _bornRadiusCacheUpdates      = 0;
+   _numberOfRecomputedBornRadii = 0;
 }
 
 /**---------------------------------------------------------------------------------------
@@ -205,20 +221,453 @@ RealOpenMM* CpuObc::getObcChainTemp( void ){
    return _obcChainTemp;
 }
 
+/**---------------------------------------------------------------------------------------
+
+   Enable/disable cutoff GB mode
+
+   @param useCutoff           if nonzero, use the cutoff
+
+   @return SimTKOpenMMCommon::DefaultReturn
+
+   --------------------------------------------------------------------------------------- */
+
+int CpuObc::setUseCutoff( int useCutoff ){
+   _useCutoff = useCutoff;
+   return SimTKOpenMMCommon::DefaultReturn;
+}
+
+int CpuObc::getUseCutoff( void ) const {
+   return _useCutoff;
+}
+
+/**---------------------------------------------------------------------------------------
+
+   Set cutoff distance (length units of the parameters) for cutoff GB mode
+
+   @param cutoff              cutoff distance
+
+   @return SimTKOpenMMCommon::DefaultReturn
+
+   --------------------------------------------------------------------------------------- */
+
+int CpuObc::setCutoff( RealOpenMM cutoff ){
+   _cutoff = cutoff;
+   return SimTKOpenMMCommon::DefaultReturn;
+}
+
+RealOpenMM CpuObc::getCutoff( void ) const {
+   return _cutoff;
+}
+
+/**---------------------------------------------------------------------------------------
+
+   Enable/disable the mixed precision all-pairs kernels
+
+   @param useMixedPrecision   if nonzero, use single precision pair terms
+
+   @return SimTKOpenMMCommon::DefaultReturn
+
+   --------------------------------------------------------------------------------------- */
+
+int CpuObc::setUseMixedPrecision( int useMixedPrecision ){
+   _useMixedPrecision = useMixedPrecision;
+   if( useMixedPrecision ){
+      _mixedPrecisionKernelType = CpuObcMixedPrecisionKernels::selectKernelType();
+   }
+   return SimTKOpenMMCommon::DefaultReturn;
+}
+
+int CpuObc::getUseMixedPrecision( void ) const {
+   return _useMixedPrecision;
+}
+
+const char* CpuObc::getMixedPrecisionKernelName( void ) const {
+   return CpuObcMixedPrecisionKernels::getKernelTypeName( _mixedPrecisionKernelType );
+}
+
+/**---------------------------------------------------------------------------------------
+
+   Enable/disable per-atom energies
+
+   @param computeAtomEnergies if nonzero, record the per-atom GB energies
+
+   @return SimTKOpenMMCommon::DefaultReturn
+
+   --------------------------------------------------------------------------------------- */
+
+int CpuObc::setComputeAtomEnergies( int computeAtomEnergies ){
+   _computeAtomEnergies = computeAtomEnergies;
+   if( !computeAtomEnergies ){
+      _atomGbEnergy.clear();
+   }
+   return SimTKOpenMMCommon::DefaultReturn;
+}
+
+int CpuObc::getComputeAtomEnergies( void ) const {
+   return _computeAtomEnergies;
+}
+
+const RealOpenMM* CpuObc::getAtomGbEnergies( void ) const {
+   if( !_computeAtomEnergies || (int) _atomGbEnergy.size() != _obcParameters->getNumberOfAtoms() ){
+      return NULL;
+   }
+   return &_atomGbEnergy[0];
+}
+
+/**---------------------------------------------------------------------------------------
+
+   Enable/disable the Born radius cache
+
+   @param useBornRadiusCache  if nonzero, reuse the descreening sums of unmoved atoms
+
+   @return SimTKOpenMMCommon::DefaultReturn
+
+   --------------------------------------------------------------------------------------- */
+
+int CpuObc::setUseBornRadiusCache( int useBornRadiusCache ){
+   _useBornRadiusCache   = useBornRadiusCache;
+   _bornRadiusCacheValid = 0;
+   return SimTKOpenMMCommon::DefaultReturn;
+}
+
+int CpuObc::getUseBornRadiusCache( void ) const {
+   return _useBornRadiusCache;
+}
+
+int CpuObc::getNumberOfRecomputedBornRadii( void ) const {
+   return _numberOfRecomputedBornRadii;
+}
+
+/**
+ * This finds the neighbors of each atom in parallel, given atoms already
+ * binned into cells. Each atom's list is written only by its own work item,
+ * and cells are visited in a fixed order, so the lists don't depend on the
+ * number of threads.
+ */
+
+class NeighborListTask : public ParallelExecutor::Task {
+public:
+    NeighborListTask
+       (const ImplicitSolventCoordinates&   atomCoordinates,
+        const IntVector&                    cellHead,
+        const IntVector&                    cellNext,
+        const IntVector&                    atomCell,
+        const int*                          gridSize,
+        RealOpenMM                          cutoff2,
+        std::vector<IntVector>&             neighborList)
+    :   atomCoordinates(atomCoordinates), cellHead(cellHead), cellNext(cellNext),
+        atomCell(atomCell), gridSize(gridSize), cutoff2(cutoff2), neighborList(neighborList) {
+    }
+    void execute(int atomI) {
+        IntVector& neighbors = neighborList[atomI];
+        neighbors.clear();
+
+        const int cell = atomCell[atomI];
+        const int cx   = cell / (gridSize[1]*gridSize[2]);
+        const int cy   = (cell / gridSize[2]) % gridSize[1];
+        const int cz   = cell % gridSize[2];
+
+        for( int ix = std::max(cx-1,0); ix <= std::min(cx+1,gridSize[0]-1); ix++ ){
+        for( int iy = std::max(cy-1,0); iy <= std::min(cy+1,gridSize[1]-1); iy++ ){
+        for( int iz = std::max(cz-1,0); iz <= std::min(cz+1,gridSize[2]-1); iz++ ){
+            const int other = (ix*gridSize[1] + iy)*gridSize[2] + iz;
+            for( int atomJ = cellHead[other]; atomJ >= 0; atomJ = cellNext[atomJ] ){
+                if( atomJ == atomI )
+                    continue;
+                RealOpenMM deltaX = atomCoordinates.x[atomJ] - atomCoordinates.x[atomI];
+                RealOpenMM deltaY = atomCoordinates.y[atomJ] - atomCoordinates.y[atomI];
+                RealOpenMM deltaZ = atomCoordinates.z[atomJ] - atomCoordinates.z[atomI];
+                if( deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ < cutoff2 )
+                    neighbors.push_back( atomJ );
+            }
+        }}}
+    }
+private:
+    ImplicitSolventCoordinates          atomCoordinates;
+    const IntVector&                    cellHead;
+    const IntVector&                    cellNext;
+    const IntVector&                    atomCell;
+    const int*                          gridSize;
+    const RealOpenMM                    cutoff2;
+    std::vector<IntVector>&             neighborList;
+};
+
+/**---------------------------------------------------------------------------------------
+
+   Build the cutoff neighbor list: bin the atoms on a grid of cells whose edge is
+   at least the cutoff, then search the 27 cells around each atom.
+
+   @param atomCoordinates     atomic coordinates
+   @param executor            if not NULL, used to search in parallel
+
+   @return SimTKOpenMMCommon::DefaultReturn, or SimTKOpenMMCommon::ErrorReturn
+           if any coordinate is NaN or infinite
+
+   --------------------------------------------------------------------------------------- */
+
+int CpuObc::buildNeighborList( const ImplicitSolventCoordinates&   atomCoordinates,
+                               SimTK::ParallelExecutor*            executor ){
+
+   // ---------------------------------------------------------------------------------------
+
+   static const char* methodName = "\nCpuObc::buildNeighborList";
+
+   // ---------------------------------------------------------------------------------------
+
+   const int numberOfAtoms = _obcParameters->getNumberOfAtoms();
+   _neighborList.resize( numberOfAtoms );
+   if( numberOfAtoms == 0 ){
+      return SimTKOpenMMCommon::DefaultReturn;
+   }
+
+   // bounding box of the atoms; a NaN or infinite coordinate (a simulation
+   // that has blown up) would make the cell counts below meaningless
+
+   const RealOpenMM* coordinate[3] = { atomCoordinates.x, atomCoordinates.y, atomCoordinates.z };
+   RealOpenMM low[3], high[3];
+   for( int kk = 0; kk < 3; kk++ ){
+      low[kk] = high[kk] = coordinate[kk][0];
+      for( int ii = 0; ii < numberOfAtoms; ii++ ){
+         if( !std::isfinite( coordinate[kk][ii] ) ){
+            low[kk] = coordinate[kk][ii];
+            break;
+         }
+         low[kk]  = std::min( low[kk],  coordinate[kk][ii] );
+         high[kk] = std::max( high[kk], coordinate[kk][ii] );
+      }
+      if( !std::isfinite( high[kk] - low[kk] ) ){
+         for( int ii = 0; ii < numberOfAtoms; ii++ ){
+            _neighborList[ii].clear();
+         }
+         std::stringstream message;
+         message << methodName << " atom coordinates are not finite (" << low[kk] << " to " << high[kk] << ").";
+         SimTKOpenMMLog::printMessage( message );
+         return SimTKOpenMMCommon::ErrorReturn;
+      }
+   }
+
+   // cell edge is the cutoff, grown if necessary so that a sparse system
+   // doesn't produce many more cells than atoms; cell counts are compared
+   // in floating point so a huge box can't overflow them, and after
+   // maxCoarsenings doublings we give up and use one cell edge for the box
+
+   const int maxCoarsenings = 64;
+   const double maxCells    = std::max( 64.0, 8.0*numberOfAtoms );
+   RealOpenMM cellSize      = _cutoff;
+   for( int pass = 0; ; pass++ ){
+      double numberOfCells = 1;
+      for( int kk = 0; kk < 3; kk++ ){
+         numberOfCells *= std::floor( (high[kk] - low[kk])/cellSize ) + 1;
+      }
+      if( numberOfCells <= maxCells )
+         break;
+      if( pass == maxCoarsenings ){
+         cellSize = std::max( high[0] - low[0], std::max( high[1] - low[1], high[2] - low[2] ) );
+         break;
+      }
+      cellSize *= (RealOpenMM) 2.0;
+   }
+   int gridSize[3];
+   for( int kk = 0; kk < 3; kk++ ){
+      gridSize[kk] = (int) ((high[kk] - low[kk])/cellSize) + 1;
+   }
+
+   // linked list of atoms in each cell; atoms are inserted in reverse so
+   // each cell's list is in increasing atom order
+
+   _cellHead.assign( gridSize[0]*gridSize[1]*gridSize[2], -1 );
+   _cellNext.resize( numberOfAtoms );
+   _atomCell.resize( numberOfAtoms );
+   for( int ii = numberOfAtoms - 1; ii >= 0; ii-- ){
+      int cell[3];
+      for( int kk = 0; kk < 3; kk++ ){
+         cell[kk] = std::min( (int) ((coordinate[kk][ii] - low[kk])/cellSize), gridSize[kk] - 1 );
+      }
+      const int cellIndex = (cell[0]*gridSize[1] + cell[1])*gridSize[2] + cell[2];
+      _atomCell[ii]        = cellIndex;
+      _cellNext[ii]        = _cellHead[cellIndex];
+      _cellHead[cellIndex] = ii;
+   }
+
+   NeighborListTask task( atomCoordinates, _cellHead, _cellNext, _atomCell, gridSize,
+                          _cutoff*_cutoff, _neighborList );
+   executeAtomTask( task, numberOfAtoms, executor );
+
+   return SimTKOpenMMCommon::DefaultReturn;
+}
+
+/**
+ * HCT descreening of atom I by atom J at distance r, as used in the Born
+ * radius sums below; zero if J's scaled sphere doesn't reach I.
+ */
+
+static inline RealOpenMM calcHctDescreening( RealOpenMM offsetRadiusI, RealOpenMM scaledRadiusJ, RealOpenMM r ){
+
+   static const RealOpenMM one     = (RealOpenMM) 1.0;
+   static const RealOpenMM two     = (RealOpenMM) 2.0;
+   static const RealOpenMM half    = (RealOpenMM) 0.5;
+   static const RealOpenMM fourth  = (RealOpenMM) 0.25;
+
+   RealOpenMM rScaledRadiusJ  = r + scaledRadiusJ;
+   if( offsetRadiusI >= rScaledRadiusJ ){
+      return (RealOpenMM) 0.0;
+   }
+
+   RealOpenMM rInverse = one/r;
+   RealOpenMM l_ij     = offsetRadiusI > FABS( r - scaledRadiusJ ) ? offsetRadiusI : FABS( r - scaledRadiusJ );
+              l_ij     = one/l_ij;
+
+   RealOpenMM u_ij     = one/rScaledRadiusJ;
+
+   RealOpenMM l_ij2    = l_ij*l_ij;
+   RealOpenMM u_ij2    = u_ij*u_ij;
+
+   RealOpenMM ratio    = LN( (u_ij/l_ij) );
+   RealOpenMM term     = l_ij - u_ij + fourth*r*(u_ij2 - l_ij2)  + ( half*rInverse*ratio) + (fourth*scaledRadiusJ*scaledRadiusJ*rInverse)*(l_ij2 - u_ij2);
+   if( offsetRadiusI < (scaledRadiusJ - r) ){
+      term += two*( one/offsetRadiusI - l_ij);
+   }
+   return term;
+}
+
+/**
+ * Chain rule factor of the second force loop for the descreening of atom I
+ * by atom J at distance r: the force on I along (J - I) is -de*(J - I).
+ */
+
+static inline RealOpenMM calcHctDescreeningForce( RealOpenMM offsetRadiusI, RealOpenMM scaledRadiusJ,
+                                                  RealOpenMM r, RealOpenMM bornForceI ){
+
+   static const RealOpenMM one     = (RealOpenMM) 1.0;
+   static const RealOpenMM fourth  = (RealOpenMM) 0.25;
+   static const RealOpenMM eighth  = (RealOpenMM) 0.125;
+
+   RealOpenMM rScaledRadiusJ  = r + scaledRadiusJ;
+   if( offsetRadiusI >= rScaledRadiusJ ){
+      return (RealOpenMM) 0.0;
+   }
+
+   RealOpenMM l_ij          = offsetRadiusI > FABS( r - scaledRadiusJ ) ? offsetRadiusI : FABS( r - scaledRadiusJ );
+              l_ij          = one/l_ij;
+   RealOpenMM u_ij          = one/rScaledRadiusJ;
+
+   RealOpenMM l_ij2         = l_ij*l_ij;
+   RealOpenMM u_ij2         = u_ij*u_ij;
+
+   RealOpenMM rInverse      = one/r;
+   RealOpenMM r2Inverse     = rInverse*rInverse;
+
+   RealOpenMM t3            = eighth*(one + scaledRadiusJ*scaledRadiusJ*r2Inverse)*(l_ij2 - u_ij2) + fourth*LN( u_ij/l_ij )*r2Inverse;
+
+   return bornForceI*t3*rInverse;
+}
+
+
+/**---------------------------------------------------------------------------------------
+
+   Declare rigid clusters and cache the descreening within each one (see CpuObc.h)
+
+   @param numberOfClusters    number of clusters; 0 removes the clusters
+   @param clusterStart        numberOfClusters+1 cluster boundaries
+   @param clusterCoordinates  coordinates, each cluster in any frame
+
+   @return SimTKOpenMMCommon::DefaultReturn, or SimTKOpenMMCommon::ErrorReturn
+           if the clusters don't cover the atoms
+
+   --------------------------------------------------------------------------------------- */
+
+int CpuObc::setRigidClusters( int numberOfClusters, const int* clusterStart,
+                              const ImplicitSolventCoordinates& clusterCoordinates ){
+
+   _bornRadiusCacheValid = 0;
+
+   // ---------------------------------------------------------------------------------------
+
+   static const char* methodName = "\nCpuObc::setRigidClusters";
+
+   // ---------------------------------------------------------------------------------------
+
+   const ObcParameters* obcParameters    = getObcParameters();
+   const int numberOfAtoms               = obcParameters->getNumberOfAtoms();
+
+   _numberOfClusters = 0;
+   _clusterBegin.clear();
+   _clusterEnd.clear();
+   _intraClusterBornSum.clear();
+
+   if( numberOfClusters <= 0 ){
+      return SimTKOpenMMCommon::DefaultReturn;
+   }
+
+   bool valid = clusterStart[0] == 0 && clusterStart[numberOfClusters] == numberOfAtoms;
+   for( int cluster = 0; valid && cluster < numberOfClusters; cluster++ ){
+      valid = clusterStart[cluster] <= clusterStart[cluster+1];
+   }
+   if( !valid ){
+      std::stringstream message;
+      message << methodName << " clusters do not cover the " << numberOfAtoms << " atoms in order.";
+      SimTKOpenMMLog::printMessage( message );
+      return SimTKOpenMMCommon::ErrorReturn;
+   }
+
+   const RealOpenMM* atomicRadii         = obcParameters->getAtomicRadii();
+   const RealOpenMM* scaledRadiusFactor  = obcParameters->getScaledRadiusFactors();
+   const RealOpenMM dielectricOffset     = obcParameters->getDielectricOffset();
+
+   _numberOfClusters = numberOfClusters;
+   _clusterBegin.resize( numberOfAtoms );
+   _clusterEnd.resize( numberOfAtoms );
+   _intraClusterBornSum.resize( numberOfAtoms );
+
+   for( int cluster = 0; cluster < numberOfClusters; cluster++ ){
+      const int begin = clusterStart[cluster];
+      const int end   = clusterStart[cluster+1];
+      for( int atomI = begin; atomI < end; atomI++ ){
+         const RealOpenMM offsetRadiusI = atomicRadii[atomI] - dielectricOffset;
+         RealOpenMM sum                 = (RealOpenMM) 0.0;
+         for( int atomJ = begin; atomJ < end; atomJ++ ){
+            if( atomJ == atomI ){
+               continue;
+            }
+            RealOpenMM deltaX          = clusterCoordinates.x[atomJ] - clusterCoordinates.x[atomI];
+            RealOpenMM deltaY          = clusterCoordinates.y[atomJ] - clusterCoordinates.y[atomI];
+            RealOpenMM deltaZ          = clusterCoordinates.z[atomJ] - clusterCoordinates.z[atomI];
+            RealOpenMM r               = SQRT( deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ );
+            RealOpenMM scaledRadiusJ   = (atomicRadii[atomJ] - dielectricOffset)*scaledRadiusFactor[atomJ];
+            sum                       += calcHctDescreening( offsetRadiusI, scaledRadiusJ, r );
+         }
+         _clusterBegin[atomI]        = begin;
+         _clusterEnd[atomI]          = end;
+         _intraClusterBornSum[atomI] = sum;
+      }
+   }
+
+   return SimTKOpenMMCommon::DefaultReturn;
+}
+
+int CpuObc::getNumberOfRigidClusters( void ) const {
+   return _numberOfClusters;
+}
 
 /**
- * This calculates Born radii in parallel.
+ * This calculates Born radii in parallel. With rigid clusters the pairs in
+ * atom I's own cluster are skipped and their cached sum is used instead.
  */
 
 class BornRadiiTask : public ParallelExecutor::Task {
 public:
     BornRadiiTask
        (RealOpenMM*                 bornRadii, 
-        const RealOpenMM* const*    atomCoordinates, 
+        const ImplicitSolventCoordinates& atomCoordinates, 
         RealOpenMM*                 obcChain, 
-        ObcParameters*              obcParameters) 
+        ObcParameters*              obcParameters,
+        const int*                  clusterBegin,
+        const int*                  clusterEnd,
+        const RealOpenMM*           intraClusterBornSum,
+        RealOpenMM*                 bornSum = NULL) 
     :   bornRadii(bornRadii), atomCoordinates(atomCoordinates), obcChain(obcChain), obcParameters(obcParameters),
-        zero((RealOpenMM) 0.0), one((RealOpenMM) 1.0), two((RealOpenMM) 2.0), three((RealOpenMM) 3.0),
+        clusterBegin(clusterBegin), clusterEnd(clusterEnd), intraClusterBornSum(intraClusterBornSum),
+        bornSum(bornSum), zero((RealOpenMM) 0.0), one((RealOpenMM) 1.0), two((RealOpenMM) 2.0), three((RealOpenMM) 3.0),
         half((RealOpenMM) 0.5), fourth((RealOpenMM) 0.25) {
     }
     void execute(int atomI) {
@@ -237,15 +686,25 @@ public:
       RealOpenMM radiusIInverse  = one/offsetRadiusI;
       RealOpenMM sum             = zero;
 
+      // atoms [skipBegin, skipEnd) are atom I itself or its rigid cluster
+
+      int skipBegin              = atomI;
+      int skipEnd                = atomI + 1;
+      if( clusterBegin != NULL ){
+         skipBegin               = clusterBegin[atomI];
+         skipEnd                 = clusterEnd[atomI];
+         sum                     = intraClusterBornSum[atomI];
+      }
+
       // HCT code
 
       for( int atomJ = 0; atomJ < numberOfAtoms; atomJ++ ){
 
-         if( atomJ != atomI ){
+         if( atomJ < skipBegin || atomJ >= skipEnd ){
 
-            RealOpenMM deltaX          = atomCoordinates[atomJ][0] - atomCoordinates[atomI][0];
-            RealOpenMM deltaY          = atomCoordinates[atomJ][1] - atomCoordinates[atomI][1];
-            RealOpenMM deltaZ          = atomCoordinates[atomJ][2] - atomCoordinates[atomI][2];
+            RealOpenMM deltaX          = atomCoordinates.x[atomJ] - atomCoordinates.x[atomI];
+            RealOpenMM deltaY          = atomCoordinates.y[atomJ] - atomCoordinates.y[atomI];
+            RealOpenMM deltaZ          = atomCoordinates.z[atomJ] - atomCoordinates.z[atomI];
  
             RealOpenMM r2              = deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ;
             RealOpenMM r               = SQRT( r2 );
@@ -272,6 +731,12 @@ public:
             }
          }
       }
+
+      // the raw descreening sum is what the Born radius cache keeps
+
+      if( bornSum != NULL ){
+         bornSum[atomI]     = sum;
+      }
  
       // OBC-specific code (Eqs. 6-8 in paper)
 
@@ -287,47 +752,228 @@ public:
     }
 private:
     RealOpenMM*                 bornRadii;
-    const RealOpenMM* const*    atomCoordinates;
+    ImplicitSolventCoordinates  atomCoordinates;
     RealOpenMM*                 obcChain;
     ObcParameters*              obcParameters;
+    const int*                  clusterBegin;
+    const int*                  clusterEnd;
+    const RealOpenMM*           intraClusterBornSum;
+    RealOpenMM*                 bornSum;
     const RealOpenMM zero, one, two, three, half, fourth;
 };
 
-/**---------------------------------------------------------------------------------------
+/**
+ * This updates Born radii from the Born radius cache, in parallel. A moved
+ * atom I gets its descreening sum recomputed as in BornRadiiTask. An unmoved
+ * atom I keeps its cached sum, less the old and plus the new descreening by
+ * each moved atom; atom I's own cluster is skipped either way. Each work item
+ * writes only atom I's sum, radius and chain factor.
+ */
 
-   Get Born radii based on papers:
+class IncrementalBornRadiiTask : public ParallelExecutor::Task {
+public:
+    IncrementalBornRadiiTask
+       (RealOpenMM*                 bornRadii, 
+        const ImplicitSolventCoordinates& atomCoordinates, 
+        const ImplicitSolventCoordinates& oldCoordinates, 
+        RealOpenMM*                 obcChain, 
+        const ObcParameters*        obcParameters,
+        const int*                  atomMoved,
+        const IntVector&            movedAtoms,
+        const int*                  clusterBegin,
+        const int*                  clusterEnd,
+        const RealOpenMM*           intraClusterBornSum,
+        RealOpenMM*                 bornSum) 
+    :   bornRadii(bornRadii), atomCoordinates(atomCoordinates), oldCoordinates(oldCoordinates),
+        obcChain(obcChain), obcParameters(obcParameters), atomMoved(atomMoved), movedAtoms(movedAtoms),
+        clusterBegin(clusterBegin), clusterEnd(clusterEnd), intraClusterBornSum(intraClusterBornSum),
+        bornSum(bornSum), one((RealOpenMM) 1.0), two((RealOpenMM) 2.0), three((RealOpenMM) 3.0),
+        half((RealOpenMM) 0.5) {
+    }
+    void execute(int atomI) {
 
-      J. Phys. Chem. 1996 100, 19824-19839 (HCT paper)
-      Proteins: Structure, Function, and Bioinformatcis 55:383-394 (2004) (OBC paper)
+      const int numberOfAtoms               = obcParameters->getNumberOfAtoms();
+      const RealOpenMM* atomicRadii         = obcParameters->getAtomicRadii();
+      const RealOpenMM* scaledRadiusFactor  = obcParameters->getScaledRadiusFactors();
+      const RealOpenMM dielectricOffset     = obcParameters->getDielectricOffset();
+      const RealOpenMM alphaObc             = obcParameters->getAlphaObc();
+      const RealOpenMM betaObc              = obcParameters->getBetaObc();
+      const RealOpenMM gammaObc             = obcParameters->getGammaObc();
 
-   @param atomCoordinates     atomic coordinates
-   @param bornRadii           output array of Born radii
+      RealOpenMM radiusI         = atomicRadii[atomI];
+      RealOpenMM offsetRadiusI   = radiusI - dielectricOffset;
 
-   @return array of Born radii
+      // atoms [skipBegin, skipEnd) are atom I itself or its rigid cluster
 
-   --------------------------------------------------------------------------------------- */
+      int skipBegin              = atomI;
+      int skipEnd                = atomI + 1;
+      if( clusterBegin != NULL ){
+         skipBegin               = clusterBegin[atomI];
+         skipEnd                 = clusterEnd[atomI];
+      }
 
-int CpuObc::computeBornRadii( const RealOpenMM* const*  atomCoordinates, 
-                              RealOpenMM*               bornRadii, 
-                              SimTK::ParallelExecutor*  executor, 
-                              RealOpenMM*               obcChain ){
+      RealOpenMM sum;
+      if( atomMoved[atomI] ){
+         sum = clusterBegin != NULL ? intraClusterBornSum[atomI] : (RealOpenMM) 0.0;
+         for( int atomJ = 0; atomJ < numberOfAtoms; atomJ++ ){
+            if( atomJ >= skipBegin && atomJ < skipEnd ){
+               continue;
+            }
+            RealOpenMM scaledRadiusJ   = (atomicRadii[atomJ] - dielectricOffset)*scaledRadiusFactor[atomJ];
+            sum                       += calcHctDescreening( offsetRadiusI, scaledRadiusJ,
+                                                             distance( atomCoordinates, atomI, atomJ ) );
+         }
+      } else {
+         sum = bornSum[atomI];
+         for( int jj = 0; jj < (int) movedAtoms.size(); jj++ ){
+            const int atomJ            = movedAtoms[jj];
+            if( atomJ >= skipBegin && atomJ < skipEnd ){
+               continue;
+            }
+            RealOpenMM deltaX          = oldCoordinates.x[atomJ] - atomCoordinates.x[atomI];
+            RealOpenMM deltaY          = oldCoordinates.y[atomJ] - atomCoordinates.y[atomI];
+            RealOpenMM deltaZ          = oldCoordinates.z[atomJ] - atomCoordinates.z[atomI];
+            RealOpenMM oldR            = SQRT( deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ );
+            RealOpenMM scaledRadiusJ   = (atomicRadii[atomJ] - dielectricOffset)*scaledRadiusFactor[atomJ];
+            sum                       += calcHctDescreening( offsetRadiusI, scaledRadiusJ,
+                                                             distance( atomCoordinates, atomI, atomJ ) )
+                                       - calcHctDescreening( offsetRadiusI, scaledRadiusJ, oldR );
+         }
+      }
+      bornSum[atomI]        = sum;
 
-   // ---------------------------------------------------------------------------------------
+      // OBC-specific code (Eqs. 6-8 in paper)
 
-   static const RealOpenMM zero    = (RealOpenMM) 0.0;
-   static const RealOpenMM one     = (RealOpenMM) 1.0;
-   static const RealOpenMM two     = (RealOpenMM) 2.0;
-   static const RealOpenMM three   = (RealOpenMM) 3.0;
-   static const RealOpenMM half    = (RealOpenMM) 0.5;
-   static const RealOpenMM fourth  = (RealOpenMM) 0.25;
+      sum                  *= half*offsetRadiusI;
+      RealOpenMM sum2       = sum*sum;
+      RealOpenMM sum3       = sum*sum2;
+      RealOpenMM tanhSum    = TANH( alphaObc*sum - betaObc*sum2 + gammaObc*sum3 );
+      
+      bornRadii[atomI]      = one/( one/offsetRadiusI - tanhSum/radiusI ); 
+ 
+      obcChain[atomI]       = offsetRadiusI*( alphaObc - two*betaObc*sum + three*gammaObc*sum2 );
+      obcChain[atomI]       = (one - tanhSum*tanhSum)*obcChain[atomI]/radiusI;
+    }
+private:
+    static RealOpenMM distance( const ImplicitSolventCoordinates& coordinates, int atomI, int atomJ ){
+      RealOpenMM deltaX          = coordinates.x[atomJ] - coordinates.x[atomI];
+      RealOpenMM deltaY          = coordinates.y[atomJ] - coordinates.y[atomI];
+      RealOpenMM deltaZ          = coordinates.z[atomJ] - coordinates.z[atomI];
+      return SQRT( deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ );
+    }
 
-   // static const char* methodName = "\nCpuObc::computeBornRadii";
+    RealOpenMM*                 bornRadii;
+    ImplicitSolventCoordinates  atomCoordinates;
+    ImplicitSolventCoordinates  oldCoordinates;
+    RealOpenMM*                 obcChain;
+    const ObcParameters*        obcParameters;
+    const int*                  atomMoved;
+    const IntVector&            movedAtoms;
+    const int*                  clusterBegin;
+    const int*                  clusterEnd;
+    const RealOpenMM*           intraClusterBornSum;
+    RealOpenMM*                 bornSum;
+    const RealOpenMM one, two, three, half;
+};
 
-   // ---------------------------------------------------------------------------------------
+/**
+ * This calculates Born radii from the cutoff neighbor list, in parallel.
+ */
 
-   ObcParameters* obcParameters          = getObcParameters();
+class CutoffBornRadiiTask : public ParallelExecutor::Task {
+public:
+    CutoffBornRadiiTask
+       (RealOpenMM*                     bornRadii, 
+        const ImplicitSolventCoordinates& atomCoordinates, 
+        RealOpenMM*                     obcChain, 
+        const ObcParameters*            obcParameters,
+        const std::vector<IntVector>&   neighborList) 
+    :   bornRadii(bornRadii), atomCoordinates(atomCoordinates), obcChain(obcChain), obcParameters(obcParameters),
+        neighborList(neighborList), one((RealOpenMM) 1.0), two((RealOpenMM) 2.0), three((RealOpenMM) 3.0),
+        half((RealOpenMM) 0.5) {
+    }
+    void execute(int atomI) {
 
-   const int numberOfAtoms               = obcParameters->getNumberOfAtoms();
+      const RealOpenMM* atomicRadii         = obcParameters->getAtomicRadii();
+      const RealOpenMM* scaledRadiusFactor  = obcParameters->getScaledRadiusFactors();
+      RealOpenMM dielectricOffset           = obcParameters->getDielectricOffset();
+      RealOpenMM alphaObc                   = obcParameters->getAlphaObc();
+      RealOpenMM betaObc                    = obcParameters->getBetaObc();
+      RealOpenMM gammaObc                   = obcParameters->getGammaObc();
+
+      RealOpenMM radiusI         = atomicRadii[atomI];
+      RealOpenMM offsetRadiusI   = radiusI - dielectricOffset;
+      RealOpenMM sum             = (RealOpenMM) 0.0;
+
+      // HCT code, restricted to neighbors within the cutoff
+
+      const IntVector& neighbors = neighborList[atomI];
+      for( int jj = 0; jj < (int) neighbors.size(); jj++ ){
+         const int atomJ            = neighbors[jj];
+         RealOpenMM deltaX          = atomCoordinates.x[atomJ] - atomCoordinates.x[atomI];
+         RealOpenMM deltaY          = atomCoordinates.y[atomJ] - atomCoordinates.y[atomI];
+         RealOpenMM deltaZ          = atomCoordinates.z[atomJ] - atomCoordinates.z[atomI];
+         RealOpenMM r               = SQRT( deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ );
+         RealOpenMM scaledRadiusJ   = (atomicRadii[atomJ] - dielectricOffset)*scaledRadiusFactor[atomJ];
+         sum                       += calcHctDescreening( offsetRadiusI, scaledRadiusJ, r );
+      }
+ 
+      // OBC-specific code (Eqs. 6-8 in paper)
+
+      sum                  *= half*offsetRadiusI;
+      RealOpenMM sum2       = sum*sum;
+      RealOpenMM sum3       = sum*sum2;
+      RealOpenMM tanhSum    = TANH( alphaObc*sum - betaObc*sum2 + gammaObc*sum3 );
+      
+      bornRadii[atomI]      = one/( one/offsetRadiusI - tanhSum/radiusI ); 
+ 
+      obcChain[atomI]       = offsetRadiusI*( alphaObc - two*betaObc*sum + three*gammaObc*sum2 );
+      obcChain[atomI]       = (one - tanhSum*tanhSum)*obcChain[atomI]/radiusI;
+    }
+private:
+    RealOpenMM*                     bornRadii;
+    ImplicitSolventCoordinates      atomCoordinates;
+    RealOpenMM*                     obcChain;
+    const ObcParameters*            obcParameters;
+    const std::vector<IntVector>&   neighborList;
+    const RealOpenMM one, two, three, half;
+};
+
+/**---------------------------------------------------------------------------------------
+
+   Get Born radii based on papers:
+
+      J. Phys. Chem. 1996 100, 19824-19839 (HCT paper)
+      Proteins: Structure, Function, and Bioinformatcis 55:383-394 (2004) (OBC paper)
+
+   @param atomCoordinates     atomic coordinates
+   @param bornRadii           output array of Born radii
+
+   @return array of Born radii
+
+   --------------------------------------------------------------------------------------- */
+
+int CpuObc::computeBornRadii( const ImplicitSolventCoordinates&   atomCoordinates, 
+                              RealOpenMM*                         bornRadii,
+                              SimTK::ParallelExecutor*            executor,
+                              RealOpenMM*                         obcChain ){
+
+   // ---------------------------------------------------------------------------------------
+
+   static const RealOpenMM zero    = (RealOpenMM) 0.0;
+   static const RealOpenMM one     = (RealOpenMM) 1.0;
+   static const RealOpenMM two     = (RealOpenMM) 2.0;
+   static const RealOpenMM three   = (RealOpenMM) 3.0;
+   static const RealOpenMM half    = (RealOpenMM) 0.5;
+   static const RealOpenMM fourth  = (RealOpenMM) 0.25;
+
+   // static const char* methodName = "\nCpuObc::computeBornRadii";
+
+   // ---------------------------------------------------------------------------------------
+
+   ObcParameters* obcParameters          = getObcParameters();
+
+   const int numberOfAtoms               = obcParameters->getNumberOfAtoms();
    const RealOpenMM* atomicRadii         = obcParameters->getAtomicRadii();
    const RealOpenMM* scaledRadiusFactor  = obcParameters->getScaledRadiusFactors();
    if( !obcChain ) {
@@ -347,9 +993,33 @@ int CpuObc::computeBornRadii( const RealOpenMM* const*  atomCoordinates,
 //FILE* logFile = NULL;
 //FILE* logFile = fopen( "bR", "w" );
 
-   if (executor != NULL) {
-           BornRadiiTask task(bornRadii, atomCoordinates, obcChain, obcParameters);
-           executor->execute(task, numberOfAtoms);
+   // with a cutoff, only neighbors found with the cell list contribute; the
+   // list is kept for the force loops in computeBornEnergyForces()
+
+   if( _useCutoff ){
+      if( buildNeighborList( atomCoordinates, executor ) != SimTKOpenMMCommon::DefaultReturn ){
+         return SimTKOpenMMCommon::ErrorReturn;
+      }
+      CutoffBornRadiiTask task( bornRadii, atomCoordinates, obcChain, obcParameters, _neighborList );
+      executeAtomTask( task, numberOfAtoms, executor );
+      return SimTKOpenMMCommon::DefaultReturn;
+   }
+
+   if( _useMixedPrecision ){
+      return _computeBornRadiiMixedPrecision( atomCoordinates, bornRadii, executor, obcChain );
+   }
+
+   if( _useBornRadiusCache ){
+      return _computeBornRadiiCached( atomCoordinates, bornRadii, executor, obcChain );
+   }
+   _numberOfRecomputedBornRadii = numberOfAtoms;
+
+   if (executor != NULL || _numberOfClusters > 0) {
+           BornRadiiTask task(bornRadii, atomCoordinates, obcChain, obcParameters,
+                              _numberOfClusters > 0 ? &_clusterBegin[0] : NULL,
+                              _numberOfClusters > 0 ? &_clusterEnd[0] : NULL,
+                              _numberOfClusters > 0 ? &_intraClusterBornSum[0] : NULL);
+           executeAtomTask(task, numberOfAtoms, executor);
    }
    else {
        for( int atomI = 0; atomI < numberOfAtoms; atomI++ ){
@@ -366,9 +1036,9 @@ int CpuObc::computeBornRadii( const RealOpenMM* const*  atomCoordinates,
 
              if( atomJ != atomI ){
 
-                RealOpenMM deltaX          = atomCoordinates[atomJ][0] - atomCoordinates[atomI][0];
-                RealOpenMM deltaY          = atomCoordinates[atomJ][1] - atomCoordinates[atomI][1];
-                RealOpenMM deltaZ          = atomCoordinates[atomJ][2] - atomCoordinates[atomI][2];
+                RealOpenMM deltaX          = atomCoordinates.x[atomJ] - atomCoordinates.x[atomI];
+                RealOpenMM deltaY          = atomCoordinates.y[atomJ] - atomCoordinates.y[atomI];
+                RealOpenMM deltaZ          = atomCoordinates.z[atomJ] - atomCoordinates.z[atomI];
 
                 RealOpenMM r2              = deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ;
                 RealOpenMM r               = SQRT( r2 );
@@ -439,19 +1109,24 @@ if( logFile && atomI >= 0 ){
 
 /**
  * This performs the first main loop of the force calculation in parallel.
+ * With AtomEnergies each pair's energy is also split evenly between its two
+ * atoms in atomEnergy; the executor never gives two threads the same atom at
+ * once, just as for the Born forces.
  */
 
+template <bool AtomEnergies>
 class ParallelTask1 : public Parallel2DExecutor::Task {
 public:
     ParallelTask1(const RealOpenMM*         bornRadii, 
-                  const RealOpenMM* const*  atomCoordinates, 
+                  const ImplicitSolventCoordinates& atomCoordinates, 
                   const RealOpenMM*         partialCharges,
-                  RealOpenMM* const*        forces, 
+                  const ImplicitSolventForces* forces, 
                   RealOpenMM*               bornForces, 
                   RealOpenMM&               obcEnergy, 
-                  RealOpenMM                preFactor) 
+                  RealOpenMM                preFactor,
+                  RealOpenMM*               atomEnergy) 
     :   bornRadii(bornRadii), atomCoordinates(atomCoordinates), partialCharges(partialCharges),
-        forces(forces), bornForces(bornForces), obcEnergy(obcEnergy), preFactor(preFactor),
+        forces(forces), bornForces(bornForces), obcEnergy(obcEnergy), atomEnergy(atomEnergy), preFactor(preFactor),
         one((RealOpenMM) 1.0), four((RealOpenMM) 4.0), half((RealOpenMM) 0.5), fourth((RealOpenMM) 0.25) {
     }
     void initialize() {
@@ -462,161 +1137,728 @@ public:
     }
     void execute(int atomI, int atomJ) {
 
-         // 3 FLOP
+         // 3 FLOP
+
+         RealOpenMM deltaX             = atomCoordinates.x[atomJ] - atomCoordinates.x[atomI];
+         RealOpenMM deltaY             = atomCoordinates.y[atomJ] - atomCoordinates.y[atomI];
+         RealOpenMM deltaZ             = atomCoordinates.z[atomJ] - atomCoordinates.z[atomI];
+ 
+         // 5 FLOP
+
+         RealOpenMM r2                 = deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ;
+
+         // 3 FLOP
+
+         RealOpenMM alpha2_ij          = bornRadii[atomI]*bornRadii[atomJ];
+         RealOpenMM D_ij               = r2/(four*alpha2_ij);
+
+         // exp + 2 + sqrt FLOP 
+
+         RealOpenMM expTerm            = EXP( -D_ij );
+         RealOpenMM denominator2       = r2 + alpha2_ij*expTerm; 
+         RealOpenMM denominator        = SQRT( denominator2 ); 
+         
+         // 6 FLOP
+
+         RealOpenMM Gpol               = (preFactor*partialCharges[atomI]*partialCharges[atomJ])/denominator; 
+
+         // energy only
+
+         if( forces == NULL ){
+            energy += atomI != atomJ ? Gpol : half*Gpol;
+            if( AtomEnergies ){
+               addAtomEnergies( atomI, atomJ, atomI != atomJ ? Gpol : half*Gpol );
+            }
+            return;
+         }
+
+         RealOpenMM dGpol_dr           = -Gpol*( one - fourth*expTerm )/denominator2;  
+
+         // 5 FLOP
+
+         RealOpenMM dGpol_dalpha2_ij   = -half*Gpol*expTerm*( one + D_ij )/denominator2;
+
+         // 11 FLOP
+
+         if( atomI != atomJ ){
+
+             bornForces[atomJ] += dGpol_dalpha2_ij*bornRadii[atomI];
+
+             deltaX            *= dGpol_dr;
+             deltaY            *= dGpol_dr;
+             deltaZ            *= dGpol_dr;
+
+             forces->x[atomI]  += deltaX;
+             forces->y[atomI]  += deltaY;
+             forces->z[atomI]  += deltaZ;
+
+             forces->x[atomJ]  -= deltaX;
+             forces->y[atomJ]  -= deltaY;
+             forces->z[atomJ]  -= deltaZ;
+
+         } else {
+            Gpol *= half;
+         }
+
+         // 3 FLOP
+
+         energy += Gpol;
+         if( AtomEnergies ){
+            addAtomEnergies( atomI, atomJ, Gpol );
+         }
+         bornForces[atomI] += dGpol_dalpha2_ij*bornRadii[atomJ];
+    }
+private:
+
+    // Gpol is the pair energy, already halved for the self term
+
+    void addAtomEnergies(int atomI, int atomJ, RealOpenMM Gpol) {
+         if( atomI != atomJ ){
+            atomEnergy[atomI] += half*Gpol;
+            atomEnergy[atomJ] += half*Gpol;
+         } else {
+            atomEnergy[atomI] += Gpol;
+         }
+    }
+
+    const RealOpenMM*        bornRadii;
+    ImplicitSolventCoordinates atomCoordinates;
+    const RealOpenMM*        partialCharges;
+    RealOpenMM&              obcEnergy;
+    RealOpenMM*              bornForces;
+    const ImplicitSolventForces* forces;
+    RealOpenMM*              atomEnergy;
+
+    static thread_local Real energy;
+
+    const RealOpenMM one, four, half, fourth, preFactor;
+};
+
+template <bool AtomEnergies> thread_local Real ParallelTask1<AtomEnergies>::energy;
+
+/**
+ * This performs the second main loop of the force calculation in parallel.
+ */
+
+class ParallelTask2 : public Parallel2DExecutor::Task {
+public:
+    ParallelTask2
+       (const RealOpenMM*           atomicRadii, 
+        const ImplicitSolventCoordinates& atomCoordinates, 
+        const RealOpenMM*           partialCharges,
+        const RealOpenMM*           scaledRadiusFactor, 
+        const ImplicitSolventForces* forces, 
+        RealOpenMM*                 bornForces, 
+        RealOpenMM                  dielectricOffs,
+        const int*                  clusterBegin,
+        const int*                  clusterEnd)
+    :   atomicRadii(atomicRadii), atomCoordinates(atomCoordinates), partialCharges(partialCharges),
+        scaledRadiusFactor(scaledRadiusFactor), forces(forces), bornForces(bornForces), dielectricOffset(dielectricOffs),
+        clusterBegin(clusterBegin), clusterEnd(clusterEnd), one((RealOpenMM) 1.0), fourth((RealOpenMM) 0.25), eighth((RealOpenMM) 0.125) 
+    {
+    }
+
+    void execute(int atomI, int atomJ) {
+        if (atomI == atomJ)
+            return;
+
+        // the descreening within a rigid cluster is constant
+
+        if (clusterBegin != NULL && atomJ >= clusterBegin[atomI] && atomJ < clusterEnd[atomI])
+            return;
+        RealOpenMM offsetRadiusI      = atomicRadii[atomI] - dielectricOffset;
+        RealOpenMM deltaX             = atomCoordinates.x[atomJ] - atomCoordinates.x[atomI];
+        RealOpenMM deltaY             = atomCoordinates.y[atomJ] - atomCoordinates.y[atomI];
+        RealOpenMM deltaZ             = atomCoordinates.z[atomJ] - atomCoordinates.z[atomI];
+
+        RealOpenMM r2                 = deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ;
+        RealOpenMM r                  = SQRT( r2 );
+
+        // radius w/ dielectric offset applied
+
+        RealOpenMM offsetRadiusJ      = atomicRadii[atomJ] - dielectricOffset;
+
+        RealOpenMM scaledRadiusJ      = offsetRadiusJ*scaledRadiusFactor[atomJ];
+        RealOpenMM scaledRadiusJ2     = scaledRadiusJ*scaledRadiusJ;
+        RealOpenMM rScaledRadiusJ     = r + scaledRadiusJ;
+
+        // dL/dr & dU/dr are zero (this can be shown analytically)
+        // removed from calculation
+
+        if( offsetRadiusI < rScaledRadiusJ ){
+
+           RealOpenMM l_ij          = offsetRadiusI > FABS( r - scaledRadiusJ ) ? offsetRadiusI : FABS( r - scaledRadiusJ );
+                l_ij                = one/l_ij;
+
+           RealOpenMM u_ij          = one/rScaledRadiusJ;
+
+           RealOpenMM l_ij2         = l_ij*l_ij;
+
+           RealOpenMM u_ij2         = u_ij*u_ij;
+
+           RealOpenMM rInverse      = one/r;
+           RealOpenMM r2Inverse     = rInverse*rInverse;
+
+           RealOpenMM t3            = eighth*(one + scaledRadiusJ2*r2Inverse)*(l_ij2 - u_ij2) + fourth*LN( u_ij/l_ij )*r2Inverse;
+
+           RealOpenMM de            = bornForces[atomI]*t3*rInverse;
+
+           deltaX                  *= de;
+           deltaY                  *= de;
+           deltaZ                  *= de;
+
+           forces->x[atomI]        -= deltaX;
+           forces->y[atomI]        -= deltaY;
+           forces->z[atomI]        -= deltaZ;
+
+           forces->x[atomJ]        += deltaX;
+           forces->y[atomJ]        += deltaY;
+           forces->z[atomJ]        += deltaZ;
+        }
+    }
+private:
+    const RealOpenMM*           atomicRadii;
+    ImplicitSolventCoordinates  atomCoordinates;
+    const RealOpenMM*           partialCharges;
+    const RealOpenMM*           scaledRadiusFactor;
+    RealOpenMM*                 bornForces;
+    const ImplicitSolventForces* forces;
+    const int*                  clusterBegin;
+    const int*                  clusterEnd;
+
+    const RealOpenMM one, fourth, eighth, dielectricOffset;
+};
+
+/**
+ * This performs the first main loop of the force calculation over the
+ * cutoff neighbor list, in parallel. Each work item gathers everything for
+ * its own atom I, so every pair is evaluated from both ends; that doubles the
+ * arithmetic but needs no locking, and the per-atom energies are summed in
+ * atom order afterwards so the result doesn't depend on the thread count.
+ */
+
+class CutoffForceTask1 : public ParallelExecutor::Task {
+public:
+    CutoffForceTask1(const RealOpenMM*              bornRadii, 
+                     const ImplicitSolventCoordinates& atomCoordinates, 
+                     const RealOpenMM*              partialCharges,
+                     const ImplicitSolventForces*   forces, 
+                     RealOpenMM*                    bornForces, 
+                     RealOpenMM*                    atomEnergy, 
+                     RealOpenMM                     preFactor,
+                     const std::vector<IntVector>&  neighborList) 
+    :   bornRadii(bornRadii), atomCoordinates(atomCoordinates), partialCharges(partialCharges),
+        forces(forces), bornForces(bornForces), atomEnergy(atomEnergy), preFactor(preFactor),
+        neighborList(neighborList), one((RealOpenMM) 1.0), four((RealOpenMM) 4.0), half((RealOpenMM) 0.5),
+        fourth((RealOpenMM) 0.25) {
+    }
+    void execute(int atomI) {
+
+      // self term
+
+      RealOpenMM alpha2_ii          = bornRadii[atomI]*bornRadii[atomI];
+      RealOpenMM Gpol_ii            = (preFactor*partialCharges[atomI]*partialCharges[atomI])/bornRadii[atomI];
+      RealOpenMM energy             = half*Gpol_ii;
+      RealOpenMM bornForce          = -half*Gpol_ii/alpha2_ii*bornRadii[atomI];
+      RealOpenMM force[3]           = { 0.0, 0.0, 0.0 };
+
+      const IntVector& neighbors = neighborList[atomI];
+      for( int jj = 0; jj < (int) neighbors.size(); jj++ ){
+
+         const int atomJ               = neighbors[jj];
+         RealOpenMM deltaX             = atomCoordinates.x[atomJ] - atomCoordinates.x[atomI];
+         RealOpenMM deltaY             = atomCoordinates.y[atomJ] - atomCoordinates.y[atomI];
+         RealOpenMM deltaZ             = atomCoordinates.z[atomJ] - atomCoordinates.z[atomI];
+         RealOpenMM r2                 = deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ;
+
+         RealOpenMM alpha2_ij          = bornRadii[atomI]*bornRadii[atomJ];
+         RealOpenMM D_ij               = r2/(four*alpha2_ij);
+
+         RealOpenMM expTerm            = EXP( -D_ij );
+         RealOpenMM denominator2       = r2 + alpha2_ij*expTerm; 
+         RealOpenMM denominator        = SQRT( denominator2 ); 
+         
+         RealOpenMM Gpol               = (preFactor*partialCharges[atomI]*partialCharges[atomJ])/denominator; 
+
+         // each pair is seen from both ends; I gets half its energy
+
+         energy                       += half*Gpol;
+         if( forces == NULL ){
+            continue;
+         }
+
+         RealOpenMM dGpol_dr           = -Gpol*( one - fourth*expTerm )/denominator2;  
+         RealOpenMM dGpol_dalpha2_ij   = -half*Gpol*expTerm*( one + D_ij )/denominator2;
+
+         bornForce                    += dGpol_dalpha2_ij*bornRadii[atomJ];
+         force[0]                     += dGpol_dr*deltaX;
+         force[1]                     += dGpol_dr*deltaY;
+         force[2]                     += dGpol_dr*deltaZ;
+      }
+
+      atomEnergy[atomI] = energy;
+      if( forces != NULL ){
+         bornForces[atomI] += bornForce;
+         forces->x[atomI]  += force[0];
+         forces->y[atomI]  += force[1];
+         forces->z[atomI]  += force[2];
+      }
+    }
+private:
+    const RealOpenMM*               bornRadii;
+    ImplicitSolventCoordinates      atomCoordinates;
+    const RealOpenMM*               partialCharges;
+    const ImplicitSolventForces*    forces;
+    RealOpenMM*                     bornForces;
+    RealOpenMM*                     atomEnergy;
+    const RealOpenMM                preFactor;
+    const std::vector<IntVector>&   neighborList;
+    const RealOpenMM one, four, half, fourth;
+};
+
+/**
+ * This performs the second main loop of the force calculation over the
+ * cutoff neighbor list, in parallel. As in the first loop each work item
+ * owns atom I; it applies both the descreening of I by J (scaled by I's
+ * Born force) and of J by I (scaled by J's).
+ */
+
+class CutoffForceTask2 : public ParallelExecutor::Task {
+public:
+    CutoffForceTask2
+       (const RealOpenMM*               atomicRadii, 
+        const ImplicitSolventCoordinates& atomCoordinates, 
+        const RealOpenMM*               scaledRadiusFactor, 
+        const ImplicitSolventForces*    forces, 
+        const RealOpenMM*               bornForces, 
+        RealOpenMM                      dielectricOffset,
+        const std::vector<IntVector>&   neighborList)
+    :   atomicRadii(atomicRadii), atomCoordinates(atomCoordinates), scaledRadiusFactor(scaledRadiusFactor),
+        forces(forces), bornForces(bornForces), dielectricOffset(dielectricOffset), neighborList(neighborList) {
+    }
+
+    void execute(int atomI) {
+        RealOpenMM offsetRadiusI      = atomicRadii[atomI] - dielectricOffset;
+        RealOpenMM scaledRadiusI      = offsetRadiusI*scaledRadiusFactor[atomI];
+        RealOpenMM force[3]           = { 0.0, 0.0, 0.0 };
+
+        const IntVector& neighbors = neighborList[atomI];
+        for( int jj = 0; jj < (int) neighbors.size(); jj++ ){
+            const int atomJ           = neighbors[jj];
+            RealOpenMM deltaX         = atomCoordinates.x[atomJ] - atomCoordinates.x[atomI];
+            RealOpenMM deltaY         = atomCoordinates.y[atomJ] - atomCoordinates.y[atomI];
+            RealOpenMM deltaZ         = atomCoordinates.z[atomJ] - atomCoordinates.z[atomI];
+            RealOpenMM r              = SQRT( deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ );
+
+            RealOpenMM offsetRadiusJ  = atomicRadii[atomJ] - dielectricOffset;
+            RealOpenMM scaledRadiusJ  = offsetRadiusJ*scaledRadiusFactor[atomJ];
+
+            RealOpenMM de             = calcHctDescreeningForce( offsetRadiusI, scaledRadiusJ, r, bornForces[atomI] )
+                                      + calcHctDescreeningForce( offsetRadiusJ, scaledRadiusI, r, bornForces[atomJ] );
+
+            force[0]                 -= de*deltaX;
+            force[1]                 -= de*deltaY;
+            force[2]                 -= de*deltaZ;
+        }
+
+        forces->x[atomI] += force[0];
+        forces->y[atomI] += force[1];
+        forces->z[atomI] += force[2];
+    }
+private:
+    const RealOpenMM*               atomicRadii;
+    ImplicitSolventCoordinates      atomCoordinates;
+    const RealOpenMM*               scaledRadiusFactor;
+    const ImplicitSolventForces*    forces;
+    const RealOpenMM*               bornForces;
+    const RealOpenMM                dielectricOffset;
+    const std::vector<IntVector>&   neighborList;
+};
+
+/**
+ * This applies the Born radius chain rule to the Born forces between the two
+ * main loops, in parallel. Each work item owns atom I; for the mixed precision
+ * kernels it also stores the single precision copy of I's Born force.
+ */
+
+class BornForceChainRuleTask : public ParallelExecutor::Task {
+public:
+    BornForceChainRuleTask(const RealOpenMM*    bornRadii,
+                           const RealOpenMM*    obcChain,
+                           RealOpenMM*          bornForces,
+                           float*               floatBornForces)
+    :   bornRadii(bornRadii), obcChain(obcChain), bornForces(bornForces),
+        floatBornForces(floatBornForces) {
+    }
+    void execute(int atomI) {
+        bornForces[atomI] *= bornRadii[atomI]*bornRadii[atomI]*obcChain[atomI];      
+        if( floatBornForces != NULL ){
+            floatBornForces[atomI] = (float) bornForces[atomI];
+        }
+    }
+private:
+    const RealOpenMM*   bornRadii;
+    const RealOpenMM*   obcChain;
+    RealOpenMM*         bornForces;
+    float*              floatBornForces;
+};
+
+/**
+ * This calculates Born radii with single precision pair terms, in parallel.
+ * Each work item owns atom I; its descreening sum and the OBC rescaling are
+ * done in double. With rigid clusters atom I's own cluster is skipped and
+ * its cached sum is used instead.
+ */
+
+class MixedPrecisionBornRadiiTask : public ParallelExecutor::Task {
+public:
+    MixedPrecisionBornRadiiTask
+       (const ObcFloatAtoms&                               atoms,
+        CpuObcMixedPrecisionKernels::BornRadiusRowKernel   kernel,
+        const ObcParameters*                               obcParameters,
+        RealOpenMM*                                        bornRadii,
+        RealOpenMM*                                        obcChain,
+        const int*                                         clusterBegin,
+        const int*                                         clusterEnd,
+        const RealOpenMM*                                  intraClusterBornSum) 
+    :   atoms(atoms), kernel(kernel), obcParameters(obcParameters), bornRadii(bornRadii), obcChain(obcChain),
+        clusterBegin(clusterBegin), clusterEnd(clusterEnd), intraClusterBornSum(intraClusterBornSum),
+        one((RealOpenMM) 1.0), two((RealOpenMM) 2.0), three((RealOpenMM) 3.0), half((RealOpenMM) 0.5) {
+    }
+    void execute(int atomI) {
+
+      const int numberOfAtoms     = obcParameters->getNumberOfAtoms();
+      const RealOpenMM alphaObc   = obcParameters->getAlphaObc();
+      const RealOpenMM betaObc    = obcParameters->getBetaObc();
+      const RealOpenMM gammaObc   = obcParameters->getGammaObc();
+      const RealOpenMM radiusI    = obcParameters->getAtomicRadii()[atomI];
+      const RealOpenMM offsetRadiusI = radiusI - obcParameters->getDielectricOffset();
+
+      // HCT code
+
+      RealOpenMM sum              = (RealOpenMM) 0.0;
+      int skipBegin               = atomI;
+      int skipEnd                 = atomI + 1;
+      if( clusterBegin != NULL ){
+         skipBegin                = clusterBegin[atomI];
+         skipEnd                  = clusterEnd[atomI];
+         sum                      = intraClusterBornSum[atomI];
+      }
+      kernel( atoms, atomI, 0, skipBegin, sum );
+      kernel( atoms, atomI, skipEnd, numberOfAtoms, sum );
+
+      // OBC-specific code (Eqs. 6-8 in paper)
+
+      sum                        *= half*offsetRadiusI;
+      RealOpenMM sum2             = sum*sum;
+      RealOpenMM sum3             = sum*sum2;
+      RealOpenMM tanhSum          = TANH( alphaObc*sum - betaObc*sum2 + gammaObc*sum3 );
+
+      bornRadii[atomI]            = one/( one/offsetRadiusI - tanhSum/radiusI ); 
+
+      obcChain[atomI]             = offsetRadiusI*( alphaObc - two*betaObc*sum + three*gammaObc*sum2 );
+      obcChain[atomI]             = (one - tanhSum*tanhSum)*obcChain[atomI]/radiusI;
+    }
+private:
+    const ObcFloatAtoms&                                atoms;
+    CpuObcMixedPrecisionKernels::BornRadiusRowKernel    kernel;
+    const ObcParameters*                                obcParameters;
+    RealOpenMM*                                         bornRadii;
+    RealOpenMM*                                         obcChain;
+    const int*                                          clusterBegin;
+    const int*                                          clusterEnd;
+    const RealOpenMM*                                   intraClusterBornSum;
+    const RealOpenMM one, two, three, half;
+};
+
+/**
+ * This performs the first main loop of the force calculation with single
+ * precision pair terms, in parallel. As in CutoffForceTask1 each work item
+ * gathers everything for its own atom I over the whole row, including the
+ * self term, so nothing is shared between threads.
+ */
+
+class MixedPrecisionForceTask1 : public ParallelExecutor::Task {
+public:
+    MixedPrecisionForceTask1
+       (const ObcFloatAtoms&                           atoms,
+        CpuObcMixedPrecisionKernels::ForceRowKernel1   kernel,
+        int                                            numberOfAtoms,
+        const ImplicitSolventForces*                   forces,
+        RealOpenMM*                                    bornForces,
+        RealOpenMM*                                    atomEnergy) 
+    :   atoms(atoms), kernel(kernel), numberOfAtoms(numberOfAtoms), forces(forces), bornForces(bornForces),
+        atomEnergy(atomEnergy) {
+    }
+    void execute(int atomI) {
+
+      RealOpenMM energy           = (RealOpenMM) 0.0;
+      RealOpenMM bornForce        = (RealOpenMM) 0.0;
+      RealOpenMM force[3]         = { 0.0, 0.0, 0.0 };
+      kernel( atoms, atomI, 0, numberOfAtoms, energy, bornForce, force );
+
+      // each pair is seen from both ends, and the self term is halved too
+
+      atomEnergy[atomI] = (RealOpenMM) 0.5*energy;
+      if( forces != NULL ){
+         bornForces[atomI] += bornForce;
+         forces->x[atomI]  += force[0];
+         forces->y[atomI]  += force[1];
+         forces->z[atomI]  += force[2];
+      }
+    }
+private:
+    const ObcFloatAtoms&                            atoms;
+    CpuObcMixedPrecisionKernels::ForceRowKernel1    kernel;
+    const int                                       numberOfAtoms;
+    const ImplicitSolventForces*                    forces;
+    RealOpenMM*                                     bornForces;
+    RealOpenMM*                                     atomEnergy;
+};
+
+/**
+ * This performs the second main loop of the force calculation with single
+ * precision pair terms, in parallel. As in CutoffForceTask2 each work item
+ * owns atom I and applies the descreening of I by J and of J by I; atoms in
+ * I's rigid cluster, if any, are skipped.
+ */
+
+class MixedPrecisionForceTask2 : public ParallelExecutor::Task {
+public:
+    MixedPrecisionForceTask2
+       (const ObcFloatAtoms&                           atoms,
+        CpuObcMixedPrecisionKernels::ForceRowKernel2   kernel,
+        int                                            numberOfAtoms,
+        const ImplicitSolventForces*                   forces,
+        const int*                                     clusterBegin,
+        const int*                                     clusterEnd)
+    :   atoms(atoms), kernel(kernel), numberOfAtoms(numberOfAtoms), forces(forces),
+        clusterBegin(clusterBegin), clusterEnd(clusterEnd) {
+    }
+    void execute(int atomI) {
+
+      RealOpenMM force[3]         = { 0.0, 0.0, 0.0 };
+      const int skipBegin         = clusterBegin != NULL ? clusterBegin[atomI] : atomI;
+      const int skipEnd           = clusterBegin != NULL ? clusterEnd[atomI] : atomI + 1;
+      kernel( atoms, atomI, 0, skipBegin, force );
+      kernel( atoms, atomI, skipEnd, numberOfAtoms, force );
+
+      forces->x[atomI] -= force[0];
+      forces->y[atomI] -= force[1];
+      forces->z[atomI] -= force[2];
+    }
+private:
+    const ObcFloatAtoms&                            atoms;
+    CpuObcMixedPrecisionKernels::ForceRowKernel2    kernel;
+    const int                                       numberOfAtoms;
+    const ImplicitSolventForces*                    forces;
+    const int*                                      clusterBegin;
+    const int*                                      clusterEnd;
+};
+
+/**---------------------------------------------------------------------------------------
 
-         RealOpenMM deltaX             = atomCoordinates[atomJ][0] - atomCoordinates[atomI][0];
-         RealOpenMM deltaY             = atomCoordinates[atomJ][1] - atomCoordinates[atomI][1];
-         RealOpenMM deltaZ             = atomCoordinates[atomJ][2] - atomCoordinates[atomI][2];
- 
-         // 5 FLOP
+   Fill the single precision coordinate and radius arrays used by the mixed
+   precision kernels
 
-         RealOpenMM r2                 = deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ;
+   @param atomCoordinates     atomic coordinates
 
-         // 3 FLOP
+   --------------------------------------------------------------------------------------- */
 
-         RealOpenMM alpha2_ij          = bornRadii[atomI]*bornRadii[atomJ];
-         RealOpenMM D_ij               = r2/(four*alpha2_ij);
+void CpuObc::_packMixedPrecisionArrays( const ImplicitSolventCoordinates& atomCoordinates ){
 
-         // exp + 2 + sqrt FLOP 
+   const ObcParameters* obcParameters    = getObcParameters();
+   const int numberOfAtoms               = obcParameters->getNumberOfAtoms();
+   const RealOpenMM* atomicRadii         = obcParameters->getAtomicRadii();
+   const RealOpenMM* scaledRadiusFactor  = obcParameters->getScaledRadiusFactors();
+   const RealOpenMM dielectricOffset     = obcParameters->getDielectricOffset();
 
-         RealOpenMM expTerm            = EXP( -D_ij );
-         RealOpenMM denominator2       = r2 + alpha2_ij*expTerm; 
-         RealOpenMM denominator        = SQRT( denominator2 ); 
-         
-         // 6 FLOP
+   _floatX.resize( numberOfAtoms );
+   _floatY.resize( numberOfAtoms );
+   _floatZ.resize( numberOfAtoms );
+   _floatOffsetRadii.resize( numberOfAtoms );
+   _floatScaledRadii.resize( numberOfAtoms );
 
-         RealOpenMM Gpol               = (preFactor*partialCharges[atomI]*partialCharges[atomJ])/denominator; 
-         RealOpenMM dGpol_dr           = -Gpol*( one - fourth*expTerm )/denominator2;  
+   for( int atomI = 0; atomI < numberOfAtoms; atomI++ ){
+      const RealOpenMM offsetRadius = atomicRadii[atomI] - dielectricOffset;
+      _floatX[atomI]           = (float) atomCoordinates.x[atomI];
+      _floatY[atomI]           = (float) atomCoordinates.y[atomI];
+      _floatZ[atomI]           = (float) atomCoordinates.z[atomI];
+      _floatOffsetRadii[atomI] = (float) offsetRadius;
+      _floatScaledRadii[atomI] = (float) (offsetRadius*scaledRadiusFactor[atomI]);
+   }
 
-         // 5 FLOP
+   _floatAtoms.x           = &_floatX[0];
+   _floatAtoms.y           = &_floatY[0];
+   _floatAtoms.z           = &_floatZ[0];
+   _floatAtoms.offsetRadii = &_floatOffsetRadii[0];
+   _floatAtoms.scaledRadii = &_floatScaledRadii[0];
+   _floatAtoms.preFactor   = (float) obcParameters->getPreFactor();
+}
 
-         RealOpenMM dGpol_dalpha2_ij   = -half*Gpol*expTerm*( one + D_ij )/denominator2;
+/**---------------------------------------------------------------------------------------
 
-         // 11 FLOP
+   All-pairs Born radii using the Born radius cache (see CpuObc.h)
 
-         if( atomI != atomJ ){
+   --------------------------------------------------------------------------------------- */
 
-             bornForces[atomJ] += dGpol_dalpha2_ij*bornRadii[atomI];
+int CpuObc::_computeBornRadiiCached( const ImplicitSolventCoordinates&   atomCoordinates,
+                                     RealOpenMM*                         bornRadii,
+                                     SimTK::ParallelExecutor*            executor,
+                                     RealOpenMM*                         obcChain ){
 
-             deltaX            *= dGpol_dr;
-             deltaY            *= dGpol_dr;
-             deltaZ            *= dGpol_dr;
+   // a correction costs about two pair terms per moved atom for each atom, so
+   // recompute everything once a quarter of the atoms have moved; corrections
+   // accumulate roundoff so don't chain too many of them
+
+   static const int maxBornRadiusCacheUpdates = 100;
 
-             forces[atomI][0]  += deltaX;
-             forces[atomI][1]  += deltaY;
-             forces[atomI][2]  += deltaZ;
+   ObcParameters* obcParameters          = getObcParameters();
+   const int numberOfAtoms               = obcParameters->getNumberOfAtoms();
 
-             forces[atomJ][0]  -= deltaX;
-             forces[atomJ][1]  -= deltaY;
-             forces[atomJ][2]  -= deltaZ;
+   const int* clusterBegin               = _numberOfClusters > 0 ? &_clusterBegin[0] : NULL;
+   const int* clusterEnd                 = _numberOfClusters > 0 ? &_clusterEnd[0] : NULL;
+   const RealOpenMM* intraClusterBornSum = _numberOfClusters > 0 ? &_intraClusterBornSum[0] : NULL;
 
-         } else {
-            Gpol *= half;
+   int numberOfMovedAtoms                = numberOfAtoms;
+   if( _bornRadiusCacheValid && _bornRadiusCacheUpdates < maxBornRadiusCacheUpdates ){
+      _movedAtoms.clear();
+      for( int atomI = 0; atomI < numberOfAtoms; atomI++ ){
+         _atomMoved[atomI] = atomCoordinates.x[atomI] != _cachedX[atomI] ||
+                             atomCoordinates.y[atomI] != _cachedY[atomI] ||
+                             atomCoordinates.z[atomI] != _cachedZ[atomI];
+         if( _atomMoved[atomI] ){
+            _movedAtoms.push_back( atomI );
          }
+      }
+      numberOfMovedAtoms = (int) _movedAtoms.size();
+   }
 
-         // 3 FLOP
+   if( 4*numberOfMovedAtoms > numberOfAtoms ){
 
-         energy += Gpol;
-         bornForces[atomI] += dGpol_dalpha2_ij*bornRadii[atomJ];
-    }
-private:
-    const RealOpenMM*        bornRadii;
-    const RealOpenMM* const* atomCoordinates;
-    const RealOpenMM*        partialCharges;
-    RealOpenMM&              obcEnergy;
-    RealOpenMM*              bornForces;
-    RealOpenMM* const*       forces;
+      _cachedBornSum.resize( numberOfAtoms );
+      BornRadiiTask task( bornRadii, atomCoordinates, obcChain, obcParameters,
+                          clusterBegin, clusterEnd, intraClusterBornSum, &_cachedBornSum[0] );
+      executeAtomTask( task, numberOfAtoms, executor );
 
-    static thread_local Real energy;
+      _cachedX.assign( atomCoordinates.x, atomCoordinates.x + numberOfAtoms );
+      _cachedY.assign( atomCoordinates.y, atomCoordinates.y + numberOfAtoms );
+      _cachedZ.assign( atomCoordinates.z, atomCoordinates.z + numberOfAtoms );
+      _atomMoved.resize( numberOfAtoms );
+      _bornRadiusCacheValid        = 1;
+      _bornRadiusCacheUpdates      = 0;
+      _numberOfRecomputedBornRadii = numberOfAtoms;
 
-    const RealOpenMM one, four, half, fourth, preFactor;
-};
+   } else {
 
-thread_local Real ParallelTask1::energy;
+      const ImplicitSolventCoordinates oldCoordinates = { &_cachedX[0], &_cachedY[0], &_cachedZ[0] };
+      IncrementalBornRadiiTask task( bornRadii, atomCoordinates, oldCoordinates, obcChain, obcParameters,
+                                     &_atomMoved[0], _movedAtoms, clusterBegin, clusterEnd,
+                                     intraClusterBornSum, &_cachedBornSum[0] );
+      executeAtomTask( task, numberOfAtoms, executor );
+
+      for( int jj = 0; jj < numberOfMovedAtoms; jj++ ){
+         const int atomJ = _movedAtoms[jj];
+         _cachedX[atomJ] = atomCoordinates.x[atomJ];
+         _cachedY[atomJ] = atomCoordinates.y[atomJ];
+         _cachedZ[atomJ] = atomCoordinates.z[atomJ];
+      }
+      if( numberOfMovedAtoms > 0 ){
+         _bornRadiusCacheUpdates++;
+      }
+      _numberOfRecomputedBornRadii = numberOfMovedAtoms;
+   }
 
-/**
- * This performs the second main loop of the force calculation in parallel.
- */
+   return SimTKOpenMMCommon::DefaultReturn;
+}
 
-class ParallelTask2 : public Parallel2DExecutor::Task {
-public:
-    ParallelTask2
-       (const RealOpenMM*           atomicRadii, 
-        const RealOpenMM* const*    atomCoordinates, 
-        const RealOpenMM*           partialCharges,
-        const RealOpenMM*           scaledRadiusFactor, 
-        RealOpenMM* const*          forces, 
-        RealOpenMM*                 bornForces, 
-        RealOpenMM                  dielectricOffs)
-    :   atomicRadii(atomicRadii), atomCoordinates(atomCoordinates), partialCharges(partialCharges),
-        scaledRadiusFactor(scaledRadiusFactor), forces(forces), bornForces(bornForces), dielectricOffset(dielectricOffs),
-        one((RealOpenMM) 1.0), fourth((RealOpenMM) 0.25), eighth((RealOpenMM) 0.125) 
-    {
-    }
+/**---------------------------------------------------------------------------------------
 
-    void execute(int atomI, int atomJ) {
-        if (atomI == atomJ)
-            return;
-        RealOpenMM offsetRadiusI      = atomicRadii[atomI] - dielectricOffset;
-        RealOpenMM deltaX             = atomCoordinates[atomJ][0] - atomCoordinates[atomI][0];
-        RealOpenMM deltaY             = atomCoordinates[atomJ][1] - atomCoordinates[atomI][1];
-        RealOpenMM deltaZ             = atomCoordinates[atomJ][2] - atomCoordinates[atomI][2];
+   Get Born radii with single precision pair terms (see computeBornRadii())
 
-        RealOpenMM r2                 = deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ;
-        RealOpenMM r                  = SQRT( r2 );
+   --------------------------------------------------------------------------------------- */
 
-        // radius w/ dielectric offset applied
+int CpuObc::_computeBornRadiiMixedPrecision( const ImplicitSolventCoordinates&   atomCoordinates,
+                                             RealOpenMM*                         bornRadii,
+                                             SimTK::ParallelExecutor*            executor,
+                                             RealOpenMM*                         obcChain ){
 
-        RealOpenMM offsetRadiusJ      = atomicRadii[atomJ] - dielectricOffset;
+   const ObcParameters* obcParameters = getObcParameters();
 
-        RealOpenMM scaledRadiusJ      = offsetRadiusJ*scaledRadiusFactor[atomJ];
-        RealOpenMM scaledRadiusJ2     = scaledRadiusJ*scaledRadiusJ;
-        RealOpenMM rScaledRadiusJ     = r + scaledRadiusJ;
+   _packMixedPrecisionArrays( atomCoordinates );
 
-        // dL/dr & dU/dr are zero (this can be shown analytically)
-        // removed from calculation
+   MixedPrecisionBornRadiiTask task( _floatAtoms,
+                                     CpuObcMixedPrecisionKernels::getBornRadiusRowKernel( _mixedPrecisionKernelType ),
+                                     obcParameters, bornRadii, obcChain,
+                                     _numberOfClusters > 0 ? &_clusterBegin[0] : NULL,
+                                     _numberOfClusters > 0 ? &_clusterEnd[0] : NULL,
+                                     _numberOfClusters > 0 ? &_intraClusterBornSum[0] : NULL );
+   executeAtomTask( task, obcParameters->getNumberOfAtoms(), executor );
 
-        if( offsetRadiusI < rScaledRadiusJ ){
+   return SimTKOpenMMCommon::DefaultReturn;
+}
 
-           RealOpenMM l_ij          = offsetRadiusI > FABS( r - scaledRadiusJ ) ? offsetRadiusI : FABS( r - scaledRadiusJ );
-                l_ij                = one/l_ij;
+/**---------------------------------------------------------------------------------------
 
-           RealOpenMM u_ij          = one/rScaledRadiusJ;
+   Both main loops of computeBornEnergyForces() with single precision pair terms;
+   bornForces must hold the ACE contribution (or zero) on entry and the OBC energy
+   is added to obcEnergy
 
-           RealOpenMM l_ij2         = l_ij*l_ij;
+   --------------------------------------------------------------------------------------- */
 
-           RealOpenMM u_ij2         = u_ij*u_ij;
+int CpuObc::_computeBornEnergyForcesMixedPrecision( const RealOpenMM*                   bornRadii,
+                                                    const ImplicitSolventCoordinates&   atomCoordinates,
+                                                    const RealOpenMM*                   partialCharges,
+                                                    const ImplicitSolventForces*        forces,
+                                                    RealOpenMM*                         bornForces,
+                                                    RealOpenMM&                         obcEnergy,
+                                                    SimTK::ParallelExecutor*            executor ){
 
-           RealOpenMM rInverse      = one/r;
-           RealOpenMM r2Inverse     = rInverse*rInverse;
+   const int numberOfAtoms = getObcParameters()->getNumberOfAtoms();
 
-           RealOpenMM t3            = eighth*(one + scaledRadiusJ2*r2Inverse)*(l_ij2 - u_ij2) + fourth*LN( u_ij/l_ij )*r2Inverse;
+   _packMixedPrecisionArrays( atomCoordinates );
 
-           RealOpenMM de            = bornForces[atomI]*t3*rInverse;
+   _floatCharges.resize( numberOfAtoms );
+   _floatBornRadii.resize( numberOfAtoms );
+   for( int atomI = 0; atomI < numberOfAtoms; atomI++ ){
+      _floatCharges[atomI]   = (float) partialCharges[atomI];
+      _floatBornRadii[atomI] = (float) bornRadii[atomI];
+   }
+   _floatAtoms.charges     = &_floatCharges[0];
+   _floatAtoms.bornRadii   = &_floatBornRadii[0];
 
-           deltaX                  *= de;
-           deltaY                  *= de;
-           deltaZ                  *= de;
+   // first main loop; per-atom energies are summed in atom order so the
+   // result doesn't depend on the thread count
+
+   _atomEnergy.resize( numberOfAtoms );
+   MixedPrecisionForceTask1 task( _floatAtoms,
+                                  CpuObcMixedPrecisionKernels::getForceRowKernel1( _mixedPrecisionKernelType, forces != NULL ),
+                                  numberOfAtoms, forces, bornForces, &_atomEnergy[0] );
+   executeAtomTask( task, numberOfAtoms, executor );
+   for( int atomI = 0; atomI < numberOfAtoms; atomI++ ){
+      obcEnergy += _atomEnergy[atomI];
+   }
 
-           forces[atomI][0]        -= deltaX;
-           forces[atomI][1]        -= deltaY;
-           forces[atomI][2]        -= deltaZ;
+   if( forces == NULL ){
+      return SimTKOpenMMCommon::DefaultReturn;
+   }
 
-           forces[atomJ][0]        += deltaX;
-           forces[atomJ][1]        += deltaY;
-           forces[atomJ][2]        += deltaZ;
-        }
-    }
-private:
-    const RealOpenMM*           atomicRadii;
-    const RealOpenMM* const*    atomCoordinates;
-    const RealOpenMM*           partialCharges;
-    const RealOpenMM*           scaledRadiusFactor;
-    RealOpenMM*                 bornForces;
-    RealOpenMM* const*          forces;
+   // second main loop
 
-    const RealOpenMM one, fourth, eighth, dielectricOffset;
-};
+   _floatBornForces.resize( numberOfAtoms );
+   BornForceChainRuleTask chainRuleTask( bornRadii, getObcChainConst(), bornForces, &_floatBornForces[0] );
+   executeAtomTask( chainRuleTask, numberOfAtoms, executor );
+   _floatAtoms.bornForces  = &_floatBornForces[0];
+
+   MixedPrecisionForceTask2 task2( _floatAtoms,
+                                   CpuObcMixedPrecisionKernels::getForceRowKernel2( _mixedPrecisionKernelType ),
+                                   numberOfAtoms, forces,
+                                   _numberOfClusters > 0 ? &_clusterBegin[0] : NULL,
+                                   _numberOfClusters > 0 ? &_clusterEnd[0] : NULL );
+   executeAtomTask( task2, numberOfAtoms, executor );
+
+   return SimTKOpenMMCommon::DefaultReturn;
+}
 
 /**---------------------------------------------------------------------------------------
 
@@ -626,7 +1868,7 @@ private:
                               entry is used
    @param atomCoordinates     atomic coordinates
    @param partialCharges      partial charges
-   @param forces              forces
+   @param forces              forces; if NULL only the energy is computed
    @param executor            used for parallelizing the force calculation
 
    @return SimTKOpenMMCommon::DefaultReturn;
@@ -635,11 +1877,11 @@ private:
 
    --------------------------------------------------------------------------------------- */
 
-int CpuObc::computeBornEnergyForces( const RealOpenMM*          bornRadii, 
-                                     const RealOpenMM* const*   atomCoordinates,
-                                     const RealOpenMM*          partialCharges, 
-                                     RealOpenMM* const*         forces, 
-                                     Parallel2DExecutor*        executor ){
+int CpuObc::computeBornEnergyForces( const RealOpenMM*                   bornRadii, 
+                                     const ImplicitSolventCoordinates&   atomCoordinates,
+                                     const RealOpenMM*                   partialCharges,
+                                     const ImplicitSolventForces*        forces,
+                                     Parallel2DExecutor*                 executor ){
 
    // ---------------------------------------------------------------------------------------
 
@@ -673,28 +1915,59 @@ int CpuObc::computeBornEnergyForces( const RealOpenMM*          bornRadii,
 
    // ---------------------------------------------------------------------------------------
 
-   // set energy/forces to zero
+   // set energy/forces to zero and add the ACE term
 
    RealOpenMM obcEnergy                 = zero;
-   const unsigned int arraySzInBytes    = sizeof( RealOpenMM )*numberOfAtoms;
+   RealOpenMM* bornForces               = getBornForce();
+   _initializeBornEnergyForces( bornRadii, forces, obcEnergy,
+                                executor == NULL ? NULL : &executor->getExecutor() );
 
-   for( int ii = 0; ii < numberOfAtoms; ii++ ){
-      memset( forces[ii], 0, 3*sizeof( RealOpenMM ) );
-   }
+   // ---------------------------------------------------------------------------------------
 
-   RealOpenMM* bornForces = getBornForce();
-   memset( bornForces, 0, arraySzInBytes );
+   // cutoff mode: both loops run over the neighbor list built by computeBornRadii()
 
-   // ---------------------------------------------------------------------------------------
+   if( _useCutoff ){
 
-   // N*( 8 + pow) ACE
-   // compute the nonpolar solvation via ACE approximation
-    
-   if( includeAceApproximation() ){
-      computeAceNonPolarForce( obcParameters, bornRadii, &obcEnergy, bornForces );
+      ParallelExecutor* atomExecutor = executor == NULL ? NULL : &executor->getExecutor();
+      if( (int) _neighborList.size() != numberOfAtoms &&
+          buildNeighborList( atomCoordinates, atomExecutor ) != SimTKOpenMMCommon::DefaultReturn ){
+         return SimTKOpenMMCommon::ErrorReturn;
+      }
+
+      _atomEnergy.resize( numberOfAtoms );
+      CutoffForceTask1 task( bornRadii, atomCoordinates, partialCharges, forces, bornForces,
+                             &_atomEnergy[0], preFactor, _neighborList );
+      executeAtomTask( task, numberOfAtoms, atomExecutor );
+      for( int atomI = 0; atomI < numberOfAtoms; atomI++ ){
+         obcEnergy += _atomEnergy[atomI];
+      }
+      if( _computeAtomEnergies ){
+         _atomGbEnergy = _atomEnergy;
+      }
+
+      if( forces != NULL ){
+         BornForceChainRuleTask chainRuleTask( bornRadii, getObcChain(), bornForces, NULL );
+         executeAtomTask( chainRuleTask, numberOfAtoms, atomExecutor );
+         CutoffForceTask2 task2( obcParameters->getAtomicRadii(), atomCoordinates,
+                                 obcParameters->getScaledRadiusFactors(), forces, bornForces,
+                                 dielectricOffset, _neighborList );
+         executeAtomTask( task2, numberOfAtoms, atomExecutor );
+      }
+
+      setEnergy( obcEnergy );
+      return SimTKOpenMMCommon::DefaultReturn;
    }
 
-   // ---------------------------------------------------------------------------------------
+   if( _useMixedPrecision ){
+      int status = _computeBornEnergyForcesMixedPrecision( bornRadii, atomCoordinates, partialCharges, forces,
+                                                           bornForces, obcEnergy,
+                                                           executor == NULL ? NULL : &executor->getExecutor() );
+      if( _computeAtomEnergies ){
+         _atomGbEnergy = _atomEnergy;
+      }
+      setEnergy( obcEnergy );
+      return status;
+   }
 
    bool tempExecutor = false;
    if (executor == NULL) {
@@ -704,12 +1977,95 @@ int CpuObc::computeBornEnergyForces( const RealOpenMM*          bornRadii,
    
    // first main loop
 
-    ParallelTask1 task(bornRadii, atomCoordinates, partialCharges, forces, bornForces, obcEnergy, preFactor);
-    executor->execute(task, Parallel2DExecutor::HalfPlusDiagonal);
+   if( _computeAtomEnergies ){
+      _atomGbEnergy.assign( numberOfAtoms, zero );
+      ParallelTask1<true> task(bornRadii, atomCoordinates, partialCharges, forces, bornForces, obcEnergy, preFactor,
+                               &_atomGbEnergy[0]);
+      executor->execute(task, Parallel2DExecutor::HalfPlusDiagonal);
+   } else {
+      ParallelTask1<false> task(bornRadii, atomCoordinates, partialCharges, forces, bornForces, obcEnergy, preFactor,
+                                NULL);
+      executor->execute(task, Parallel2DExecutor::HalfPlusDiagonal);
+   }
 
-   // ---------------------------------------------------------------------------------------
+   // second main loop; this only applies the Born radius chain rule to the forces
 
-   // second main loop
+   if( forces != NULL ){
+      _applyBornRadiusChainRule( bornRadii, atomCoordinates, forces, executor );
+   }
+   setEnergy( obcEnergy );
+   
+   if (tempExecutor)
+       delete executor;
+
+   return SimTKOpenMMCommon::DefaultReturn;
+
+}
+
+/**---------------------------------------------------------------------------------------
+
+   Zero the forces and Born forces and add the ACE term to the energy and Born forces
+
+   @param bornRadii           Born radii
+   @param forces              forces; may be NULL
+   @param obcEnergy           energy to add the ACE term to
+   @param executor            used for parallelizing the ACE term; may be NULL
+
+   @return SimTKOpenMMCommon::DefaultReturn
+
+   --------------------------------------------------------------------------------------- */
+
+int CpuObc::_initializeBornEnergyForces( const RealOpenMM*                   bornRadii,
+                                         const ImplicitSolventForces*        forces,
+                                         RealOpenMM&                         obcEnergy,
+                                         SimTK::ParallelExecutor*            executor ){
+
+   const ObcParameters* obcParameters   = getObcParameters();
+   const unsigned int arraySzInBytes    = sizeof( RealOpenMM )*obcParameters->getNumberOfAtoms();
+
+   // forces may be NULL in which case we compute only the energy
+
+   if( forces != NULL ){
+      memset( forces->x, 0, arraySzInBytes );
+      memset( forces->y, 0, arraySzInBytes );
+      memset( forces->z, 0, arraySzInBytes );
+   }
+
+   RealOpenMM* bornForces = getBornForce();
+   memset( bornForces, 0, arraySzInBytes );
+
+   // N*( 8 + pow) ACE
+   // compute the nonpolar solvation via ACE approximation
+    
+   if( includeAceApproximation() ){
+      computeAceNonPolarForce( obcParameters, bornRadii, &obcEnergy, bornForces, executor );
+   }
+
+   return SimTKOpenMMCommon::DefaultReturn;
+}
+
+/**---------------------------------------------------------------------------------------
+
+   Second main loop of the all-pairs force calculation: scale the Born forces by
+   the OBC chain factors and add the resulting descreening forces
+
+   @param bornRadii           Born radii
+   @param atomCoordinates     atomic coordinates
+   @param forces              forces
+   @param executor            used for parallelizing the loop; may be NULL
+
+   @return SimTKOpenMMCommon::DefaultReturn
+
+   --------------------------------------------------------------------------------------- */
+
+int CpuObc::_applyBornRadiusChainRule( const RealOpenMM*                   bornRadii,
+                                       const ImplicitSolventCoordinates&   atomCoordinates,
+                                       const ImplicitSolventForces*        forces,
+                                       Parallel2DExecutor*                 executor ){
+
+   const ObcParameters* obcParameters    = getObcParameters();
+   const int numberOfAtoms               = obcParameters->getNumberOfAtoms();
+   const unsigned int arraySzInBytes     = sizeof( RealOpenMM )*numberOfAtoms;
 
    // initialize Born radii & ObcChain temp arrays -- contain values
    // used in next iteration
@@ -720,29 +2076,110 @@ int CpuObc::computeBornEnergyForces( const RealOpenMM*          bornRadii,
    RealOpenMM* obcChainTemp              = getObcChainTemp();
    memset( obcChainTemp, 0, arraySzInBytes );
 
+   RealOpenMM* bornForces                = getBornForce();
    RealOpenMM* obcChain                  = getObcChain();
    const RealOpenMM* atomicRadii         = obcParameters->getAtomicRadii();
-
-   const RealOpenMM alphaObc             = obcParameters->getAlphaObc();
-   const RealOpenMM betaObc              = obcParameters->getBetaObc();
-   const RealOpenMM gammaObc             = obcParameters->getGammaObc();
    const RealOpenMM* scaledRadiusFactor  = obcParameters->getScaledRadiusFactors();
+   const RealOpenMM dielectricOffset     = obcParameters->getDielectricOffset();
 
     // compute factor that depends only on the outer loop index
 
-   for( int atomI = 0; atomI < numberOfAtoms; atomI++ ){
-      bornForces[atomI] *= bornRadii[atomI]*bornRadii[atomI]*obcChain[atomI];      
+   BornForceChainRuleTask chainRuleTask( bornRadii, obcChain, bornForces, NULL );
+   executeAtomTask( chainRuleTask, numberOfAtoms, executor == NULL ? NULL : &executor->getExecutor() );
+
+   bool tempExecutor = false;
+   if (executor == NULL) {
+       tempExecutor = true;
+       executor = new Parallel2DExecutor(numberOfAtoms, 1);
    }
 
-   ParallelTask2 task2(atomicRadii, atomCoordinates, partialCharges, scaledRadiusFactor, forces, bornForces, dielectricOffset);
+   ParallelTask2 task2(atomicRadii, atomCoordinates, NULL, scaledRadiusFactor, forces, bornForces, dielectricOffset,
+                       _numberOfClusters > 0 ? &_clusterBegin[0] : NULL,
+                       _numberOfClusters > 0 ? &_clusterEnd[0] : NULL);
    executor->execute(task2, Parallel2DExecutor::FullMatrix);
-   setEnergy( obcEnergy );
    
    if (tempExecutor)
        delete executor;
 
    return SimTKOpenMMCommon::DefaultReturn;
+}
+
+/**---------------------------------------------------------------------------------------
+
+   Start the split form of the force calculation (see CpuObc.h): Born radii,
+   zeroed forces and Born forces, and the ACE term
+
+   @param atomCoordinates     atomic coordinates
+   @param forces              forces; if NULL only the energy is computed
+   @param executor            used for parallelizing the Born radii
+   @param bornForces          set to the Born force array
+
+   @return SimTKOpenMMCommon::DefaultReturn, or SimTKOpenMMCommon::ErrorReturn
+           if the parameters are not set or the mode can't be split
+
+   --------------------------------------------------------------------------------------- */
+
+int CpuObc::beginBornEnergyForces( const ImplicitSolventCoordinates&   atomCoordinates,
+                                   const ImplicitSolventForces*        forces,
+                                   Parallel2DExecutor*                 executor,
+                                   RealOpenMM**                        bornForces ){
+
+   // ---------------------------------------------------------------------------------------
+
+   static const char* methodName = "\nCpuObc::beginBornEnergyForces";
+
+   // ---------------------------------------------------------------------------------------
+
+   if( _useCutoff || _useMixedPrecision || _computeAtomEnergies ){
+      std::stringstream message;
+      message << methodName << " only the all-pairs, full precision mode without per-atom energies can be split.";
+      SimTKOpenMMLog::printError( message );
+      return SimTKOpenMMCommon::ErrorReturn; 
+   }
+
+   if( incrementForceCallIndex() == 1 && getObcParameters()->isNotReady() ){
+      std::stringstream message;
+      message << methodName << " implicitSolventParameters are not set for force calculations!";
+      SimTKOpenMMLog::printError( message );
+      return SimTKOpenMMCommon::ErrorReturn; 
+   }
+
+   RealOpenMM* bornRadii = getBornRadii();
+   computeBornRadii( atomCoordinates, bornRadii, executor == NULL ? NULL : &executor->getExecutor() );
+
+   RealOpenMM obcEnergy  = (RealOpenMM) 0.0;
+   _initializeBornEnergyForces( bornRadii, forces, obcEnergy,
+                                executor == NULL ? NULL : &executor->getExecutor() );
+   setEnergy( obcEnergy );
+
+   *bornForces           = getBornForce();
+   return SimTKOpenMMCommon::DefaultReturn;
+}
 
+/**---------------------------------------------------------------------------------------
+
+   Finish the split form of the force calculation (see CpuObc.h)
+
+   @param atomCoordinates     atomic coordinates
+   @param forces              forces; if NULL only the energy is set
+   @param pairEnergy          GB pair energy from the caller's first loop
+   @param executor            used for parallelizing the chain rule
+
+   @return SimTKOpenMMCommon::DefaultReturn
+
+   --------------------------------------------------------------------------------------- */
+
+int CpuObc::finishBornEnergyForces( const ImplicitSolventCoordinates&   atomCoordinates,
+                                    const ImplicitSolventForces*        forces,
+                                    RealOpenMM                          pairEnergy,
+                                    Parallel2DExecutor*                 executor ){
+
+   if( forces != NULL ){
+      _applyBornRadiusChainRule( getBornRadii(), atomCoordinates, forces, executor );
+   }
+   setEnergy( getEnergy() + pairEnergy );
+
+   return SimTKOpenMMCommon::DefaultReturn;
 }
 
 /**---------------------------------------------------------------------------------------
@@ -784,10 +2221,10 @@ std::string CpuObc::getStateString( const char* title ) const {
 
    --------------------------------------------------------------------------------------- */
 
-int CpuObc::writeBornEnergyForces( const RealOpenMM* const*     atomCoordinates,
-                                   const RealOpenMM*            partialCharges, 
-                                   const RealOpenMM* const*     forces,
-                                   const std::string&           resultsFileName ) const {
+int CpuObc::writeBornEnergyForces( const ImplicitSolventCoordinates&   atomCoordinates,
+                                   const RealOpenMM*                   partialCharges,
+                                   const ImplicitSolventForces*        forces,
+                                   const std::string&                  resultsFileName ) const {
 
    // ---------------------------------------------------------------------------------------
 
@@ -844,17 +2281,17 @@ int CpuObc::writeBornEnergyForces( const RealOpenMM* const*     atomCoordinates,
 
    // output
 
-   if( forces != NULL && atomCoordinates != NULL && partialCharges != NULL && atomicRadii != NULL ){
+   if( forces != NULL && partialCharges != NULL && atomicRadii != NULL ){
       for( int ii = 0; ii < numberOfAtoms; ii++ ){
             (void) fprintf( implicitSolventResultsFile, "%.7e %.7e %.7e %.7e %.5f %.5f %.5f %.7e %.7e %.7e %.7e\n",
-                            lengthConversion*atomCoordinates[ii][0],
-                            lengthConversion*atomCoordinates[ii][1], 
-                            lengthConversion*atomCoordinates[ii][2],
+                            lengthConversion*atomCoordinates.x[ii],
+                            lengthConversion*atomCoordinates.y[ii], 
+                            lengthConversion*atomCoordinates.z[ii],
                            (bornRadii != NULL ? lengthConversion*bornRadii[ii] : 0.0),
                             partialCharges[ii], lengthConversion*atomicRadii[ii], scaledRadii[ii],
-                            forceConversion*forces[ii][0],
-                            forceConversion*forces[ii][1],
-                            forceConversion*forces[ii][2],
+                            forceConversion*forces->x[ii],
+                            forceConversion*forces->y[ii],
+                            forceConversion*forces->z[ii],
                             forceConversion*obcChain[ii]
                           );
       }
@@ -880,10 +2317,10 @@ int CpuObc::writeBornEnergyForces( const RealOpenMM* const*     atomCoordinates,
 
    --------------------------------------------------------------------------------------- */
 
-int CpuObc::writeForceLoop1( int                        numberOfAtoms, 
-                             const RealOpenMM* const*   forces, 
-                             const RealOpenMM*          bornForce,
-                             const std::string&         outputFileName ){
+int CpuObc::writeForceLoop1( int                            numberOfAtoms, 
+                             const ImplicitSolventForces&   forces, 
+                             const RealOpenMM*              bornForce,
+                             const std::string&             outputFileName ){
 
    // ---------------------------------------------------------------------------------------
 
@@ -891,20 +2328,14 @@ int CpuObc::writeForceLoop1( int                        numberOfAtoms,
 
    // ---------------------------------------------------------------------------------------
 
-   int chunkSize;
-   if( bornForce ){
-      chunkSize = 3;
-   } else {
-      chunkSize = 4;
-   }
-
    StringVector lineVector;
    std::stringstream header;
    lineVector.push_back( "# bornF F" );
    for( int atomI = 0; atomI < numberOfAtoms; atomI++ ){
       std::stringstream line;
       line << (atomI+1) << " ";
-      SimTKOpenMMUtilities::formatRealStringStream( line, forces[atomI], chunkSize );
+      const RealOpenMM force[3] = { forces.x[atomI], forces.y[atomI], forces.z[atomI] };
+      SimTKOpenMMUtilities::formatRealStringStream( line, force, 3 );
       if( bornForce ){
          line << " " << bornForce[atomI];
       }
@@ -994,8 +2425,8 @@ int CpuObc::writeForceLoop( int numberOfAtoms, const IntVector& chunkSizes,
 
    --------------------------------------------------------------------------------------- */
 
-int CpuObc::computeBornEnergyForcesPrint( RealOpenMM* bornRadii, RealOpenMM** atomCoordinates,
-                                         const RealOpenMM* partialCharges, RealOpenMM** forces ){
+int CpuObc::computeBornEnergyForcesPrint( RealOpenMM* bornRadii, const ImplicitSolventCoordinates& atomCoordinates,
+                                          const RealOpenMM* partialCharges, const ImplicitSolventForces& forces ){
  
    // ---------------------------------------------------------------------------------------
 
@@ -1048,9 +2479,9 @@ FILE* logFile = fopen( "bF", "w" );
    RealOpenMM obcEnergy                 = zero;
    const unsigned int arraySzInBytes    = sizeof( RealOpenMM )*numberOfAtoms;
 
-   for( int ii = 0; ii < numberOfAtoms; ii++ ){
-      memset( forces[ii], 0, 3*sizeof( RealOpenMM ) );
-   }
+   memset( forces.x, 0, arraySzInBytes );
+   memset( forces.y, 0, arraySzInBytes );
+   memset( forces.z, 0, arraySzInBytes );
 
    RealOpenMM* bornForces = getBornForce();
    memset( bornForces, 0, arraySzInBytes );
@@ -1075,9 +2506,9 @@ FILE* logFile = fopen( "bF", "w" );
 
          // 3 FLOP
 
-         RealOpenMM deltaX             = atomCoordinates[atomJ][0] - atomCoordinates[atomI][0];
-         RealOpenMM deltaY             = atomCoordinates[atomJ][1] - atomCoordinates[atomI][1];
-         RealOpenMM deltaZ             = atomCoordinates[atomJ][2] - atomCoordinates[atomI][2];
+         RealOpenMM deltaX             = atomCoordinates.x[atomJ] - atomCoordinates.x[atomI];
+         RealOpenMM deltaY             = atomCoordinates.y[atomJ] - atomCoordinates.y[atomI];
+         RealOpenMM deltaZ             = atomCoordinates.z[atomJ] - atomCoordinates.z[atomI];
  
          // 5 FLOP
 
@@ -1115,13 +2546,13 @@ FILE* logFile = fopen( "bF", "w" );
              deltaY                   *= dGpol_dr;
              deltaZ                   *= dGpol_dr;
 
-             forces[atomI][0]         += deltaX;
-             forces[atomI][1]         += deltaY;
-             forces[atomI][2]         += deltaZ;
+             forces.x[atomI]         += deltaX;
+             forces.y[atomI]         += deltaY;
+             forces.z[atomI]         += deltaZ;
 
-             forces[atomJ][0]         -= deltaX;
-             forces[atomJ][1]         -= deltaY;
-             forces[atomJ][2]         -= deltaZ;
+             forces.x[atomJ]         -= deltaX;
+             forces.y[atomJ]         -= deltaY;
+             forces.z[atomJ]         -= deltaZ;
 
          } else {
             Gpol *= half;
@@ -1135,7 +2566,7 @@ FILE* logFile = fopen( "bF", "w" );
 if( logFile && (atomI == -1 || atomJ == -1) ){
 //   (void) fprintf( logFile, "\nWWX %d %d F[%.6e %.6e %.6e] bF=[%.6e %.6e] Gpl[%.6e %.6e %.6e] rb[%6.4f %7.4f] rs[%6.4f %7.4f] ",
 //                    atomI, atomJ,
-//                    forces[atomI][0],  forces[atomI][1],  forces[atomI][2],
+//                    forces.x[atomI],  forces.y[atomI],  forces.z[atomI],
 //                    bornForces[atomI], bornForces[atomJ],
 //                    Gpol,dGpol_dr,dGpol_dalpha2_ij,
 //                    bornRadii[atomI],bornRadii[atomJ],atomicRadii[atomI],atomicRadii[atomJ] );
@@ -1156,7 +2587,7 @@ if( logFile ){
    (void) fprintf( logFile, "\nWXX bF & F E=%.8e", obcEnergy );
    for( int atomI = 0; atomI < numberOfAtoms; atomI++ ){
       (void) fprintf( logFile, "\nWXX %d %.6e q=%.3f F[%.6e %.6e %.6e] ",
-                      atomI, partialCharges[atomI],  bornForces[atomI], forces[atomI][0],  forces[atomI][1],  forces[atomI][2] );
+                      atomI, partialCharges[atomI],  bornForces[atomI], forces.x[atomI],  forces.y[atomI],  forces.z[atomI] );
    }
 }
 
@@ -1165,7 +2596,7 @@ if( logFile ){
       CpuObc::writeForceLoop1( numberOfAtoms, forces, bornForces, outputFileName );
 /*
       for( int atomI = 0; atomI < numberOfAtoms; atomI++ ){
-         forces[atomI][0] = forces[atomI][1] = forces[atomI][2] = (RealOpenMM) 0.0;
+         forces.x[atomI] = forces.y[atomI] = forces.z[atomI] = (RealOpenMM) 0.0;
       }
 */
    }
@@ -1202,12 +2633,13 @@ if( logFile ){
       std::string outputFileName = "PostLoop1Cpu.txt";
 
       IntVector chunkVector;
-      chunkVector.push_back( 3 );
 
       RealOpenMMPtrPtrVector realPtrPtrVector;
-      realPtrPtrVector.push_back( forces );
 
       RealOpenMMPtrVector realPtrVector;
+      realPtrVector.push_back( forces.x );
+      realPtrVector.push_back( forces.y );
+      realPtrVector.push_back( forces.z );
       realPtrVector.push_back( obcChain );
       realPtrVector.push_back( bornRadii );
       realPtrVector.push_back( bornForces );
@@ -1219,9 +2651,9 @@ RealOpenMM* bornSumArray = (RealOpenMM*) malloc( sizeof( RealOpenMM )*numberOfAt
 memset( bornSumArray, 0, sizeof( RealOpenMM )*numberOfAtoms );
 /*
 for( int atomI = 0; atomI < numberOfAtoms; atomI++ ){
-   forces[atomI][0]  = 0.0;
-   forces[atomI][1]  = 0.0;
-   forces[atomI][2]  = 0.0;
+   forces.x[atomI]  = 0.0;
+   forces.y[atomI]  = 0.0;
+   forces.z[atomI]  = 0.0;
 } */
    
 
@@ -1240,9 +2672,9 @@ for( int atomI = 0; atomI < numberOfAtoms; atomI++ ){
 
          if( atomJ != atomI ){
 
-            RealOpenMM deltaX             = atomCoordinates[atomJ][0] - atomCoordinates[atomI][0];
-            RealOpenMM deltaY             = atomCoordinates[atomJ][1] - atomCoordinates[atomI][1];
-            RealOpenMM deltaZ             = atomCoordinates[atomJ][2] - atomCoordinates[atomI][2];
+            RealOpenMM deltaX             = atomCoordinates.x[atomJ] - atomCoordinates.x[atomI];
+            RealOpenMM deltaY             = atomCoordinates.y[atomJ] - atomCoordinates.y[atomI];
+            RealOpenMM deltaZ             = atomCoordinates.z[atomJ] - atomCoordinates.z[atomI];
     
             RealOpenMM r2                 = deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ;
             RealOpenMM r                  = SQRT( r2 );
@@ -1282,13 +2714,13 @@ for( int atomI = 0; atomI < numberOfAtoms; atomI++ ){
                deltaY                    *= de;
                deltaZ                    *= de;
 
-               forces[atomI][0]          -= deltaX;
-               forces[atomI][1]          -= deltaY;
-               forces[atomI][2]          -= deltaZ;
+               forces.x[atomI]          -= deltaX;
+               forces.y[atomI]          -= deltaY;
+               forces.z[atomI]          -= deltaZ;
   
-               forces[atomJ][0]          += deltaX;
-               forces[atomJ][1]          += deltaY;
-               forces[atomJ][2]          += deltaZ;
+               forces.x[atomJ]          += deltaX;
+               forces.y[atomJ]          += deltaY;
+               forces.z[atomJ]          += deltaZ;
  
                // Born radius term
 
@@ -1303,7 +2735,7 @@ if( atomI == -1 || atomJ == -1 ){
    (void) fprintf( logFile, "\nXXY %d %d de=%.6e bF[%.6e %6e] t3=%.6e r=%.6e trm=%.6e bSm=%.6e f[%.6e %.6e %.6e]",
                    atomI, atomJ, de,
                    bornForces[atomI], obcChain[atomI],
-                   t3, r, term, bornSum, forces[atomI][0],  forces[atomI][1],  forces[atomI][2] );
+                   t3, r, term, bornSum, forces.x[atomI],  forces.y[atomI],  forces.z[atomI] );
 }
             }
         }
@@ -1337,12 +2769,13 @@ if( logFile && atomI >= 0 ){
       std::string outputFileName = "Loop2Cpu.txt";
 
       IntVector chunkVector;
-      chunkVector.push_back( 3 );
 
       RealOpenMMPtrPtrVector realPtrPtrVector;
-      realPtrPtrVector.push_back( forces );
 
       RealOpenMMPtrVector realPtrVector;
+      realPtrVector.push_back( forces.x );
+      realPtrVector.push_back( forces.y );
+      realPtrVector.push_back( forces.z );
       realPtrVector.push_back( bornSumArray );
       // realPtrVector.push_back( bornRadiiTemp );
       // realPtrVector.push_back( obcChainTemp );
@@ -1362,9 +2795,9 @@ if( logFile && atomI >= 0 ){
    if( fabs(forceFactor - 1.0f) > 1.0e-04 ){
       constantFactor *= forceFactor;
       for( int ii = 0; ii < numberOfAtoms; ii++ ){
-         forces[ii][0]  *= forceFactor;
-         forces[ii][1]  *= forceFactor;
-         forces[ii][2]  *= forceFactor;
+         forces.x[ii]  *= forceFactor;
+         forces.y[ii]  *= forceFactor;
+         forces.z[ii]  *= forceFactor;
       }
    } */
 
@@ -27,6 +27,7 @@
 
 #include "ObcParameters.h"
 #include "CpuImplicitSolvent.h"
+#include "CpuObcMixedPrecisionKernels.h"
 
 namespace SimTK {
 
@@ -45,6 +46,133 @@ class CpuObc : public CpuImplicitSolvent {
       RealOpenMM* _obcChain;
       RealOpenMM* _obcChainTemp;
 
+      // cutoff GB: if set, the Born radius descreening sums and both force
+      // loops only consider pairs closer than _cutoff (in the length units of
+      // the parameters, Angstrom by default); the pairs are found with a cell
+      // list in computeBornRadii() and the resulting neighbor list is shared
+      // with computeBornEnergyForces()
+
+      int                     _useCutoff;
+      RealOpenMM              _cutoff;
+      std::vector<IntVector>  _neighborList;
+      IntVector               _cellHead;
+      IntVector               _cellNext;
+      IntVector               _atomCell;
+      RealOpenMMVector        _atomEnergy;
+
+      // rigid clusters: if set, atom I belongs to the cluster of atoms
+      // [_clusterBegin[I], _clusterEnd[I]) whose mutual distances never change;
+      // the all-pairs Born radius sums take the descreening of I by the rest of
+      // its cluster from _intraClusterBornSum and skip those pairs, as does the
+      // second force loop
+
+      int                     _numberOfClusters;
+      IntVector               _clusterBegin;
+      IntVector               _clusterEnd;
+      RealOpenMMVector        _intraClusterBornSum;
+
+      // mixed precision: if set, the all-pairs Born radius sums and both force
+      // loops evaluate each pair in single precision and accumulate per-atom
+      // sums in double; _floatAtoms points into the single precision copies of
+      // the coordinates and per-atom parameters, which are refreshed on every call
+
+      int                     _useMixedPrecision;
+      CpuObcMixedPrecisionKernels::KernelType _mixedPrecisionKernelType;
+      ObcFloatAtoms           _floatAtoms;
+      std::vector<float>      _floatX;
+      std::vector<float>      _floatY;
+      std::vector<float>      _floatZ;
+      std::vector<float>      _floatOffsetRadii;
+      std::vector<float>      _floatScaledRadii;
+      std::vector<float>      _floatCharges;
+      std::vector<float>      _floatBornRadii;
+      std::vector<float>      _floatBornForces;
+
+      // per-atom energies: if set, computeBornEnergyForces() also leaves each
+      // atom's share of the GB energy in _atomGbEnergy -- its self term and half
+      // of each of its pair terms -- alongside the per-atom ACE terms
+
+      int                     _computeAtomEnergies;
+      RealOpenMMVector        _atomGbEnergy;
+
+      // Born radius cache: if set, the all-pairs, full precision Born radii keep
+      // each atom's raw descreening sum together with the coordinates it was
+      // computed from. On the next call only atoms whose coordinates changed
+      // get their sums recomputed; every other atom's sum is corrected for the
+      // moved atoms alone. Too many moved atoms, or too many corrections in a
+      // row, cause a full recomputation
+
+      int                     _useBornRadiusCache;
+      int                     _bornRadiusCacheValid;
+      int                     _bornRadiusCacheUpdates;
+      int                     _numberOfRecomputedBornRadii;
+      RealOpenMMVector        _cachedX;
+      RealOpenMMVector        _cachedY;
+      RealOpenMMVector        _cachedZ;
+      RealOpenMMVector        _cachedBornSum;
+      IntVector               _atomMoved;
+      IntVector               _movedAtoms;
+
+      /**---------------------------------------------------------------------------------------
+      
+         All-pairs Born radii using the Born radius cache (see computeBornRadii())
+      
+         --------------------------------------------------------------------------------------- */
+      
+      int _computeBornRadiiCached( const ImplicitSolventCoordinates&   atomCoordinates,
+                                   RealOpenMM*                         bornRadii,
+                                   SimTK::ParallelExecutor*            executor,
+                                   RealOpenMM*                         obcChain );
+
+      /**---------------------------------------------------------------------------------------
+      
+         Fill the single precision coordinate and radius arrays used by the mixed
+         precision kernels
+      
+         @param atomCoordinates   atomic coordinates
+      
+         --------------------------------------------------------------------------------------- */
+      
+      void _packMixedPrecisionArrays( const ImplicitSolventCoordinates& atomCoordinates );
+
+      /**---------------------------------------------------------------------------------------
+      
+         Mixed precision versions of the all-pairs Born radius calculation and of the
+         two force loops in computeBornEnergyForces()
+      
+         --------------------------------------------------------------------------------------- */
+      
+      int _computeBornRadiiMixedPrecision( const ImplicitSolventCoordinates&   atomCoordinates,
+                                           RealOpenMM*                         bornRadii,
+                                           SimTK::ParallelExecutor*            executor,
+                                           RealOpenMM*                         obcChain );
+
+      int _computeBornEnergyForcesMixedPrecision( const RealOpenMM*                   bornRadii,
+                                                  const ImplicitSolventCoordinates&   atomCoordinates,
+                                                  const RealOpenMM*                   partialCharges,
+                                                  const ImplicitSolventForces*        forces,
+                                                  RealOpenMM*                         bornForces,
+                                                  RealOpenMM&                         obcEnergy,
+                                                  SimTK::ParallelExecutor*            executor );
+
+      /**---------------------------------------------------------------------------------------
+      
+         Common parts of computeBornEnergyForces() and the split form below: zero
+         the forces and Born forces and add the ACE term; then, after the first
+         loop, apply the Born radius chain rule (the second loop) to the forces
+      
+         --------------------------------------------------------------------------------------- */
+      
+      int _initializeBornEnergyForces( const RealOpenMM*                   bornRadii,
+                                       const ImplicitSolventForces*        forces,
+                                       RealOpenMM&                         obcEnergy,
+                                       SimTK::ParallelExecutor*            executor );
+
+      int _applyBornRadiusChainRule( const RealOpenMM*                   bornRadii,
+                                     const ImplicitSolventCoordinates&   atomCoordinates,
+                                     const ImplicitSolventForces*        forces,
+                                     SimTK::Parallel2DExecutor*          executor );
+
       // initialize data members (more than
       // one constructor, so centralize intialization here)
 
@@ -117,6 +245,147 @@ class CpuObc : public CpuImplicitSolvent {
       
       RealOpenMM* getObcChainTemp( void );
       
+      /**---------------------------------------------------------------------------------------
+      
+         Enable/disable the cutoff GB mode (disabled by default)
+      
+         @param useCutoff         if nonzero, only pairs closer than the cutoff
+                                  contribute to the Born radii and GB energy
+      
+         @return SimTKOpenMMCommon::DefaultReturn
+      
+         --------------------------------------------------------------------------------------- */
+      
+      int setUseCutoff( int useCutoff );
+      int getUseCutoff( void ) const;
+      
+      /**---------------------------------------------------------------------------------------
+      
+         Set the GB cutoff distance in the length units of the parameters; only
+         used if setUseCutoff() is on
+      
+         @param cutoff            cutoff distance (Angstrom by default)
+      
+         @return SimTKOpenMMCommon::DefaultReturn
+      
+         --------------------------------------------------------------------------------------- */
+      
+      int setCutoff( RealOpenMM cutoff );
+      RealOpenMM getCutoff( void ) const;
+      
+      /**---------------------------------------------------------------------------------------
+      
+         Enable/disable mixed precision (disabled by default): pair terms of the
+         all-pairs Born radii and force loops are computed in single precision and
+         summed in double, giving roughly 1e-5 relative error in the energy or
+         better. The vectorized kernels are used if the processor supports them.
+         The cutoff mode and the ACE term always use full precision.
+      
+         @param useMixedPrecision if nonzero, use the mixed precision kernels
+      
+         @return SimTKOpenMMCommon::DefaultReturn
+      
+         --------------------------------------------------------------------------------------- */
+      
+      int setUseMixedPrecision( int useMixedPrecision );
+      int getUseMixedPrecision( void ) const;
+
+      // name of the mixed precision kernels in use ("scalar" or "AVX2")
+
+      const char* getMixedPrecisionKernelName( void ) const;
+      
+      /**---------------------------------------------------------------------------------------
+      
+         Enable/disable per-atom energies (disabled by default). When enabled,
+         computeBornEnergyForces() also records each atom's share of the GB energy:
+         its self term plus half of each pair term it is in. Together with the
+         per-atom ACE terms these add up to the total energy. When disabled
+         nothing extra is computed.
+      
+         @param computeAtomEnergies if nonzero, record the per-atom energies
+      
+         @return SimTKOpenMMCommon::DefaultReturn
+      
+         --------------------------------------------------------------------------------------- */
+      
+      int setComputeAtomEnergies( int computeAtomEnergies );
+      int getComputeAtomEnergies( void ) const;
+
+      // per-atom GB energies of the last computeBornEnergyForces() call, or NULL
+      // if per-atom energies weren't being computed then
+
+      const RealOpenMM* getAtomGbEnergies( void ) const;
+
+      /**---------------------------------------------------------------------------------------
+      
+         Enable/disable the Born radius cache (disabled by default). When enabled,
+         the all-pairs, full precision Born radius calculation remembers the
+         coordinates and descreening sums of the previous call. Atoms whose
+         coordinates are bit-for-bit unchanged keep their sums, corrected only
+         for the atoms that moved, so the cost is proportional to the number of
+         moved atoms rather than to N^2. The radii agree with a full calculation
+         to roundoff. Cutoff and mixed precision modes don't use the cache.
+         Setting this, or the rigid clusters, empties the cache; do so if the
+         radii change.
+      
+         @param useBornRadiusCache if nonzero, use the cache
+      
+         @return SimTKOpenMMCommon::DefaultReturn
+      
+         --------------------------------------------------------------------------------------- */
+      
+      int setUseBornRadiusCache( int useBornRadiusCache );
+      int getUseBornRadiusCache( void ) const;
+
+      // number of atoms whose descreening sums were recomputed from scratch by the
+      // last all-pairs, full precision Born radius calculation: all of them unless
+      // the cache was used
+
+      int getNumberOfRecomputedBornRadii( void ) const;
+
+      /**---------------------------------------------------------------------------------------
+      
+         Declare rigid clusters of atoms, e.g. the atoms of one rigid body, and
+         cache the HCT descreening within each cluster. Cluster c is the atoms
+         [clusterStart[c], clusterStart[c+1]); clusters must cover all atoms in order.
+         
+         The all-pairs Born radii then only evaluate pairs in different clusters.
+         The second force loop skips pairs in the same cluster too, so the
+         returned atom forces are only correct as resultant forces and torques
+         on each cluster. Cutoff mode ignores the clusters. Call this again if
+         the radii or units change.
+      
+         @param numberOfClusters  number of clusters; 0 removes the clusters
+         @param clusterStart      numberOfClusters+1 cluster boundaries
+         @param clusterCoordinates atom coordinates; only distances between
+                                  atoms in the same cluster are used, so each
+                                  cluster may be given in its own frame
+      
+         @return SimTKOpenMMCommon::DefaultReturn, or SimTKOpenMMCommon::ErrorReturn
+                 if the clusters don't cover the atoms
+      
+         --------------------------------------------------------------------------------------- */
+      
+      int setRigidClusters( int numberOfClusters, const int* clusterStart,
+                            const ImplicitSolventCoordinates& clusterCoordinates );
+      int getNumberOfRigidClusters( void ) const;
+      
+      /**---------------------------------------------------------------------------------------
+      
+         Build the neighbor list used in cutoff mode: for each atom, all other
+         atoms closer than the cutoff, in increasing cell order. Atoms are binned
+         on a cell grid of edge >= cutoff so only the 27 surrounding cells are searched.
+      
+         @param atomCoordinates   atomic coordinates
+         @param executor          if not NULL, used to search the cells in parallel
+      
+         @return SimTKOpenMMCommon::DefaultReturn
+      
+         --------------------------------------------------------------------------------------- */
+      
+      int buildNeighborList( const ImplicitSolventCoordinates&   atomCoordinates,
+                             SimTK::ParallelExecutor*            executor );
+      
       /**---------------------------------------------------------------------------------------
       
          Get Born radii based on OBC 
@@ -130,10 +399,10 @@ class CpuObc : public CpuImplicitSolvent {
       
          --------------------------------------------------------------------------------------- */
       
-      int computeBornRadii( const RealOpenMM* const*    atomCoordinates, 
-                            RealOpenMM*                 bornRadii, 
-                            SimTK::ParallelExecutor*    executor,
-                            RealOpenMM*                 obcChain = NULL );
+      int computeBornRadii( const ImplicitSolventCoordinates&   atomCoordinates, 
+                            RealOpenMM*                         bornRadii,
+                            SimTK::ParallelExecutor*            executor,
+                            RealOpenMM*                         obcChain = NULL );
       
       /**---------------------------------------------------------------------------------------
       
@@ -149,14 +418,48 @@ class CpuObc : public CpuImplicitSolvent {
       
          --------------------------------------------------------------------------------------- */
       
-      int computeBornEnergyForces( const RealOpenMM*            bornRadii, 
-                                   const RealOpenMM* const*     atomCoordinates,
-                                   const RealOpenMM*            partialCharges, 
-                                   RealOpenMM* const*           forces, 
-                                   SimTK::Parallel2DExecutor*   executor );
+      int computeBornEnergyForces( const RealOpenMM*                   bornRadii, 
+                                   const ImplicitSolventCoordinates&   atomCoordinates,
+                                   const RealOpenMM*                   partialCharges,
+                                   const ImplicitSolventForces*        forces,
+                                   SimTK::Parallel2DExecutor*          executor );
+      
+      /**---------------------------------------------------------------------------------------
+      
+         Split form of computeImplicitSolventForces() for callers that evaluate the
+         first force loop -- the GB pair energies -- themselves, fused with other
+         pair terms. beginBornEnergyForces() computes the Born radii, zeroes the
+         forces and Born forces and adds the ACE term. The caller then adds each
+         pair's dE/d(bornRadius) into bornForces (and its pair forces wherever it
+         likes), and finishBornEnergyForces() applies the Born radius chain rule to
+         the forces and sets the energy to ACE plus pairEnergy.
+         
+         Only the all-pairs, full precision mode without per-atom energies can be split.
+      
+         @param atomCoordinates   atomic coordinates
+         @param forces            forces; if NULL only the energy is computed
+         @param executor          used for parallelizing the Born radii and chain rule
+         @param bornForces        set to the Born force array to be accumulated into
+         @param pairEnergy        GB pair energy from the caller's first loop
+      
+         @return SimTKOpenMMCommon::DefaultReturn, or SimTKOpenMMCommon::ErrorReturn
+                 if the parameters are not set or the cutoff, mixed precision
+                 or per-atom energy mode is on
+      
+         --------------------------------------------------------------------------------------- */
+      
+      int beginBornEnergyForces( const ImplicitSolventCoordinates&   atomCoordinates,
+                                 const ImplicitSolventForces*        forces,
+                                 SimTK::Parallel2DExecutor*          executor,
+                                 RealOpenMM**                        bornForces );
+
+      int finishBornEnergyForces( const ImplicitSolventCoordinates&   atomCoordinates,
+                                  const ImplicitSolventForces*        forces,
+                                  RealOpenMM                          pairEnergy,
+                                  SimTK::Parallel2DExecutor*          executor );
       
-      int computeBornEnergyForcesPrint( RealOpenMM* bornRadii, RealOpenMM** atomCoordinates,
-                                        const RealOpenMM* partialCharges, RealOpenMM** forces );
+      int computeBornEnergyForcesPrint( RealOpenMM* bornRadii, const ImplicitSolventCoordinates& atomCoordinates,
+                                        const RealOpenMM* partialCharges, const ImplicitSolventForces& forces );
       
       /**---------------------------------------------------------------------------------------
       
@@ -183,10 +486,10 @@ class CpuObc : public CpuImplicitSolvent {
       
          --------------------------------------------------------------------------------------- */
           
-      int writeBornEnergyForces( const RealOpenMM* const*   atomCoordinates,
-                                 const RealOpenMM*          partialCharges, 
-                                 const RealOpenMM* const*   forces,
-                                 const std::string&         resultsFileName ) const;
+      int writeBornEnergyForces( const ImplicitSolventCoordinates&   atomCoordinates,
+                                 const RealOpenMM*                   partialCharges,
+                                 const ImplicitSolventForces*        forces,
+                                 const std::string&                  resultsFileName ) const;
 
       /**---------------------------------------------------------------------------------------
       
@@ -202,10 +505,10 @@ class CpuObc : public CpuImplicitSolvent {
       
          --------------------------------------------------------------------------------------- */
       
-      static int writeForceLoop1( int                       numberOfAtoms, 
-                                  const RealOpenMM* const*  forces, 
-                                  const RealOpenMM*         bornForce,
-                                  const std::string&        outputFileName );
+      static int writeForceLoop1( int                            numberOfAtoms, 
+                                  const ImplicitSolventForces&   forces,
+                                  const RealOpenMM*              bornForce,
+                                  const std::string&             outputFileName );
       
       /**---------------------------------------------------------------------------------------
       
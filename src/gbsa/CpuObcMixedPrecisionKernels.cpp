@@ -0,0 +1,534 @@
+
+/* Portions copyright (c) 2026 Stanford University and Simbios.
+ * Contributors:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject
+ * to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "CpuObcMixedPrecisionKernels.h"
+
+#include <string.h>
+#include <cmath>
+
+// The AVX2 kernels are compiled with function attributes so that the rest of
+// the library doesn't require AVX2; the processor is checked before they are
+// selected. They accumulate into RealOpenMM, so they assume it is double.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && RealOpenMMType == 2
+   #define OBC_X86_KERNELS
+   #include <immintrin.h>
+#endif
+
+using namespace SimTK;
+
+/**---------------------------------------------------------------------------------------
+
+   Single precision natural log and exponential. The polynomials are those of the
+   Cephes logf() and expf() and are good to about one ulp; the AVX2 versions below
+   do the same arithmetic eight at a time.
+
+   --------------------------------------------------------------------------------------- */
+
+static inline float lnFloat( float x ){
+
+   // x = m*2^e with m in [sqrt(1/2), sqrt(2)); x must be positive and normal
+
+   int bits;
+   memcpy( &bits, &x, sizeof( float ) );
+   int e          = ((bits >> 23) & 0xff) - 126;
+   bits           = (bits & 0x007fffff) | 0x3f000000;
+   float m;
+   memcpy( &m, &bits, sizeof( float ) );
+
+   if( m < 0.707106781186547524f ){
+      e          -= 1;
+      m           = m + m - 1.0f;
+   } else {
+      m           = m - 1.0f;
+   }
+
+   const float z  = m*m;
+   float y        = 7.0376836292E-2f;
+   y              = y*m - 1.1514610310E-1f;
+   y              = y*m + 1.1676998740E-1f;
+   y              = y*m - 1.2420140846E-1f;
+   y              = y*m + 1.4249322787E-1f;
+   y              = y*m - 1.6668057665E-1f;
+   y              = y*m + 2.0000714765E-1f;
+   y              = y*m - 2.4999993993E-1f;
+   y              = y*m + 3.3333331174E-1f;
+   y             *= m*z;
+
+   const float fe = (float) e;
+   y             += fe*-2.12194440E-4f;
+   y             -= 0.5f*z;
+   return m + y + fe*0.693359375f;
+}
+
+static inline float expFloat( float x ){
+
+   // x = n*ln(2) + f with |f| <= ln(2)/2; clamped so that 2^n is a normal float
+
+   if( x < -87.0f ) x = -87.0f;
+   if( x >  88.0f ) x =  88.0f;
+
+   const float t  = x*1.44269504088896341f;
+   const int   n  = (int) (t < 0.0f ? t - 0.5f : t + 0.5f);
+   const float fn = (float) n;
+   x             -= fn*0.693359375f;
+   x             -= fn*-2.12194440E-4f;
+
+   const float z  = x*x;
+   float y        = 1.9875691500E-4f;
+   y              = y*x + 1.3981999507E-3f;
+   y              = y*x + 8.3334519073E-3f;
+   y              = y*x + 4.1665795894E-2f;
+   y              = y*x + 1.6666665459E-1f;
+   y              = y*x + 5.0000001201E-1f;
+   y              = y*z + x + 1.0f;
+
+   const int bits = (n + 127) << 23;
+   float scale;
+   memcpy( &scale, &bits, sizeof( float ) );
+   return y*scale;
+}
+
+/**---------------------------------------------------------------------------------------
+
+   Scalar row kernels; the pair terms are the same as in the double precision
+   loops of CpuObc
+
+   --------------------------------------------------------------------------------------- */
+
+static void scalarBornRadiusRowKernel( const ObcFloatAtoms& a, int atomI, int jBegin, int jEnd,
+                                       RealOpenMM& sum ){
+
+   const float offsetRadiusI  = a.offsetRadii[atomI];
+   const float radiusIInverse = 1.0f/offsetRadiusI;
+
+   for( int atomJ = jBegin; atomJ < jEnd; atomJ++ ){
+
+      const float deltaX         = a.x[atomJ] - a.x[atomI];
+      const float deltaY         = a.y[atomJ] - a.y[atomI];
+      const float deltaZ         = a.z[atomJ] - a.z[atomI];
+      const float r              = std::sqrt( deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ );
+      const float scaledRadiusJ  = a.scaledRadii[atomJ];
+      const float rScaledRadiusJ = r + scaledRadiusJ;
+      if( offsetRadiusI >= rScaledRadiusJ ){
+         continue;
+      }
+
+      const float rInverse       = 1.0f/r;
+      const float absDiff        = std::fabs( r - scaledRadiusJ );
+      const float l_ij           = 1.0f/(offsetRadiusI > absDiff ? offsetRadiusI : absDiff);
+      const float u_ij           = 1.0f/rScaledRadiusJ;
+      const float l_ij2          = l_ij*l_ij;
+      const float u_ij2          = u_ij*u_ij;
+
+      float term                 = l_ij - u_ij + 0.25f*r*(u_ij2 - l_ij2) + 0.5f*rInverse*lnFloat( u_ij/l_ij )
+                                 + (0.25f*scaledRadiusJ*scaledRadiusJ*rInverse)*(l_ij2 - u_ij2);
+      if( offsetRadiusI < (scaledRadiusJ - r) ){
+         term                   += 2.0f*(radiusIInverse - l_ij);
+      }
+      sum += term;
+   }
+}
+
+template <bool CalcForces>
+static void scalarForceRowKernel1( const ObcFloatAtoms& a, int atomI, int jBegin, int jEnd,
+                                   RealOpenMM& energy, RealOpenMM& bornForce, RealOpenMM* force ){
+
+   const float bornRadiusI = a.bornRadii[atomI];
+   const float chargeI     = a.preFactor*a.charges[atomI];
+
+   for( int atomJ = jBegin; atomJ < jEnd; atomJ++ ){
+
+      const float deltaX       = a.x[atomJ] - a.x[atomI];
+      const float deltaY       = a.y[atomJ] - a.y[atomI];
+      const float deltaZ       = a.z[atomJ] - a.z[atomI];
+      const float r2           = deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ;
+
+      const float alpha2_ij    = bornRadiusI*a.bornRadii[atomJ];
+      const float D_ij         = r2/(4.0f*alpha2_ij);
+      const float expTerm      = expFloat( -D_ij );
+      const float denominator2 = r2 + alpha2_ij*expTerm;
+      const float Gpol         = (chargeI*a.charges[atomJ])/std::sqrt( denominator2 );
+
+      energy                  += Gpol;
+      if( CalcForces ){
+         const float dGpol_dr         = -Gpol*( 1.0f - 0.25f*expTerm )/denominator2;
+         const float dGpol_dalpha2_ij = -0.5f*Gpol*expTerm*( 1.0f + D_ij )/denominator2;
+         bornForce            += dGpol_dalpha2_ij*a.bornRadii[atomJ];
+         force[0]             += dGpol_dr*deltaX;
+         force[1]             += dGpol_dr*deltaY;
+         force[2]             += dGpol_dr*deltaZ;
+      }
+   }
+}
+
+// chain rule factor for the descreening of atom I by atom J, without the Born force
+
+static inline float hctDescreeningForceFloat( float offsetRadiusI, float scaledRadiusJ, float r, float rInverse ){
+
+   const float rScaledRadiusJ = r + scaledRadiusJ;
+   if( offsetRadiusI >= rScaledRadiusJ ){
+      return 0.0f;
+   }
+   const float absDiff        = std::fabs( r - scaledRadiusJ );
+   const float l_ij           = 1.0f/(offsetRadiusI > absDiff ? offsetRadiusI : absDiff);
+   const float u_ij           = 1.0f/rScaledRadiusJ;
+   const float r2Inverse      = rInverse*rInverse;
+   const float t3             = 0.125f*(1.0f + scaledRadiusJ*scaledRadiusJ*r2Inverse)*(l_ij*l_ij - u_ij*u_ij)
+                              + 0.25f*lnFloat( u_ij/l_ij )*r2Inverse;
+   return t3*rInverse;
+}
+
+static void scalarForceRowKernel2( const ObcFloatAtoms& a, int atomI, int jBegin, int jEnd,
+                                   RealOpenMM* force ){
+
+   const float offsetRadiusI = a.offsetRadii[atomI];
+   const float scaledRadiusI = a.scaledRadii[atomI];
+   const float bornForceI    = a.bornForces[atomI];
+
+   for( int atomJ = jBegin; atomJ < jEnd; atomJ++ ){
+
+      const float deltaX     = a.x[atomJ] - a.x[atomI];
+      const float deltaY     = a.y[atomJ] - a.y[atomI];
+      const float deltaZ     = a.z[atomJ] - a.z[atomI];
+      const float r          = std::sqrt( deltaX*deltaX + deltaY*deltaY + deltaZ*deltaZ );
+      const float rInverse   = 1.0f/r;
+
+      const float de         = bornForceI*hctDescreeningForceFloat( offsetRadiusI, a.scaledRadii[atomJ], r, rInverse )
+                             + a.bornForces[atomJ]*hctDescreeningForceFloat( a.offsetRadii[atomJ], scaledRadiusI, r, rInverse );
+
+      force[0]              += de*deltaX;
+      force[1]              += de*deltaY;
+      force[2]              += de*deltaZ;
+   }
+}
+
+#ifdef OBC_X86_KERNELS
+
+/**---------------------------------------------------------------------------------------
+
+   AVX2 row kernels: eight j atoms at a time, with the pair terms converted to
+   double and summed in four-wide double accumulators. Any leftover atoms are
+   done with the scalar kernels.
+
+   --------------------------------------------------------------------------------------- */
+
+__attribute__((target("avx2,fma")))
+static inline __m256 lnFloat8( __m256 x ){
+
+   const __m256  one   = _mm256_set1_ps( 1.0f );
+   const __m256i bits  = _mm256_castps_si256( x );
+   __m256i e           = _mm256_sub_epi32( _mm256_srli_epi32( bits, 23 ), _mm256_set1_epi32( 126 ) );
+   __m256  m           = _mm256_castsi256_ps( _mm256_or_si256( _mm256_and_si256( bits, _mm256_set1_epi32( 0x007fffff ) ),
+                                                               _mm256_set1_epi32( 0x3f000000 ) ) );
+
+   // where m < sqrt(1/2): e -= 1 and m = 2m - 1; elsewhere m = m - 1
+
+   const __m256 small  = _mm256_cmp_ps( m, _mm256_set1_ps( 0.707106781186547524f ), _CMP_LT_OQ );
+   e                   = _mm256_add_epi32( e, _mm256_castps_si256( small ) );
+   m                   = _mm256_add_ps( _mm256_sub_ps( m, one ), _mm256_and_ps( small, m ) );
+
+   const __m256 z      = _mm256_mul_ps( m, m );
+   __m256 y            = _mm256_set1_ps( 7.0376836292E-2f );
+   y                   = _mm256_fmadd_ps( y, m, _mm256_set1_ps( -1.1514610310E-1f ) );
+   y                   = _mm256_fmadd_ps( y, m, _mm256_set1_ps(  1.1676998740E-1f ) );
+   y                   = _mm256_fmadd_ps( y, m, _mm256_set1_ps( -1.2420140846E-1f ) );
+   y                   = _mm256_fmadd_ps( y, m, _mm256_set1_ps(  1.4249322787E-1f ) );
+   y                   = _mm256_fmadd_ps( y, m, _mm256_set1_ps( -1.6668057665E-1f ) );
+   y                   = _mm256_fmadd_ps( y, m, _mm256_set1_ps(  2.0000714765E-1f ) );
+   y                   = _mm256_fmadd_ps( y, m, _mm256_set1_ps( -2.4999993993E-1f ) );
+   y                   = _mm256_fmadd_ps( y, m, _mm256_set1_ps(  3.3333331174E-1f ) );
+   y                   = _mm256_mul_ps( y, _mm256_mul_ps( m, z ) );
+
+   const __m256 fe     = _mm256_cvtepi32_ps( e );
+   y                   = _mm256_fmadd_ps( fe, _mm256_set1_ps( -2.12194440E-4f ), y );
+   y                   = _mm256_fnmadd_ps( _mm256_set1_ps( 0.5f ), z, y );
+   return _mm256_fmadd_ps( fe, _mm256_set1_ps( 0.693359375f ), _mm256_add_ps( m, y ) );
+}
+
+__attribute__((target("avx2,fma")))
+static inline __m256 expFloat8( __m256 x ){
+
+   x                   = _mm256_max_ps( x, _mm256_set1_ps( -87.0f ) );
+   x                   = _mm256_min_ps( x, _mm256_set1_ps(  88.0f ) );
+
+   const __m256i n     = _mm256_cvtps_epi32( _mm256_mul_ps( x, _mm256_set1_ps( 1.44269504088896341f ) ) );
+   const __m256  fn    = _mm256_cvtepi32_ps( n );
+   x                   = _mm256_fnmadd_ps( fn, _mm256_set1_ps( 0.693359375f ), x );
+   x                   = _mm256_fnmadd_ps( fn, _mm256_set1_ps( -2.12194440E-4f ), x );
+
+   const __m256 z      = _mm256_mul_ps( x, x );
+   __m256 y            = _mm256_set1_ps( 1.9875691500E-4f );
+   y                   = _mm256_fmadd_ps( y, x, _mm256_set1_ps( 1.3981999507E-3f ) );
+   y                   = _mm256_fmadd_ps( y, x, _mm256_set1_ps( 8.3334519073E-3f ) );
+   y                   = _mm256_fmadd_ps( y, x, _mm256_set1_ps( 4.1665795894E-2f ) );
+   y                   = _mm256_fmadd_ps( y, x, _mm256_set1_ps( 1.6666665459E-1f ) );
+   y                   = _mm256_fmadd_ps( y, x, _mm256_set1_ps( 5.0000001201E-1f ) );
+   y                   = _mm256_fmadd_ps( y, z, _mm256_add_ps( x, _mm256_set1_ps( 1.0f ) ) );
+
+   const __m256 scale  = _mm256_castsi256_ps( _mm256_slli_epi32( _mm256_add_epi32( n, _mm256_set1_epi32( 127 ) ), 23 ) );
+   return _mm256_mul_ps( y, scale );
+}
+
+__attribute__((target("avx2,fma")))
+static inline void accumulate8( __m256d& sum, __m256 v ){
+   sum = _mm256_add_pd( sum, _mm256_cvtps_pd( _mm256_castps256_ps128( v ) ) );
+   sum = _mm256_add_pd( sum, _mm256_cvtps_pd( _mm256_extractf128_ps( v, 1 ) ) );
+}
+
+__attribute__((target("avx2,fma")))
+static inline RealOpenMM sum4( __m256d v ){
+   const __m128d lo = _mm_add_pd( _mm256_castpd256_pd128( v ), _mm256_extractf128_pd( v, 1 ) );
+   return _mm_cvtsd_f64( _mm_add_sd( lo, _mm_unpackhi_pd( lo, lo ) ) );
+}
+
+__attribute__((target("avx2,fma")))
+static inline __m256 absFloat8( __m256 x ){
+   return _mm256_andnot_ps( _mm256_set1_ps( -0.0f ), x );
+}
+
+__attribute__((target("avx2,fma")))
+static void avx2BornRadiusRowKernel( const ObcFloatAtoms& a, int atomI, int jBegin, int jEnd,
+                                     RealOpenMM& sum ){
+
+   const __m256 one            = _mm256_set1_ps( 1.0f );
+   const __m256 half           = _mm256_set1_ps( 0.5f );
+   const __m256 fourth         = _mm256_set1_ps( 0.25f );
+   const __m256 xI             = _mm256_set1_ps( a.x[atomI] );
+   const __m256 yI             = _mm256_set1_ps( a.y[atomI] );
+   const __m256 zI             = _mm256_set1_ps( a.z[atomI] );
+   const __m256 offsetRadiusI  = _mm256_set1_ps( a.offsetRadii[atomI] );
+   const __m256 radiusIInverse = _mm256_set1_ps( 1.0f/a.offsetRadii[atomI] );
+
+   __m256d sum4d               = _mm256_setzero_pd();
+
+   int atomJ = jBegin;
+   for( ; atomJ + 8 <= jEnd; atomJ += 8 ){
+
+      const __m256 deltaX         = _mm256_sub_ps( _mm256_loadu_ps( a.x + atomJ ), xI );
+      const __m256 deltaY         = _mm256_sub_ps( _mm256_loadu_ps( a.y + atomJ ), yI );
+      const __m256 deltaZ         = _mm256_sub_ps( _mm256_loadu_ps( a.z + atomJ ), zI );
+      const __m256 r2             = _mm256_fmadd_ps( deltaX, deltaX, _mm256_fmadd_ps( deltaY, deltaY, _mm256_mul_ps( deltaZ, deltaZ ) ) );
+      const __m256 r              = _mm256_sqrt_ps( r2 );
+      const __m256 scaledRadiusJ  = _mm256_loadu_ps( a.scaledRadii + atomJ );
+      const __m256 rScaledRadiusJ = _mm256_add_ps( r, scaledRadiusJ );
+      const __m256 rInverse       = _mm256_div_ps( one, r );
+
+      const __m256 l_ij           = _mm256_div_ps( one, _mm256_max_ps( offsetRadiusI, absFloat8( _mm256_sub_ps( r, scaledRadiusJ ) ) ) );
+      const __m256 u_ij           = _mm256_div_ps( one, rScaledRadiusJ );
+      const __m256 l2MinusU2      = _mm256_sub_ps( _mm256_mul_ps( l_ij, l_ij ), _mm256_mul_ps( u_ij, u_ij ) );
+
+      // l - u - r(l^2 - u^2)/4 + ln(u/l)/2r + s^2(l^2 - u^2)/4r
+
+      __m256 term                 = _mm256_sub_ps( l_ij, u_ij );
+      term                        = _mm256_fnmadd_ps( _mm256_mul_ps( fourth, r ), l2MinusU2, term );
+      term                        = _mm256_fmadd_ps( _mm256_mul_ps( half, rInverse ), lnFloat8( _mm256_div_ps( u_ij, l_ij ) ), term );
+      term                        = _mm256_fmadd_ps( _mm256_mul_ps( _mm256_mul_ps( fourth, _mm256_mul_ps( scaledRadiusJ, scaledRadiusJ ) ), rInverse ),
+                                                     l2MinusU2, term );
+
+      // atom I inside J's scaled sphere
+
+      const __m256 inside         = _mm256_cmp_ps( offsetRadiusI, _mm256_sub_ps( scaledRadiusJ, r ), _CMP_LT_OQ );
+      term                        = _mm256_add_ps( term, _mm256_and_ps( inside, _mm256_mul_ps( _mm256_set1_ps( 2.0f ),
+                                                                                              _mm256_sub_ps( radiusIInverse, l_ij ) ) ) );
+
+      const __m256 overlaps       = _mm256_cmp_ps( offsetRadiusI, rScaledRadiusJ, _CMP_LT_OQ );
+      accumulate8( sum4d, _mm256_and_ps( overlaps, term ) );
+   }
+
+   sum += sum4( sum4d );
+   scalarBornRadiusRowKernel( a, atomI, atomJ, jEnd, sum );
+}
+
+template <bool CalcForces>
+__attribute__((target("avx2,fma")))
+static void avx2ForceRowKernel1( const ObcFloatAtoms& a, int atomI, int jBegin, int jEnd,
+                                 RealOpenMM& energy, RealOpenMM& bornForce, RealOpenMM* force ){
+
+   const __m256 one          = _mm256_set1_ps( 1.0f );
+   const __m256 half         = _mm256_set1_ps( 0.5f );
+   const __m256 fourth       = _mm256_set1_ps( 0.25f );
+   const __m256 xI           = _mm256_set1_ps( a.x[atomI] );
+   const __m256 yI           = _mm256_set1_ps( a.y[atomI] );
+   const __m256 zI           = _mm256_set1_ps( a.z[atomI] );
+   const __m256 bornRadiusI  = _mm256_set1_ps( a.bornRadii[atomI] );
+   const __m256 chargeI      = _mm256_set1_ps( a.preFactor*a.charges[atomI] );
+
+   __m256d energy4d          = _mm256_setzero_pd();
+   __m256d bornForce4d       = _mm256_setzero_pd();
+   __m256d forceX4d          = _mm256_setzero_pd();
+   __m256d forceY4d          = _mm256_setzero_pd();
+   __m256d forceZ4d          = _mm256_setzero_pd();
+
+   int atomJ = jBegin;
+   for( ; atomJ + 8 <= jEnd; atomJ += 8 ){
+
+      const __m256 deltaX       = _mm256_sub_ps( _mm256_loadu_ps( a.x + atomJ ), xI );
+      const __m256 deltaY       = _mm256_sub_ps( _mm256_loadu_ps( a.y + atomJ ), yI );
+      const __m256 deltaZ       = _mm256_sub_ps( _mm256_loadu_ps( a.z + atomJ ), zI );
+      const __m256 r2           = _mm256_fmadd_ps( deltaX, deltaX, _mm256_fmadd_ps( deltaY, deltaY, _mm256_mul_ps( deltaZ, deltaZ ) ) );
+
+      const __m256 bornRadiusJ  = _mm256_loadu_ps( a.bornRadii + atomJ );
+      const __m256 alpha2_ij    = _mm256_mul_ps( bornRadiusI, bornRadiusJ );
+      const __m256 D_ij         = _mm256_div_ps( r2, _mm256_mul_ps( _mm256_set1_ps( 4.0f ), alpha2_ij ) );
+      const __m256 expTerm      = expFloat8( _mm256_sub_ps( _mm256_setzero_ps(), D_ij ) );
+      const __m256 denominator2 = _mm256_fmadd_ps( alpha2_ij, expTerm, r2 );
+      const __m256 Gpol         = _mm256_div_ps( _mm256_mul_ps( chargeI, _mm256_loadu_ps( a.charges + atomJ ) ),
+                                                 _mm256_sqrt_ps( denominator2 ) );
+
+      accumulate8( energy4d, Gpol );
+      if( CalcForces ){
+         const __m256 GpolOverD2       = _mm256_div_ps( Gpol, denominator2 );
+         const __m256 dGpol_dr         = _mm256_mul_ps( GpolOverD2, _mm256_fmsub_ps( fourth, expTerm, one ) );
+         const __m256 dGpol_dalpha2_ij = _mm256_mul_ps( _mm256_mul_ps( _mm256_mul_ps( half, GpolOverD2 ), expTerm ),
+                                                        _mm256_sub_ps( _mm256_setzero_ps(), _mm256_add_ps( one, D_ij ) ) );
+         accumulate8( bornForce4d, _mm256_mul_ps( dGpol_dalpha2_ij, bornRadiusJ ) );
+         accumulate8( forceX4d,    _mm256_mul_ps( dGpol_dr, deltaX ) );
+         accumulate8( forceY4d,    _mm256_mul_ps( dGpol_dr, deltaY ) );
+         accumulate8( forceZ4d,    _mm256_mul_ps( dGpol_dr, deltaZ ) );
+      }
+   }
+
+   energy += sum4( energy4d );
+   if( CalcForces ){
+      bornForce += sum4( bornForce4d );
+      force[0]  += sum4( forceX4d );
+      force[1]  += sum4( forceY4d );
+      force[2]  += sum4( forceZ4d );
+   }
+   scalarForceRowKernel1<CalcForces>( a, atomI, atomJ, jEnd, energy, bornForce, force );
+}
+
+__attribute__((target("avx2,fma")))
+static inline __m256 hctDescreeningForceFloat8( __m256 offsetRadiusI, __m256 scaledRadiusJ, __m256 r, __m256 rInverse ){
+
+   const __m256 one            = _mm256_set1_ps( 1.0f );
+   const __m256 rScaledRadiusJ = _mm256_add_ps( r, scaledRadiusJ );
+   const __m256 l_ij           = _mm256_div_ps( one, _mm256_max_ps( offsetRadiusI, absFloat8( _mm256_sub_ps( r, scaledRadiusJ ) ) ) );
+   const __m256 u_ij           = _mm256_div_ps( one, rScaledRadiusJ );
+   const __m256 r2Inverse      = _mm256_mul_ps( rInverse, rInverse );
+   const __m256 l2MinusU2      = _mm256_sub_ps( _mm256_mul_ps( l_ij, l_ij ), _mm256_mul_ps( u_ij, u_ij ) );
+
+   __m256 t3                   = _mm256_mul_ps( _mm256_mul_ps( _mm256_set1_ps( 0.125f ),
+                                                               _mm256_fmadd_ps( _mm256_mul_ps( scaledRadiusJ, scaledRadiusJ ), r2Inverse, one ) ),
+                                                l2MinusU2 );
+   t3                          = _mm256_fmadd_ps( _mm256_mul_ps( _mm256_set1_ps( 0.25f ), lnFloat8( _mm256_div_ps( u_ij, l_ij ) ) ),
+                                                  r2Inverse, t3 );
+
+   const __m256 overlaps       = _mm256_cmp_ps( offsetRadiusI, rScaledRadiusJ, _CMP_LT_OQ );
+   return _mm256_and_ps( overlaps, _mm256_mul_ps( t3, rInverse ) );
+}
+
+__attribute__((target("avx2,fma")))
+static void avx2ForceRowKernel2( const ObcFloatAtoms& a, int atomI, int jBegin, int jEnd,
+                                 RealOpenMM* force ){
+
+   const __m256 xI            = _mm256_set1_ps( a.x[atomI] );
+   const __m256 yI            = _mm256_set1_ps( a.y[atomI] );
+   const __m256 zI            = _mm256_set1_ps( a.z[atomI] );
+   const __m256 offsetRadiusI = _mm256_set1_ps( a.offsetRadii[atomI] );
+   const __m256 scaledRadiusI = _mm256_set1_ps( a.scaledRadii[atomI] );
+   const __m256 bornForceI    = _mm256_set1_ps( a.bornForces[atomI] );
+
+   __m256d forceX4d           = _mm256_setzero_pd();
+   __m256d forceY4d           = _mm256_setzero_pd();
+   __m256d forceZ4d           = _mm256_setzero_pd();
+
+   int atomJ = jBegin;
+   for( ; atomJ + 8 <= jEnd; atomJ += 8 ){
+
+      const __m256 deltaX     = _mm256_sub_ps( _mm256_loadu_ps( a.x + atomJ ), xI );
+      const __m256 deltaY     = _mm256_sub_ps( _mm256_loadu_ps( a.y + atomJ ), yI );
+      const __m256 deltaZ     = _mm256_sub_ps( _mm256_loadu_ps( a.z + atomJ ), zI );
+      const __m256 r2         = _mm256_fmadd_ps( deltaX, deltaX, _mm256_fmadd_ps( deltaY, deltaY, _mm256_mul_ps( deltaZ, deltaZ ) ) );
+      const __m256 r          = _mm256_sqrt_ps( r2 );
+      const __m256 rInverse   = _mm256_div_ps( _mm256_set1_ps( 1.0f ), r );
+
+      const __m256 de         = _mm256_fmadd_ps( bornForceI,
+                                                 hctDescreeningForceFloat8( offsetRadiusI, _mm256_loadu_ps( a.scaledRadii + atomJ ), r, rInverse ),
+                                                 _mm256_mul_ps( _mm256_loadu_ps( a.bornForces + atomJ ),
+                                                                hctDescreeningForceFloat8( _mm256_loadu_ps( a.offsetRadii + atomJ ), scaledRadiusI, r, rInverse ) ) );
+
+      accumulate8( forceX4d, _mm256_mul_ps( de, deltaX ) );
+      accumulate8( forceY4d, _mm256_mul_ps( de, deltaY ) );
+      accumulate8( forceZ4d, _mm256_mul_ps( de, deltaZ ) );
+   }
+
+   force[0] += sum4( forceX4d );
+   force[1] += sum4( forceY4d );
+   force[2] += sum4( forceZ4d );
+   scalarForceRowKernel2( a, atomI, atomJ, jEnd, force );
+}
+
+#endif // OBC_X86_KERNELS
+
+/**---------------------------------------------------------------------------------------
+
+   Kernel selection
+
+   --------------------------------------------------------------------------------------- */
+
+CpuObcMixedPrecisionKernels::KernelType CpuObcMixedPrecisionKernels::selectKernelType( void ){
+#ifdef OBC_X86_KERNELS
+   __builtin_cpu_init();
+   if( __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" ) ){
+      return AVX2;
+   }
+#endif
+   return Scalar;
+}
+
+CpuObcMixedPrecisionKernels::BornRadiusRowKernel CpuObcMixedPrecisionKernels::getBornRadiusRowKernel( KernelType kernelType ){
+#ifdef OBC_X86_KERNELS
+   if( kernelType == AVX2 ){
+      return avx2BornRadiusRowKernel;
+   }
+#endif
+   return scalarBornRadiusRowKernel;
+}
+
+CpuObcMixedPrecisionKernels::ForceRowKernel1 CpuObcMixedPrecisionKernels::getForceRowKernel1( KernelType kernelType, int calcForces ){
+#ifdef OBC_X86_KERNELS
+   if( kernelType == AVX2 ){
+      return calcForces ? avx2ForceRowKernel1<true> : avx2ForceRowKernel1<false>;
+   }
+#endif
+   return calcForces ? scalarForceRowKernel1<true> : scalarForceRowKernel1<false>;
+}
+
+CpuObcMixedPrecisionKernels::ForceRowKernel2 CpuObcMixedPrecisionKernels::getForceRowKernel2( KernelType kernelType ){
+#ifdef OBC_X86_KERNELS
+   if( kernelType == AVX2 ){
+      return avx2ForceRowKernel2;
+   }
+#endif
+   return scalarForceRowKernel2;
+}
+
+const char* CpuObcMixedPrecisionKernels::getKernelTypeName( KernelType kernelType ){
+   switch( kernelType ){
+      case AVX2: return "AVX2";
+      default:   return "scalar";
+   }
+}
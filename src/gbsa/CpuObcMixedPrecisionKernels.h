@@ -0,0 +1,99 @@
+
+/* Portions copyright (c) 2026 Stanford University and Simbios.
+ * Contributors:
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject
+ * to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __CpuObcMixedPrecisionKernels_H__
+#define __CpuObcMixedPrecisionKernels_H__
+
+#include "SimTKOpenMMRealType.h"
+
+namespace SimTK {
+
+// ---------------------------------------------------------------------------------------
+
+// Single precision, structure-of-arrays copy of the per-atom data used by the
+// mixed precision OBC kernels (see CpuObc::setUseMixedPrecision()). Lengths are
+// in the units of the ObcParameters.
+
+struct ObcFloatAtoms {
+   const float* x;
+   const float* y;
+   const float* z;
+   const float* offsetRadii;   // atomic radius minus dielectric offset
+   const float* scaledRadii;   // offset radius times OBC scale factor
+   const float* charges;       // partial charges
+   const float* bornRadii;
+   const float* bornForces;    // Born forces already multiplied by the OBC chain factor
+   float        preFactor;     // GB prefactor (see ImplicitSolventParameters::getPreFactor())
+};
+
+// ---------------------------------------------------------------------------------------
+
+// Row kernels: each evaluates the pairs of atom i with the atoms j in [jBegin,jEnd)
+// in single precision and *adds* the sums over j to the double precision results.
+// There is a portable scalar version of each and, on x86 processors, an AVX2 version
+// that handles eight j atoms at a time; the kernel type is chosen at run time.
+
+class CpuObcMixedPrecisionKernels {
+
+   public:
+
+      // descreening sum of the HCT Born radius of atom i; [jBegin,jEnd) must not include i
+
+      typedef void (*BornRadiusRowKernel)( const ObcFloatAtoms& atoms, int atomI, int jBegin, int jEnd,
+                                           RealOpenMM& sum );
+
+      // first force loop: GB energy, Born force and force on atom i (j == i is allowed and gives
+      // the self term); energy-only kernels leave bornForce and force alone
+
+      typedef void (*ForceRowKernel1)( const ObcFloatAtoms& atoms, int atomI, int jBegin, int jEnd,
+                                       RealOpenMM& energy, RealOpenMM& bornForce, RealOpenMM* force );
+
+      // second force loop: Born radius chain rule force on atom i from the descreening of
+      // i by j and of j by i; [jBegin,jEnd) must not include i
+
+      typedef void (*ForceRowKernel2)( const ObcFloatAtoms& atoms, int atomI, int jBegin, int jEnd,
+                                       RealOpenMM* force );
+
+      enum KernelType {
+         Scalar = 0,
+         AVX2   = 1
+      };
+
+      /**---------------------------------------------------------------------------------------
+      
+         Return the fastest kernel type supported by this processor
+      
+         --------------------------------------------------------------------------------------- */
+
+      static KernelType selectKernelType( void );
+
+      static BornRadiusRowKernel getBornRadiusRowKernel( KernelType kernelType );
+      static ForceRowKernel1 getForceRowKernel1( KernelType kernelType, int calcForces );
+      static ForceRowKernel2 getForceRowKernel2( KernelType kernelType );
+      static const char* getKernelTypeName( KernelType kernelType );
+};
+
+} // namespace SimTK
+
+#endif // __CpuObcMixedPrecisionKernels_H__
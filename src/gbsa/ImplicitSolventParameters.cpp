@@ -103,6 +103,8 @@ ImplicitSolventParameters::ImplicitSolventParameters( int numberOfAtoms ){
 
    _atomicRadii            = NULL;
 
+   _units                  = SimTKOpenMMCommon::KcalAngUnits;
+
    // see comments in ~ImplicitSolventParameters for explanation
 
    _freeArrays             = false;
@@ -274,6 +276,83 @@ int ImplicitSolventParameters::setElectricConstant( RealOpenMM electricConstant
    return SimTKOpenMMCommon::DefaultReturn;
 }
 
+/**---------------------------------------------------------------------------------------
+
+   Get units of the parameters, coordinates and forces
+
+   @return SimTKOpenMMCommon::KcalAngUnits or SimTKOpenMMCommon::MdUnits
+
+   --------------------------------------------------------------------------------------- */
+
+int ImplicitSolventParameters::getUnits( void ) const {
+
+   // ---------------------------------------------------------------------------------------
+
+   // static const char* methodName = "\nImplicitSolventParameters::getUnits:";
+
+   // ---------------------------------------------------------------------------------------
+
+   return _units;
+}
+
+/**---------------------------------------------------------------------------------------
+
+   Set units of the parameters, coordinates and forces; the electric constant,
+   probe radius, surface area factor and atomic radii already set are rescaled
+   to the new units
+
+   @param units       units flag: SimTKOpenMMCommon::KcalAngUnits or
+                                  SimTKOpenMMCommon::MdUnits 
+
+   @return SimTKOpenMMCommon::DefaultReturn or SimTKOpenMMCommon::ErrorReturn
+           if units is not recognized
+
+   --------------------------------------------------------------------------------------- */
+
+int ImplicitSolventParameters::setUnits( int units ){
+
+   // ---------------------------------------------------------------------------------------
+
+   static const char* methodName = "\nImplicitSolventParameters::setUnits:";
+
+   // ---------------------------------------------------------------------------------------
+
+   if( units != SimTKOpenMMCommon::MdUnits && units != SimTKOpenMMCommon::KcalAngUnits ){
+      std::stringstream message;
+      message << methodName;
+      message << " units=" << units << " not recognized.";
+      SimTKOpenMMLog::printWarning( message );
+      return SimTKOpenMMCommon::ErrorReturn;
+   }
+
+   if( units == _units ){
+      return SimTKOpenMMCommon::DefaultReturn;
+   }
+
+   // length and energy scale factors going from kcal/A to kJ/nm, or back
+
+   RealOpenMM lengthScale = (RealOpenMM) 0.1;
+   RealOpenMM energyScale = (RealOpenMM) 4.184;
+   if( units == SimTKOpenMMCommon::KcalAngUnits ){
+      lengthScale = (RealOpenMM) 1.0/lengthScale;
+      energyScale = (RealOpenMM) 1.0/energyScale;
+   }
+
+   _electricConstant *= energyScale*lengthScale;
+   _probeRadius      *= lengthScale;
+   _pi4Asolv         *= energyScale/(lengthScale*lengthScale);
+
+   if( _atomicRadii ){
+      for( int ii = 0; ii < getNumberOfAtoms(); ii++ )
+         _atomicRadii[ii] *= lengthScale;
+   }
+
+   _units = units;
+   _resetPreFactor();
+
+   return SimTKOpenMMCommon::DefaultReturn;
+}
+
 /**---------------------------------------------------------------------------------------
 
    Get probe radius (Simbios) 
@@ -503,16 +582,16 @@ int ImplicitSolventParameters::setAtomicRadii( const RealOpenMMVector& atomicRad
       numberOfAtoms = numberOfAtoms < (int) atomicRadii.size() ? numberOfAtoms : (int) atomicRadii.size();
    }
 
-   // force kcal/A units
+   // convert to the units of the parameters
 
-   if( units == SimTKOpenMMCommon::MdUnits ){
-      const RealOpenMM ten = (RealOpenMM) 10;
-      for( int ii = 0; ii < numberOfAtoms; ii++ )
-         _atomicRadii[ii] = ten*atomicRadii[ii];
-   } else {
-      for( int ii = 0; ii < numberOfAtoms; ii++ )
-         _atomicRadii[ii] = atomicRadii[ii];
+   RealOpenMM lengthScale = (RealOpenMM) 1.0;
+   if( units == SimTKOpenMMCommon::MdUnits && _units == SimTKOpenMMCommon::KcalAngUnits ){
+      lengthScale = (RealOpenMM) 10.0;
+   } else if( units == SimTKOpenMMCommon::KcalAngUnits && _units == SimTKOpenMMCommon::MdUnits ){
+      lengthScale = (RealOpenMM) 0.1;
    }
+   for( int ii = 0; ii < numberOfAtoms; ii++ )
+      _atomicRadii[ii] = lengthScale*atomicRadii[ii];
 
    return SimTKOpenMMCommon::DefaultReturn;
 }
@@ -542,16 +621,16 @@ int ImplicitSolventParameters::setAtomicRadii( const RealOpenMM* atomicRadii, in
    delete[] _atomicRadii;
    _atomicRadii = new RealOpenMM[numberOfAtoms];
    
-   // force kcal/A units
+   // convert to the units of the parameters
 
-   if( units == SimTKOpenMMCommon::MdUnits ){
-      const RealOpenMM ten = (RealOpenMM) 10;
-      for( int ii = 0; ii < numberOfAtoms; ii++ )
-         _atomicRadii[ii] = ten*atomicRadii[ii];
-   } else {
-      for( int ii = 0; ii < numberOfAtoms; ii++ )
-         _atomicRadii[ii] = atomicRadii[ii];
+   RealOpenMM lengthScale = (RealOpenMM) 1.0;
+   if( units == SimTKOpenMMCommon::MdUnits && _units == SimTKOpenMMCommon::KcalAngUnits ){
+      lengthScale = (RealOpenMM) 10.0;
+   } else if( units == SimTKOpenMMCommon::KcalAngUnits && _units == SimTKOpenMMCommon::MdUnits ){
+      lengthScale = (RealOpenMM) 0.1;
    }
+   for( int ii = 0; ii < numberOfAtoms; ii++ )
+      _atomicRadii[ii] = lengthScale*atomicRadii[ii];
 
    return SimTKOpenMMCommon::DefaultReturn;
 }
@@ -723,18 +802,22 @@ int ImplicitSolventParameters::isNotReady( void ) const {
       message << "\n   scaledRadiusFactors is not set";
    }
 
-   // check radii are in correct units
+   // check radii are in correct units; the limits are in Angstroms
 
    RealOpenMM average, stdDev, maxValue, minValue;
    int minIndex, maxIndex;
    SimTKOpenMMUtilities::getArrayStatistics( getNumberOfAtoms(), atomicRadii, &average,
                                              &stdDev, &minValue, &minIndex,
                                              &maxValue, &maxIndex );
+   if( getUnits() == SimTKOpenMMCommon::MdUnits ){
+      average  *= (RealOpenMM) 10.0;
+      minValue *= (RealOpenMM) 10.0;
+   }
 
    if( average < 0.6 || average > 10.0 || minValue < 0.5 ){
       errors++;
-      message << "\n   atomic radii appear not to be set correctly -- radii should be in Angstroms";
-      message << "\n   average radius=" << average << " min radius=" << minValue << " at atom index=" << minIndex;
+      message << "\n   atomic radii appear not to be set correctly -- check the units";
+      message << "\n   average radius (Angstrom)=" << average << " min radius=" << minValue << " at atom index=" << minIndex;
    }
 
 
@@ -46,6 +46,11 @@ class ImplicitSolventParameters {
       RealOpenMM _pi4Asolv;
 
       RealOpenMM _preFactor;
+
+      // units of the constants, radii, coordinates and forces:
+      // SimTKOpenMMCommon::KcalAngUnits (default) or SimTKOpenMMCommon::MdUnits
+
+      int _units;
    
       // ---------------------------------------------------------------------------------------
 
@@ -228,6 +233,32 @@ class ImplicitSolventParameters {
       
       int setElectricConstant( RealOpenMM electricConstant );
 
+      /**---------------------------------------------------------------------------------------
+      
+         Get units of the parameters, coordinates and forces
+      
+         @return SimTKOpenMMCommon::KcalAngUnits or SimTKOpenMMCommon::MdUnits
+      
+         --------------------------------------------------------------------------------------- */
+
+      int getUnits( void ) const;
+
+      /**---------------------------------------------------------------------------------------
+      
+         Set units of the parameters, coordinates and forces; the electric constant,
+         probe radius, surface area factor and atomic radii already set are rescaled
+         to the new units
+      
+         @param units       units flag: SimTKOpenMMCommon::KcalAngUnits or
+                                        SimTKOpenMMCommon::MdUnits 
+      
+         @return SimTKOpenMMCommon::DefaultReturn or SimTKOpenMMCommon::ErrorReturn
+                 if units is not recognized
+      
+         --------------------------------------------------------------------------------------- */
+
+      virtual int setUnits( int units );
+
       /**---------------------------------------------------------------------------------------
       
          Get probe radius (Simbios) 
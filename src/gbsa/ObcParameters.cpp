@@ -231,6 +231,35 @@ RealOpenMM ObcParameters::getDielectricOffset( void ) const {
    return _dielectricOffset;
 }
 
+/**---------------------------------------------------------------------------------------
+
+   Set units of the parameters, coordinates and forces; also rescales the
+   dielectric offset
+
+   @param units       units flag: SimTKOpenMMCommon::KcalAngUnits or
+                                  SimTKOpenMMCommon::MdUnits 
+
+   @return SimTKOpenMMCommon::DefaultReturn or SimTKOpenMMCommon::ErrorReturn
+
+   --------------------------------------------------------------------------------------- */
+
+int ObcParameters::setUnits( int units ){
+
+   // ---------------------------------------------------------------------------------------
+
+   // static const char* methodName = "\nObcParameters::setUnits:";
+
+   // ---------------------------------------------------------------------------------------
+
+   const int oldUnits = getUnits();
+   const int status   = ImplicitSolventParameters::setUnits( units );
+   if( status == SimTKOpenMMCommon::DefaultReturn && units != oldUnits ){
+      _dielectricOffset *= (units == SimTKOpenMMCommon::MdUnits) ? (RealOpenMM) 0.1 : (RealOpenMM) 10.0;
+   }
+
+   return status;
+}
+
 /**---------------------------------------------------------------------------------------
 
    Get alpha OBC (Eqs. 6 & 7) in Proteins paper
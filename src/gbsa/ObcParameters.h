@@ -158,6 +158,20 @@ class ObcParameters : public ImplicitSolventParameters {
       
       RealOpenMM getDielectricOffset( void ) const;
 
+      /**---------------------------------------------------------------------------------------
+      
+         Set units of the parameters, coordinates and forces; also rescales the
+         dielectric offset
+      
+         @param units       units flag: SimTKOpenMMCommon::KcalAngUnits or
+                                        SimTKOpenMMCommon::MdUnits 
+      
+         @return SimTKOpenMMCommon::DefaultReturn or SimTKOpenMMCommon::ErrorReturn
+      
+         --------------------------------------------------------------------------------------- */
+      
+      int setUnits( int units );
+
       /**---------------------------------------------------------------------------------------
       
          Return OBC scale factors
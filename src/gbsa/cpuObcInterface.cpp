@@ -161,10 +161,33 @@ cpuCalculateImplicitSolventForces( const RealOpenMM** atomCoordinates,
 
    // ---------------------------------------------------------------------------------------
 
-   int status = CpuImplicitSolvent::getCpuImplicitSolvent()->computeImplicitSolventForces( atomCoordinates, partialCharges,
-                                                                  forces, executor );
+   // CpuImplicitSolvent works on structure-of-arrays buffers; copy the
+   // coordinates in and the forces back out
 
-   *energy = CpuImplicitSolvent::getCpuImplicitSolvent()->getEnergy(); 
+   CpuImplicitSolvent* cpuImplicitSolvent = CpuImplicitSolvent::getCpuImplicitSolvent();
+   const int numberOfAtoms                = cpuImplicitSolvent->getNumberOfAtoms();
+
+   RealOpenMMVector coordinateX( numberOfAtoms ), coordinateY( numberOfAtoms ), coordinateZ( numberOfAtoms );
+   RealOpenMMVector forceX( numberOfAtoms ), forceY( numberOfAtoms ), forceZ( numberOfAtoms );
+   for( int atomI = 0; atomI < numberOfAtoms; atomI++ ){
+      coordinateX[atomI] = atomCoordinates[atomI][0];
+      coordinateY[atomI] = atomCoordinates[atomI][1];
+      coordinateZ[atomI] = atomCoordinates[atomI][2];
+   }
+
+   const ImplicitSolventCoordinates coordinates = { &coordinateX[0], &coordinateY[0], &coordinateZ[0] };
+   const ImplicitSolventForces      soaForces   = { &forceX[0], &forceY[0], &forceZ[0] };
+
+   int status = cpuImplicitSolvent->computeImplicitSolventForces( coordinates, partialCharges,
+                                                                  &soaForces, executor );
+
+   for( int atomI = 0; atomI < numberOfAtoms; atomI++ ){
+      forces[atomI][0] = forceX[atomI];
+      forces[atomI][1] = forceY[atomI];
+      forces[atomI][2] = forceZ[atomI];
+   }
+
+   *energy = cpuImplicitSolvent->getEnergy(); 
    // printf( "\ncpuCalculateImplicitSolventForcesE=%.5e", *energy );
 
    return status;
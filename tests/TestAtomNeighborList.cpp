@@ -0,0 +1,207 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKmolmodel.h"
+#include "molmodel/internal/AtomSubsystem.h"
+
+#include "SimTKcommon/Testing.h"
+
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <vector>
+
+using namespace SimTK;
+
+typedef std::set< std::pair<int,int> > PairSet;
+
+static PairSet getPairs(const AtomSubsystem& atoms, const State& state, 
+                        Real cutoff, AtomSubsystem::NeighborAlgorithm algorithm) 
+{
+    PairSet pairs;
+    for (AtomSubsystem::PairIterator pair = 
+            atoms.pairBegin(state, cutoff, algorithm);
+         pair != atoms.pairEnd(); ++pair)
+        pairs.insert(std::make_pair(std::min<int>(pair->first, pair->second),
+                                    std::max<int>(pair->first, pair->second)));
+    return pairs;
+}
+
+// A gas of single-atom bodies. The voxel hash pairs come from the neighbor
+// list kept in the State: it must be built once for repeated evaluations,
+// survive small motions, be rebuilt after large ones, and always give the
+// same pairs as the n-squared search.
+void testNeighborListIsReused() {
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter(system);
+    AtomSubsystem           atoms(system);
+    atoms.setNeighborListSkin(0.2);
+    SimTK_TEST(atoms.getNeighborListSkin() == 0.2);
+
+    Random::Uniform random(-1.5, 1.5);
+    random.setSeed(5);
+
+    const int numBodies = 200;
+    for (int b = 0; b < numBodies; ++b) {
+        MobilizedBody::Cartesian body(matter.updGround(),
+            Body::Rigid(MassProperties(40.0, Vec3(0), Inertia(1))));
+        body.setDefaultQ(Vec3(random.getValue(), random.getValue(), random.getValue()));
+
+        AtomSubsystem::AtomIndex atomIx = atoms.addAtom(40.0);
+        atoms.updAtom(atomIx).setStationInBodyFrame(Vec3(0));
+        atoms.setAtomMobilizedBodyIndex(atomIx, body.getMobilizedBodyIndex());
+    }
+
+    system.realizeTopology();
+    State state = system.getDefaultState();
+    system.realize(state, Stage::Position);
+
+    const Real cutoff = 0.5;
+    const PairSet expected = getPairs(atoms, state, cutoff, AtomSubsystem::N_SQUARED);
+    SimTK_TEST(!expected.empty());
+    SimTK_TEST(atoms.getNeighborListBuildCount() == 0);
+
+    // Force and energy evaluations on the same step share the list.
+    SimTK_TEST(getPairs(atoms, state, cutoff, AtomSubsystem::VOXEL_HASH) == expected);
+    SimTK_TEST(getPairs(atoms, state, cutoff, AtomSubsystem::VOXEL_HASH) == expected);
+    SimTK_TEST(atoms.getNeighborListBuildCount() == 1);
+
+    // Every atom moves less than half the skin.
+    Random::Uniform jiggle(-0.05, 0.05);
+    jiggle.setSeed(9);
+    for (int i = 0; i < state.getNQ(); ++i)
+        state.updQ()[i] += jiggle.getValue();
+    system.realize(state, Stage::Position);
+    SimTK_TEST(getPairs(atoms, state, cutoff, AtomSubsystem::VOXEL_HASH) 
+               == getPairs(atoms, state, cutoff, AtomSubsystem::N_SQUARED));
+    SimTK_TEST(atoms.getNeighborListBuildCount() == 1);
+
+    // One atom moves more than half the skin.
+    state.updQ()[0] += 0.3;
+    system.realize(state, Stage::Position);
+    SimTK_TEST(getPairs(atoms, state, cutoff, AtomSubsystem::VOXEL_HASH) 
+               == getPairs(atoms, state, cutoff, AtomSubsystem::N_SQUARED));
+    SimTK_TEST(atoms.getNeighborListBuildCount() == 2);
+
+    // A different cutoff needs a different list.
+    SimTK_TEST(getPairs(atoms, state, 0.7, AtomSubsystem::VOXEL_HASH) 
+               == getPairs(atoms, state, 0.7, AtomSubsystem::N_SQUARED));
+    SimTK_TEST(atoms.getNeighborListBuildCount() == 3);
+
+    // ... but it is kept alongside the first one, so forces with different
+    // cutoffs can take turns without rebuilding either list.
+    for (int i = 0; i < 3; ++i) {
+        SimTK_TEST(getPairs(atoms, state, cutoff, AtomSubsystem::VOXEL_HASH) 
+                   == getPairs(atoms, state, cutoff, AtomSubsystem::N_SQUARED));
+        SimTK_TEST(getPairs(atoms, state, 0.7, AtomSubsystem::VOXEL_HASH) 
+                   == getPairs(atoms, state, 0.7, AtomSubsystem::N_SQUARED));
+    }
+    SimTK_TEST(atoms.getNeighborListBuildCount() == 3);
+
+    // An iterator keeps working while one for another cutoff is created
+    // part way through, even if that builds a new list.
+    PairSet interleaved;
+    AtomSubsystem::PairIterator pair = 
+        atoms.pairBegin(state, cutoff, AtomSubsystem::VOXEL_HASH);
+    SimTK_TEST(pair != atoms.pairEnd());
+    interleaved.insert(std::make_pair(std::min<int>(pair->first, pair->second),
+                                      std::max<int>(pair->first, pair->second)));
+    ++pair;
+    SimTK_TEST(getPairs(atoms, state, 0.9, AtomSubsystem::VOXEL_HASH) 
+               == getPairs(atoms, state, 0.9, AtomSubsystem::N_SQUARED));
+    SimTK_TEST(atoms.getNeighborListBuildCount() == 4);
+    for (; pair != atoms.pairEnd(); ++pair)
+        interleaved.insert(std::make_pair(std::min<int>(pair->first, pair->second),
+                                          std::max<int>(pair->first, pair->second)));
+    SimTK_TEST(interleaved == getPairs(atoms, state, cutoff, AtomSubsystem::N_SQUARED));
+}
+
+// AUTOTUNE must give the same pairs as the other algorithms while it times
+// them, and settle on one of them after three complete passes each.
+void testAutotunePicksAnAlgorithm() {
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter(system);
+    AtomSubsystem           atoms(system);
+
+    Random::Uniform random(-1.5, 1.5);
+    random.setSeed(17);
+
+    for (int b = 0; b < 100; ++b) {
+        MobilizedBody::Cartesian body(matter.updGround(),
+            Body::Rigid(MassProperties(40.0, Vec3(0), Inertia(1))));
+        body.setDefaultQ(Vec3(random.getValue(), random.getValue(), random.getValue()));
+
+        AtomSubsystem::AtomIndex atomIx = atoms.addAtom(40.0);
+        atoms.updAtom(atomIx).setStationInBodyFrame(Vec3(0));
+        atoms.setAtomMobilizedBodyIndex(atomIx, body.getMobilizedBodyIndex());
+    }
+
+    system.realizeTopology();
+    State state = system.getDefaultState();
+    system.realize(state, Stage::Position);
+
+    const Real cutoff = 0.6;
+    const PairSet expected = getPairs(atoms, state, cutoff, AtomSubsystem::N_SQUARED);
+    SimTK_TEST(atoms.getAutotunedNeighborAlgorithm(cutoff) == AtomSubsystem::AUTOTUNE);
+    SimTK_TEST(atoms.getAutotunedNeighborAlgorithm(0) == AtomSubsystem::N_SQUARED);
+
+    for (int pass = 0; pass < 6; ++pass) {
+        SimTK_TEST(atoms.getAutotunedNeighborAlgorithm(cutoff) == AtomSubsystem::AUTOTUNE);
+        SimTK_TEST(getPairs(atoms, state, cutoff, AtomSubsystem::AUTOTUNE) == expected);
+    }
+
+    const AtomSubsystem::NeighborAlgorithm winner = 
+        atoms.getAutotunedNeighborAlgorithm(cutoff);
+    SimTK_TEST(winner == AtomSubsystem::N_SQUARED || winner == AtomSubsystem::VOXEL_HASH);
+    SimTK_TEST(getPairs(atoms, state, cutoff, AtomSubsystem::AUTOTUNE) == expected);
+    SimTK_TEST(atoms.getAutotunedNeighborAlgorithm(cutoff) == winner);
+
+    std::ostringstream timings;
+    atoms.dumpNeighborAlgorithmTimings(timings);
+    std::cout << timings.str();
+    SimTK_TEST(timings.str().find("N_SQUARED 3 passes") != std::string::npos);
+    SimTK_TEST(timings.str().find("VOXEL_HASH 3 passes") != std::string::npos);
+    // The one list build is reported on its own, and is charged to the 
+    // VOXEL_HASH passes.
+    SimTK_TEST(timings.str().find("neighbor list built 1 times") != std::string::npos);
+    SimTK_TEST(timings.str().find("(1 builds)") != std::string::npos);
+    SimTK_TEST(timings.str().find("(0 builds)") != std::string::npos);
+    SimTK_TEST(timings.str().find("using N_SQUARED") != std::string::npos
+               || timings.str().find("using VOXEL_HASH") != std::string::npos);
+}
+
+int main() {
+    SimTK_START_TEST("TestAtomNeighborList");
+        SimTK_SUBTEST(testNeighborListIsReused);
+        SimTK_SUBTEST(testAutotunePicksAnAlgorithm);
+    SimTK_END_TEST();
+}
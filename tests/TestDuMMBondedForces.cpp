@@ -0,0 +1,94 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+// Tests for DuMM's serial and multithreaded bonded force calculations.
+
+#include "SimTKmolmodel.h"
+#include "SimTKsimbody.h"
+
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// Calculate the bonded forces and energy of a peptide long enough that its
+// bonded terms are divided into several batches for parallel evaluation.
+static Real calcPeptideBondedForces(int numThreads, Vector_<SpatialVec>& forces)
+{
+    CompoundSystem system;
+    SimbodyMatterSubsystem matter(system);
+    DuMMForceFieldSubsystem dumm(system);
+    dumm.loadAmber99Parameters();
+
+    dumm.setVdwGlobalScaleFactor(0);
+    dumm.setCoulombGlobalScaleFactor(0);
+    dumm.setGbsaGlobalScaleFactor(0);
+
+    dumm.setUseMultithreadedComputation(numThreads > 0);
+    dumm.setNumThreadsRequested(numThreads);
+
+    Protein peptide("SIVKGAFLWDERTYCASIVKGAFLWDERTYCASIVKGAFLW");
+    system.adoptCompound(peptide);
+    system.modelCompounds();
+
+    State state = system.realizeTopology();
+    system.realize(state, Stage::Dynamics);
+    forces = system.getRigidBodyForces(state, Stage::Dynamics);
+    return system.calcPotentialEnergy(state);
+}
+
+// The multithreaded calculation must give bitwise identical results for
+// any number of threads, and agree with the serial calculation to roundoff.
+void testMultithreadedIsDeterministic() {
+    Vector_<SpatialVec> fSerial, fRef, f;
+    const Real eSerial = calcPeptideBondedForces(0, fSerial);
+    const Real eRef    = calcPeptideBondedForces(1, fRef);
+    SimTK_TEST_EQ(eRef, eSerial);
+    SimTK_TEST(fRef.size() == fSerial.size());
+    for (int i=0; i < fRef.size(); ++i)
+        SimTK_TEST_EQ_TOL(fRef[i], fSerial[i], 1e-10);
+
+    for (int numThreads=2; numThreads <= 5; ++numThreads) {
+        const Real e = calcPeptideBondedForces(numThreads, f);
+        SimTK_TEST(e == eRef);
+        SimTK_TEST(f.size() == fRef.size());
+        for (int i=0; i < f.size(); ++i)
+            SimTK_TEST(f[i] == fRef[i]);
+    }
+}
+
+int main() {
+    SimTK_START_TEST("TestDuMMBondedForces");
+        SimTK_SUBTEST(testMultithreadedIsDeterministic);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,94 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+// Tests for DuMM's energy-only calculation, which is used when someone asks
+// for the potential energy before forces have been calculated.
+
+#include "SimTKmolmodel.h"
+#include "SimTKsimbody.h"
+
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// Compare the energy calculated without forces (at Position stage) with the
+// energy calculated along with forces (at Dynamics stage) for a small 
+// peptide with all terms turned on, including GBSA.
+static void checkEnergyOnly(bool useCutoff, int numThreads) {
+    CompoundSystem system;
+    SimbodyMatterSubsystem matter(system);
+    DuMMForceFieldSubsystem dumm(system);
+    dumm.loadAmber99Parameters();
+
+    dumm.setUseNonbondedCutoff(useCutoff);
+    dumm.setNonbondedCutoff(Real(0.8));
+    dumm.setUseMultithreadedComputation(numThreads > 0);
+    dumm.setNumThreadsRequested(numThreads);
+
+    Protein peptide("SIVKGAFLWDERTYCA");
+    system.adoptCompound(peptide);
+    system.modelCompounds();
+
+    State state = system.realizeTopology();
+    system.realize(state, Stage::Position);
+
+    const long long before = dumm.getForceEvaluationCount();
+    const Real energyOnly = dumm.calcPotentialEnergy(state);
+    SimTK_TEST(dumm.getForceEvaluationCount() == before+1);
+
+    // Asking again shouldn't recalculate anything.
+    SimTK_TEST(dumm.calcPotentialEnergy(state) == energyOnly);
+    SimTK_TEST(dumm.getForceEvaluationCount() == before+1);
+
+    system.realize(state, Stage::Dynamics);
+    SimTK_TEST(dumm.getForceEvaluationCount() == before+2);
+    SimTK_TEST_EQ(dumm.calcPotentialEnergy(state), energyOnly);
+}
+
+void testEnergyOnly() {
+    checkEnergyOnly(false, 0);
+    checkEnergyOnly(false, 3);
+}
+
+void testEnergyOnlyCutoff() {
+    checkEnergyOnly(true, 0);
+    checkEnergyOnly(true, 3);
+}
+
+int main() {
+    SimTK_START_TEST("TestDuMMEnergyOnly");
+        SimTK_SUBTEST(testEnergyOnly);
+        SimTK_SUBTEST(testEnergyOnlyCutoff);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,95 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+
+// Tests for DuMM's optional fused calculation of the all-pairs Coulomb, van
+// der Waals and generalized Born pair terms.
+
+#include "SimTKmolmodel.h"
+#include "SimTKsimbody.h"
+
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// Calculate the nonbonded and GBSA forces and energy of a small peptide,
+// either in one fused pass or in the usual separate passes.
+static Real calcPeptideForces(bool useFused, int numThreads, 
+                              Vector_<SpatialVec>& forces)
+{
+    CompoundSystem system;
+    SimbodyMatterSubsystem matter(system);
+    DuMMForceFieldSubsystem dumm(system);
+    dumm.loadAmber99Parameters();
+
+    dumm.setAllGlobalScaleFactors(0);
+    dumm.setCoulombGlobalScaleFactor(1);
+    dumm.setVdwGlobalScaleFactor(1);
+    dumm.setGbsaGlobalScaleFactor(Real(0.8));
+
+    dumm.setUseFusedGbsaNonbonded(useFused);
+    dumm.setUseMultithreadedComputation(numThreads > 0);
+    dumm.setNumThreadsRequested(numThreads);
+
+    Protein peptide("SIVKGAFLWDERTYCA");
+    system.adoptCompound(peptide);
+    system.modelCompounds();
+
+    State state = system.realizeTopology();
+    system.realize(state, Stage::Dynamics);
+    forces = system.getRigidBodyForces(state, Stage::Dynamics);
+    return system.calcPotentialEnergy(state);
+}
+
+// The fused pass is off by default, and must give the separate passes' 
+// result up to roundoff, both serially and multithreaded.
+void testFusedMatchesSeparate() {
+    CompoundSystem system;
+    DuMMForceFieldSubsystem dumm(system);
+    SimTK_TEST(!dumm.getUseFusedGbsaNonbonded());
+
+    Vector_<SpatialVec> fSeparate, f;
+    const Real eSeparate = calcPeptideForces(false, 0, fSeparate);
+    for (int nt=0; nt <= 3; ++nt) {
+        SimTK_TEST_EQ_TOL(calcPeptideForces(true, nt, f), eSeparate, 1e-10);
+        for (int i=0; i < fSeparate.size(); ++i)
+            SimTK_TEST_EQ_TOL(f[i], fSeparate[i], 1e-10);
+    }
+}
+
+int main() {
+    SimTK_START_TEST("TestDuMMFusedGbsaNonbonded");
+        SimTK_SUBTEST(testFusedMatchesSeparate);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,111 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+
+// Tests for DuMM's per-atom breakdown of the GBSA energy and for collecting
+// it by compound and residue.
+
+#include "SimTKmolmodel.h"
+#include "SimTKsimbody.h"
+
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// Build a small peptide with only GBSA turned on and check that its per-atom, 
+// per-residue and compound energies all add up to the GBSA energy.
+static void checkPeptideGbsaAtomEnergies(bool useCutoff, int numThreads)
+{
+    CompoundSystem system;
+    SimbodyMatterSubsystem matter(system);
+    DuMMForceFieldSubsystem dumm(system);
+    dumm.loadAmber99Parameters();
+
+    dumm.setAllGlobalScaleFactors(0);
+    dumm.setGbsaGlobalScaleFactor(Real(0.8));
+    dumm.setGbsaIncludeAceApproximation(true);
+    dumm.setUseGbsaCutoff(useCutoff);
+    dumm.setGbsaCutoff(1);
+
+    dumm.setUseMultithreadedComputation(numThreads > 0);
+    dumm.setNumThreadsRequested(numThreads);
+
+    Protein peptide("SIVKGAFLWDERTYCA");
+    system.adoptCompound(peptide);
+    system.modelCompounds();
+
+    State state = system.realizeTopology();
+    system.realize(state, Stage::Position);
+
+    Vector gb, ace;
+    dumm.calcGbsaAtomEnergies(state, gb, ace);
+    SimTK_TEST(gb.size() == dumm.getNumAtoms());
+    SimTK_TEST(ace.size() == dumm.getNumAtoms());
+
+    // Energies are negative for the polar part, positive for the nonpolar.
+    SimTK_TEST(gb.sum() < 0);
+    SimTK_TEST(ace.sum() > 0);
+
+    const Real energy = dumm.calcPotentialEnergy(state);
+    SimTK_TEST_EQ_TOL(gb.sum() + ace.sum(), energy, 1e-10);
+
+    const Compound& compound = system.getCompound(CompoundSystem::CompoundIndex(0));
+    SimTK_TEST_EQ_TOL(compound.sumDuMMAtomValues(gb), gb.sum(), 1e-10);
+
+    const Vector residueGb  = peptide.sumDuMMAtomValuesByResidue(gb);
+    const Vector residueAce = peptide.sumDuMMAtomValuesByResidue(ace);
+    SimTK_TEST(residueGb.size() == peptide.getNumResidues());
+    SimTK_TEST_EQ_TOL(residueGb.sum() + residueAce.sum(), energy, 1e-10);
+
+    // The ordinary energy calculation isn't affected.
+    system.realize(state, Stage::Dynamics);
+    SimTK_TEST_EQ_TOL(system.calcPotentialEnergy(state), energy, 1e-10);
+}
+
+void testAllPairsAtomEnergies() {
+    checkPeptideGbsaAtomEnergies(false, 0);
+    checkPeptideGbsaAtomEnergies(false, 2);
+}
+
+void testCutoffAtomEnergies() {
+    checkPeptideGbsaAtomEnergies(true, 0);
+    checkPeptideGbsaAtomEnergies(true, 2);
+}
+
+int main() {
+    SimTK_START_TEST("TestDuMMGbsaAtomEnergies");
+        SimTK_SUBTEST(testAllPairsAtomEnergies);
+        SimTK_SUBTEST(testCutoffAtomEnergies);
+    SimTK_END_TEST();
+}
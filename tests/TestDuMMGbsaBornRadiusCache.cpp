@@ -0,0 +1,145 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+
+// Tests for DuMM's reuse of GBSA Born radii between evaluations.
+
+#include "SimTKmolmodel.h"
+#include "SimTKsimbody.h"
+
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace SimTK;
+using namespace std;
+
+// Build a small peptide with only GBSA turned on, with or without the Born
+// radius cache.
+static void buildPeptideGbsa(CompoundSystem& system, DuMMForceFieldSubsystem& dumm,
+                             bool useCache, int numThreads)
+{
+    dumm.loadAmber99Parameters();
+
+    dumm.setAllGlobalScaleFactors(0);
+    dumm.setGbsaGlobalScaleFactor(1);
+    dumm.setGbsaIncludeAceApproximation(true);
+    dumm.setUseGbsaBornRadiusCache(useCache);
+    SimTK_TEST(dumm.getUseGbsaBornRadiusCache() == useCache);
+
+    dumm.setUseMultithreadedComputation(numThreads > 0);
+    dumm.setNumThreadsRequested(numThreads);
+
+    Protein peptide("SIVKGAFLWDERTYCA");
+    system.adoptCompound(peptide);
+    system.modelCompounds();
+}
+
+// Move the two copies of the peptide the same way, a few atoms at a time and
+// then all at once, and check that the energies and body forces agree. The
+// cached copy must recompute the Born radii of just the atoms that moved,
+// unless so many moved that it starts over.
+static void checkPeptideBornRadiusCache(int numThreads)
+{
+    CompoundSystem system, cachedSystem;
+    SimbodyMatterSubsystem matter(system), cachedMatter(cachedSystem);
+    DuMMForceFieldSubsystem dumm(system), cachedDumm(cachedSystem);
+    buildPeptideGbsa(system, dumm, false, numThreads);
+    buildPeptideGbsa(cachedSystem, cachedDumm, true, numThreads);
+
+    State state = system.realizeTopology();
+    State cachedState = cachedSystem.realizeTopology();
+    SimTK_TEST(state.getNQ() == cachedState.getNQ());
+    const int nq = state.getNQ();
+
+    const Compound& peptide = 
+        cachedSystem.getCompound(CompoundSystem::CompoundIndex(0));
+    const int numAtoms = peptide.getNumAtoms();
+    SimTK_TEST(cachedDumm.getNumAtoms() == numAtoms);
+    std::vector<Vec3> previousLocations(numAtoms);
+
+    // The last q moves only the atoms of one small body; the first moves
+    // the whole peptide. Change each a few times, then both together.
+    const int moves[] = {nq-1, nq-1, nq/2, nq-1, 0, nq-1, nq-1};
+    for (int i=-1; i < (int)(sizeof(moves)/sizeof(moves[0])); ++i) {
+        if (i >= 0) {
+            state.updQ()[moves[i]] += 0.1;
+            cachedState.updQ()[moves[i]] += 0.1;
+        }
+        system.realize(state, Stage::Dynamics);
+        cachedSystem.realize(cachedState, Stage::Dynamics);
+
+        int numMoved = 0;
+        for (Compound::AtomIndex a(0); a < numAtoms; ++a) {
+            const Vec3 location = 
+                peptide.calcAtomLocationInGroundFrame(cachedState, a);
+            if (i < 0 || location != previousLocations[a]) ++numMoved;
+            previousLocations[a] = location;
+        }
+        const int numRecomputed = cachedDumm.getNumGbsaBornRadiiRecomputed();
+        if (i >= 0 && moves[i] == nq-1) {
+            SimTK_TEST(0 < numMoved && 4*numMoved <= numAtoms);
+            SimTK_TEST(numRecomputed == numMoved);
+        } else if (i < 0 || moves[i] == 0) {
+            SimTK_TEST(numMoved == numAtoms);
+            SimTK_TEST(numRecomputed == numAtoms);
+        }
+        SimTK_TEST(dumm.getNumGbsaBornRadiiRecomputed() == numAtoms);
+
+        const Real energy = system.calcPotentialEnergy(state);
+        SimTK_TEST(energy != 0);
+        SimTK_TEST_EQ_TOL(cachedSystem.calcPotentialEnergy(cachedState),
+                          energy, 1e-10);
+
+        const Vector_<SpatialVec>& forces = 
+            system.getRigidBodyForces(state, Stage::Dynamics);
+        const Vector_<SpatialVec>& cachedForces = 
+            cachedSystem.getRigidBodyForces(cachedState, Stage::Dynamics);
+        for (int b=0; b < forces.size(); ++b)
+            SimTK_TEST_EQ_TOL(cachedForces[b], forces[b], 1e-10);
+    }
+}
+
+void testSerialBornRadiusCache() {
+    checkPeptideBornRadiusCache(0);
+}
+
+void testMultithreadedBornRadiusCache() {
+    checkPeptideBornRadiusCache(2);
+}
+
+int main() {
+    SimTK_START_TEST("TestDuMMGbsaBornRadiusCache");
+        SimTK_SUBTEST(testSerialBornRadiusCache);
+        SimTK_SUBTEST(testMultithreadedBornRadiusCache);
+    SimTK_END_TEST();
+}
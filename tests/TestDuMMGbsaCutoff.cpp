@@ -0,0 +1,113 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+
+// Tests for DuMM's optional GBSA cutoff, which restricts the Born radius
+// sums and the generalized Born pair energy to nearby atoms.
+
+#include "SimTKmolmodel.h"
+#include "SimTKsimbody.h"
+
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// Calculate the GBSA forces and energy of a small peptide.
+static Real calcPeptideGbsaForces(bool useCutoff, Real cutoff, int numThreads,
+                                  Vector_<SpatialVec>& forces)
+{
+    CompoundSystem system;
+    SimbodyMatterSubsystem matter(system);
+    DuMMForceFieldSubsystem dumm(system);
+    dumm.loadAmber99Parameters();
+
+    dumm.setAllGlobalScaleFactors(0);
+    dumm.setGbsaGlobalScaleFactor(1);
+
+    dumm.setUseGbsaCutoff(useCutoff);
+    dumm.setGbsaCutoff(cutoff);
+    dumm.setUseMultithreadedComputation(numThreads > 0);
+    dumm.setNumThreadsRequested(numThreads);
+
+    Protein peptide("SIVKGAFLWDERTYCA");
+    system.adoptCompound(peptide);
+    system.modelCompounds();
+
+    State state = system.realizeTopology();
+    system.realize(state, Stage::Dynamics);
+    forces = system.getRigidBodyForces(state, Stage::Dynamics);
+    return system.calcPotentialEnergy(state);
+}
+
+// With a cutoff larger than the molecule every pair is included, so we must
+// get the all-pairs result up to roundoff from the different summation order.
+void testHugeCutoffMatchesAllPairs() {
+    Vector_<SpatialVec> fAll, f;
+    const Real eAll = calcPeptideGbsaForces(false, 2, 0, fAll);
+    SimTK_TEST_EQ_TOL(calcPeptideGbsaForces(true, 100, 0, f), eAll, 1e-8);
+    for (int i=0; i < fAll.size(); ++i)
+        SimTK_TEST_EQ_TOL(f[i], fAll[i], 1e-8);
+    SimTK_TEST_EQ_TOL(calcPeptideGbsaForces(true, 100, 3, f), eAll, 1e-8);
+    for (int i=0; i < fAll.size(); ++i)
+        SimTK_TEST_EQ_TOL(f[i], fAll[i], 1e-8);
+}
+
+// The cutoff is off by default, and a short one must actually drop pairs.
+// Each atom gathers its own terms and the energies are summed in atom order,
+// so the cutoff calculation is identical for any number of threads and for
+// the serial code.
+void testShortCutoff() {
+    CompoundSystem system;
+    DuMMForceFieldSubsystem dumm(system);
+    SimTK_TEST(!dumm.getUseGbsaCutoff());
+    SimTK_TEST_EQ(dumm.getGbsaCutoff(), 2.0);
+    SimTK_TEST_MUST_THROW(dumm.setGbsaCutoff(0));
+
+    Vector_<SpatialVec> fSerial, f;
+    const Real eAll = calcPeptideGbsaForces(false, 2, 0, f);
+    const Real eSerial = calcPeptideGbsaForces(true, Real(0.8), 0, fSerial);
+    SimTK_TEST_NOTEQ(eSerial, eAll);
+    for (int nt=1; nt <= 4; ++nt) {
+        SimTK_TEST(calcPeptideGbsaForces(true, Real(0.8), nt, f) == eSerial);
+        for (int i=0; i < fSerial.size(); ++i)
+            SimTK_TEST(f[i] == fSerial[i]);
+    }
+}
+
+int main() {
+    SimTK_START_TEST("TestDuMMGbsaCutoff");
+        SimTK_SUBTEST(testHugeCutoffMatchesAllPairs);
+        SimTK_SUBTEST(testShortCutoff);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,101 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+
+// Tests for DuMM's optional mixed precision GBSA, which evaluates the
+// all-pairs Born radius and generalized Born pair terms in single precision.
+
+#include "SimTKmolmodel.h"
+#include "SimTKsimbody.h"
+
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// Calculate the GBSA forces and energy of a small peptide, with the pair
+// terms in single or double precision.
+static Real calcPeptideGbsaForces(bool useMixedPrecision, int numThreads,
+                                  Vector_<SpatialVec>& forces)
+{
+    CompoundSystem system;
+    SimbodyMatterSubsystem matter(system);
+    DuMMForceFieldSubsystem dumm(system);
+    dumm.loadAmber99Parameters();
+
+    dumm.setAllGlobalScaleFactors(0);
+    dumm.setGbsaGlobalScaleFactor(1);
+
+    dumm.setUseGbsaMixedPrecision(useMixedPrecision);
+    dumm.setUseMultithreadedComputation(numThreads > 0);
+    dumm.setNumThreadsRequested(numThreads);
+
+    Protein peptide("SIVKGAFLWDERTYCA");
+    system.adoptCompound(peptide);
+    system.modelCompounds();
+
+    State state = system.realizeTopology();
+    system.realize(state, Stage::Dynamics);
+    forces = system.getRigidBodyForces(state, Stage::Dynamics);
+    return system.calcPotentialEnergy(state);
+}
+
+// Mixed precision is off by default. Single precision pair terms summed in
+// double should reproduce the full precision energy to about 1e-5 relative
+// error; forces are looser. Each atom gathers its own row and the energies
+// are summed in atom order, so the result is identical for any number of
+// threads.
+void testMatchesDoublePrecision() {
+    CompoundSystem system;
+    DuMMForceFieldSubsystem dumm(system);
+    SimTK_TEST(!dumm.getUseGbsaMixedPrecision());
+
+    Vector_<SpatialVec> fDouble, fMixed, f;
+    const Real eDouble = calcPeptideGbsaForces(false, 0, fDouble);
+    const Real eMixed  = calcPeptideGbsaForces(true, 0, fMixed);
+    SimTK_TEST_EQ_TOL(eMixed, eDouble, 1e-5);
+    for (int i=0; i < fDouble.size(); ++i)
+        SimTK_TEST_EQ_TOL(fMixed[i], fDouble[i], 1e-3);
+
+    for (int nt=1; nt <= 4; ++nt) {
+        SimTK_TEST(calcPeptideGbsaForces(true, nt, f) == eMixed);
+        for (int i=0; i < fMixed.size(); ++i)
+            SimTK_TEST(f[i] == fMixed[i]);
+    }
+}
+
+int main() {
+    SimTK_START_TEST("TestDuMMGbsaMixedPrecision");
+        SimTK_SUBTEST(testMatchesDoublePrecision);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,115 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+
+// Checks that DuMM's multithreaded GBSA calculation gives the serial result
+// for any number of threads, and reports how well GBSA alone scales. The
+// timings are only printed; they depend too much on the machine to test.
+
+#include "SimTKmolmodel.h"
+#include "SimTKsimbody.h"
+
+#include "SimTKcommon/Testing.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+static const int NumEvaluations = 10;
+
+// Calculate the GBSA forces and energy of a 48-residue peptide, and the 
+// average real time per force evaluation.
+static Real calcPeptideGbsaForces(int numThreads, Vector_<SpatialVec>& forces,
+                                  Real& secondsPerEvaluation)
+{
+    CompoundSystem system;
+    SimbodyMatterSubsystem matter(system);
+    DuMMForceFieldSubsystem dumm(system);
+    dumm.loadAmber99Parameters();
+
+    dumm.setAllGlobalScaleFactors(0);
+    dumm.setGbsaGlobalScaleFactor(1);
+    dumm.setGbsaIncludeAceApproximation(true);
+
+    dumm.setUseMultithreadedComputation(numThreads > 0);
+    dumm.setNumThreadsRequested(numThreads);
+
+    Protein peptide("SIVKGAFLWDERTYCASIVKGAFLWDERTYCASIVKGAFLWDERTYCA");
+    system.adoptCompound(peptide);
+    system.modelCompounds();
+
+    State state = system.realizeTopology();
+    system.realize(state, Stage::Dynamics);
+    forces = system.getRigidBodyForces(state, Stage::Dynamics);
+    const Real energy = system.calcPotentialEnergy(state);
+
+    const Real start = realTime();
+    for (int i=0; i < NumEvaluations; ++i) {
+        state.invalidateAll(Stage::Position);
+        system.realize(state, Stage::Dynamics);
+    }
+    secondsPerEvaluation = (realTime() - start) / NumEvaluations;
+    return energy;
+}
+
+// Every thread count, including the serial code, must give the same answer
+// up to roundoff; speedup and efficiency are relative to one thread.
+void testGbsaScaling() {
+    Vector_<SpatialVec> fSerial, f;
+    Real tSerial, tOneThread = 0, t;
+    const Real eSerial = calcPeptideGbsaForces(0, fSerial, tSerial);
+
+    printf("%8s %12s %10s %10s\n", 
+           "threads", "ms/eval", "speedup", "efficiency");
+    printf("%8s %12.3f\n", "serial", 1000*tSerial);
+
+    const int maxThreads = std::max(4, ParallelExecutor::getNumProcessors());
+    for (int nt=1; nt <= maxThreads; nt *= 2) {
+        const Real e = calcPeptideGbsaForces(nt, f, t);
+        SimTK_TEST_EQ_TOL(e, eSerial, 1e-10);
+        for (int i=0; i < fSerial.size(); ++i)
+            SimTK_TEST_EQ_TOL(f[i], fSerial[i], 1e-10);
+
+        if (nt == 1) tOneThread = t;
+        const Real speedup = tOneThread / t;
+        printf("%8d %12.3f %10.2f %9.0f%%\n", 
+               nt, 1000*t, speedup, 100*speedup/nt);
+    }
+}
+
+int main() {
+    SimTK_START_TEST("TestDuMMGbsaScaling");
+        SimTK_SUBTEST(testGbsaScaling);
+    SimTK_END_TEST();
+}
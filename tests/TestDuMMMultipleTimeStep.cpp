@@ -0,0 +1,181 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+// Tests for DuMM's multiple time stepping force groups.
+
+#include "SimTKmolmodel.h"
+#include "SimTKsimbody.h"
+
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+static const Real StepSize = Real(0.002); // ps
+
+// Build a small peptide and return the DuMM body forces and the potential
+// energy at the given step. If bondedOnly is set the nonbonded and GBSA
+// terms are turned off. The nonbonded and GBSA terms are put on the given
+// interval if multiple time stepping is on.
+static Real calcPeptideForces(bool bondedOnly, bool useMTS, int slowInterval,
+                              int step, Vector_<SpatialVec>& forces)
+{
+    CompoundSystem system;
+    SimbodyMatterSubsystem matter(system);
+    DuMMForceFieldSubsystem dumm(system);
+    dumm.loadAmber99Parameters();
+
+    if (bondedOnly) {
+        dumm.setVdwGlobalScaleFactor(0);
+        dumm.setCoulombGlobalScaleFactor(0);
+        dumm.setGbsaGlobalScaleFactor(0);
+    }
+
+    if (useMTS) {
+        dumm.setMultipleTimeStepSize(StepSize);
+        dumm.setForceGroupInterval
+           (DuMMForceFieldSubsystem::NonbondedNearForceGroup, slowInterval);
+        dumm.setForceGroupInterval
+           (DuMMForceFieldSubsystem::GBSAForceGroup, slowInterval);
+    }
+
+    Protein peptide("SIVKGAFLW");
+    system.adoptCompound(peptide);
+    system.modelCompounds();
+
+    State state = system.realizeTopology();
+    state.setTime(step * StepSize);
+    system.realize(state, Stage::Dynamics);
+    forces = system.getRigidBodyForces(state, Stage::Dynamics);
+    return system.calcPotentialEnergy(state);
+}
+
+static void testForcesEqual(const Vector_<SpatialVec>& f, 
+                            const Vector_<SpatialVec>& fRef)
+{
+    SimTK_TEST(f.size() == fRef.size());
+    for (int i=0; i < f.size(); ++i)
+        SimTK_TEST_EQ_TOL(f[i], fRef[i], 1e-8);
+}
+
+// With every interval 1 the forces must be the same as without multiple
+// time stepping, and so must the energy.
+void testIntervalOneMatchesSingleStep() {
+    Vector_<SpatialVec> fRef, f;
+    const Real eRef = calcPeptideForces(false, false, 1, 0, fRef);
+    const Real e    = calcPeptideForces(false, true,  1, 3, f);
+    SimTK_TEST_EQ(e, eRef);
+    testForcesEqual(f, fRef);
+}
+
+// With the nonbonded and GBSA terms on interval 2, at even steps they are
+// applied with weight 2 and at odd steps not at all. The potential energy
+// is always the full energy.
+void testSlowForcesAreImpulseWeighted() {
+    Vector_<SpatialVec> fAll, fBonded, f;
+    const Real eAll = calcPeptideForces(false, false, 1, 0, fAll);
+    calcPeptideForces(true, false, 1, 0, fBonded);
+
+    Real e = calcPeptideForces(false, true, 2, 4, f);
+    SimTK_TEST_EQ(e, eAll);
+    Vector_<SpatialVec> fExpected(fAll.size());
+    for (int i=0; i < fAll.size(); ++i)
+        fExpected[i] = fBonded[i] + 2*(fAll[i] - fBonded[i]);
+    testForcesEqual(f, fExpected);
+
+    e = calcPeptideForces(false, true, 2, 5, f);
+    SimTK_TEST_EQ(e, eAll);
+    testForcesEqual(f, fBonded);
+}
+
+// Slow forces belong to one configuration. If the positions change at the
+// same time they must be recalculated. Forces are wanted only at step times;
+// at any other time (as at an integrator's intermediate stage, or a step
+// shortened to reach a report time) realizing them is an error, but the
+// roundoff in a time reached by adding up a great many steps isn't.
+void testSlowForcesFollowPositions() {
+    CompoundSystem system;
+    SimbodyMatterSubsystem matter(system);
+    DuMMForceFieldSubsystem dumm(system);
+    dumm.loadAmber99Parameters();
+    dumm.setMultipleTimeStepSize(StepSize);
+    dumm.setForceGroupInterval
+       (DuMMForceFieldSubsystem::NonbondedNearForceGroup, 2);
+    dumm.setForceGroupInterval
+       (DuMMForceFieldSubsystem::GBSAForceGroup, 2);
+
+    Protein peptide("SIVKGAFLW");
+    system.adoptCompound(peptide);
+    system.modelCompounds();
+
+    State state = system.realizeTopology();
+    state.setTime(4 * StepSize);
+    State moved = state;
+
+    system.realize(state, Stage::Dynamics);
+    for (int i=0; i < state.getNQ(); ++i)
+        state.updQ()[i] += 0.01;
+    system.realize(state, Stage::Dynamics);
+    const Vector_<SpatialVec> f = 
+        system.getRigidBodyForces(state, Stage::Dynamics);
+
+    for (int i=0; i < moved.getNQ(); ++i)
+        moved.updQ()[i] += 0.01;
+    system.realize(moved, Stage::Dynamics);
+    testForcesEqual(f, system.getRigidBodyForces(moved, Stage::Dynamics));
+
+    state.setTime(3.5 * StepSize);
+    SimTK_TEST_MUST_THROW(system.realize(state, Stage::Dynamics));
+    state.setTime(Real(4.001) * StepSize);
+    SimTK_TEST_MUST_THROW(system.realize(state, Stage::Dynamics));
+
+    const int NumSteps = 1000000;
+    Real t = 0;
+    for (int i=0; i < NumSteps; ++i)
+        t += StepSize;
+    state.setTime(t);
+    system.realize(state, Stage::Dynamics);
+    const Vector_<SpatialVec> fSummed = 
+        system.getRigidBodyForces(state, Stage::Dynamics);
+    state.setTime(NumSteps * StepSize);
+    system.realize(state, Stage::Dynamics);
+    testForcesEqual(fSummed, system.getRigidBodyForces(state, Stage::Dynamics));
+}
+
+int main() {
+    SimTK_START_TEST("TestDuMMMultipleTimeStep");
+        SimTK_SUBTEST(testIntervalOneMatchesSingleStep);
+        SimTK_SUBTEST(testSlowForcesAreImpulseWeighted);
+        SimTK_SUBTEST(testSlowForcesFollowPositions);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,116 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+// Tests for DuMM's vectorized nonbonded kernels, which must agree with the
+// scalar kernel, and for the tiled multithreaded calculation that uses them.
+
+#include "SimTKmolmodel.h"
+#include "SimTKsimbody.h"
+
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// Calculate the van der Waals + Coulomb energy and the body forces of a 
+// small peptide, using vectorized kernels if allowed.
+static Real calcPeptideNonbonded(bool vectorized, int numThreads,
+                                 Vector_<SpatialVec>& bodyForces, 
+                                 string& kernel, int tileSize=32)
+{
+    CompoundSystem system;
+    SimbodyMatterSubsystem matter(system);
+    DuMMForceFieldSubsystem dumm(system);
+    dumm.loadAmber99Parameters();
+
+    dumm.setAllGlobalScaleFactors(0);
+    dumm.setVdwGlobalScaleFactor(1);
+    dumm.setCoulombGlobalScaleFactor(1);
+
+    dumm.setUseVectorizedNonbondedKernels(vectorized);
+    dumm.setUseMultithreadedComputation(numThreads > 0);
+    dumm.setNumThreadsRequested(numThreads, tileSize);
+    SimTK_TEST(dumm.getNumThreadsRequested() == numThreads);
+    SimTK_TEST(dumm.getNonbondedTileSize() == tileSize);
+
+    Protein peptide("SIVKGAFLWDERTYCA");
+    system.adoptCompound(peptide);
+    system.modelCompounds();
+
+    State state = system.realizeTopology();
+    kernel = dumm.getNonbondedKernelInUse();
+
+    system.realize(state, Stage::Dynamics);
+    bodyForces = system.getRigidBodyForces(state, Stage::Dynamics);
+    return system.calcPotentialEnergy(state);
+}
+
+void testVectorizedMatchesScalar() {
+    Vector_<SpatialVec> scalarForces, vectorForces;
+    string scalarKernel, vectorKernel;
+    const Real scalar = calcPeptideNonbonded(false, 0, scalarForces, scalarKernel);
+    SimTK_TEST(scalarKernel == "scalar");
+
+    const Real vector = calcPeptideNonbonded(true, 0, vectorForces, vectorKernel);
+    cout << "Nonbonded kernel in use: " << vectorKernel << endl;
+    SimTK_TEST_EQ(vector, scalar);
+    SimTK_TEST_EQ(vectorForces, scalarForces);
+
+    const Real vectorMT = calcPeptideNonbonded(true, 3, vectorForces, vectorKernel);
+    SimTK_TEST_EQ(vectorMT, scalar);
+    SimTK_TEST_EQ(vectorForces, scalarForces);
+}
+
+// The multithreaded result must not depend on how the work is tiled; the
+// peptide has a few hundred atoms, so these go from one atom per tile to a
+// single tile.
+void testTileSizesMatchSerial() {
+    Vector_<SpatialVec> serialForces, tiledForces;
+    string kernel;
+    const Real serial = calcPeptideNonbonded(true, 0, serialForces, kernel);
+
+    const int tileSizes[] = {1, 7, 32, 1000};
+    for (int i=0; i < 4; ++i) {
+        const Real tiled = calcPeptideNonbonded(true, 4, tiledForces, kernel,
+                                                tileSizes[i]);
+        SimTK_TEST_EQ(tiled, serial);
+        SimTK_TEST_EQ(tiledForces, serialForces);
+    }
+}
+
+int main() {
+    SimTK_START_TEST("TestDuMMNonbondKernels");
+        SimTK_SUBTEST(testVectorizedMatchesScalar);
+        SimTK_SUBTEST(testTileSizesMatchSerial);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,144 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+// Tests for DuMM's optional nonbonded cutoff and its Verlet neighbor list.
+
+#include "SimTKmolmodel.h"
+#include "SimTKsimbody.h"
+
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+// Calculate the van der Waals + Coulomb energy of a small peptide.
+static Real calcPeptideNonbondedEnergy(bool useCutoff, Real cutoff,
+                                       int numThreads)
+{
+    CompoundSystem system;
+    SimbodyMatterSubsystem matter(system);
+    DuMMForceFieldSubsystem dumm(system);
+    dumm.loadAmber99Parameters();
+
+    dumm.setAllGlobalScaleFactors(0);
+    dumm.setVdwGlobalScaleFactor(1);
+    dumm.setCoulombGlobalScaleFactor(1);
+
+    dumm.setUseNonbondedCutoff(useCutoff);
+    dumm.setNonbondedCutoff(cutoff);
+    dumm.setUseMultithreadedComputation(numThreads > 0);
+    dumm.setNumThreadsRequested(numThreads);
+
+    Protein peptide("SIVKGAFLWDERTYCA");
+    system.adoptCompound(peptide);
+    system.modelCompounds();
+
+    State state = system.realizeTopology();
+    system.realize(state, Stage::Dynamics);
+    return system.calcPotentialEnergy(state);
+}
+
+// With a cutoff larger than the molecule we must get exactly the same
+// pairs as the all-pairs calculation, with the same scaling of bonded pairs.
+void testHugeCutoffMatchesAllPairs() {
+    const Real allPairs = calcPeptideNonbondedEnergy(false, 1, 0);
+    SimTK_TEST_EQ(calcPeptideNonbondedEnergy(true, 100, 0), allPairs);
+    SimTK_TEST_EQ(calcPeptideNonbondedEnergy(true, 100, 3), allPairs);
+}
+
+// Serial and multithreaded neighbor list calculations must agree.
+void testSerialMatchesMultithreaded() {
+    const Real serial = calcPeptideNonbondedEnergy(true, Real(0.6), 0);
+    SimTK_TEST_EQ(calcPeptideNonbondedEnergy(true, Real(0.6), 1), serial);
+    SimTK_TEST_EQ(calcPeptideNonbondedEnergy(true, Real(0.6), 4), serial);
+}
+
+// Move a sodium ion around a chloride ion and check that the neighbor list
+// is rebuilt only when the sodium has moved more than half the skin, and
+// that pairs beyond the cutoff are ignored.
+void testNeighborListRebuild() {
+    CompoundSystem system;
+    SimbodyMatterSubsystem matter(system);
+    DuMMForceFieldSubsystem dumm(system);
+
+    dumm.setAllGlobalScaleFactors(0);
+    dumm.setCoulombGlobalScaleFactor(1);
+    dumm.setUseNonbondedCutoff(true);
+    dumm.setNonbondedCutoff(1);
+    dumm.setNeighborListSkin(Real(0.2));
+
+    SodiumIon::setAmberLikeParameters(dumm);
+    ChlorideIon::setAmberLikeParameters(dumm);
+
+    SodiumIon na;
+    ChlorideIon cl;
+    system.adoptCompound(na, Vec3(0.5, 0, 0));
+    system.adoptCompound(cl);
+    system.modelCompounds();
+
+    const MobilizedBody& naBody =
+        matter.getMobilizedBody(na.getAtomMobilizedBodyIndex(Compound::AtomIndex(0)));
+
+    State state = system.realizeTopology();
+    const Real qq = 138.935456 * -1.0 * 1.0;
+
+    naBody.setQToFitTranslation(state, Vec3(0.5, 0, 0));
+    system.realize(state, Stage::Dynamics);
+    SimTK_TEST_EQ(system.calcPotentialEnergy(state), qq/0.5);
+    SimTK_TEST(dumm.getNeighborListBuildCount() == 1);
+
+    // Moved less than half the skin; the list is reused.
+    naBody.setQToFitTranslation(state, Vec3(0.55, 0, 0));
+    system.realize(state, Stage::Dynamics);
+    SimTK_TEST_EQ(system.calcPotentialEnergy(state), qq/0.55);
+    SimTK_TEST(dumm.getNeighborListBuildCount() == 1);
+
+    // Moved more than half the skin since the list was built.
+    naBody.setQToFitTranslation(state, Vec3(0.75, 0, 0));
+    system.realize(state, Stage::Dynamics);
+    SimTK_TEST_EQ(system.calcPotentialEnergy(state), qq/0.75);
+    SimTK_TEST(dumm.getNeighborListBuildCount() == 2);
+
+    // Beyond the cutoff there is no interaction at all.
+    naBody.setQToFitTranslation(state, Vec3(1.5, 0, 0));
+    system.realize(state, Stage::Dynamics);
+    SimTK_TEST_EQ(system.calcPotentialEnergy(state), 0.0);
+}
+
+int main() {
+    SimTK_START_TEST("TestDuMMNonbondedCutoff");
+        SimTK_SUBTEST(testHugeCutoffMatchesAllPairs);
+        SimTK_SUBTEST(testSerialMatchesMultithreaded);
+        SimTK_SUBTEST(testNeighborListRebuild);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,100 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+
+// Tests for DuMM's multithreaded topology realization and its timing and
+// memory report.
+
+#include "SimTKmolmodel.h"
+#include "SimTKsimbody.h"
+
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+#include <sstream>
+
+using namespace SimTK;
+using namespace std;
+
+// Calculate the potential energy and body forces of a 48-residue peptide with
+// all the force field terms on. Zero threads means the serial code is used
+// for topology realization too.
+static Real calcPeptideForces(int numThreads, Vector_<SpatialVec>& bodyForces,
+                              string& report)
+{
+    CompoundSystem system;
+    SimbodyMatterSubsystem matter(system);
+    DuMMForceFieldSubsystem dumm(system);
+    dumm.loadAmber99Parameters();
+
+    dumm.setUseMultithreadedComputation(numThreads > 0);
+    dumm.setNumThreadsRequested(numThreads);
+
+    Protein peptide("SIVKGAFLWDERTYCASIVKGAFLWDERTYCASIVKGAFLWDERTYCA");
+    system.adoptCompound(peptide);
+    system.modelCompounds();
+
+    State state = system.realizeTopology();
+    ostringstream out;
+    dumm.dumpTopologyStatistics(out);
+    report = out.str();
+
+    system.realize(state, Stage::Dynamics);
+    bodyForces = system.getRigidBodyForces(state, Stage::Dynamics);
+    return system.calcPotentialEnergy(state);
+}
+
+// The bond graph is split into blocks of atoms for the threads; the result
+// must not depend on how many there are. The report says how the walk was
+// done and what it cost.
+void testParallelTopologyMatchesSerial() {
+    Vector_<SpatialVec> serialForces, forces;
+    string serialReport, report;
+    const Real serial = calcPeptideForces(0, serialForces, serialReport);
+    cout << serialReport;
+    SimTK_TEST(serialReport.find("walked with 1 thread.") != string::npos);
+    SimTK_TEST(serialReport.find("bond graph walk") != string::npos);
+    SimTK_TEST(serialReport.find("total") != string::npos);
+    SimTK_TEST(serialReport.find("memory (MB)") != string::npos);
+
+    for (int nt=2; nt <= 3; ++nt) {
+        SimTK_TEST_EQ_TOL(calcPeptideForces(nt, forces, report), serial, 1e-10);
+        SimTK_TEST(report.find("walked with 1 thread.") == string::npos);
+        for (int i=0; i < serialForces.size(); ++i)
+            SimTK_TEST_EQ_TOL(forces[i], serialForces[i], 1e-10);
+    }
+}
+
+int main() {
+    SimTK_START_TEST("TestDuMMParallelTopology");
+        SimTK_SUBTEST(testParallelTopologyMatchesSerial);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,122 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+// Tests for DuMM's periodic box and PME electrostatics.
+
+#include "SimTKmolmodel.h"
+#include "SimTKsimbody.h"
+
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+using namespace std;
+
+static const Real CoulombConstant = 138.935456; // kJ-nm/mol-e^2
+
+// A sodium and a chloride ion near opposite faces of the box are close
+// together through the periodic boundary.
+void testMinimumImage() {
+    CompoundSystem system;
+    SimbodyMatterSubsystem matter(system);
+    DuMMForceFieldSubsystem dumm(system);
+
+    dumm.setAllGlobalScaleFactors(0);
+    dumm.setCoulombGlobalScaleFactor(1);
+    dumm.setUseNonbondedCutoff(true);
+    dumm.setNonbondedCutoff(Real(0.9));
+    dumm.setPeriodicBoxDimensions(Vec3(2));
+    dumm.setUseEwaldElectrostatics(false);
+
+    SodiumIon::setAmberLikeParameters(dumm);
+    ChlorideIon::setAmberLikeParameters(dumm);
+
+    SodiumIon na;
+    ChlorideIon cl;
+    system.adoptCompound(na, Vec3(0.1, 1, 1));
+    system.adoptCompound(cl, Vec3(1.9, 1, 1));
+    system.modelCompounds();
+
+    State state = system.realizeTopology();
+    system.realize(state, Stage::Dynamics);
+    SimTK_TEST_EQ(system.calcPotentialEnergy(state), -CoulombConstant/0.2);
+}
+
+// The electrostatic energy of a rock salt crystal is given by its Madelung 
+// constant, which PME should reproduce to within its error tolerance.
+void testMadelungConstant() {
+    CompoundSystem system;
+    SimbodyMatterSubsystem matter(system);
+    DuMMForceFieldSubsystem dumm(system);
+
+    const Real a = Real(0.564); // lattice constant, nm
+    const int  nCells = 3;
+
+    dumm.setAllGlobalScaleFactors(0);
+    dumm.setCoulombGlobalScaleFactor(1);
+    dumm.setUseNonbondedCutoff(true);
+    dumm.setNonbondedCutoff(Real(0.8));
+    dumm.setPeriodicBoxDimensions(Vec3(nCells*a));
+    dumm.setEwaldErrorTolerance(Real(1e-5));
+
+    SodiumIon::setAmberLikeParameters(dumm);
+    ChlorideIon::setAmberLikeParameters(dumm);
+
+    int nIons = 0;
+    for (int i=0; i < 2*nCells; ++i)
+        for (int j=0; j < 2*nCells; ++j)
+            for (int k=0; k < 2*nCells; ++k, ++nIons) {
+                const Vec3 location(i*a/2, j*a/2, k*a/2);
+                if ((i+j+k) % 2) {
+                    SodiumIon na;
+                    system.adoptCompound(na, location);
+                } else {
+                    ChlorideIon cl;
+                    system.adoptCompound(cl, location);
+                }
+            }
+    system.modelCompounds();
+
+    State state = system.realizeTopology();
+    system.realize(state, Stage::Dynamics);
+
+    const Real madelung = Real(1.747565);
+    const Real expected = -(nIons/2) * madelung * CoulombConstant / (a/2);
+    SimTK_TEST_EQ_TOL(system.calcPotentialEnergy(state), expected, 1e-4);
+}
+
+int main() {
+    SimTK_START_TEST("TestDuMMPeriodicBox");
+        SimTK_SUBTEST(testMinimumImage);
+        SimTK_SUBTEST(testMadelungConstant);
+    SimTK_END_TEST();
+}
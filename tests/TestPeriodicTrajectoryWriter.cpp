@@ -0,0 +1,228 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+
+// Tests for the PDB atom order and for PeriodicTrajectoryWriter's DCD and
+// compressed trajectory formats.
+
+#include "SimTKmolmodel.h"
+#include "SimTKsimbody.h"
+
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace SimTK;
+using namespace std;
+
+// Two peptides, so that atom ordering across compounds gets checked too.
+// The state is moved away from the default configuration.
+class TwoPeptides {
+public:
+    TwoPeptides()
+    :   matter(system), dumm(system), first("SIVKW"), second("GAF")
+    {
+        dumm.loadAmber99Parameters();
+
+        system.adoptCompound(first);
+        system.adoptCompound(second, Vec3(2, 0, 0));
+        system.modelCompounds();
+
+        state = system.realizeTopology();
+        system.realizeModel(state);
+        for (int i = 0; i < state.getNQ(); ++i)
+            state.updQ()[i] += Real(0.05)*std::sin(Real(i));
+        system.realize(state, Stage::Position);
+    }
+
+    // Reference locations, gathered one atom at a time.
+    Array_<Vec3> calcLocationsOneByOne() const {
+        Array_<Vec3> locations;
+        for (CompoundSystem::CompoundIndex c(0); c < system.getNumCompounds(); ++c) {
+            const Compound& compound = system.getCompound(c);
+            Array_<Compound::AtomIndex> atomIndices;
+            compound.getAtomIndicesInPdbOrder(atomIndices);
+            SimTK_TEST((int)atomIndices.size() == compound.getNumAtoms());
+            for (unsigned i = 0; i < atomIndices.size(); ++i)
+                locations.push_back(compound.calcAtomLocationInGroundFrame(state, atomIndices[i]));
+        }
+        return locations;
+    }
+
+    CompoundSystem          system;
+    SimbodyMatterSubsystem  matter;
+    DuMMForceFieldSubsystem dumm;
+    Protein                 first, second;
+    State                   state;
+};
+
+// Parse the coordinates, in nanometers, from the ATOM records of PDB text.
+static Array_<Vec3> readPdbLocations(const string& pdb) {
+    Array_<Vec3> locations;
+    istringstream in(pdb);
+    string line;
+    while (getline(in, line)) {
+        if (line.length() > 54 && (line.substr(0, 6) == "ATOM  " || line.substr(0, 6) == "HETATM")) {
+            Vec3 x;
+            for (int k = 0; k < 3; ++k)
+                istringstream(line.substr(30 + 8*k, 8)) >> x[k];
+            locations.push_back(x/10);
+        }
+    }
+    return locations;
+}
+
+template <class T>
+static T readNative(istream& in) {
+    T value;
+    in.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return value;
+}
+
+void testPdbAtomOrder() {
+    TwoPeptides peptides;
+    const Array_<Vec3> locations = peptides.calcLocationsOneByOne();
+
+    // Same order as writePdb(), which prints to 0.01 Angstrom.
+    ostringstream pdb;
+    int nextAtomSerialNumber = 1;
+    for (CompoundSystem::CompoundIndex c(0); c < peptides.system.getNumCompounds(); ++c)
+        peptides.system.getCompound(c).writePdb(peptides.state, pdb, nextAtomSerialNumber);
+    const Array_<Vec3> pdbLocations = readPdbLocations(pdb.str());
+    SimTK_TEST(pdbLocations.size() == locations.size());
+    for (unsigned i = 0; i < pdbLocations.size(); ++i)
+        SimTK_TEST_EQ_TOL(pdbLocations[i], locations[i], 1e-3);
+}
+
+void testDcdTrajectory() {
+    TwoPeptides peptides;
+    const Array_<Vec3> expected = peptides.calcLocationsOneByOne();
+    const int numAtoms = (int)expected.size();
+
+    stringstream dcd(ios::in | ios::out | ios::binary);
+    ostringstream topology;
+    PeriodicTrajectoryWriter writer(peptides.system, dcd, 0.5);
+    writer.setTopologyStream(topology);
+    SimTK_TEST(writer.getFormat() == PeriodicTrajectoryWriter::DcdFormat);
+
+    const int numFrames = 3;
+    for (int f = 0; f < numFrames; ++f) {
+        peptides.state.setTime(0.5*f);
+        writer.handleEvent(peptides.state);
+    }
+    SimTK_TEST(writer.getNumFramesWritten() == numFrames);
+    SimTK_TEST((int)readPdbLocations(topology.str()).size() == numAtoms);
+
+    // Control record, with the frame count patched in after each frame.
+    dcd.seekg(0);
+    SimTK_TEST(readNative<int>(dcd) == 84);
+    char cord[4];
+    dcd.read(cord, 4);
+    SimTK_TEST(string(cord, 4) == "CORD");
+    int icntrl[20];
+    for (int i = 0; i < 20; ++i)
+        icntrl[i] = readNative<int>(dcd);
+    SimTK_TEST(icntrl[0] == numFrames);
+    SimTK_TEST(icntrl[19] == 24);
+    SimTK_TEST(readNative<int>(dcd) == 84);
+
+    const int titleSize = readNative<int>(dcd);
+    dcd.seekg(titleSize, ios::cur);
+    SimTK_TEST(readNative<int>(dcd) == titleSize);
+
+    SimTK_TEST(readNative<int>(dcd) == 4);
+    SimTK_TEST(readNative<int>(dcd) == numAtoms);
+    SimTK_TEST(readNative<int>(dcd) == 4);
+
+    // Frames hold single precision Angstroms, X then Y then Z.
+    for (int f = 0; f < numFrames; ++f)
+        for (int k = 0; k < 3; ++k) {
+            SimTK_TEST(readNative<int>(dcd) == 4*numAtoms);
+            for (int a = 0; a < numAtoms; ++a)
+                SimTK_TEST_EQ_TOL(readNative<float>(dcd)/Real(10), expected[a][k], 1e-6);
+            SimTK_TEST(readNative<int>(dcd) == 4*numAtoms);
+        }
+    dcd.peek();
+    SimTK_TEST(dcd.eof());
+}
+
+static void checkCompressedTrajectory(Real precision) {
+    TwoPeptides peptides;
+    const Array_<Vec3> expected = peptides.calcLocationsOneByOne();
+
+    stringstream xtc(ios::in | ios::out | ios::binary);
+    PeriodicTrajectoryWriter writer(peptides.system, xtc, 0.5,
+                                    PeriodicTrajectoryWriter::CompressedFormat);
+    writer.setPrecision(precision);
+
+    const int numFrames = 2;
+    for (int f = 0; f < numFrames; ++f) {
+        peptides.state.setTime(0.5*f);
+        writer.handleEvent(peptides.state);
+    }
+
+    // Neighboring atoms are close together, so this is much smaller than
+    // the twelve bytes per atom of a DCD frame.
+    SimTK_TEST((int)xtc.str().size() < numFrames*8*(int)expected.size());
+
+    // Not the XTC magic number, so XTC readers won't mistake it for theirs.
+    SimTK_TEST(xtc.str().substr(0, 4) == "SMTR");
+
+    xtc.seekg(0);
+    Array_<Vec3> locations;
+    int step;
+    Real time;
+    for (int f = 0; f < numFrames; ++f) {
+        SimTK_TEST(PeriodicTrajectoryWriter::readCompressedFrame(xtc, locations, step, time));
+        SimTK_TEST(step == f);
+        SimTK_TEST_EQ(time, 0.5*f);
+        SimTK_TEST(locations.size() == expected.size());
+        for (unsigned i = 0; i < locations.size(); ++i)
+            for (int k = 0; k < 3; ++k)
+                SimTK_TEST(std::abs(locations[i][k] - expected[i][k]) <= 0.5001/precision);
+    }
+    SimTK_TEST(!PeriodicTrajectoryWriter::readCompressedFrame(xtc, locations, step, time));
+}
+
+void testCompressedTrajectory() {
+    checkCompressedTrajectory(1000);
+    checkCompressedTrajectory(100);
+}
+
+int main() {
+    SimTK_START_TEST("TestPeriodicTrajectoryWriter");
+        SimTK_SUBTEST(testPdbAtomOrder);
+        SimTK_SUBTEST(testDcdTrajectory);
+        SimTK_SUBTEST(testCompressedTrajectory);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,124 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKmolmodel.h"
+#include "molmodel/internal/AtomSubsystem.h"
+#include "molmodel/internal/VanDerWaalsForce.h"
+
+#include "SimTKcommon/Testing.h"
+
+#include <iostream>
+
+using namespace SimTK;
+
+// Argon atoms, one to a body, on a jiggled cubic lattice inside a bounding
+// sphere. The multithreaded forces and energy must match the serial ones.
+// With a cutoff the threads share out the AtomSubsystem's neighbor list;
+// without one they share out the bodies.
+static void checkMultithreadedMatchesSerial(Real cutoff) {
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter(system);
+    GeneralForceSubsystem   forces(system);
+    AtomSubsystem           atoms(system);
+
+    const Real argonMass = 39.948 * md::daltons;
+    VanDerWaalsForce* vdwForce = new VanDerWaalsForce(atoms, cutoff);
+    Force::Custom(forces, vdwForce);
+
+    Random::Uniform jiggle(-0.5 * md::angstroms, 0.5 * md::angstroms);
+    jiggle.setSeed(3);
+
+    const int  edge       = 8;
+    const Real latSpacing = 4.0 * md::angstroms;
+    for (int x = 0; x < edge; ++x)
+        for (int y = 0; y < edge; ++y)
+            for (int z = 0; z < edge; ++z) {
+                MobilizedBody::Cartesian body(matter.updGround(),
+                    Body::Rigid(MassProperties(argonMass, Vec3(0), Inertia(1))));
+                body.setDefaultQ(Vec3(x, y, z) * latSpacing 
+                    + Vec3(jiggle.getValue(), jiggle.getValue(), jiggle.getValue()));
+
+                AtomSubsystem::AtomIndex atomIx = atoms.addAtom(argonMass);
+                atoms.updAtom(atomIx).setStationInBodyFrame(Vec3(0));
+                atoms.setAtomMobilizedBodyIndex(atomIx, body.getMobilizedBodyIndex());
+                vdwForce->addAtom(atomIx, 1.88 * md::angstroms, 
+                                  0.23725 * md::kilocalories_per_mole);
+            }
+    vdwForce->addBoundarySphere(Vec3(0.5 * (edge-1) * latSpacing), 
+                                3.0 * md::nanometers, 
+                                1.88 * md::angstroms, 
+                                0.23725 * md::kilocalories_per_mole);
+
+    system.realizeTopology();
+    State state = system.getDefaultState();
+    system.realize(state, Stage::Position);
+
+    const int nb = matter.getNumBodies();
+    Vector_<Vec3> particleForces;
+    Vector mobilityForces;
+
+    SimTK_TEST(!vdwForce->getUseMultithreadedComputation());
+    Vector_<SpatialVec> serialForces(nb, SpatialVec(Vec3(0), Vec3(0)));
+    vdwForce->calcForce(state, serialForces, particleForces, mobilityForces);
+    const Real serialEnergy = vdwForce->calcPotentialEnergy(state);
+    std::cout << "serial energy " << serialEnergy << std::endl;
+
+    vdwForce->setUseMultithreadedComputation(true);
+    for (int numThreads = 0; numThreads <= 3; ++numThreads) {
+        vdwForce->setNumThreadsRequested(numThreads);
+        SimTK_TEST(vdwForce->getNumThreadsRequested() == numThreads);
+
+        Vector_<SpatialVec> parallelForces(nb, SpatialVec(Vec3(0), Vec3(0)));
+        vdwForce->calcForce(state, parallelForces, particleForces, mobilityForces);
+        const Real parallelEnergy = vdwForce->calcPotentialEnergy(state);
+
+        SimTK_TEST_EQ_TOL(parallelEnergy, serialEnergy, 1e-10);
+        for (int i = 0; i < nb; ++i) {
+            SimTK_TEST_EQ_TOL(parallelForces[i][0], serialForces[i][0], 1e-10);
+            SimTK_TEST_EQ_TOL(parallelForces[i][1], serialForces[i][1], 1e-10);
+        }
+    }
+}
+
+void testMultithreadedMatchesSerialWithCutoff() {
+    checkMultithreadedMatchesSerial(1.0 * md::nanometers);
+}
+
+void testMultithreadedMatchesSerialWithoutCutoff() {
+    checkMultithreadedMatchesSerial(0.0 * md::nanometers);
+}
+
+int main() {
+    SimTK_START_TEST("TestVanDerWaalsForceThreads");
+        SimTK_SUBTEST(testMultithreadedMatchesSerialWithCutoff);
+        SimTK_SUBTEST(testMultithreadedMatchesSerialWithoutCutoff);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,181 @@
+/* -------------------------------------------------------------------------- *
+ *                      SimTK Core: SimTK Molmodel                            *
+ * -------------------------------------------------------------------------- *
+ * This is part of the SimTK Core biosimulation toolkit originating from      *
+ * Simbios, the NIH National Center for Physics-Based Simulation of           *
+ * Biological Structures at Stanford, funded under the NIH Roadmap for        *
+ * Medical Research, grant U54 GM072970. See https://simtk.org.               *
+ *                                                                            *
+ * Portions copyright (c) 2026 Stanford University and the Authors.           *
+ * Authors:                                                                   *
+ * Contributors:                                                              *
+ *                                                                            *
+ * Permission is hereby granted, free of charge, to any person obtaining a    *
+ * copy of this software and associated documentation files (the "Software"), *
+ * to deal in the Software without restriction, including without limitation  *
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,   *
+ * and/or sell copies of the Software, and to permit persons to whom the      *
+ * Software is furnished to do so, subject to the following conditions:       *
+ *                                                                            *
+ * The above copyright notice and this permission notice shall be included in *
+ * all copies or substantial portions of the Software.                        *
+ *                                                                            *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,   *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL    *
+ * THE AUTHORS, CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,    *
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR      *
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE  *
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.                                     *
+ * -------------------------------------------------------------------------- */
+
+#include "SimTKmolmodel.h"
+#include "molmodel/internal/AtomSubsystem.h"
+#include "molmodel/internal/VoxelHash.h"
+
+#include "SimTKcommon/Testing.h"
+
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <vector>
+
+using namespace SimTK;
+
+// Compare the grid's neighbor and all-pairs queries with a brute force
+// search, for a compact cluster, a widely scattered set of points and a
+// set with coincident points.
+void testVoxelHashMatchesBruteForce() {
+    Random::Uniform random(-1.0, 1.0);
+    random.setSeed(7);
+
+    for (int trial = 0; trial < 3; ++trial) {
+        const int  n      = 500;
+        const Real spread = trial == 1 ? 100.0 : 2.5;
+        const Real cutoff = 0.6;
+
+        std::vector<Vec3> points(n);
+        VoxelHash<int> voxelHash(cutoff, n);
+        for (int i = 0; i < n; ++i) {
+            points[i] = spread * Vec3(random.getValue(), random.getValue(), random.getValue());
+            if (trial == 2 && i % 4 == 3) points[i] = points[i-1];
+            voxelHash.insert(i, points[i]);
+        }
+
+        std::set< std::pair<int,int> > expected;
+        for (int i = 0; i < n; ++i)
+            for (int j = i+1; j < n; ++j)
+                if ((points[i] - points[j]).normSqr() <= cutoff*cutoff)
+                    expected.insert(std::make_pair(i, j));
+
+        std::vector< std::pair<int,int> > pairs;
+        voxelHash.findAllPairs(pairs, cutoff);
+        std::set< std::pair<int,int> > found;
+        for (size_t p = 0; p < pairs.size(); ++p)
+            found.insert(std::make_pair(std::min(pairs[p].first, pairs[p].second),
+                                        std::max(pairs[p].first, pairs[p].second)));
+        SimTK_TEST(pairs.size() == expected.size());
+        SimTK_TEST(found == expected);
+
+        for (int q = 0; q < 50; ++q) {
+            const Vec3 location = q < 25 
+                ? points[q] 
+                : 1.5 * spread * Vec3(random.getValue(), random.getValue(), random.getValue());
+            std::vector<int> neighbors;
+            voxelHash.findNeighbors(neighbors, location, cutoff);
+            std::set<int> expectedNeighbors;
+            for (int i = 0; i < n; ++i)
+                if ((points[i] - location).normSqr() <= cutoff*cutoff)
+                    expectedNeighbors.insert(i);
+            SimTK_TEST(neighbors.size() == expectedNeighbors.size());
+            SimTK_TEST(std::set<int>(neighbors.begin(), neighbors.end()) == expectedNeighbors);
+        }
+    }
+}
+
+// The voxel hash pair iterator must visit exactly the pairs the n-squared
+// one does: atoms within the cutoff, on different bodies that are not
+// excluded from one another.
+void testPairIteratorAlgorithmsAgree() {
+    MultibodySystem         system;
+    SimbodyMatterSubsystem  matter(system);
+    AtomSubsystem           atoms(system);
+
+    Random::Uniform random(-1.5, 1.5);
+    random.setSeed(11);
+
+    const int numBodies = 150;
+    std::vector<MobilizedBodyIndex> bodies;
+    for (int b = 0; b < numBodies; ++b) {
+        MobilizedBody::Cartesian body(matter.updGround(),
+            Body::Rigid(MassProperties(40.0, Vec3(0), Inertia(1))));
+        body.setDefaultQ(Vec3(random.getValue(), random.getValue(), random.getValue()));
+        bodies.push_back(body.getMobilizedBodyIndex());
+
+        for (int a = 0; a < 2; ++a) {
+            AtomSubsystem::AtomIndex atomIx = atoms.addAtom(40.0);
+            atoms.updAtom(atomIx).setStationInBodyFrame(Vec3(0.1*a, 0, 0));
+            atoms.setAtomMobilizedBodyIndex(atomIx, body.getMobilizedBodyIndex());
+        }
+    }
+    for (int b = 1; b < numBodies; b += 3)
+        atoms.addBodyExclusion(bodies[b-1], bodies[b]);
+
+    system.realizeTopology();
+    State state = system.getDefaultState();
+    system.realize(state, Stage::Position);
+
+    const Real cutoff = 0.5;
+    std::set< std::pair<int,int> > nSquaredPairs, voxelHashPairs;
+    int numVoxelHashPairs = 0;
+
+    for (AtomSubsystem::PairIterator pair = 
+            atoms.pairBegin(state, cutoff, AtomSubsystem::N_SQUARED);
+         pair != atoms.pairEnd(); ++pair)
+        nSquaredPairs.insert(std::make_pair(std::min<int>(pair->first, pair->second),
+                                            std::max<int>(pair->first, pair->second)));
+
+    for (AtomSubsystem::PairIterator pair = 
+            atoms.pairBegin(state, cutoff, AtomSubsystem::VOXEL_HASH);
+         pair != atoms.pairEnd(); ++pair, ++numVoxelHashPairs)
+        voxelHashPairs.insert(std::make_pair(std::min<int>(pair->first, pair->second),
+                                             std::max<int>(pair->first, pair->second)));
+
+    std::cout << nSquaredPairs.size() << " pairs within cutoff" << std::endl;
+    SimTK_TEST(!nSquaredPairs.empty());
+    SimTK_TEST(numVoxelHashPairs == (int)voxelHashPairs.size());
+    SimTK_TEST(voxelHashPairs == nSquaredPairs);
+}
+
+// Locations from a simulation that has blown up must raise an error rather
+// than hang sizing the grid; locations that are merely far apart must work.
+void testNonFiniteLocationsThrow() {
+    const Real bad[] = {NaN, Infinity};
+    for (int i = 0; i < 2; ++i) {
+        VoxelHash<int> voxelHash(0.5, 3);
+        voxelHash.insert(0, Vec3(0));
+        voxelHash.insert(1, Vec3(1, bad[i], 0));
+        voxelHash.insert(2, Vec3(0, 1, 0));
+        std::vector< std::pair<int,int> > pairs;
+        SimTK_TEST_MUST_THROW(voxelHash.findAllPairs(pairs, 0.5));
+    }
+
+    VoxelHash<int> voxelHash(1e-3, 3);
+    voxelHash.insert(0, Vec3(-1e200, 0, 0));
+    voxelHash.insert(1, Vec3(1e200, 3, 0));
+    voxelHash.insert(2, Vec3(1e200, 3, 0.5));
+    std::vector< std::pair<int,int> > pairs;
+    voxelHash.findAllPairs(pairs, 1);
+    SimTK_TEST(pairs.size() == 1);
+
+    std::vector<int> neighbors;
+    SimTK_TEST_MUST_THROW(voxelHash.findNeighbors(neighbors, Vec3(NaN), 1));
+}
+
+int main() {
+    SimTK_START_TEST("TestVoxelHash");
+        SimTK_SUBTEST(testVoxelHashMatchesBruteForce);
+        SimTK_SUBTEST(testPairIteratorAlgorithmsAgree);
+        SimTK_SUBTEST(testNonFiniteLocationsThrow);
+    SimTK_END_TEST();
+}